@@ -233,6 +233,28 @@ public:
         m_bit_count -= count;
     }
 
+    /// Reads as many whole bytes from the underlying stream as fit into the bit buffer.
+    /// Unlike peek_bits(), this stops short instead of failing once the underlying stream runs dry.
+    ErrorOr<void> fill_bit_buffer()
+    {
+        while (m_bit_count <= bit_buffer_size - bits_per_byte) {
+            BufferType buffer = 0;
+            auto bytes = TRY(m_stream->read_some({ &buffer, (bit_buffer_size - m_bit_count) / bits_per_byte }));
+            if (bytes.is_empty())
+                break;
+
+            m_bit_buffer |= buffer << m_bit_count;
+            m_bit_count += bytes.size() * bits_per_byte;
+        }
+
+        return {};
+    }
+
+    /// Direct access to the bit buffer, for decoders that want to consume several fields per refill.
+    /// The buffer holds buffered_bit_count() valid bits, and everything above them is zero.
+    ALWAYS_INLINE u64 buffered_bits() const { return m_bit_buffer; }
+    ALWAYS_INLINE u8 buffered_bit_count() const { return m_bit_count; }
+
     /// Discards any sub-byte stream positioning the input stream may be keeping track of.
     /// Non-bitwise reads will implicitly call this.
     u8 align_to_byte_boundary()
@@ -25,6 +25,16 @@ static CPUIDResult cpuid(u32 leaf, u32 subleaf)
         : "0"(leaf), "2"(subleaf));
     return result;
 }
+
+static u64 xgetbv(u32 index)
+{
+    u32 eax;
+    u32 edx;
+    asm("xgetbv"
+        : "=a"(eax), "=d"(edx)
+        : "c"(index));
+    return (static_cast<u64>(edx) << 32) | eax;
+}
 #    endif
 
 CPUFeatures Detail::detect_cpu_features_uncached()
@@ -48,6 +58,27 @@ CPUFeatures Detail::detect_cpu_features_uncached()
     if (cpuid1.ecx >> 25 & 1)
         result |= CPUFeatures::X86_AES;
 #        endif
+#        if AK_CAN_CODEGEN_FOR_X86_PCLMUL
+    if (cpuid1.ecx >> 1 & 1)
+        result |= CPUFeatures::X86_PCLMUL;
+#        endif
+    // The extended vector registers are only usable if the OS saves them on context switches, as reported in XCR0.
+    [[maybe_unused]] u64 xcr0 = (cpuid1.ecx >> 27 & 1) ? xgetbv(0) : 0;
+
+#        if AK_CAN_CODEGEN_FOR_X86_AVX2
+    // AVX2 needs the SSE and the upper YMM state (XCR0 bits 1 and 2).
+    if ((xcr0 & 0b110) == 0b110 && cpuid7.ebx >> 5 & 1)
+        result |= CPUFeatures::X86_AVX2;
+#        endif
+#        if AK_CAN_CODEGEN_FOR_X86_AVX512F
+    // AVX-512 additionally needs the opmask and the upper ZMM state (XCR0 bits 5 to 7).
+    if ((xcr0 & 0b1110'0110) == 0b1110'0110 && cpuid7.ebx >> 16 & 1)
+        result |= CPUFeatures::X86_AVX512F;
+#        endif
+#        if AK_CAN_CODEGEN_FOR_X86_VPCLMULQDQ
+    if (cpuid7.ecx >> 10 & 1)
+        result |= CPUFeatures::X86_VPCLMULQDQ;
+#        endif
 #    endif
 
     return result;
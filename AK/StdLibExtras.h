@@ -15,6 +15,7 @@
 #include <AK/StdLibExtraDetails.h>
 
 #include <AK/Assertions.h>
+#include <AK/Diagnostics.h>
 
 namespace AK {
 
@@ -211,6 +212,17 @@ __DEFINE_GENERIC_ABS(long double, 0.0L, fabsl);
 
 }
 
+// Like offsetof(), but also usable on classes that aren't standard-layout. This is meant for code that
+// has to reach into an object from the outside (e.g. JIT-compiled code), so keep it behind accessors.
+#define OFFSET_OF(class, member)                                        \
+    ({                                                                  \
+        AK_PRAGMA(GCC diagnostic push)                                  \
+        AK_PRAGMA(GCC diagnostic ignored "-Winvalid-offsetof")          \
+        FlatPtr __offset_of_member = __builtin_offsetof(class, member); \
+        AK_PRAGMA(GCC diagnostic pop)                                   \
+        __offset_of_member;                                             \
+    })
+
 #if USING_AK_GLOBALLY
 using AK::array_size;
 using AK::ceil_div;
@@ -134,6 +134,13 @@ public:
         return m_outline_buffer;
     }
 
+    // Without inline capacity, this is where data() comes from.
+    static FlatPtr outline_buffer_offset()
+    requires(inline_capacity == 0)
+    {
+        return OFFSET_OF(Vector, m_outline_buffer);
+    }
+
     ALWAYS_INLINE VisibleType const& at(size_t i) const
     {
         VERIFY(i < m_size);
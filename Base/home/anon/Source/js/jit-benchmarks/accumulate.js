@@ -0,0 +1,10 @@
+// The smallest possible loop: a local accumulator and the loop counter.
+function accumulate() {
+    let acc = 0;
+    for (let i = 0; i < 5000000; i++) {
+        acc = acc + 2;
+    }
+    return acc;
+}
+
+console.log(accumulate());
@@ -0,0 +1,6 @@
+// Mostly calls, which still go through the runtime even in native code.
+function fib(n) {
+    return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+console.log(fib(27));
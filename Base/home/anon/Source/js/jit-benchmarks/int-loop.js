@@ -0,0 +1,12 @@
+// Int32 arithmetic in a hot loop, entered 100 times.
+function sum(n) {
+    let s = 0;
+    for (let i = 0; i < n; i++) {
+        s = (s + i) | 0;
+    }
+    return s;
+}
+
+let total = 0;
+for (let k = 0; k < 100; k++) total += sum(200000);
+console.log(total);
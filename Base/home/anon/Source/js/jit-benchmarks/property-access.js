@@ -0,0 +1,12 @@
+// Property gets and puts that hit the inline caches.
+function access() {
+    let o = { x: 1, y: 2 };
+    let acc = 0;
+    for (let i = 0; i < 5000000; i++) {
+        o.x = o.x + 1;
+        acc = acc + o.y;
+    }
+    return acc;
+}
+
+console.log(access());
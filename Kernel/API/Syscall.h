@@ -20,6 +20,7 @@ constexpr int syscall_vector = 0x82;
 
 extern "C" {
 struct pollfd;
+struct epoll_event;
 struct timeval;
 struct timespec;
 struct sockaddr;
@@ -72,6 +73,9 @@ enum class NeedsBigProcessLock {
     S(dump_backtrace, NeedsBigProcessLock::No)             \
     S(dup2, NeedsBigProcessLock::No)                       \
     S(emuctl, NeedsBigProcessLock::No)                     \
+    S(epoll_create1, NeedsBigProcessLock::No)              \
+    S(epoll_ctl, NeedsBigProcessLock::No)                  \
+    S(epoll_wait, NeedsBigProcessLock::No)                 \
     S(execve, NeedsBigProcessLock::Yes)                    \
     S(exit, NeedsBigProcessLock::Yes)                      \
     S(exit_thread, NeedsBigProcessLock::Yes)               \
@@ -145,20 +149,21 @@ enum class NeedsBigProcessLock {
     S(profiling_free_buffer, NeedsBigProcessLock::Yes)     \
     S(ptrace, NeedsBigProcessLock::Yes)                    \
     S(purge, NeedsBigProcessLock::Yes)                     \
-    S(read, NeedsBigProcessLock::Yes)                      \
-    S(pread, NeedsBigProcessLock::Yes)                     \
+    S(read, NeedsBigProcessLock::No)                       \
+    S(pread, NeedsBigProcessLock::No)                      \
     S(readlink, NeedsBigProcessLock::No)                   \
-    S(readv, NeedsBigProcessLock::Yes)                     \
+    S(readv, NeedsBigProcessLock::No)                      \
     S(realpath, NeedsBigProcessLock::No)                   \
     S(recvfd, NeedsBigProcessLock::No)                     \
-    S(recvmsg, NeedsBigProcessLock::Yes)                   \
+    S(recvmsg, NeedsBigProcessLock::No)                    \
     S(rename, NeedsBigProcessLock::No)                     \
     S(remount, NeedsBigProcessLock::No)                    \
     S(rmdir, NeedsBigProcessLock::No)                      \
     S(scheduler_get_parameters, NeedsBigProcessLock::No)   \
     S(scheduler_set_parameters, NeedsBigProcessLock::No)   \
     S(sendfd, NeedsBigProcessLock::No)                     \
-    S(sendmsg, NeedsBigProcessLock::Yes)                   \
+    S(sendfile, NeedsBigProcessLock::No)                   \
+    S(sendmsg, NeedsBigProcessLock::No)                    \
     S(set_mmap_name, NeedsBigProcessLock::No)              \
     S(setegid, NeedsBigProcessLock::No)                    \
     S(seteuid, NeedsBigProcessLock::No)                    \
@@ -200,8 +205,8 @@ enum class NeedsBigProcessLock {
     S(utime, NeedsBigProcessLock::No)                      \
     S(utimensat, NeedsBigProcessLock::No)                  \
     S(waitid, NeedsBigProcessLock::Yes)                    \
-    S(write, NeedsBigProcessLock::Yes)                     \
-    S(pwritev, NeedsBigProcessLock::Yes)                   \
+    S(write, NeedsBigProcessLock::No)                      \
+    S(pwritev, NeedsBigProcessLock::No)                    \
     S(yield, NeedsBigProcessLock::No)
 
 namespace Syscall {
@@ -267,6 +272,13 @@ struct SC_poll_params {
     u32 const* sigmask;
 };
 
+struct SC_epoll_wait_params {
+    int epfd;
+    struct epoll_event* events;
+    int maxevents;
+    const struct timespec* timeout;
+};
+
 struct SC_clock_nanosleep_params {
     int clock_id;
     int flags;
@@ -129,7 +129,7 @@ void do_context_first_init(Thread* from_thread, Thread* to_thread)
     // Since we got here and don't have Scheduler::context_switch in the
     // call stack (because this is the first time we switched into this
     // context), we need to notify the scheduler so that it can release
-    // the scheduler lock. We don't want to enable interrupts at this point
+    // the context switch lock. We don't want to enable interrupts at this point
     // as we're still in the middle of a context switch. Doing so could
     // trigger a context switch within a context switch, leading to a crash.
     Scheduler::leave_on_first_switch(InterruptsState::Disabled);
@@ -193,73 +193,88 @@ ErrorOr<Vector<FlatPtr, 32>> ProcessorBase<T>::capture_stack_trace(Thread& threa
     // is a chance a context switch may happen while we're trying
     // to get it. It also won't be entirely accurate and merely
     // reflect the status at the last context switch.
-    SpinlockLocker lock(g_scheduler_lock);
-    if (&thread == Processor::current_thread()) {
-        VERIFY(thread.state() == Thread::State::Running);
-        // Leave the scheduler lock. If we trigger page faults we may
-        // need to be preempted. Since this is our own thread it won't
-        // cause any problems as the stack won't change below this frame.
-        lock.unlock();
-        TRY(capture_current_thread());
-    } else if (thread.is_active()) {
+    // NOTE: Context switches only take g_scheduler_lock to change the state
+    //       of the threads involved, so holding it doesn't stop them. If we
+    //       catch the thread in the middle of one, we try again.
+    for (;;) {
+        SpinlockLocker lock(g_scheduler_lock);
+        if (&thread == Processor::current_thread()) {
+            VERIFY(thread.state() == Thread::State::Running);
+            // Leave the scheduler lock. If we trigger page faults we may
+            // need to be preempted. Since this is our own thread it won't
+            // cause any problems as the stack won't change below this frame.
+            lock.unlock();
+            TRY(capture_current_thread());
+        } else if (thread.is_active()) {
 #if ARCH(X86_64)
-        VERIFY(thread.cpu() != Processor::current_id());
-        // If this is the case, the thread is currently running
-        // on another processor. We can't trust the kernel stack as
-        // it may be changing at any time. We need to probably send
-        // an IPI to that processor, have it walk the stack and wait
-        // until it returns the data back to us
-        auto& proc = Processor::current();
-        ErrorOr<void> result;
-        Processor::smp_unicast(
-            thread.cpu(),
-            [&]() {
-                dbgln("CPU[{}] getting stack for cpu #{}", Processor::current_id(), proc.id());
-                ScopedAddressSpaceSwitcher switcher(thread.process());
-                VERIFY(&Processor::current() != &proc);
-                VERIFY(&thread == Processor::current_thread());
-                // NOTE: Because the other processor is still holding the
-                // scheduler lock while waiting for this callback to finish,
-                // the current thread on the target processor cannot change
-
-                // TODO: What to do about page faults here? We might deadlock
-                //       because the other processor is still holding the
-                //       scheduler lock...
-                result = capture_current_thread();
-            },
-            false);
-        TRY(result);
+            // The thread is being switched in or out.
+            if (thread.state() != Thread::State::Running || thread.cpu() == Processor::current_id())
+                continue;
+            // If this is the case, the thread is currently running
+            // on another processor. We can't trust the kernel stack as
+            // it may be changing at any time. We need to probably send
+            // an IPI to that processor, have it walk the stack and wait
+            // until it returns the data back to us
+            auto& proc = Processor::current();
+            ErrorOr<void> result;
+            bool thread_was_switched_in = true;
+            Processor::smp_unicast(
+                thread.cpu(),
+                [&]() {
+                    dbgln("CPU[{}] getting stack for cpu #{}", Processor::current_id(), proc.id());
+                    VERIFY(&Processor::current() != &proc);
+                    // NOTE: The thread may have been picked, but not switched to yet.
+                    //       Because we hold the scheduler lock, the other processor
+                    //       can't switch away from the thread once it is current.
+                    if (&thread != Processor::current_thread()) {
+                        thread_was_switched_in = false;
+                        return;
+                    }
+                    ScopedAddressSpaceSwitcher switcher(thread.process());
+
+                    // TODO: What to do about page faults here? We might deadlock
+                    //       because we are still holding the scheduler lock...
+                    result = capture_current_thread();
+                },
+                false);
+            if (!thread_was_switched_in)
+                continue;
+            TRY(result);
 #elif ARCH(AARCH64) || ARCH(RISCV64)
-        VERIFY_NOT_REACHED(); // We don't support SMP on AArch64 and RISC-V yet, so this should be unreachable.
+            VERIFY_NOT_REACHED(); // We don't support SMP on AArch64 and RISC-V yet, so this should be unreachable.
 #else
 #    error Unknown architecture
 #endif
-    } else {
-        switch (thread.state()) {
-        case Thread::State::Running:
-            VERIFY_NOT_REACHED(); // should have been handled above
-        case Thread::State::Runnable:
-        case Thread::State::Stopped:
-        case Thread::State::Blocked:
-        case Thread::State::Dying:
-        case Thread::State::Dead: {
-            ScopedAddressSpaceSwitcher switcher(thread.process());
-            auto& regs = thread.regs();
-
-            pc = regs.ip();
-            frame_ptr = regs.frame_pointer();
-
-            // TODO: We need to leave the scheduler lock here, but we also
-            //       need to prevent the target thread from being run while
-            //       we walk the stack
-            lock.unlock();
-            TRY(walk_stack(frame_ptr));
-            break;
-        }
-        default:
-            dbgln("Cannot capture stack trace for thread {} in state {}", thread, thread.state_string());
-            break;
+        } else {
+            switch (thread.state()) {
+            case Thread::State::Running:
+                VERIFY_NOT_REACHED(); // should have been handled above
+            case Thread::State::Runnable:
+            case Thread::State::Stopped:
+            case Thread::State::Blocked:
+            case Thread::State::Dying:
+            case Thread::State::Dead: {
+                // NOTE: Switching to the thread needs the scheduler lock to
+                //       mark it as running, so its registers can't change here.
+                ScopedAddressSpaceSwitcher switcher(thread.process());
+                auto& regs = thread.regs();
+
+                pc = regs.ip();
+                frame_ptr = regs.frame_pointer();
+
+                // TODO: We need to leave the scheduler lock here, but we also
+                //       need to prevent the target thread from being run while
+                //       we walk the stack
+                lock.unlock();
+                TRY(walk_stack(frame_ptr));
+                break;
+            }
+            default:
+                dbgln("Cannot capture stack trace for thread {} in state {}", thread, thread.state_string());
+                break;
+            }
         }
+        break;
     }
 
     return stack_trace;
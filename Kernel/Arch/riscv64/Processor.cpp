@@ -361,7 +361,7 @@ void ProcessorBase<T>::assume_context(Thread& thread, InterruptsState new_interr
     VERIFY_INTERRUPTS_DISABLED();
     Scheduler::prepare_after_exec();
     // in_critical() should be 2 here. The critical section in Process::exec
-    // and then the scheduler lock
+    // and then the context switch lock
     VERIFY(Processor::in_critical() == 2);
 
     do_assume_context(&thread, to_underlying(new_interrupts_state));
@@ -372,10 +372,10 @@ void ProcessorBase<T>::assume_context(Thread& thread, InterruptsState new_interr
 template<typename T>
 FlatPtr ProcessorBase<T>::init_context(Thread& thread, bool leave_crit)
 {
-    VERIFY(g_scheduler_lock.is_locked());
+    VERIFY(Scheduler::context_switch_lock().is_locked_by_current_processor());
     if (leave_crit) {
         // Leave the critical section we set up in Process::exec,
-        // but because we still have the scheduler lock we should end up with 1
+        // but because we still have the context switch lock we should end up with 1
         VERIFY(in_critical() == 2);
         m_in_critical = 1; // leave it without triggering anything or restoring flags
     }
@@ -270,11 +270,10 @@ extern "C" void handle_interrupt(TrapFrame*) __attribute__((used));
 
 extern "C" UNMAP_AFTER_INIT void pre_init_finished(void)
 {
-    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
+    VERIFY(Scheduler::context_switch_lock().is_locked_by_current_processor());
 
-    // Because init_finished() will wait on the other APs, we need
-    // to release the scheduler lock so that the other APs can also get
-    // to this point
+    // init_finished() will wait on the other APs, which we must not do
+    // in the middle of a context switch
 
     // The target flags will get restored upon leaving the trap
     Scheduler::leave_on_first_switch(Processor::interrupts_state());
@@ -282,7 +281,7 @@ extern "C" UNMAP_AFTER_INIT void pre_init_finished(void)
 
 extern "C" UNMAP_AFTER_INIT void post_init_finished(void)
 {
-    // We need to re-acquire the scheduler lock before a context switch
+    // We need to re-acquire the context switch lock before a context switch
     // transfers control into the idle loop, which needs the lock held
     Scheduler::prepare_for_idle_loop();
 }
@@ -4,115 +4,489 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/FixedArray.h>
+#include <AK/HashFunctions.h>
 #include <AK/IntrusiveList.h>
+#include <AK/QuickSort.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/WorkQueue.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
+// The disk cache is split into shards by block index, each with its own lock,
+// so that I/O on unrelated blocks doesn't serialize on a single mutex.
+//
+// Within a shard, clean blocks are managed with the 2Q replacement policy:
+// Blocks enter a probationary FIFO queue on their first use, and only get
+// promoted to the protected LRU queue if they are used again soon after
+// being evicted (which we remember in a "ghost" queue of block indices).
+// This keeps one large sequential read from flushing out the working set,
+// as it only ever churns the probationary queue.
+//
+// Dirty blocks are taken off the queues until they have been written back.
+// They are kept on a per-shard list in the order they became dirty, so the
+// writeback engine can easily find the ones that have been dirty the longest.
+
+enum class CacheQueue : u8 {
+    Free,
+    Probationary,
+    Protected,
+};
+
 struct CacheEntry {
     IntrusiveListNode<CacheEntry> list_node;
     BlockBasedFileSystem::BlockIndex block_index { 0 };
     u8* data { nullptr };
     bool has_data { false };
+    bool is_dirty { false };
+    bool is_being_written_back { false };
+    CacheQueue queue { CacheQueue::Free };
+    u64 dirtied_at_ms { 0 };
+    u64 dirty_generation { 0 };
 };
 
-class DiskCache {
+class DiskCacheShard {
+    AK_MAKE_NONCOPYABLE(DiskCacheShard);
+    AK_MAKE_NONMOVABLE(DiskCacheShard);
+
 public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
-        : m_fs(fs)
-        , m_cached_block_data(move(cached_block_data))
-        , m_entries(move(entries_buffer))
+    using EntryList = IntrusiveList<&CacheEntry::list_node>;
+
+    DiskCacheShard() = default;
+
+    ~DiskCacheShard()
     {
-        for (size_t i = 0; i < EntryCount; ++i) {
-            entries()[i].data = m_cached_block_data->data() + i * m_fs->logical_block_size();
-            m_clean_list.append(entries()[i]);
-        }
+        // NOTE: The entries live in our chunks, so make sure our lists let go of them first.
+        m_free_list.clear();
+        m_probationary_list.clear();
+        m_protected_list.clear();
+        m_dirty_list.clear();
     }
 
-    ~DiskCache() = default;
+    ErrorOr<void> initialize(BlockBasedFileSystem& fs, size_t capacity)
+    {
+        m_fs = &fs;
+        m_capacity = capacity;
+
+        // NOTE: Following the 2Q paper, a quarter of the shard is set aside for blocks on probation,
+        //       and we remember the last half a shard's worth of blocks evicted from probation.
+        m_probationary_target = max<size_t>(m_capacity / 4, 1);
+        m_ghost_ring = TRY(FixedArray<BlockBasedFileSystem::BlockIndex>::create(max<size_t>(m_capacity / 2, 1)));
+
+        TRY(m_ghosts.try_ensure_capacity(m_ghost_ring.size()));
+        return {};
+    }
+
+    Mutex& lock() { return m_lock; }
 
     bool is_dirty() const { return !m_dirty_list.is_empty(); }
-    bool entry_is_dirty(CacheEntry const& entry) const { return m_dirty_list.contains(entry); }
+    size_t dirty_count() const { return m_dirty_count; }
+
+    CacheEntry* find(BlockBasedFileSystem::BlockIndex block_index)
+    {
+        VERIFY(m_lock.is_exclusively_locked_by_current_thread());
+        auto it = m_hash.find(block_index);
+        if (it == m_hash.end())
+            return nullptr;
+        VERIFY(it->value->block_index == block_index);
+        return it->value;
+    }
+
+    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index)
+    {
+        if (auto* entry = find(block_index)) {
+            ++m_statistics.hits;
+            // Only repeated use of a protected block counts towards its recency.
+            // Blocks on probation are often used several times in a row, that doesn't make them hot.
+            if (!entry->is_dirty && entry->queue == CacheQueue::Protected && m_protected_list.first() != entry)
+                m_protected_list.prepend(*entry);
+            return entry;
+        }
+
+        ++m_statistics.misses;
+        auto* entry = TRY(take_entry_for_reuse());
+
+        auto hash_result = m_hash.try_set(block_index, entry);
+        if (hash_result.is_error()) {
+            m_free_list.append(*entry);
+            return hash_result.release_error();
+        }
+
+        entry->block_index = block_index;
+        entry->has_data = false;
+
+        if (forget_ghost(block_index)) {
+            // We evicted this block from probation not too long ago, so it's part of the working set.
+            ++m_statistics.ghost_hits;
+            entry->queue = CacheQueue::Protected;
+            m_protected_list.prepend(*entry);
+            ++m_protected_count;
+        } else {
+            entry->queue = CacheQueue::Probationary;
+            m_probationary_list.prepend(*entry);
+            ++m_probationary_count;
+        }
+        return entry;
+    }
+
+    bool has_data_for(BlockBasedFileSystem::BlockIndex block_index)
+    {
+        auto* entry = find(block_index);
+        return entry && entry->has_data;
+    }
+
+    // Bumped whenever a block in this shard is written, so readahead can tell whether the data it read is still current.
+    u64 write_generation() const { return m_write_generation; }
+    void did_write_block() { ++m_write_generation; }
 
-    void mark_all_clean()
+    // Puts a block that was read ahead of time into the cache, unless someone wrote to this shard in the meantime.
+    // NOTE: We never write back dirty blocks to make room for readahead.
+    bool insert_prefetched(BlockBasedFileSystem::BlockIndex block_index, ReadonlyBytes data, u64 write_generation)
     {
-        while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
+        VERIFY(data.size() == m_fs->logical_block_size());
+        if (write_generation != m_write_generation)
+            return false;
+
+        auto* entry = find(block_index);
+        if (entry && entry->has_data)
+            return false;
+
+        if (!entry) {
+            if (m_free_list.is_empty() && m_probationary_list.is_empty() && m_protected_list.is_empty()) {
+                if (grow().is_error())
+                    return false;
+            }
+            auto entry_or_error = take_entry_for_reuse();
+            if (entry_or_error.is_error())
+                return false;
+            entry = entry_or_error.release_value();
+            if (m_hash.try_set(block_index, entry).is_error()) {
+                m_free_list.append(*entry);
+                return false;
+            }
+            entry->block_index = block_index;
+            entry->queue = CacheQueue::Probationary;
+            m_probationary_list.prepend(*entry);
+            ++m_probationary_count;
+        }
+
+        memcpy(entry->data, data.data(), data.size());
+        entry->has_data = true;
+        ++m_statistics.prefetched;
+        return true;
+    }
+
+    ErrorOr<void> fill(CacheEntry& entry)
+    {
+        if (entry.has_data)
+            return {};
+        auto base_offset = entry.block_index.value() * m_fs->logical_block_size();
+        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+        auto nread = TRY(m_fs->file_description().read(entry_data_buffer, base_offset, m_fs->logical_block_size()));
+        VERIFY(nread == m_fs->logical_block_size());
+        entry.has_data = true;
+        return {};
     }
 
     void mark_dirty(CacheEntry& entry)
     {
-        m_dirty_list.prepend(entry);
+        did_write_block();
+        // NOTE: This lets writeback tell whether the block was written to again while its data was on the way to the disk.
+        entry.dirty_generation = m_write_generation;
+        if (entry.is_dirty)
+            return;
+        remove_from_queue(entry);
+        entry.is_dirty = true;
+        entry.dirtied_at_ms = static_cast<u64>(TimeManagement::the().monotonic_time().milliseconds());
+        m_dirty_list.append(entry);
+        ++m_dirty_count;
     }
 
+    // Calls the callback for dirty entries, starting with the one that has been dirty the longest.
+    template<typename Callback>
+    void for_each_dirty_entry(Callback callback)
+    {
+        VERIFY(m_lock.is_exclusively_locked_by_current_thread());
+        for (auto& entry : m_dirty_list) {
+            if (callback(entry) == IterationDecision::Break)
+                return;
+        }
+    }
+
+    // Copies out the data of a block that is still dirty, along with the generation of the last write to it.
+    // The block stays dirty until did_write_back_block() is called for it.
+    bool start_writeback(BlockBasedFileSystem::BlockIndex block_index, Bytes destination, u64& dirty_generation)
+    {
+        auto* entry = find(block_index);
+        if (!entry || !entry->is_dirty || entry->is_being_written_back)
+            return false;
+        VERIFY(destination.size() == m_fs->logical_block_size());
+        memcpy(destination.data(), entry->data, destination.size());
+        dirty_generation = entry->dirty_generation;
+        entry->is_being_written_back = true;
+        return true;
+    }
+
+    // Marks a block as clean once its data made it to the disk, unless it was written to again since we copied it out.
+    void did_write_back_block(BlockBasedFileSystem::BlockIndex block_index, u64 dirty_generation, bool success)
+    {
+        auto* entry = find(block_index);
+        VERIFY(entry && entry->is_dirty && entry->is_being_written_back);
+        entry->is_being_written_back = false;
+        if (success && entry->dirty_generation == dirty_generation)
+            mark_clean(*entry);
+    }
+
+    size_t flush()
+    {
+        VERIFY(m_lock.is_exclusively_locked_by_current_thread());
+        size_t count = 0;
+        for (auto it = m_dirty_list.begin(); it != m_dirty_list.end();) {
+            auto& entry = *it;
+            ++it;
+            // NOTE: Writing a block that is being written back could let the older data in flight land after ours.
+            //       It stays dirty instead, so writeback will take care of it.
+            if (entry.is_being_written_back)
+                continue;
+            auto base_offset = entry.block_index.value() * m_fs->logical_block_size();
+            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+            [[maybe_unused]] auto rc = m_fs->file_description().write(base_offset, entry_data_buffer, m_fs->logical_block_size());
+            mark_clean(entry);
+            ++count;
+        }
+        return count;
+    }
+
+    void flush_entry_if_dirty(CacheEntry& entry)
+    {
+        if (!entry.is_dirty)
+            return;
+        // NOTE: Uncached I/O doesn't happen during writeback, see BlockBasedFileSystem::m_writeback_lock.
+        VERIFY(!entry.is_being_written_back);
+        auto base_offset = entry.block_index.value() * m_fs->logical_block_size();
+        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
+        [[maybe_unused]] auto rc = m_fs->file_description().write(base_offset, entry_data_buffer, m_fs->logical_block_size());
+        mark_clean(entry);
+    }
+
+    size_t capacity() const { return m_capacity; }
+
+    void add_statistics_to(BlockBasedFileSystem::DiskCacheStatistics& statistics) const
+    {
+        statistics.hits += m_statistics.hits;
+        statistics.misses += m_statistics.misses;
+        statistics.evictions += m_statistics.evictions;
+        statistics.ghost_hits += m_statistics.ghost_hits;
+        statistics.prefetched += m_statistics.prefetched;
+        statistics.capacity += m_capacity;
+        statistics.probationary_blocks += m_probationary_count;
+        statistics.protected_blocks += m_protected_count;
+        statistics.dirty_blocks += m_dirty_count;
+    }
+
+private:
     void mark_clean(CacheEntry& entry)
     {
-        m_clean_list.prepend(entry);
+        VERIFY(entry.is_dirty);
+        m_dirty_list.remove(entry);
+        --m_dirty_count;
+        entry.is_dirty = false;
+        add_to_queue(entry);
     }
 
-    CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
+    ErrorOr<void> grow()
     {
-        auto it = m_hash.find(block_index);
-        if (it == m_hash.end())
-            return nullptr;
-        auto& entry = const_cast<CacheEntry&>(*it->value);
-        VERIFY(entry.block_index == block_index);
-        if (!entry_is_dirty(entry) && (m_clean_list.first() != &entry)) {
-            // Cache hit! Promote the entry to the front of the list.
-            m_clean_list.prepend(entry);
+        if (m_entry_count == m_capacity)
+            return ENOMEM;
+
+        auto count = min(GrowthEntryCount, m_capacity - m_entry_count);
+        auto entries = TRY(FixedArray<CacheEntry>::create(count));
+        auto data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, count * m_fs->logical_block_size()));
+        TRY(m_chunks.try_append({ move(entries), move(data) }));
+
+        auto& chunk = m_chunks.last();
+        for (size_t i = 0; i < count; ++i) {
+            chunk.entries[i].data = chunk.data->data() + i * m_fs->logical_block_size();
+            m_free_list.append(chunk.entries[i]);
         }
-        return &entry;
+        m_entry_count += count;
+        return {};
     }
 
-    ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index) const
+    ErrorOr<CacheEntry*> take_entry_for_reuse()
     {
-        if (auto* entry = get(block_index))
+        if (auto* entry = m_free_list.take_first())
             return entry;
 
-        if (m_clean_list.is_empty()) {
-            // Not a single clean entry! Flush writes and try again.
-            // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
-            //       not some FileBackedFileSystem subclass flush!
-            m_fs->flush_writes_impl();
-            return ensure(block_index);
+        // The cache only takes up memory once it's actually used, so grow it before evicting anything.
+        // NOTE: If we're out of memory, we can still make do with the entries we already have.
+        if (!grow().is_error())
+            return m_free_list.take_first();
+
+        if (m_probationary_list.is_empty() && m_protected_list.is_empty()) {
+            // Not a single clean entry! Write back this shard and try again.
+            if (flush() == 0)
+                return ENOMEM;
+        }
+
+        CacheEntry* victim = nullptr;
+        if (!m_probationary_list.is_empty() && (m_probationary_count > m_probationary_target || m_protected_list.is_empty()))
+            victim = m_probationary_list.last();
+        else
+            victim = m_protected_list.last();
+        VERIFY(victim);
+
+        if (victim->queue == CacheQueue::Probationary)
+            remember_ghost(victim->block_index);
+        remove_from_queue(*victim);
+        m_hash.remove(victim->block_index);
+        victim->queue = CacheQueue::Free;
+        ++m_statistics.evictions;
+        return victim;
+    }
+
+    void add_to_queue(CacheEntry& entry)
+    {
+        if (entry.queue == CacheQueue::Protected) {
+            m_protected_list.prepend(entry);
+            ++m_protected_count;
+        } else {
+            VERIFY(entry.queue == CacheQueue::Probationary);
+            m_probationary_list.prepend(entry);
+            ++m_probationary_count;
+        }
+    }
+
+    void remove_from_queue(CacheEntry& entry)
+    {
+        if (entry.queue == CacheQueue::Protected) {
+            m_protected_list.remove(entry);
+            --m_protected_count;
+        } else {
+            VERIFY(entry.queue == CacheQueue::Probationary);
+            m_probationary_list.remove(entry);
+            --m_probationary_count;
+        }
+    }
+
+    void remember_ghost(BlockBasedFileSystem::BlockIndex block_index)
+    {
+        // The ghost queue is a ring of block indices, the oldest of which gets overwritten.
+        // NOTE: A block may have left the ghost queue and come back since the slot was written,
+        //       in which case the map points at its newer slot and must be left alone.
+        if (m_ghost_count == m_ghost_ring.size()) {
+            auto oldest = m_ghost_ring[m_ghost_head];
+            if (auto it = m_ghosts.find(oldest); it != m_ghosts.end() && it->value == m_ghost_head)
+                m_ghosts.remove(it);
+        } else {
+            ++m_ghost_count;
         }
+        m_ghost_ring[m_ghost_head] = block_index;
+        // NOTE: Failing to remember a ghost only costs us a promotion later on.
+        (void)m_ghosts.try_set(block_index, m_ghost_head);
+        m_ghost_head = (m_ghost_head + 1) % m_ghost_ring.size();
+    }
+
+    bool forget_ghost(BlockBasedFileSystem::BlockIndex block_index)
+    {
+        return m_ghosts.remove(block_index);
+    }
+
+    // Blocks are allocated in chunks of this many at a time as the shard fills up.
+    static constexpr size_t GrowthEntryCount = 64;
+
+    struct Chunk {
+        FixedArray<CacheEntry> entries;
+        NonnullOwnPtr<KBuffer> data;
+    };
+
+    mutable Mutex m_lock { "DiskCacheShard"sv };
+
+    BlockBasedFileSystem* m_fs { nullptr };
+    size_t m_capacity { 0 };
+    size_t m_entry_count { 0 };
+    Vector<Chunk> m_chunks;
+    size_t m_probationary_target { 0 };
+
+    EntryList m_free_list;
+    EntryList m_probationary_list;
+    EntryList m_protected_list;
+    EntryList m_dirty_list;
+    size_t m_probationary_count { 0 };
+    size_t m_protected_count { 0 };
+    size_t m_dirty_count { 0 };
+    HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+
+    FixedArray<BlockBasedFileSystem::BlockIndex> m_ghost_ring;
+    size_t m_ghost_head { 0 };
+    size_t m_ghost_count { 0 };
+    HashMap<BlockBasedFileSystem::BlockIndex, size_t> m_ghosts;
+
+    struct {
+        u64 hits { 0 };
+        u64 misses { 0 };
+        u64 evictions { 0 };
+        u64 ghost_hits { 0 };
+        u64 prefetched { 0 };
+    } m_statistics;
+    u64 m_write_generation { 0 };
+};
+
+class DiskCache {
+public:
+    static constexpr size_t ShardCount = 16;
 
-        VERIFY(m_clean_list.last());
-        auto& new_entry = *m_clean_list.last();
-        m_clean_list.prepend(new_entry);
+    // The cache may grow with physical memory, but never gets smaller than the 10000 blocks we used to have.
+    // NOTE: This is only an upper bound, the shards allocate their blocks as they need them.
+    static constexpr size_t MinimumEntryCount = 10000;
+    static constexpr size_t PhysicalMemoryFraction = 32;
+    static constexpr size_t MaximumSize = 256 * MiB;
 
-        m_hash.remove(new_entry.block_index);
-        TRY(m_hash.try_set(block_index, &new_entry));
+    static size_t entry_count_for_block_size(size_t block_size)
+    {
+        auto physical_memory_size = MM.get_system_memory_info().physical_pages * PAGE_SIZE;
+        auto maximum_entry_count = max(MaximumSize / block_size, MinimumEntryCount);
+        auto entry_count = clamp<size_t>(physical_memory_size / PhysicalMemoryFraction / block_size, MinimumEntryCount, maximum_entry_count);
+        return round_up_to_power_of_two(entry_count, ShardCount);
+    }
 
-        new_entry.block_index = block_index;
-        new_entry.has_data = false;
+    static ErrorOr<NonnullOwnPtr<DiskCache>> try_create(BlockBasedFileSystem& fs)
+    {
+        auto entry_count = entry_count_for_block_size(fs.logical_block_size());
+        auto cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(fs)));
 
-        return &new_entry;
+        for (auto& shard : cache->m_shards)
+            TRY(shard.initialize(fs, entry_count / ShardCount));
+        return cache;
     }
 
-    CacheEntry const* entries() const { return (CacheEntry const*)m_entries->data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
+    ~DiskCache() = default;
+
+    DiskCacheShard& shard_for(BlockBasedFileSystem::BlockIndex block_index)
+    {
+        return m_shards[u64_hash(block_index.value()) % ShardCount];
+    }
 
     template<typename Callback>
-    void for_each_dirty_entry(Callback callback)
+    void for_each_shard(Callback callback)
     {
-        for (auto& entry : m_dirty_list)
-            callback(entry);
+        for (auto& shard : m_shards)
+            callback(shard);
     }
 
 private:
+    explicit DiskCache(BlockBasedFileSystem& fs)
+        : m_fs(fs)
+    {
+    }
+
     mutable NonnullRefPtr<BlockBasedFileSystem> m_fs;
-    NonnullOwnPtr<KBuffer> m_cached_block_data;
-
-    // NOTE: m_entries must be declared before m_dirty_list and m_clean_list because their entries are allocated from it.
-    // We need to ensure that the destructors of m_dirty_list and m_clean_list are called before m_entries is destroyed.
-    NonnullOwnPtr<KBuffer> m_entries;
-    mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
-    mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
-    mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
+    Array<DiskCacheShard, ShardCount> m_shards;
 };
 
 BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
@@ -136,9 +510,7 @@ ErrorOr<void> BlockBasedFileSystem::initialize_while_locked()
     VERIFY(m_lock.is_locked());
     VERIFY(!is_initialized_while_locked());
     VERIFY(logical_block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache blocks"sv, DiskCache::EntryCount * logical_block_size()));
-    auto entries_data = TRY(KBuffer::try_create_with_size("BlockBasedFS: Cache entries"sv, DiskCache::EntryCount * sizeof(CacheEntry)));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
+    auto disk_cache = TRY(DiskCache::try_create(*this));
 
     m_cache.with_exclusive([&](auto& cache) {
         cache = move(disk_cache);
@@ -159,23 +531,32 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
 
     TRY(data.read(buffered_data.bytes()));
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    MutexLocker writeback_locker;
+    if (!allow_cache)
+        writeback_locker.attach_and_lock(m_writeback_lock, Mutex::Mode::Shared);
+
+    return m_cache.with_shared([&](auto& cache) -> ErrorOr<void> {
+        auto& shard = cache->shard_for(index);
+        MutexLocker locker(shard.lock());
+
         if (!allow_cache) {
-            flush_specific_block_if_needed(index);
+            if (auto* entry = shard.find(index))
+                shard.flush_entry_if_dirty(*entry);
+            shard.did_write_block();
             u64 base_offset = index.value() * logical_block_size() + offset;
             auto nwritten = TRY(file_description().write(base_offset, data, count));
             VERIFY(nwritten == count);
             return {};
         }
 
-        auto entry = TRY(cache->ensure(index));
+        auto entry = TRY(shard.ensure(index));
         if (count < logical_block_size()) {
             // Fill the cache first.
-            TRY(read_block(index, nullptr, logical_block_size()));
+            TRY(shard.fill(*entry));
         }
         memcpy(entry->data + offset, buffered_data.data(), count);
 
-        cache->mark_dirty(*entry);
+        shard.mark_dirty(*entry);
         entry->has_data = true;
         return {};
     });
@@ -233,23 +614,25 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
     VERIFY(offset + count <= logical_block_size());
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_block {}", index);
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    MutexLocker writeback_locker;
+    if (!allow_cache)
+        writeback_locker.attach_and_lock(m_writeback_lock, Mutex::Mode::Shared);
+
+    return m_cache.with_shared([&](auto& cache) -> ErrorOr<void> {
+        auto& shard = cache->shard_for(index);
+        MutexLocker locker(shard.lock());
+
         if (!allow_cache) {
-            const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(index);
+            if (auto* entry = shard.find(index))
+                shard.flush_entry_if_dirty(*entry);
             u64 base_offset = index.value() * logical_block_size() + offset;
             auto nread = TRY(file_description().read(*buffer, base_offset, count));
             VERIFY(nread == count);
             return {};
         }
 
-        auto* entry = TRY(cache->ensure(index));
-        if (!entry->has_data) {
-            auto base_offset = index.value() * logical_block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-            auto nread = TRY(file_description().read(entry_data_buffer, base_offset, logical_block_size()));
-            VERIFY(nread == logical_block_size());
-            entry->has_data = true;
-        }
+        auto* entry = TRY(shard.ensure(index));
+        TRY(shard.fill(*entry));
         if (buffer)
             TRY(buffer->write(entry->data + offset, count));
         return {};
@@ -272,43 +655,231 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
     return {};
 }
 
-void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
+void BlockBasedFileSystem::flush_writes_impl()
 {
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
-            return;
-        auto* entry = cache->get(index);
-        if (!entry)
-            return;
-        if (!cache->entry_is_dirty(*entry))
-            return;
-        size_t base_offset = entry->block_index.value() * logical_block_size();
-        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
-        (void)file_description().write(base_offset, entry_data_buffer, logical_block_size());
+    auto count = write_back_dirty_blocks(WritebackMode::All);
+    if (count > 0)
+        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
+}
+
+ErrorOr<void> BlockBasedFileSystem::flush_writes()
+{
+    flush_writes_impl();
+    return {};
+}
+
+ErrorOr<void> BlockBasedFileSystem::flush_expired_writes()
+{
+    (void)write_back_dirty_blocks(WritebackMode::Expired);
+    return {};
+}
+
+size_t BlockBasedFileSystem::write_back_dirty_blocks(WritebackMode mode)
+{
+    MutexLocker writeback_locker(m_writeback_lock);
+    return m_cache.with_shared([&](auto& cache) -> size_t {
+        if (!cache)
+            return 0;
+
+        size_t capacity = 0;
+        size_t dirty_count = 0;
+        cache->for_each_shard([&](DiskCacheShard& shard) {
+            MutexLocker locker(shard.lock());
+            capacity += shard.capacity();
+            dirty_count += shard.dirty_count();
+        });
+        if (dirty_count == 0)
+            return 0;
+
+        // In the background, we write back blocks that have been dirty for too long, and if too much of the cache
+        // is dirty, as many of the oldest other ones as it takes to get back under the limit.
+        auto background_threshold = capacity * DirtyBackgroundRatio / 100;
+        auto excess_count = dirty_count > background_threshold ? dirty_count - background_threshold : 0;
+        auto now_ms = static_cast<u64>(TimeManagement::the().monotonic_time().milliseconds());
+
+        Vector<BlockIndex> blocks;
+        ErrorOr<void> result {};
+        cache->for_each_shard([&](DiskCacheShard& shard) {
+            MutexLocker locker(shard.lock());
+            if (result.is_error() || !shard.is_dirty())
+                return;
+            auto minimum_count = mode == WritebackMode::All ? NumericLimits<size_t>::max() : ceil_div(excess_count * shard.dirty_count(), dirty_count);
+            size_t count = 0;
+            shard.for_each_dirty_entry([&](CacheEntry& entry) {
+                if (count >= minimum_count && now_ms < entry.dirtied_at_ms + DirtyExpiryAgeMilliseconds)
+                    return IterationDecision::Break;
+                result = blocks.try_append(entry.block_index);
+                if (result.is_error())
+                    return IterationDecision::Break;
+                ++count;
+                return IterationDecision::Continue;
+            });
+        });
+
+        if (!result.is_error()) {
+            auto count_or_error = write_back_blocks(*cache, blocks);
+            if (!count_or_error.is_error())
+                return count_or_error.release_value();
+        }
+
+        // We couldn't get the memory to write back blocks in large batches.
+        // If we were asked to write everything, do it the slow way, otherwise try again later.
+        if (mode == WritebackMode::Expired)
+            return 0;
+        size_t count = 0;
+        cache->for_each_shard([&](DiskCacheShard& shard) {
+            MutexLocker locker(shard.lock());
+            count += shard.flush();
+        });
+        m_blocks_written_back += count;
+        m_writeback_requests += count;
+        return count;
     });
 }
 
-void BlockBasedFileSystem::flush_writes_impl()
+ErrorOr<size_t> BlockBasedFileSystem::write_back_blocks(DiskCache& cache, Vector<BlockIndex>& blocks)
 {
+    VERIFY(m_writeback_lock.is_exclusively_locked_by_current_thread());
+    if (blocks.is_empty())
+        return 0;
+
+    // Writing back in block order lets us merge adjacent blocks into a single request, no matter when they became dirty.
+    quick_sort(blocks);
+
+    auto max_run_length = min(blocks.size(), max<size_t>(MaximumWritebackRunSize / logical_block_size(), 1));
+    auto buffer = TRY(KBuffer::try_create_with_size("BlockBasedFS: Writeback"sv, max_run_length * logical_block_size()));
+    Vector<u64> dirty_generations;
+    TRY(dirty_generations.try_resize(max_run_length));
+
     size_t count = 0;
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
+    for (size_t i = 0; i < blocks.size();) {
+        auto first_block = blocks[i];
+        size_t run_length = 0;
+        while (i < blocks.size() && run_length < max_run_length && blocks[i].value() == first_block.value() + run_length) {
+            auto& shard = cache.shard_for(blocks[i]);
+            MutexLocker locker(shard.lock());
+            auto destination = buffer->bytes().slice(run_length * logical_block_size(), logical_block_size());
+            bool is_still_dirty = shard.start_writeback(blocks[i], destination, dirty_generations[run_length]);
+            ++i;
+            // NOTE: If someone wrote this block back in the meantime, the run ends here.
+            if (!is_still_dirty)
+                break;
+            ++run_length;
+        }
+        if (run_length == 0)
+            continue;
+
+        auto base_offset = first_block.value() * logical_block_size();
+        auto run_size = run_length * logical_block_size();
+        auto kernel_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer->data());
+        auto nwritten_or_error = file_description().write(base_offset, kernel_buffer, run_size);
+        bool success = !nwritten_or_error.is_error() && nwritten_or_error.value() == run_size;
+        if (!success)
+            dbgln("{}: Failed to write back {} blocks at {}", class_name(), run_length, first_block);
+        ++m_writeback_requests;
+
+        for (size_t j = 0; j < run_length; ++j) {
+            auto index = BlockIndex { first_block.value() + j };
+            auto& shard = cache.shard_for(index);
+            MutexLocker locker(shard.lock());
+            shard.did_write_back_block(index, dirty_generations[j], success);
+        }
+        if (success)
+            count += run_length;
+    }
+    m_blocks_written_back += count;
+    return count;
+}
+
+void BlockBasedFileSystem::queue_readahead(Vector<BlockIndex> blocks) const
+{
+    if (blocks.is_empty())
+        return;
+
+    // If the device can't keep up with the readahead we already asked for, asking for more won't help.
+    if (m_pending_readaheads.fetch_add(1) >= MaximumPendingReadaheads) {
+        m_pending_readaheads.fetch_sub(1);
+        return;
+    }
+
+    auto fs = NonnullRefPtr { const_cast<BlockBasedFileSystem&>(*this) };
+    auto result = g_readahead_work->try_queue([fs, blocks = move(blocks)] {
+        fs->read_ahead(blocks);
+        fs->m_pending_readaheads.fetch_sub(1);
+    });
+    if (result.is_error())
+        m_pending_readaheads.fetch_sub(1);
+}
+
+void BlockBasedFileSystem::read_ahead(ReadonlySpan<BlockIndex> blocks)
+{
+    m_cache.with_shared([&](auto& cache) {
+        if (!cache)
             return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * logical_block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, logical_block_size());
-            ++count;
-        });
-        cache->mark_all_clean();
-        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
+
+        // Only read what's missing, and remember what each shard looked like when we checked.
+        Vector<BlockIndex> missing_blocks;
+        Vector<u64> write_generations;
+        for (auto index : blocks) {
+            auto& shard = cache->shard_for(index);
+            MutexLocker locker(shard.lock());
+            if (shard.has_data_for(index))
+                continue;
+            if (missing_blocks.try_append(index).is_error() || write_generations.try_append(shard.write_generation()).is_error())
+                return;
+        }
+        if (missing_blocks.is_empty())
+            return;
+
+        auto max_run_length = min(missing_blocks.size(), max<size_t>(ReadaheadWindow::MaximumSize / logical_block_size(), 1));
+        auto buffer_or_error = KBuffer::try_create_with_size("BlockBasedFS: Readahead"sv, max_run_length * logical_block_size());
+        if (buffer_or_error.is_error())
+            return;
+        auto buffer = buffer_or_error.release_value();
+
+        // Adjacent blocks are read from the device with a single request.
+        for (size_t i = 0; i < missing_blocks.size();) {
+            size_t run_length = 1;
+            while (i + run_length < missing_blocks.size() && run_length < max_run_length
+                && missing_blocks[i + run_length].value() == missing_blocks[i].value() + run_length)
+                ++run_length;
+
+            auto base_offset = missing_blocks[i].value() * logical_block_size();
+            auto run_size = run_length * logical_block_size();
+            auto kernel_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer->data());
+            auto nread_or_error = file_description().read(kernel_buffer, base_offset, run_size);
+            if (nread_or_error.is_error() || nread_or_error.value() != run_size) {
+                dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem: Readahead of {} blocks at {} failed", run_length, missing_blocks[i]);
+                return;
+            }
+
+            for (size_t j = 0; j < run_length; ++j) {
+                auto index = missing_blocks[i + j];
+                auto& shard = cache->shard_for(index);
+                MutexLocker locker(shard.lock());
+                (void)shard.insert_prefetched(index, buffer->bytes().slice(j * logical_block_size(), logical_block_size()), write_generations[i + j]);
+            }
+            i += run_length;
+        }
     });
 }
 
-ErrorOr<void> BlockBasedFileSystem::flush_writes()
+BlockBasedFileSystem::DiskCacheStatistics BlockBasedFileSystem::disk_cache_statistics() const
 {
-    flush_writes_impl();
-    return {};
+    DiskCacheStatistics statistics;
+    m_cache.with_shared([&](auto& cache) {
+        if (!cache)
+            return;
+        cache->for_each_shard([&](DiskCacheShard& shard) {
+            MutexLocker locker(shard.lock());
+            shard.add_statistics_to(statistics);
+        });
+    });
+    statistics.written_back = m_blocks_written_back.load();
+    statistics.writeback_requests = m_writeback_requests.load();
+    statistics.dirty_background_blocks = statistics.capacity * DirtyBackgroundRatio / 100;
+    statistics.dirty_expiry_age_ms = DirtyExpiryAgeMilliseconds;
+    return statistics;
 }
 
 }
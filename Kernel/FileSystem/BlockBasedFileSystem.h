@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/Locking/MutexProtected.h>
 
@@ -20,8 +21,28 @@ public:
     u64 device_block_size() const { return m_device_block_size; }
 
     virtual ErrorOr<void> flush_writes() override;
+    virtual ErrorOr<void> flush_expired_writes() override;
     void flush_writes_impl();
 
+    virtual bool is_block_based() const override { return true; }
+
+    struct DiskCacheStatistics {
+        u64 hits { 0 };
+        u64 misses { 0 };
+        u64 evictions { 0 };
+        u64 ghost_hits { 0 };
+        u64 prefetched { 0 };
+        size_t capacity { 0 };
+        size_t probationary_blocks { 0 };
+        size_t protected_blocks { 0 };
+        size_t dirty_blocks { 0 };
+        u64 written_back { 0 };
+        u64 writeback_requests { 0 };
+        size_t dirty_background_blocks { 0 };
+        u64 dirty_expiry_age_ms { 0 };
+    };
+    DiskCacheStatistics disk_cache_statistics() const;
+
 protected:
     explicit BlockBasedFileSystem(OpenFileDescription&);
 
@@ -39,13 +60,42 @@ protected:
     ErrorOr<void> write_block(BlockIndex, UserOrKernelBuffer const&, size_t count, u64 offset = 0, bool allow_cache = true);
     ErrorOr<void> write_blocks(BlockIndex, unsigned count, UserOrKernelBuffer const&, bool allow_cache = true);
 
+    // Reads the given blocks into the cache in the background, so they are there by the time someone asks for them.
+    void queue_readahead(Vector<BlockIndex>) const;
+
     u64 m_device_block_size { 512 };
 
     void remove_disk_cache_before_last_unmount();
 
 private:
-    void flush_specific_block_if_needed(BlockIndex index);
+    static constexpr u32 MaximumPendingReadaheads = 8;
+
+    // Dirty blocks are written back in the background once they have been dirty for this long,
+    // or once this percentage of the cache is dirty, whichever comes first.
+    static constexpr u64 DirtyExpiryAgeMilliseconds = 5000;
+    static constexpr size_t DirtyBackgroundRatio = 10;
+
+    // Adjacent dirty blocks are written back together, in requests of up to this size.
+    static constexpr size_t MaximumWritebackRunSize = 1 * MiB;
+
+    enum class WritebackMode {
+        All,
+        Expired,
+    };
+
+    void read_ahead(ReadonlySpan<BlockIndex>);
+    size_t write_back_dirty_blocks(WritebackMode);
+    ErrorOr<size_t> write_back_blocks(DiskCache&, Vector<BlockIndex>&);
+
+    mutable Atomic<u32> m_pending_readaheads { 0 };
+
+    // Held exclusively while writing back, and shared by uncached I/O, which must not see the disk
+    // before the blocks in flight have landed.
+    mutable Mutex m_writeback_lock { "BlockBasedFileSystem Writeback"sv };
+    Atomic<u64> m_blocks_written_back { 0 };
+    Atomic<u64> m_writeback_requests { 0 };
 
+    // NOTE: This only protects the cache from going away, every shard of the cache has its own lock.
     mutable MutexProtected<OwnPtr<DiskCache>> m_cache;
 };
 
@@ -0,0 +1,279 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+// Guards the link between EPoll entries and the descriptions they watch.
+// Either side can go away first, so both sides detach under this lock.
+// Lock order: attachment lock -> file blocker set lock -> EPoll ready lock.
+static Spinlock<LockRank::None> s_attachment_lock {};
+
+static BlockFlags block_flags_for_events(u32 events)
+{
+    BlockFlags block_flags = BlockFlags::WriteError | BlockFlags::WriteHangUp; // always want EPOLLERR, EPOLLHUP
+    if (events & EPOLLIN)
+        block_flags |= BlockFlags::Read;
+    if (events & EPOLLOUT)
+        block_flags |= BlockFlags::Write;
+    if (events & EPOLLPRI)
+        block_flags |= BlockFlags::ReadPriority;
+    if (events & EPOLLWRBAND)
+        block_flags |= BlockFlags::WritePriority;
+    if (events & EPOLLRDHUP)
+        block_flags |= BlockFlags::ReadHangUp;
+    return block_flags;
+}
+
+static u32 events_for_unblock_flags(BlockFlags unblock_flags)
+{
+    u32 events = 0;
+    if (has_flag(unblock_flags, BlockFlags::WriteHangUp))
+        events |= EPOLLHUP;
+    if (has_flag(unblock_flags, BlockFlags::WriteError))
+        events |= EPOLLERR;
+    if (has_flag(unblock_flags, BlockFlags::Read))
+        events |= EPOLLIN;
+    if (has_flag(unblock_flags, BlockFlags::ReadPriority))
+        events |= EPOLLPRI;
+    if (!has_flag(unblock_flags, BlockFlags::WriteHangUp) && has_flag(unblock_flags, BlockFlags::Write))
+        events |= EPOLLOUT;
+    if (has_flag(unblock_flags, BlockFlags::WritePriority))
+        events |= EPOLLWRBAND;
+    if (has_flag(unblock_flags, BlockFlags::ReadHangUp))
+        events |= EPOLLRDHUP;
+    return events;
+}
+
+u32 EPollEntry::ready_events() const
+{
+    // NOTE: A disabled EPOLLONESHOT entry has no events left.
+    auto events = m_events.load();
+    if (events == 0)
+        return 0;
+    VERIFY(m_description);
+    return events_for_unblock_flags(m_description->should_unblock(block_flags_for_events(events)));
+}
+
+void EPollEntry::block_conditions_changed()
+{
+    // NOTE: The description can't go away while we are here, as it has to remove us
+    //       from its blocker set first, and we are called with that blocker set locked.
+    if (ready_events() != 0)
+        m_epoll.enqueue_ready_entry(*this);
+}
+
+ErrorOr<NonnullRefPtr<EPoll>> EPoll::try_create()
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) EPoll);
+}
+
+EPoll::~EPoll()
+{
+    SpinlockLocker locker(s_attachment_lock);
+    for (auto& it : m_entries)
+        detach_entry(*it.value);
+}
+
+bool EPoll::can_read(OpenFileDescription const&, u64) const
+{
+    SpinlockLocker locker(m_ready_lock);
+    return !m_ready_entries.is_empty();
+}
+
+ErrorOr<NonnullOwnPtr<KString>> EPoll::pseudo_path(OpenFileDescription const&) const
+{
+    MutexLocker locker(m_lock, Mutex::Mode::Shared);
+    return KString::formatted("EPoll:({})", m_entries.size());
+}
+
+ErrorOr<void> EPoll::add(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    // FIXME: Linux allows nesting epoll instances, as long as they don't form a loop.
+    if (description.is_epoll())
+        return EINVAL;
+
+    MutexLocker locker(m_lock);
+    if (auto it = m_entries.find(fd); it != m_entries.end()) {
+        // NOTE: If the description we were watching has been closed, the fd may have been reused.
+        //       In that case, the old entry is stale and gets replaced.
+        {
+            SpinlockLocker attachment_locker(s_attachment_lock);
+            if (it->value->m_description == &description)
+                return EEXIST;
+            detach_entry(*it->value);
+        }
+        m_entries.remove(it);
+    }
+
+    auto entry = TRY(adopt_nonnull_own_or_enomem(new (nothrow) EPollEntry(*this, fd, event)));
+    auto& entry_ref = *entry;
+    TRY(m_entries.try_set(fd, move(entry)));
+
+    SpinlockLocker attachment_locker(s_attachment_lock);
+    entry_ref.m_description = &description;
+    description.epoll_entries({}).append(entry_ref);
+    description.blocker_set().add_listener(entry_ref);
+    return {};
+}
+
+ErrorOr<void> EPoll::modify(int fd, OpenFileDescription& description, epoll_event const& event)
+{
+    MutexLocker locker(m_lock);
+    auto it = m_entries.find(fd);
+    if (it == m_entries.end())
+        return ENOENT;
+
+    auto& entry = *it->value;
+    SpinlockLocker attachment_locker(s_attachment_lock);
+    if (entry.m_description != &description)
+        return ENOENT;
+
+    entry.m_events = event.events;
+    entry.m_data = event.data.u64;
+
+    // Re-arm the entry with its new interest set.
+    entry.block_conditions_changed();
+    return {};
+}
+
+ErrorOr<void> EPoll::remove(int fd, OpenFileDescription& description)
+{
+    MutexLocker locker(m_lock);
+    auto it = m_entries.find(fd);
+    if (it == m_entries.end())
+        return ENOENT;
+
+    bool was_watching_description = false;
+    {
+        SpinlockLocker attachment_locker(s_attachment_lock);
+        was_watching_description = it->value->m_description == &description;
+        detach_entry(*it->value);
+    }
+    m_entries.remove(it);
+
+    if (!was_watching_description)
+        return ENOENT;
+    return {};
+}
+
+void EPoll::detach_description(Badge<OpenFileDescription>, OpenFileDescription& description)
+{
+    SpinlockLocker locker(s_attachment_lock);
+    auto& entries = description.epoll_entries({});
+    while (auto* entry = entries.first())
+        entry->m_epoll.detach_entry(*entry);
+}
+
+void EPoll::detach_entry(EPollEntry& entry)
+{
+    VERIFY(s_attachment_lock.is_locked());
+
+    if (auto* description = exchange(entry.m_description, nullptr)) {
+        description->blocker_set().remove_listener(entry);
+        description->epoll_entries({}).remove(entry);
+    }
+
+    SpinlockLocker locker(m_ready_lock);
+    if (entry.m_on_ready_list) {
+        m_ready_entries.remove(entry);
+        entry.m_on_ready_list = false;
+    }
+}
+
+void EPoll::enqueue_ready_entry(EPollEntry& entry)
+{
+    {
+        SpinlockLocker locker(m_ready_lock);
+        if (entry.m_on_ready_list)
+            return;
+        entry.m_on_ready_list = true;
+        m_ready_entries.append(entry);
+    }
+
+    m_wait_queue.wake_all();
+    evaluate_block_conditions();
+}
+
+size_t EPoll::collect_ready_events(Span<epoll_event> events)
+{
+    // NOTE: Holding the lock shared keeps epoll_ctl() from freeing entries under us,
+    //       and holding the attachment lock keeps descriptions from going away.
+    MutexLocker locker(m_lock, Mutex::Mode::Shared);
+    SpinlockLocker attachment_locker(s_attachment_lock);
+
+    size_t count = 0;
+    EPollEntry::ReadyList still_ready_entries;
+
+    while (count < events.size()) {
+        EPollEntry* entry = nullptr;
+        {
+            SpinlockLocker ready_locker(m_ready_lock);
+            entry = m_ready_entries.take_first();
+            if (!entry)
+                break;
+            entry->m_on_ready_list = false;
+        }
+
+        if (!entry->m_description)
+            continue;
+
+        // The entry was queued when it became ready, but someone may have consumed
+        // the data by now. Only report what's still true.
+        auto ready_events = entry->ready_events();
+        if (ready_events == 0)
+            continue;
+
+        auto& event = events[count++];
+        event.events = ready_events;
+        event.data.u64 = entry->m_data;
+
+        auto interest = entry->m_events.load();
+        if (interest & EPOLLONESHOT) {
+            entry->m_events = 0;
+            continue;
+        }
+
+        // Level-triggered entries stay on the ready list until they stop being ready.
+        // We find out about that on the next call.
+        if (!(interest & EPOLLET)) {
+            SpinlockLocker ready_locker(m_ready_lock);
+            if (!entry->m_on_ready_list) {
+                entry->m_on_ready_list = true;
+                still_ready_entries.append(*entry);
+            }
+        }
+    }
+
+    SpinlockLocker ready_locker(m_ready_lock);
+    while (auto* entry = still_ready_entries.take_first())
+        m_ready_entries.append(*entry);
+
+    return count;
+}
+
+ErrorOr<size_t> EPoll::wait(Span<epoll_event> events, Thread::BlockTimeout const& timeout)
+{
+    VERIFY(!events.is_empty());
+
+    for (;;) {
+        if (auto count = collect_ready_events(events); count > 0)
+            return count;
+
+        if (!timeout.is_infinite() && TimeManagement::the().current_time(timeout.clock_id()) >= timeout.absolute_time())
+            return 0;
+
+        if (m_wait_queue.wait_on(timeout, "EPoll"sv).was_interrupted())
+            return EINTR;
+    }
+}
+
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Badge.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <Kernel/API/POSIX/sys/epoll.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/Spinlock.h>
+#include <Kernel/Tasks/WaitQueue.h>
+
+namespace Kernel {
+
+class EPoll;
+
+// An interest in one open file description, registered with an EPoll.
+// The entry listens to the blocker set of the file and queues itself on
+// the ready list of its EPoll whenever the description becomes ready.
+class EPollEntry final : public FileBlockerSet::Listener {
+    AK_MAKE_NONCOPYABLE(EPollEntry);
+    AK_MAKE_NONMOVABLE(EPollEntry);
+
+public:
+    virtual ~EPollEntry() override = default;
+
+private:
+    friend class EPoll;
+
+    EPollEntry(EPoll& epoll, int fd, epoll_event const& event)
+        : m_epoll(epoll)
+        , m_fd(fd)
+        , m_events(event.events)
+        , m_data(event.data.u64)
+    {
+    }
+
+    virtual void block_conditions_changed() override;
+
+    u32 ready_events() const;
+
+    EPoll& m_epoll;
+
+    // NOTE: This is cleared when the description goes away before the entry does.
+    //       Guarded by the global EPoll attachment lock.
+    OpenFileDescription* m_description { nullptr };
+
+    int const m_fd { -1 };
+    Atomic<u32> m_events { 0 };
+    u64 m_data { 0 };
+
+    // Guarded by the ready lock of the EPoll.
+    bool m_on_ready_list { false };
+
+    IntrusiveListNode<EPollEntry> m_description_list_node;
+    IntrusiveListNode<EPollEntry> m_ready_list_node;
+
+public:
+    using DescriptionList = IntrusiveList<&EPollEntry::m_description_list_node>;
+    using ReadyList = IntrusiveList<&EPollEntry::m_ready_list_node>;
+};
+
+// EPoll is the File behind an epoll file descriptor. Unlike poll() and select(),
+// the set of watched descriptions lives in the kernel, and readiness is pushed onto
+// a ready list as it changes. This makes epoll_wait() cost proportional to the number
+// of ready descriptions rather than the number of watched ones.
+//
+// NOTE: An EPoll cannot watch another EPoll.
+class EPoll final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<EPoll>> try_create();
+    virtual ~EPoll() override;
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "EPoll"sv; }
+    virtual bool is_epoll() const override { return true; }
+
+    ErrorOr<void> add(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> modify(int fd, OpenFileDescription&, epoll_event const&);
+    ErrorOr<void> remove(int fd, OpenFileDescription&);
+
+    // Blocks until at least one watched description is ready, the timeout expires, or we are interrupted.
+    // Returns the number of events written to the given span.
+    ErrorOr<size_t> wait(Span<epoll_event>, Thread::BlockTimeout const&);
+
+    static void detach_description(Badge<OpenFileDescription>, OpenFileDescription&);
+
+private:
+    friend class EPollEntry;
+
+    EPoll() = default;
+
+    size_t collect_ready_events(Span<epoll_event>);
+    void enqueue_ready_entry(EPollEntry&);
+    void detach_entry(EPollEntry&);
+
+    mutable Mutex m_lock { "EPoll"sv };
+    HashMap<int, NonnullOwnPtr<EPollEntry>> m_entries;
+
+    mutable Spinlock<LockRank::None> m_ready_lock {};
+    EPollEntry::ReadyList m_ready_entries;
+
+    WaitQueue m_wait_queue;
+};
+
+}
@@ -481,9 +481,35 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
         nread += num_bytes_to_copy;
     }
 
+    if (allow_cache && description && Kernel::is_regular_file(m_raw_inode.i_mode))
+        queue_readahead(*description, offset, nread);
+
     return nread;
 }
 
+void Ext2FSInode::queue_readahead(OpenFileDescription& description, off_t offset, size_t nread) const
+{
+    VERIFY(m_inode_lock.is_locked());
+
+    auto range = description.record_read_for_readahead(offset, nread);
+    if (!range.has_value() || range->offset >= size())
+        return;
+
+    auto const block_size = fs().logical_block_size();
+    auto first_block_logical_index = range->offset / block_size;
+    auto end_block_logical_index = ceil_div(min(range->offset + range->size, size()), static_cast<u64>(block_size));
+
+    Vector<BlockBasedFileSystem::BlockIndex> blocks;
+    if (blocks.try_ensure_capacity(end_block_logical_index - first_block_logical_index).is_error())
+        return;
+    for (auto logical_index = first_block_logical_index; logical_index < end_block_logical_index; ++logical_index) {
+        // Holes read as zeroes and need no I/O.
+        if (auto block_index = get_block(logical_index); block_index.value() != 0)
+            blocks.unchecked_append(block_index);
+    }
+    fs().queue_readahead(move(blocks));
+}
+
 ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 {
     VERIFY(m_inode_lock.is_locked());
@@ -59,6 +59,7 @@ private:
     ErrorOr<void> flush_block_list(Ext2FS::BlockList const& old_block_list);
 
     ErrorOr<void> compute_block_list_with_exclusive_locking();
+    void queue_readahead(OpenFileDescription&, off_t offset, size_t nread) const;
     ErrorOr<Ext2FS::BlockList> compute_block_list() const;
     ErrorOr<Ext2FS::BlockList> compute_block_list_impl(Vector<Ext2FS::BlockIndex>* meta_blocks = nullptr) const;
     ErrorOr<Vector<Ext2FS::BlockIndex>> compute_meta_blocks() const;
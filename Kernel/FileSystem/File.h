@@ -8,6 +8,7 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/Error.h>
+#include <AK/IntrusiveList.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
@@ -23,8 +24,38 @@ class File;
 
 class FileBlockerSet final : public Thread::BlockerSet {
 public:
+    // A Listener is told about every change of the block conditions of a file,
+    // without having to be a blocked thread. This is used to implement epoll.
+    class Listener {
+    public:
+        virtual ~Listener() = default;
+
+        // NOTE: This is called with the blocker set lock held.
+        virtual void block_conditions_changed() = 0;
+
+    private:
+        friend class FileBlockerSet;
+        IntrusiveListNode<Listener> m_blocker_set_list_node;
+
+    public:
+        using List = IntrusiveList<&Listener::m_blocker_set_list_node>;
+    };
+
     FileBlockerSet() { }
 
+    void add_listener(Listener& listener)
+    {
+        SpinlockLocker lock(m_lock);
+        m_listeners.append(listener);
+        listener.block_conditions_changed();
+    }
+
+    void remove_listener(Listener& listener)
+    {
+        SpinlockLocker lock(m_lock);
+        m_listeners.remove(listener);
+    }
+
     virtual bool should_add_blocker(Thread::Blocker& b, void* data) override
     {
         VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
@@ -40,7 +71,12 @@ public:
             auto& blocker = static_cast<Thread::FileBlocker&>(b);
             return blocker.unblock_if_conditions_are_met(false, data);
         });
+        for (auto& listener : m_listeners)
+            listener.block_conditions_changed();
     }
+
+private:
+    Listener::List m_listeners;
 };
 
 // File is the base class for anything that can be referenced by a OpenFileDescription.
@@ -114,6 +150,7 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_epoll() const { return false; }
     virtual bool is_mount_file() const { return false; }
     virtual bool is_loop_device() const { return false; }
 
@@ -50,4 +50,10 @@ void FileSystem::sync()
     VirtualFileSystem::sync_filesystems();
 }
 
+void FileSystem::write_back_expired()
+{
+    Inode::sync_all();
+    VirtualFileSystem::write_back_expired_filesystems();
+}
+
 }
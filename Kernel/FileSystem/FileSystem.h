@@ -26,6 +26,7 @@ public:
 
     FileSystemID fsid() const { return m_fsid; }
     static void sync();
+    static void write_back_expired();
 
     virtual ErrorOr<void> initialize() = 0;
     virtual StringView class_name() const = 0;
@@ -56,6 +57,10 @@ public:
 
     virtual ErrorOr<void> flush_writes() { return {}; }
 
+    // Called periodically to write back what has been dirty for long enough.
+    // Filesystems that don't keep track of that just write back everything.
+    virtual ErrorOr<void> flush_expired_writes() { return flush_writes(); }
+
     u64 logical_block_size() const { return m_logical_block_size; }
     size_t fragment_size() const { return m_fragment_size; }
 
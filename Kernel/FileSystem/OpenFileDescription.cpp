@@ -11,6 +11,7 @@
 #include <Kernel/Devices/TTY/MasterPTY.h>
 #include <Kernel/Devices/TTY/TTY.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/EPoll.h>
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/InodeFile.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
@@ -53,6 +54,7 @@ OpenFileDescription::OpenFileDescription(File& file)
 
 OpenFileDescription::~OpenFileDescription()
 {
+    EPoll::detach_description({}, *this);
     m_file->detach(*this);
     // FIXME: Should this error path be observed somehow?
     (void)m_file->close();
@@ -162,6 +164,13 @@ ErrorOr<size_t> OpenFileDescription::write(u64 offset, UserOrKernelBuffer const&
 
 ErrorOr<size_t> OpenFileDescription::read(UserOrKernelBuffer& buffer, size_t count)
 {
+    // NOTE: Threads sharing this description may read and write concurrently, so we have to
+    //       make sure that fetching the offset, doing the I/O and advancing the offset is atomic.
+    //       Non-seekable files may block inside File::read(), so they don't get this treatment.
+    MutexLocker offset_locker;
+    if (m_file->is_seekable())
+        offset_locker.attach_and_lock(m_offset_lock);
+
     auto offset = TRY(m_state.with([&](auto& state) -> ErrorOr<off_t> {
         if (Checked<off_t>::addition_would_overflow(state.current_offset, count))
             return EOVERFLOW;
@@ -176,6 +185,13 @@ ErrorOr<size_t> OpenFileDescription::read(UserOrKernelBuffer& buffer, size_t cou
 
 ErrorOr<size_t> OpenFileDescription::write(UserOrKernelBuffer const& data, size_t size)
 {
+    MutexLocker offset_locker;
+    if (m_file->is_seekable()) {
+        offset_locker.attach_and_lock(m_offset_lock);
+        if (should_append())
+            TRY(seek(0, SEEK_END));
+    }
+
     auto offset = TRY(m_state.with([&](auto& state) -> ErrorOr<off_t> {
         if (Checked<off_t>::addition_would_overflow(state.current_offset, size))
             return EOVERFLOW;
@@ -313,6 +329,25 @@ InodeWatcher* OpenFileDescription::inode_watcher()
     return static_cast<InodeWatcher*>(m_file.ptr());
 }
 
+bool OpenFileDescription::is_epoll() const
+{
+    return m_file->is_epoll();
+}
+
+EPoll const* OpenFileDescription::epoll() const
+{
+    if (!is_epoll())
+        return nullptr;
+    return static_cast<EPoll const*>(m_file.ptr());
+}
+
+EPoll* OpenFileDescription::epoll()
+{
+    if (!is_epoll())
+        return nullptr;
+    return static_cast<EPoll*>(m_file.ptr());
+}
+
 bool OpenFileDescription::is_mount_file() const
 {
     return m_file->is_mount_file();
@@ -10,9 +10,11 @@
 #include <AK/Badge.h>
 #include <AK/RefPtr.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/EPoll.h>
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeMetadata.h>
+#include <Kernel/FileSystem/ReadaheadWindow.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/KBuffer.h>
 #include <Kernel/Memory/VirtualAddress.h>
@@ -80,6 +82,10 @@ public:
     InodeWatcher const* inode_watcher() const;
     InodeWatcher* inode_watcher();
 
+    bool is_epoll() const;
+    EPoll const* epoll() const;
+    EPoll* epoll();
+
     bool is_mount_file() const;
     MountFile const* mount_file() const;
     MountFile* mount_file();
@@ -132,6 +138,14 @@ public:
     ErrorOr<void> apply_flock(Process const&, Userspace<flock const*>, ShouldBlock);
     ErrorOr<void> get_flock(Userspace<flock*>) const;
 
+    EPollEntry::DescriptionList& epoll_entries(Badge<EPoll>) { return m_epoll_entries; }
+
+    // Called by file systems for every cached read, to find out how much they should read ahead.
+    Optional<ReadaheadWindow::Range> record_read_for_readahead(u64 offset, size_t size)
+    {
+        return m_readahead_window.with([&](auto& window) { return window.record_read(offset, size); });
+    }
+
 private:
     explicit OpenFileDescription(File&);
 
@@ -160,5 +174,13 @@ private:
     };
 
     SpinlockProtected<State, LockRank::None> m_state {};
+
+    // Serializes offset-relative reads and writes on seekable files.
+    Mutex m_offset_lock { "OpenFileDescription offset"sv };
+
+    // The EPoll entries watching this description, guarded by the EPoll attachment lock.
+    EPollEntry::DescriptionList m_epoll_entries;
+
+    SpinlockProtected<ReadaheadWindow, LockRank::None> m_readahead_window {};
 };
 }
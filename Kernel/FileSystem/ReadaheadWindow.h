@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// Tracks how a description is being read, to decide how much to read ahead of it.
+//
+// As long as every read starts where the previous one ended, the window of data
+// we read ahead doubles each time the reader gets within half a window of its end.
+// Any other access pattern resets the window, so random access costs no extra I/O.
+class ReadaheadWindow {
+public:
+    static constexpr size_t InitialSize = 16 * KiB;
+    static constexpr size_t MaximumSize = 512 * KiB;
+
+    struct Range {
+        u64 offset { 0 };
+        size_t size { 0 };
+    };
+
+    // Records a read of `size` bytes at `offset`, and returns the range that should be read ahead, if any.
+    Optional<Range> record_read(u64 offset, size_t size)
+    {
+        if (size == 0)
+            return {};
+
+        if (offset != m_next_offset) {
+            m_next_offset = offset + size;
+            m_window_end = 0;
+            m_window_size = 0;
+            return {};
+        }
+        m_next_offset = offset + size;
+
+        // There is still enough data on its way that we don't need to ask for more yet.
+        if (m_window_size != 0 && m_window_end >= m_next_offset + m_window_size / 2)
+            return {};
+
+        m_window_size = m_window_size == 0 ? InitialSize : min(m_window_size * 2, MaximumSize);
+        auto start = max(m_window_end, m_next_offset);
+        m_window_end = start + m_window_size;
+        return Range { start, m_window_size };
+    }
+
+private:
+    u64 m_next_offset { 0 };
+    u64 m_window_end { 0 };
+    size_t m_window_size { 0 };
+};
+
+}
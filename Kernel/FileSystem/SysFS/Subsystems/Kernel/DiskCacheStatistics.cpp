@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/DiskCacheStatistics.h>
+#include <Kernel/FileSystem/VirtualFileSystem.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSDiskCacheStatistics::SysFSDiskCacheStatistics(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSDiskCacheStatistics> SysFSDiskCacheStatistics::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSDiskCacheStatistics(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSDiskCacheStatistics::try_generate(KBufferBuilder& builder)
+{
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    TRY(Process::current().vfs_root_context()->for_each_mount([&array](auto& mount) -> ErrorOr<void> {
+        auto& fs = mount.guest_fs();
+        if (!fs.is_file_backed() || !static_cast<FileBackedFileSystem const&>(fs).is_block_based())
+            return {};
+        auto statistics = static_cast<BlockBasedFileSystem const&>(fs).disk_cache_statistics();
+
+        auto fs_object = TRY(array.add_object());
+        TRY(fs_object.add("class_name"sv, fs.class_name()));
+        auto mount_point = TRY(mount.absolute_path());
+        TRY(fs_object.add("mount_point"sv, mount_point->view()));
+        TRY(fs_object.add("block_size"sv, static_cast<u64>(fs.logical_block_size())));
+        TRY(fs_object.add("capacity"sv, statistics.capacity));
+        TRY(fs_object.add("probationary_blocks"sv, statistics.probationary_blocks));
+        TRY(fs_object.add("protected_blocks"sv, statistics.protected_blocks));
+        TRY(fs_object.add("dirty_blocks"sv, statistics.dirty_blocks));
+        TRY(fs_object.add("hits"sv, statistics.hits));
+        TRY(fs_object.add("misses"sv, statistics.misses));
+        TRY(fs_object.add("evictions"sv, statistics.evictions));
+        TRY(fs_object.add("ghost_hits"sv, statistics.ghost_hits));
+        TRY(fs_object.add("prefetched"sv, statistics.prefetched));
+        TRY(fs_object.add("written_back"sv, statistics.written_back));
+        TRY(fs_object.add("writeback_requests"sv, statistics.writeback_requests));
+        TRY(fs_object.add("dirty_background_blocks"sv, statistics.dirty_background_blocks));
+        TRY(fs_object.add("dirty_expiry_age_ms"sv, statistics.dirty_expiry_age_ms));
+        TRY(fs_object.finish());
+        return {};
+    }));
+    TRY(array.finish());
+    return {};
+}
+
+}
@@ -37,6 +37,9 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     TRY(json.add("physical_uncommitted"sv, system_memory.physical_pages_uncommitted));
     TRY(json.add("kmalloc_call_count"sv, stats.kmalloc_call_count));
     TRY(json.add("kfree_call_count"sv, stats.kfree_call_count));
+    TRY(json.add("kmalloc_cached_call_count"sv, stats.cached_kmalloc_call_count));
+    TRY(json.add("kfree_cached_call_count"sv, stats.cached_kfree_call_count));
+    TRY(json.add("kmalloc_lock_acquisition_count"sv, stats.lock_acquisition_count));
     TRY(json.finish());
     return {};
 }
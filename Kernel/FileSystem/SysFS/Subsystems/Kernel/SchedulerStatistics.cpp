@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/SchedulerStatistics.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/Scheduler.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSSchedulerStatistics::SysFSSchedulerStatistics(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSSchedulerStatistics> SysFSSchedulerStatistics::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSSchedulerStatistics(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSSchedulerStatistics::try_generate(KBufferBuilder& builder)
+{
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    ErrorOr<void> result;
+    Processor::for_each([&](Processor& processor) {
+        if (result.is_error())
+            return IterationDecision::Break;
+        result = ([&]() -> ErrorOr<void> {
+            auto statistics = Scheduler::get_processor_scheduling_statistics(processor.id());
+            auto obj = TRY(array.add_object());
+            TRY(obj.add("processor"sv, processor.id()));
+            TRY(obj.add("context_switches"sv, statistics.context_switches));
+            TRY(obj.add("threads_stolen"sv, statistics.threads_stolen));
+            TRY(obj.add("ready_threads"sv, statistics.ready_threads));
+            TRY(obj.add("idle_time"sv, processor.time_spent_idle()));
+            TRY(obj.finish());
+            return {};
+        })();
+        return IterationDecision::Continue;
+    });
+    TRY(result);
+    TRY(array.finish());
+    return {};
+}
+
+}
@@ -288,6 +288,18 @@ void VirtualFileSystem::sync_filesystems()
     }
 }
 
+void VirtualFileSystem::write_back_expired_filesystems()
+{
+    Vector<NonnullRefPtr<FileSystem>, 32> file_systems;
+    s_details->file_systems_list.with([&](auto const& list) {
+        for (auto& fs : list)
+            file_systems.append(fs);
+    });
+
+    for (auto& fs : file_systems)
+        (void)fs->flush_expired_writes();
+}
+
 ErrorOr<void> VirtualFileSystem::unmount(VFSRootContext& context, Custody& mountpoint_custody)
 {
     auto& guest_inode = mountpoint_custody.inode();
@@ -23,6 +23,7 @@ class Device;
 class DeviceControlDevice;
 class DiskCache;
 class DoubleBuffer;
+class EPoll;
 class File;
 class FATInode;
 class OpenFileDescription;
@@ -4,12 +4,14 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/Assertions.h>
 #include <AK/Types.h>
 #include <Kernel/Arch/PageDirectory.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Library/Panic.h>
 #include <Kernel/Library/StdLib.h>
@@ -28,6 +30,14 @@ static_assert(is_power_of_two(CHUNK_SIZE));
 
 static constexpr size_t INITIAL_KMALLOC_MEMORY_SIZE = 2 * MiB;
 static constexpr size_t KMALLOC_DEFAULT_ALIGNMENT = 16;
+static constexpr size_t KMALLOC_SLABHEAP_COUNT = 6;
+
+// NOTE: Slabs sitting in a processor cache are invisible to AddressSanitizer, so we don't cache them when it's enabled.
+#ifdef HAS_ADDRESS_SANITIZER
+static constexpr bool KMALLOC_PROCESSOR_CACHES_ENABLED = false;
+#else
+static constexpr bool KMALLOC_PROCESSOR_CACHES_ENABLED = true;
+#endif
 
 // Treat the heap as logically separate from .bss
 __attribute__((section(".heap"))) static u8 initial_kmalloc_memory[INITIAL_KMALLOC_MEMORY_SIZE];
@@ -137,6 +147,29 @@ public:
     size_t slab_size() const { return m_slab_size; }
 
     void* allocate(size_t requested_size, [[maybe_unused]] CallerWillInitializeMemory caller_will_initialize_memory)
+    {
+        auto* ptr = take_slab(requested_size);
+        if (!ptr)
+            return nullptr;
+
+#ifndef HAS_ADDRESS_SANITIZER
+        if (caller_will_initialize_memory == CallerWillInitializeMemory::No) {
+            memset(ptr, KMALLOC_SCRUB_BYTE, m_slab_size);
+        }
+#endif
+        return ptr;
+    }
+
+    void deallocate(void* ptr)
+    {
+#ifndef HAS_ADDRESS_SANITIZER
+        memset(ptr, KFREE_SCRUB_BYTE, m_slab_size);
+#endif
+        give_back_slab(ptr);
+    }
+
+    // Like allocate() and deallocate(), but without scrubbing. The processor caches take care of that themselves.
+    void* take_slab(size_t requested_size)
     {
         if (m_usable_blocks.is_empty()) {
             // FIXME: This allocation wastes `block_size` bytes due to the implementation of kmalloc_aligned().
@@ -153,21 +186,11 @@ public:
         auto* ptr = block->allocate(requested_size);
         if (block->is_full())
             m_full_blocks.append(*block);
-
-#ifndef HAS_ADDRESS_SANITIZER
-        if (caller_will_initialize_memory == CallerWillInitializeMemory::No) {
-            memset(ptr, KMALLOC_SCRUB_BYTE, m_slab_size);
-        }
-#endif
         return ptr;
     }
 
-    void deallocate(void* ptr)
+    void give_back_slab(void* ptr)
     {
-#ifndef HAS_ADDRESS_SANITIZER
-        memset(ptr, KFREE_SCRUB_BYTE, m_slab_size);
-#endif
-
         auto* block = (KmallocSlabBlock*)((FlatPtr)ptr & KmallocSlabBlock::block_mask);
         bool block_was_full = block->is_full();
         block->deallocate(ptr);
@@ -223,6 +246,78 @@ private:
     KmallocSlabBlock::List m_full_blocks;
 };
 
+// Every processor keeps a small stack of free slabs for each slab heap, so most small allocations
+// and deallocations can be served without taking the global kmalloc lock.
+// When a stack runs empty (or full), it is refilled from (or drained into) its slab heap in a batch.
+// NOTE: A processor cache is only ever touched by its own processor, with interrupts disabled.
+class KmallocSlabCache {
+public:
+    static constexpr size_t capacity = 32;
+    static constexpr size_t batch_size = capacity / 2;
+
+    bool is_empty() const { return m_count == 0; }
+    bool is_full() const { return m_count == capacity; }
+    size_t count() const { return m_count; }
+
+    void* pop()
+    {
+        VERIFY(!is_empty());
+        return m_slabs[--m_count];
+    }
+
+    void push(void* ptr)
+    {
+        VERIFY(!is_full());
+        m_slabs[m_count++] = ptr;
+    }
+
+    void refill(KmallocSlabheap& slabheap)
+    {
+        while (m_count < batch_size) {
+            auto* ptr = slabheap.take_slab(slabheap.slab_size());
+            if (!ptr)
+                return;
+            push(ptr);
+        }
+    }
+
+    // Gives back the slabs that have been sitting here the longest, the recently freed ones are more likely to be cache-hot.
+    void drain(KmallocSlabheap& slabheap, size_t count)
+    {
+        count = min(count, m_count);
+        for (size_t i = 0; i < count; ++i)
+            slabheap.give_back_slab(m_slabs[i]);
+        for (size_t i = count; i < m_count; ++i)
+            m_slabs[i - count] = m_slabs[i];
+        m_count -= count;
+    }
+
+private:
+    size_t m_count { 0 };
+    Array<void*, capacity> m_slabs;
+};
+
+struct KmallocProcessorData {
+    KmallocSlabCache slab_caches[KMALLOC_SLABHEAP_COUNT];
+
+    size_t kmalloc_call_count { 0 };
+    size_t kfree_call_count { 0 };
+    size_t cached_kmalloc_count { 0 };
+    size_t cached_kfree_count { 0 };
+    size_t lock_acquisition_count { 0 };
+    size_t nested_kfree_calls { 0 };
+};
+
+static Array<KmallocProcessorData, MAX_CPU_COUNT> s_processor_data;
+
+static KmallocProcessorData& current_processor_data()
+{
+    VERIFY(!Processor::are_interrupts_enabled());
+    auto id = Processor::current_id();
+    VERIFY(id < s_processor_data.size());
+    return s_processor_data[id];
+}
+
 struct KmallocGlobalData {
     static constexpr size_t minimum_subheap_size = 1 * MiB;
 
@@ -255,6 +350,10 @@ struct KmallocGlobalData {
 
         // NOTE: This size calculation is a mirror of kmalloc_aligned(KmallocSlabBlock)
         if (size <= KmallocSlabBlock::block_size * 2 + sizeof(ptrdiff_t) + sizeof(size_t)) {
+            // Slabs sitting in our processor caches keep their blocks from being purged, so give them back first.
+            // NOTE: We can't touch the caches of other processors from here.
+            drain_processor_caches(current_processor_data());
+
             // FIXME: We should propagate a freed pointer, to find the specific subheap it belonged to
             //        This would save us iterating over them in the next step and remove a recursion
             bool did_purge = false;
@@ -277,6 +376,30 @@ struct KmallocGlobalData {
         return allocate(size, alignment, caller_will_initialize_memory);
     }
 
+    Optional<size_t> slabheap_index_for_allocation(size_t size, size_t alignment) const
+    {
+        for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+            if (size <= slabheaps[i].slab_size() && alignment <= slabheaps[i].slab_size())
+                return i;
+        }
+        return {};
+    }
+
+    Optional<size_t> slabheap_index_for_deallocation(size_t size) const
+    {
+        for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+            if (size <= slabheaps[i].slab_size())
+                return i;
+        }
+        return {};
+    }
+
+    void drain_processor_caches(KmallocProcessorData& processor_data)
+    {
+        for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i)
+            processor_data.slab_caches[i].drain(slabheaps[i], KmallocSlabCache::capacity);
+    }
+
     void deallocate(void* ptr, size_t size)
     {
         VERIFY(!expansion_in_progress);
@@ -412,7 +535,7 @@ struct KmallocGlobalData {
 
     KmallocSubheap::List subheaps;
 
-    KmallocSlabheap slabheaps[6] = { 16, 32, 64, 128, 256, 512 };
+    KmallocSlabheap slabheaps[KMALLOC_SLABHEAP_COUNT] = { 16, 32, 64, 128, 256, 512 };
 
     bool expansion_in_progress { false };
 };
@@ -420,9 +543,6 @@ struct KmallocGlobalData {
 READONLY_AFTER_INIT static KmallocGlobalData* g_kmalloc_global;
 alignas(KmallocGlobalData) static u8 g_kmalloc_global_heap[sizeof(KmallocGlobalData)];
 
-static size_t g_kmalloc_call_count;
-static size_t g_kfree_call_count;
-static size_t g_nested_kfree_calls;
 bool g_dump_kmalloc_stacks;
 
 void kmalloc_enable_expand()
@@ -449,15 +569,38 @@ static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMem
     // Alignment must be a power of two.
     VERIFY(is_power_of_two(alignment));
 
-    SpinlockLocker lock(s_lock);
-    ++g_kmalloc_call_count;
+    InterruptDisabler disabler;
+    auto& processor_data = current_processor_data();
+    ++processor_data.kmalloc_call_count;
 
     if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available.was_set()) {
+        SpinlockLocker lock(s_lock);
         dbgln("kmalloc({})", size);
         Kernel::dump_backtrace();
     }
 
-    void* ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+    void* ptr = nullptr;
+    auto slabheap_index = g_kmalloc_global->slabheap_index_for_allocation(size, alignment);
+    if (KMALLOC_PROCESSOR_CACHES_ENABLED && slabheap_index.has_value()) {
+        auto& cache = processor_data.slab_caches[*slabheap_index];
+        auto& slabheap = g_kmalloc_global->slabheaps[*slabheap_index];
+        if (cache.is_empty()) {
+            SpinlockLocker lock(s_lock);
+            ++processor_data.lock_acquisition_count;
+            cache.refill(slabheap);
+        } else {
+            ++processor_data.cached_kmalloc_count;
+        }
+        if (!cache.is_empty()) {
+            ptr = cache.pop();
+            if (caller_will_initialize_memory == CallerWillInitializeMemory::No)
+                memset(ptr, KMALLOC_SCRUB_BYTE, slabheap.slab_size());
+        }
+    } else {
+        SpinlockLocker lock(s_lock);
+        ++processor_data.lock_acquisition_count;
+        ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+    }
 
     Thread* current_thread = Thread::current();
     if (!current_thread)
@@ -500,11 +643,12 @@ void kfree_sized(void* ptr, size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
-    SpinlockLocker lock(s_lock);
-    ++g_kfree_call_count;
-    ++g_nested_kfree_calls;
+    InterruptDisabler disabler;
+    auto& processor_data = current_processor_data();
+    ++processor_data.kfree_call_count;
+    ++processor_data.nested_kfree_calls;
 
-    if (g_nested_kfree_calls == 1) {
+    if (processor_data.nested_kfree_calls == 1) {
         Thread* current_thread = Thread::current();
         if (!current_thread)
             current_thread = Processor::idle_thread();
@@ -514,8 +658,27 @@ void kfree_sized(void* ptr, size_t size)
         }
     }
 
-    g_kmalloc_global->deallocate(ptr, size);
-    --g_nested_kfree_calls;
+    auto slabheap_index = g_kmalloc_global->slabheap_index_for_deallocation(size);
+    if (KMALLOC_PROCESSOR_CACHES_ENABLED && slabheap_index.has_value()) {
+        VERIFY(g_kmalloc_global->is_valid_kmalloc_address(VirtualAddress { ptr }));
+        auto& cache = processor_data.slab_caches[*slabheap_index];
+        auto& slabheap = g_kmalloc_global->slabheaps[*slabheap_index];
+        memset(ptr, KFREE_SCRUB_BYTE, slabheap.slab_size());
+        if (cache.is_full()) {
+            SpinlockLocker lock(s_lock);
+            ++processor_data.lock_acquisition_count;
+            cache.drain(slabheap, KmallocSlabCache::batch_size);
+        } else {
+            ++processor_data.cached_kfree_count;
+        }
+        cache.push(ptr);
+    } else {
+        SpinlockLocker lock(s_lock);
+        ++processor_data.lock_acquisition_count;
+        g_kmalloc_global->deallocate(ptr, size);
+    }
+
+    --processor_data.nested_kfree_calls;
 }
 
 size_t kmalloc_good_size(size_t size)
@@ -600,8 +763,21 @@ void operator delete[](void* ptr, size_t size) noexcept
 void get_kmalloc_stats(kmalloc_stats& stats)
 {
     SpinlockLocker lock(s_lock);
+    stats = {};
     stats.bytes_allocated = g_kmalloc_global->allocated_bytes();
     stats.bytes_free = g_kmalloc_global->free_bytes();
-    stats.kmalloc_call_count = g_kmalloc_call_count;
-    stats.kfree_call_count = g_kfree_call_count;
+
+    // NOTE: The other processors keep going while we look at their data, so this is only a snapshot.
+    for (auto const& processor_data : s_processor_data) {
+        for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+            auto cached_bytes = processor_data.slab_caches[i].count() * g_kmalloc_global->slabheaps[i].slab_size();
+            stats.bytes_allocated -= cached_bytes;
+            stats.bytes_free += cached_bytes;
+        }
+        stats.kmalloc_call_count += processor_data.kmalloc_call_count;
+        stats.kfree_call_count += processor_data.kfree_call_count;
+        stats.cached_kmalloc_call_count += processor_data.cached_kmalloc_count;
+        stats.cached_kfree_call_count += processor_data.cached_kfree_count;
+        stats.lock_acquisition_count += processor_data.lock_acquisition_count;
+    }
 }
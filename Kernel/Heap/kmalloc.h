@@ -52,6 +52,10 @@ struct kmalloc_stats {
     size_t bytes_free;
     size_t kmalloc_call_count;
     size_t kfree_call_count;
+    // Calls that were served by the calling processor's slab cache, without taking the kmalloc lock.
+    size_t cached_kmalloc_call_count;
+    size_t cached_kfree_call_count;
+    size_t lock_acquisition_count;
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
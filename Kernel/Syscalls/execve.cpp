@@ -992,13 +992,16 @@ ErrorOr<FlatPtr> Process::sys$execve(Userspace<Syscall::SC_execve_params const*>
 
     auto* current_thread = Thread::current();
     if (current_thread == new_main_thread) {
-        // We need to enter the scheduler lock before changing the state
-        // and it will be released after the context switch into that
-        // thread. We should also still be in our critical section
+        // We need to enter the context switch lock, which will be released
+        // after the context switch into that thread. We should also still
+        // be in our critical section
         VERIFY(!g_scheduler_lock.is_locked_by_current_processor());
         VERIFY(Processor::in_critical() == 1);
-        g_scheduler_lock.lock();
-        current_thread->set_state(Thread::State::Running);
+        {
+            SpinlockLocker lock(g_scheduler_lock);
+            current_thread->set_state(Thread::State::Running);
+        }
+        Scheduler::context_switch_lock().lock();
         Processor::assume_context(*current_thread, previous_interrupts_state);
         VERIFY_NOT_REACHED();
     }
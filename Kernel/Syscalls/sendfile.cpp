@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/KBuffer.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+// The data is staged in a kernel buffer of at most this size on its way from the file to the output.
+static constexpr size_t sendfile_buffer_size = 64 * KiB;
+
+ErrorOr<FlatPtr> Process::sys$sendfile(int out_fd, int in_fd, Userspace<off_t*> user_offset, size_t count)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    // NOTE: Like Linux, we transfer at most this much in one go. The caller will have to call us again for the rest.
+    count = min(count, static_cast<size_t>(NumericLimits<i32>::max()));
+
+    auto in_description = TRY(open_file_description(in_fd));
+    if (!in_description->is_readable())
+        return EBADF;
+    if (in_description->is_directory())
+        return EISDIR;
+    // We read from the input at an explicit offset, so it has to be seekable.
+    if (!in_description->file().is_seekable())
+        return user_offset ? ESPIPE : EINVAL;
+
+    auto out_description = TRY(open_file_description(out_fd));
+    if (!out_description->is_writable())
+        return EBADF;
+
+    off_t offset = 0;
+    if (user_offset)
+        TRY(copy_from_user(&offset, user_offset));
+    else
+        offset = in_description->offset();
+    if (offset < 0)
+        return EINVAL;
+
+    if (count == 0)
+        return 0;
+
+    auto buffer = TRY(KBuffer::try_create_with_size("sendfile"sv, min(count, sendfile_buffer_size)));
+    auto kernel_buffer = buffer->as_kernel_buffer();
+
+    size_t total_nsent = 0;
+    while (total_nsent < count) {
+        auto chunk_size = min(count - total_nsent, buffer->size());
+        auto nread_or_error = in_description->read(kernel_buffer, offset + total_nsent, chunk_size);
+        if (nread_or_error.is_error()) {
+            if (total_nsent > 0)
+                break;
+            return nread_or_error.release_error();
+        }
+        auto nread = nread_or_error.release_value();
+        if (nread == 0)
+            break;
+
+        auto nwritten_or_error = do_write(*out_description, kernel_buffer, nread);
+        if (nwritten_or_error.is_error()) {
+            if (total_nsent > 0)
+                break;
+            return nwritten_or_error.release_error();
+        }
+        auto nwritten = nwritten_or_error.release_value();
+        total_nsent += nwritten;
+
+        // A non-blocking output can't take any more right now.
+        if (nwritten < nread)
+            break;
+    }
+
+    offset += total_nsent;
+    if (user_offset)
+        TRY(copy_to_user(user_offset, &offset));
+    else
+        TRY(in_description->seek(offset, SEEK_SET));
+
+    return total_nsent;
+}
+
+}
@@ -46,7 +46,27 @@ struct ThreadReadyQueues {
     Array<ThreadReadyQueue, count> queues;
 };
 
-static Singleton<SpinlockProtected<ThreadReadyQueues, LockRank::None>> g_ready_queues;
+// Every processor owns its own set of ready queues, so that picking the next
+// thread only has to touch the local queues in the common case. Idle processors
+// steal runnable threads from their peers, as long as the thread's affinity allows it.
+// Context switches only hold the lock of the processor they happen on; g_scheduler_lock
+// is taken just long enough to change the state of the threads involved.
+struct ProcessorReadyQueues {
+    Thread* find_runnable_thread(u32 affinity_mask, bool remove);
+    void enqueue(Thread&, u32 priority, u32 cpu);
+    bool dequeue(Thread&);
+
+    SpinlockProtected<ThreadReadyQueues, LockRank::None> ready_queues {};
+    RecursiveSpinlock<LockRank::None> context_switch_lock {};
+    Atomic<u32> ready_thread_count { 0 };
+    Atomic<u64> context_switches { 0 };
+    Atomic<u64> threads_stolen { 0 };
+
+private:
+    void remove(ThreadReadyQueues&, Thread&, u32 priority);
+};
+
+static Singleton<Array<ProcessorReadyQueues, MAX_CPU_COUNT>> s_processor_ready_queues;
 
 static SpinlockProtected<TotalTimeScheduled, LockRank::None> g_total_time_scheduled {};
 
@@ -55,7 +75,7 @@ static void dump_thread_list(bool = false);
 static inline u32 thread_priority_to_priority_index(u32 thread_priority)
 {
     // Converts the priority in the range of THREAD_PRIORITY_MIN...THREAD_PRIORITY_MAX
-    // to a index into g_ready_queues where 0 is the highest priority bucket
+    // to a index into the ready queues where 0 is the highest priority bucket
     VERIFY(thread_priority >= THREAD_PRIORITY_MIN && thread_priority <= THREAD_PRIORITY_MAX);
     constexpr u32 thread_priority_count = THREAD_PRIORITY_MAX - THREAD_PRIORITY_MIN + 1;
     static_assert(thread_priority_count > 0);
@@ -64,127 +84,235 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static inline u32 scheduler_processor_count()
 {
-    auto affinity_mask = 1u << Processor::current_id();
+    // NOTE: Processor::count() is not maintained on every architecture yet.
+    return clamp(Processor::count(), 1u, static_cast<u32>(min(MAX_CPU_COUNT, sizeof(u32) * 8)));
+}
 
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                thread.m_runnable_priority = -1;
-                ready_queue.thread_list.remove(thread);
-                if (ready_queue.thread_list.is_empty())
-                    ready_queues.mask &= ~(1u << priority);
-                // Mark it as active because we are using this thread. This is similar
-                // to comparing it with Processor::current_thread, but when there are
-                // multiple processors there's no easy way to check whether the thread
-                // is actually still needed. This prevents accidental finalization when
-                // a thread is no longer in Running state, but running on another core.
-
-                // We need to mark it active here so that this thread won't be
-                // scheduled on another core if it were to be queued before actually
-                // switching to it.
-                // FIXME: Figure out a better way maybe?
-                thread.set_active(true);
-                return thread;
-            }
-            priority_mask &= ~(1u << priority);
-        }
+static inline ProcessorReadyQueues& ready_queues_for_processor(u32 cpu)
+{
+    VERIFY(cpu < MAX_CPU_COUNT);
+    return (*s_processor_ready_queues)[cpu];
+}
 
-        auto* idle_thread = Processor::idle_thread();
-        idle_thread->set_active(true);
-        return *idle_thread;
-    });
+void ProcessorReadyQueues::remove(ThreadReadyQueues& queues, Thread& thread, u32 priority)
+{
+    auto& ready_queue = queues.queues[priority];
+    thread.m_runnable_priority = -1;
+    ready_queue.thread_list.remove(thread);
+    if (ready_queue.thread_list.is_empty())
+        queues.mask &= ~(1u << priority);
+    ready_thread_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
 }
 
-Thread* Scheduler::peek_next_runnable_thread()
+// Finds the highest priority thread in these ready queues that may run on the processor
+// identified by affinity_mask. If remove is true, the thread is taken off the queue.
+Thread* ProcessorReadyQueues::find_runnable_thread(u32 affinity_mask, bool remove)
 {
-    auto affinity_mask = 1u << Processor::current_id();
+    if (ready_thread_count.load(AK::MemoryOrder::memory_order_relaxed) == 0)
+        return nullptr;
 
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
-        auto priority_mask = ready_queues.mask;
+    return ready_queues.with([&](auto& queues) -> Thread* {
+        auto priority_mask = queues.mask;
         while (priority_mask != 0) {
             auto priority = bit_scan_forward(priority_mask);
             VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
+            auto& ready_queue = queues.queues[--priority];
             for (auto& thread : ready_queue.thread_list) {
                 VERIFY(thread.m_runnable_priority == (int)priority);
                 if (thread.is_active())
                     continue;
                 if (!(thread.affinity() & affinity_mask))
                     continue;
+                if (remove)
+                    this->remove(queues, thread, priority);
                 return &thread;
             }
             priority_mask &= ~(1u << priority);
         }
-
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
         return nullptr;
     });
 }
 
-bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
+void ProcessorReadyQueues::enqueue(Thread& thread, u32 priority, u32 cpu)
 {
-    if (thread.is_idle_thread())
-        return true;
+    ready_queues.with([&](auto& queues) {
+        VERIFY(thread.m_runnable_priority < 0);
+        thread.m_runnable_priority = (int)priority;
+        thread.m_runnable_processor = cpu;
+        VERIFY(!thread.m_ready_queue_node.is_in_list());
+        auto& ready_queue = queues.queues[priority];
+        bool was_empty = ready_queue.thread_list.is_empty();
+        ready_queue.thread_list.append(thread);
+        if (was_empty)
+            queues.mask |= (1u << priority);
+        ready_thread_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    });
+}
 
-    return g_ready_queues->with([&](auto& ready_queues) {
+bool ProcessorReadyQueues::dequeue(Thread& thread)
+{
+    return ready_queues.with([&](auto& queues) {
         auto priority = thread.m_runnable_priority;
         if (priority < 0) {
             VERIFY(!thread.m_ready_queue_node.is_in_list());
             return false;
         }
 
-        if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
-            return false;
-
-        VERIFY(ready_queues.mask & (1u << priority));
-        auto& ready_queue = ready_queues.queues[priority];
-        thread.m_runnable_priority = -1;
-        ready_queue.thread_list.remove(thread);
-        if (ready_queue.thread_list.is_empty())
-            ready_queues.mask &= ~(1u << priority);
+        VERIFY(queues.mask & (1u << priority));
+        remove(queues, thread, priority);
         return true;
     });
 }
 
+static Thread* find_stealable_thread(u32 current_cpu, bool remove)
+{
+    auto affinity_mask = 1u << current_cpu;
+    auto processor_count = scheduler_processor_count();
+
+    // Start with our neighbor to avoid having every idle processor hammer the same queue.
+    for (u32 i = 1; i < processor_count; ++i) {
+        auto victim_cpu = (current_cpu + i) % processor_count;
+        if (auto* thread = ready_queues_for_processor(victim_cpu).find_runnable_thread(affinity_mask, remove)) {
+            if (remove) {
+                ready_queues_for_processor(current_cpu).threads_stolen.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+                dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Stole {} from processor {}", current_cpu, *thread, victim_cpu);
+            }
+            return thread;
+        }
+    }
+    return nullptr;
+}
+
+// Picks the processor whose ready queues a thread should be put on. We prefer the processor the
+// thread last ran on for cache locality, unless another allowed processor is noticeably less loaded.
+static u32 select_processor_for_thread(Thread const& thread)
+{
+    auto processor_count = scheduler_processor_count();
+    if (processor_count == 1)
+        return 0;
+
+    auto affinity = thread.affinity();
+    auto last_cpu = thread.cpu();
+    Optional<u32> least_loaded_cpu;
+    u32 least_load = NumericLimits<u32>::max();
+    for (u32 cpu = 0; cpu < processor_count; ++cpu) {
+        if (!(affinity & (1u << cpu)))
+            continue;
+        auto load = ready_queues_for_processor(cpu).ready_thread_count.load(AK::MemoryOrder::memory_order_relaxed);
+        if (load < least_load) {
+            least_load = load;
+            least_loaded_cpu = cpu;
+        }
+    }
+
+    if (!least_loaded_cpu.has_value())
+        return last_cpu < processor_count ? last_cpu : 0;
+
+    if (last_cpu < processor_count && (affinity & (1u << last_cpu))) {
+        auto last_cpu_load = ready_queues_for_processor(last_cpu).ready_thread_count.load(AK::MemoryOrder::memory_order_relaxed);
+        if (last_cpu_load <= least_load + 1)
+            return last_cpu;
+    }
+    return least_loaded_cpu.value();
+}
+
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    VERIFY(context_switch_lock().is_locked_by_current_processor());
+    auto current_cpu = Processor::current_id();
+
+    for (;;) {
+        auto* thread = ready_queues_for_processor(current_cpu).find_runnable_thread(1u << current_cpu, true);
+        if (!thread)
+            thread = find_stealable_thread(current_cpu, true);
+        if (!thread)
+            break;
+
+        // Mark it as active because we are using this thread. This is similar
+        // to comparing it with Processor::current_thread, but when there are
+        // multiple processors there's no easy way to check whether the thread
+        // is actually still needed. This prevents accidental finalization when
+        // a thread is no longer in Running state, but running on another core.
+
+        // We need to mark it active here so that this thread won't be
+        // scheduled on another core if it were to be queued before actually
+        // switching to it.
+        // FIXME: Figure out a better way maybe?
+        thread->set_active(true);
+
+        // Taking a thread off the ready queues doesn't involve g_scheduler_lock,
+        // so its state may have changed since, e.g. because it was stopped.
+        // Whoever did that has taken care of the thread; we just pick another one.
+        SpinlockLocker lock(g_scheduler_lock);
+        if (thread->state() == Thread::State::Runnable) {
+            thread->set_state(Thread::State::Running);
+            return *thread;
+        }
+        thread->set_active(false);
+    }
+
+    auto* idle_thread = Processor::idle_thread();
+    idle_thread->set_active(true);
+    if (idle_thread->state() != Thread::State::Running) {
+        // NOTE: The idle thread only ever changes state on its own processor, so the check above is safe.
+        SpinlockLocker lock(g_scheduler_lock);
+        idle_thread->set_state(Thread::State::Running);
+    }
+    return *idle_thread;
+}
+
+Thread* Scheduler::peek_next_runnable_thread()
+{
+    auto current_cpu = Processor::current_id();
+
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread. We just want to see if we have any other thread ready
+    // to be scheduled.
+    if (auto* thread = ready_queues_for_processor(current_cpu).find_runnable_thread(1u << current_cpu, false))
+        return thread;
+    return find_stealable_thread(current_cpu, false);
+}
+
+bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
+{
+    if (thread.is_idle_thread())
+        return true;
+
+    if (thread.m_runnable_priority < 0) {
+        VERIFY(!thread.m_ready_queue_node.is_in_list());
+        return false;
+    }
+
+    if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
+        return false;
+
+    return ready_queues_for_processor(thread.m_runnable_processor).dequeue(thread);
+}
+
 void Scheduler::enqueue_runnable_thread(Thread& thread)
 {
     VERIFY(g_scheduler_lock.is_locked_by_current_processor());
     if (thread.is_idle_thread())
         return;
     auto priority = thread_priority_to_priority_index(thread.priority());
+    auto cpu = select_processor_for_thread(thread);
+    ready_queues_for_processor(cpu).enqueue(thread, priority, cpu);
+}
 
-    g_ready_queues->with([&](auto& ready_queues) {
-        VERIFY(thread.m_runnable_priority < 0);
-        thread.m_runnable_priority = (int)priority;
-        VERIFY(!thread.m_ready_queue_node.is_in_list());
-        auto& ready_queue = ready_queues.queues[priority];
-        bool was_empty = ready_queue.thread_list.is_empty();
-        ready_queue.thread_list.append(thread);
-        if (was_empty)
-            ready_queues.mask |= (1u << priority);
-    });
+RecursiveSpinlock<LockRank::None>& Scheduler::context_switch_lock()
+{
+    return ready_queues_for_processor(Processor::current_id()).context_switch_lock;
 }
 
 UNMAP_AFTER_INIT void Scheduler::start()
 {
     VERIFY_INTERRUPTS_DISABLED();
 
-    // We need to acquire our scheduler lock, which will be released
+    // We need to acquire our context switch lock, which will be released
     // by the idle thread once control transferred there
-    g_scheduler_lock.lock();
+    context_switch_lock().lock();
 
     auto& processor = Processor::current();
     VERIFY(processor.is_initialized());
@@ -194,7 +322,10 @@ UNMAP_AFTER_INIT void Scheduler::start()
     idle_thread.did_schedule();
     idle_thread.set_initialized(true);
     processor.init_context(idle_thread, false);
-    idle_thread.set_state(Thread::State::Running);
+    {
+        SpinlockLocker lock(g_scheduler_lock);
+        idle_thread.set_state(Thread::State::Running);
+    }
     VERIFY(idle_thread.affinity() == (1u << processor.id()));
     processor.initialize_context_switching(idle_thread);
     VERIFY_NOT_REACHED();
@@ -217,7 +348,9 @@ void Scheduler::pick_next()
             Processor::set_current_in_scheduler(false);
         });
 
-    SpinlockLocker lock(g_scheduler_lock);
+    // NOTE: This is released by the thread we switch to, which may have been switched out
+    //       on another processor, and so holds a different lock than the one we take here.
+    auto previous_interrupts_state = context_switch_lock().lock();
 
     if constexpr (SCHEDULER_RUNNABLE_DEBUG) {
         dump_thread_list();
@@ -232,11 +365,14 @@ void Scheduler::pick_next()
     }
 
     // We need to leave our first critical section before switching context,
-    // but since we're still holding the scheduler lock we're still in a critical section
+    // but since we're still holding the context switch lock we're still in a critical section
     critical.leave();
 
     thread_to_schedule.set_ticks_left(time_slice_for(thread_to_schedule));
     context_switch(&thread_to_schedule);
+
+    // We may be on a different processor now, so this isn't necessarily the lock we took above.
+    context_switch_lock().unlock(previous_interrupts_state);
 }
 
 void Scheduler::yield()
@@ -270,11 +406,16 @@ void Scheduler::context_switch(Thread* thread)
     // If the last process hasn't blocked (still marked as running),
     // mark it as runnable for the next round, unless it's supposed
     // to be stopped, in which case just mark it as such.
-    if (from_thread->state() == Thread::State::Running) {
-        if (from_thread->should_be_stopped())
-            from_thread->set_state(Thread::State::Stopped);
-        else
-            from_thread->set_state(Thread::State::Runnable);
+    // NOTE: It stays active until enter_current(), so no other processor
+    //       will pick it before its context has been saved.
+    {
+        SpinlockLocker lock(g_scheduler_lock);
+        if (from_thread->state() == Thread::State::Running) {
+            if (from_thread->should_be_stopped())
+                from_thread->set_state(Thread::State::Stopped);
+            else
+                from_thread->set_state(Thread::State::Runnable);
+        }
     }
 
 #ifdef LOG_EVERY_CONTEXT_SWITCH
@@ -290,8 +431,9 @@ void Scheduler::context_switch(Thread* thread)
         proc.init_context(*thread, false);
         thread->set_initialized(true);
     }
-    thread->set_state(Thread::State::Running);
+    VERIFY(thread->state() == Thread::State::Running);
 
+    ready_queues_for_processor(proc.id()).context_switches.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
     PerformanceManager::add_context_switch_perf_event(*from_thread, *thread);
 
     proc.switch_context(from_thread, thread);
@@ -309,7 +451,7 @@ void Scheduler::context_switch(Thread* thread)
 
 void Scheduler::enter_current(Thread& prev_thread)
 {
-    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
+    VERIFY(context_switch_lock().is_locked_by_current_processor());
 
     // We already recorded the scheduled time when entering the trap, so this merely accounts for the kernel time since then
     auto scheduler_time = TimeManagement::scheduler_current_time();
@@ -317,15 +459,18 @@ void Scheduler::enter_current(Thread& prev_thread)
     auto* current_thread = Thread::current();
     current_thread->update_time_scheduled(scheduler_time, true, false);
 
+    // NOTE: As soon as the thread we switched from is inactive, the finalizer
+    //       may free it if it's dying, so we have to look at its state first.
+    bool prev_thread_is_dying = prev_thread.state() == Thread::State::Dying;
+
     // NOTE: When doing an exec(), we will context switch from and to the same thread!
     //       In that case, we must not mark the previous thread as inactive.
     if (&prev_thread != current_thread)
         prev_thread.set_active(false);
 
-    if (prev_thread.state() == Thread::State::Dying) {
+    if (prev_thread_is_dying) {
         // If the thread we switched from is marked as dying, then notify
-        // the finalizer. Note that as soon as we leave the scheduler lock
-        // the finalizer may free from_thread!
+        // the finalizer.
         notify_finalizer();
     }
 }
@@ -336,7 +481,7 @@ void Scheduler::leave_on_first_switch(InterruptsState previous_interrupts_state)
     // At this point, enter_current has already be called, but because
     // Scheduler::context_switch is not in the call stack we need to
     // clean up and release locks manually here
-    g_scheduler_lock.unlock(previous_interrupts_state);
+    context_switch_lock().unlock(previous_interrupts_state);
 
     VERIFY(Processor::current_in_scheduler());
     Processor::set_current_in_scheduler(false);
@@ -346,7 +491,7 @@ void Scheduler::prepare_after_exec()
 {
     // This is called after exec() when doing a context "switch" into
     // the new process. This is called from Processor::assume_context
-    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
+    VERIFY(context_switch_lock().is_locked_by_current_processor());
 
     VERIFY(!Processor::current_in_scheduler());
     Processor::set_current_in_scheduler(true);
@@ -355,9 +500,9 @@ void Scheduler::prepare_after_exec()
 void Scheduler::prepare_for_idle_loop()
 {
     // This is called when the CPU finished setting up the idle loop
-    // and is about to run it. We need to acquire the scheduler lock
-    VERIFY(!g_scheduler_lock.is_locked_by_current_processor());
-    g_scheduler_lock.lock();
+    // and is about to run it. We need to acquire the context switch lock
+    VERIFY(!context_switch_lock().is_locked_by_current_processor());
+    context_switch_lock().lock();
 
     VERIFY(!Processor::current_in_scheduler());
     Processor::set_current_in_scheduler(true);
@@ -507,6 +652,16 @@ TotalTimeScheduled Scheduler::get_total_time_scheduled()
     return g_total_time_scheduled.with([&](auto& total_time_scheduled) { return total_time_scheduled; });
 }
 
+ProcessorSchedulingStatistics Scheduler::get_processor_scheduling_statistics(u32 cpu)
+{
+    auto& processor_queues = ready_queues_for_processor(cpu);
+    return {
+        .context_switches = processor_queues.context_switches.load(AK::MemoryOrder::memory_order_relaxed),
+        .threads_stolen = processor_queues.threads_stolen.load(AK::MemoryOrder::memory_order_relaxed),
+        .ready_threads = processor_queues.ready_thread_count.load(AK::MemoryOrder::memory_order_relaxed),
+    };
+}
+
 void dump_thread_list(bool with_stack_traces)
 {
     dbgln("Scheduler thread list for processor {}:", Processor::current_id());
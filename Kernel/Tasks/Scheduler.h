@@ -29,6 +29,12 @@ struct TotalTimeScheduled {
     u64 total_kernel { 0 };
 };
 
+struct ProcessorSchedulingStatistics {
+    u64 context_switches { 0 };
+    u64 threads_stolen { 0 };
+    u32 ready_threads { 0 };
+};
+
 class Scheduler {
 public:
     static void initialize();
@@ -37,6 +43,8 @@ public:
     static void timer_tick();
     [[noreturn]] static void start();
     static void pick_next();
+    // Held by the current processor from picking the next thread until that thread runs.
+    static RecursiveSpinlock<LockRank::None>& context_switch_lock();
     static void yield();
     static void context_switch(Thread*);
     static void enter_current(Thread& prev_thread);
@@ -55,6 +63,7 @@ public:
     static bool is_initialized();
     static TotalTimeScheduled get_total_time_scheduled();
     static void add_time_scheduled(u64, bool);
+    static ProcessorSchedulingStatistics get_processor_scheduling_statistics(u32 cpu);
 };
 
 }
@@ -17,7 +17,7 @@ UNMAP_AFTER_INIT void SyncTask::spawn()
     MUST(Process::create_kernel_process("VFS Sync Task"sv, [] {
         dbgln("VFS SyncTask is running");
         while (!Process::current().is_dying()) {
-            FileSystem::sync();
+            FileSystem::write_back_expired();
             (void)Thread::current()->sleep(Duration::from_seconds(1));
         }
         Process::current().sys$exit(0);
@@ -64,6 +64,7 @@ class Thread
     friend class Process;
     friend class Scheduler;
     friend struct ThreadReadyQueue;
+    friend struct ProcessorReadyQueues;
 
 public:
     static Thread* current()
@@ -939,7 +940,9 @@ public:
         m_ipv4_socket_write_bytes += bytes;
     }
 
-    void set_active(bool active) { m_is_active = active; }
+    // NOTE: Context switches don't hold g_scheduler_lock, so this is what publishes a switched out thread's
+    //       saved context to the processor that picks it next.
+    void set_active(bool active) { m_is_active.store(active, AK::memory_order_release); }
 
     u32 saved_critical() const { return m_saved_critical; }
     void save_critical(u32 critical) { m_saved_critical = critical; }
@@ -947,7 +950,7 @@ public:
     void track_lock_acquire(LockRank rank);
     void track_lock_release(LockRank rank);
 
-    [[nodiscard]] bool is_active() const { return m_is_active; }
+    [[nodiscard]] bool is_active() const { return m_is_active.load(AK::memory_order_acquire); }
 
     [[nodiscard]] bool is_finalizable() const
     {
@@ -1094,6 +1097,7 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    u32 m_runnable_processor { 0 };
 
     friend class WaitQueue;
 
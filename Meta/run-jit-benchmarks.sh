@@ -0,0 +1,34 @@
+#!/usr/bin/env bash
+
+set -eo pipefail
+
+# Compares the bytecode interpreter against the JIT on Base/home/anon/Source/js/jit-benchmarks.
+# Usage: Meta/run-jit-benchmarks.sh [path/to/js] [runs]
+# Each benchmark prints the best user time out of all runs, since the fastest run is the least disturbed one.
+
+script_path=$(cd -P -- "$(dirname -- "$0")" && pwd -P)
+JS=$(realpath "${1:-${script_path}/../Build/lagom/bin/js}")
+cd "${script_path}/.."
+
+RUNS="${2:-5}"
+TIMEFORMAT='%U'
+
+run_time() {
+    { time "${JS}" "$@" > /dev/null; } 2>&1
+}
+
+min() {
+    echo "$1 ${2:-$1}" | awk '{ print ($1 < $2) ? $1 : $2 }'
+}
+
+printf "%-24s %12s %12s\n" "benchmark" "interpreter" "jit"
+for benchmark in Base/home/anon/Source/js/jit-benchmarks/*.js; do
+    # Alternate between the two, so a noisy stretch on the machine doesn't only hit one of them.
+    interpreter=
+    jit=
+    for _ in $(seq "${RUNS}"); do
+        interpreter=$(min "$(run_time "${benchmark}")" "${interpreter}")
+        jit=$(min "$(run_time --jit "${benchmark}")" "${jit}")
+    done
+    printf "%-24s %11ss %11ss\n" "$(basename "${benchmark}" .js)" "${interpreter}" "${jit}"
+done
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// These tests hammer read(), write() and friends from many threads in the same process at once.
+// They make sure that I/O on independent file descriptors works in parallel, and that I/O on
+// a shared file description keeps its offset consistent.
+
+static constexpr size_t thread_count = 16;
+static constexpr size_t iterations = 256;
+static constexpr size_t record_size = 64;
+
+static void run_threads(void* (*function)(void*), void* argument = nullptr)
+{
+    Array<pthread_t, thread_count> threads;
+    for (size_t i = 0; i < thread_count; ++i) {
+        int rc = pthread_create(&threads[i], nullptr, function, argument);
+        VERIFY(rc == 0);
+    }
+    for (auto thread : threads) {
+        int rc = pthread_join(thread, nullptr);
+        VERIFY(rc == 0);
+    }
+}
+
+static u8 record_byte(size_t thread_index, size_t iteration)
+{
+    return static_cast<u8>((thread_index * 31 + iteration) & 0xff);
+}
+
+static void* pipe_ping_pong(void*)
+{
+    auto fds = MUST(Core::System::pipe2(0));
+    Array<u8, record_size> out_buffer;
+    Array<u8, record_size> in_buffer;
+
+    for (size_t i = 0; i < iterations; ++i) {
+        out_buffer.fill(static_cast<u8>(i));
+        auto nwritten = MUST(Core::System::write(fds[1], out_buffer));
+        EXPECT_EQ(static_cast<size_t>(nwritten), record_size);
+
+        auto nread = MUST(Core::System::read(fds[0], in_buffer));
+        EXPECT_EQ(static_cast<size_t>(nread), record_size);
+        EXPECT_EQ(in_buffer, out_buffer);
+    }
+
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+    return nullptr;
+}
+
+TEST_CASE(parallel_pipe_io)
+{
+    run_threads(pipe_ping_pong);
+}
+
+static void* socket_ping_pong(void*)
+{
+    int fds[2];
+    MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, fds));
+    Array<u8, record_size> out_buffer;
+    Array<u8, record_size> in_buffer;
+
+    for (size_t i = 0; i < iterations; ++i) {
+        out_buffer.fill(static_cast<u8>(i));
+
+        iovec out_iov { out_buffer.data(), out_buffer.size() };
+        msghdr out_message {};
+        out_message.msg_iov = &out_iov;
+        out_message.msg_iovlen = 1;
+        auto nsent = MUST(Core::System::sendmsg(fds[0], &out_message, 0));
+        EXPECT_EQ(static_cast<size_t>(nsent), record_size);
+
+        iovec in_iov { in_buffer.data(), in_buffer.size() };
+        msghdr in_message {};
+        in_message.msg_iov = &in_iov;
+        in_message.msg_iovlen = 1;
+        auto nreceived = MUST(Core::System::recvmsg(fds[1], &in_message, 0));
+        EXPECT_EQ(static_cast<size_t>(nreceived), record_size);
+        EXPECT_EQ(in_buffer, out_buffer);
+    }
+
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+    return nullptr;
+}
+
+TEST_CASE(parallel_socket_io)
+{
+    run_threads(socket_ping_pong);
+}
+
+static void* private_file_io(void*)
+{
+    char pattern[] = "/tmp/concurrent_io.XXXXXX";
+    auto fd = MUST(Core::System::mkstemp(pattern));
+    MUST(Core::System::unlink({ pattern, sizeof(pattern) - 1 }));
+
+    Array<u8, record_size> buffer;
+    for (size_t i = 0; i < iterations; ++i) {
+        buffer.fill(static_cast<u8>(i));
+        auto nwritten = pwrite(fd, buffer.data(), buffer.size(), i * record_size);
+        EXPECT_EQ(static_cast<size_t>(nwritten), record_size);
+    }
+
+    for (size_t i = 0; i < iterations; ++i) {
+        auto nread = pread(fd, buffer.data(), buffer.size(), i * record_size);
+        EXPECT_EQ(static_cast<size_t>(nread), record_size);
+        for (auto byte : buffer)
+            EXPECT_EQ(byte, static_cast<u8>(i));
+    }
+
+    MUST(Core::System::close(fd));
+    return nullptr;
+}
+
+TEST_CASE(parallel_file_io)
+{
+    run_threads(private_file_io);
+}
+
+static Atomic<size_t> s_next_thread_index;
+
+static void* append_records(void* fd_pointer)
+{
+    int fd = *reinterpret_cast<int*>(fd_pointer);
+    auto thread_index = s_next_thread_index.fetch_add(1);
+
+    Array<u8, record_size> buffer;
+    for (size_t i = 0; i < iterations; ++i) {
+        buffer.fill(record_byte(thread_index, i));
+        auto nwritten = MUST(Core::System::write(fd, buffer));
+        EXPECT_EQ(static_cast<size_t>(nwritten), record_size);
+    }
+    return nullptr;
+}
+
+TEST_CASE(shared_description_append)
+{
+    char pattern[] = "/tmp/concurrent_io_append.XXXXXX";
+    auto fd = MUST(Core::System::mkstemp(pattern));
+    MUST(Core::System::unlink({ pattern, sizeof(pattern) - 1 }));
+    MUST(Core::System::fcntl(fd, F_SETFL, O_APPEND | O_RDWR));
+
+    s_next_thread_index = 0;
+    run_threads(append_records, &fd);
+
+    // Every record must have landed in its own slot, without being torn or overwritten.
+    auto stat = MUST(Core::System::fstat(fd));
+    EXPECT_EQ(static_cast<size_t>(stat.st_size), thread_count * iterations * record_size);
+
+    Array<u8, record_size> buffer;
+    for (size_t offset = 0; offset < static_cast<size_t>(stat.st_size); offset += record_size) {
+        auto nread = pread(fd, buffer.data(), buffer.size(), offset);
+        EXPECT_EQ(static_cast<size_t>(nread), record_size);
+        for (auto byte : buffer)
+            EXPECT_EQ(byte, buffer[0]);
+    }
+
+    MUST(Core::System::close(fd));
+}
+
+static Atomic<size_t> s_total_records_read;
+
+static void* read_records(void* fd_pointer)
+{
+    int fd = *reinterpret_cast<int*>(fd_pointer);
+
+    Array<u8, record_size> buffer;
+    for (;;) {
+        auto nread = MUST(Core::System::read(fd, buffer));
+        if (nread == 0)
+            break;
+        EXPECT_EQ(static_cast<size_t>(nread), record_size);
+        for (auto byte : buffer)
+            EXPECT_EQ(byte, buffer[0]);
+        s_total_records_read.fetch_add(1);
+    }
+    return nullptr;
+}
+
+TEST_CASE(shared_description_read)
+{
+    char pattern[] = "/tmp/concurrent_io_read.XXXXXX";
+    auto fd = MUST(Core::System::mkstemp(pattern));
+    MUST(Core::System::unlink({ pattern, sizeof(pattern) - 1 }));
+
+    constexpr size_t record_count = thread_count * iterations;
+    Array<u8, record_size> buffer;
+    for (size_t i = 0; i < record_count; ++i) {
+        buffer.fill(static_cast<u8>(i));
+        MUST(Core::System::write(fd, buffer));
+    }
+    MUST(Core::System::lseek(fd, 0, SEEK_SET));
+
+    // Each record must be read by exactly one thread.
+    s_total_records_read = 0;
+    run_threads(read_records, &fd);
+    EXPECT_EQ(s_total_records_read.load(), record_count);
+
+    MUST(Core::System::close(fd));
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <LibCore/File.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static JsonObject root_filesystem_cache_statistics()
+{
+    auto file = MUST(Core::File::open("/sys/kernel/diskcache"sv, Core::File::OpenMode::Read));
+    auto json = MUST(JsonValue::from_string(MUST(file->read_until_eof())));
+    EXPECT(json.is_array());
+
+    Optional<JsonObject> root_statistics;
+    json.as_array().for_each([&](JsonValue const& value) {
+        auto const& object = value.as_object();
+        if (object.get_byte_string("mount_point"sv) == "/")
+            root_statistics = object;
+    });
+    VERIFY(root_statistics.has_value());
+    return root_statistics.release_value();
+}
+
+static u64 counter(JsonObject const& statistics, StringView name)
+{
+    return statistics.get_u64(name).value();
+}
+
+TEST_CASE(cache_is_at_least_as_large_as_it_used_to_be)
+{
+    auto statistics = root_filesystem_cache_statistics();
+    EXPECT(counter(statistics, "capacity"sv) >= 10000u);
+    EXPECT(counter(statistics, "probationary_blocks"sv) + counter(statistics, "protected_blocks"sv) + counter(statistics, "dirty_blocks"sv) <= counter(statistics, "capacity"sv));
+}
+
+TEST_CASE(reading_a_file_twice_hits_the_cache)
+{
+    auto read_file = [] {
+        auto file = MUST(Core::File::open("/usr/lib/libc.so"sv, Core::File::OpenMode::Read));
+        (void)MUST(file->read_until_eof());
+    };
+
+    read_file();
+    auto before = root_filesystem_cache_statistics();
+    read_file();
+    auto after = root_filesystem_cache_statistics();
+
+    EXPECT(counter(after, "hits"sv) > counter(before, "hits"sv));
+    EXPECT(counter(after, "misses"sv) >= counter(before, "misses"sv));
+    EXPECT(counter(after, "evictions"sv) >= counter(before, "evictions"sv));
+}
+
+TEST_CASE(sequential_reads_with_readahead_match_uncached_reads)
+{
+    // NOTE: An odd chunk size makes sure reads straddle block boundaries and readahead windows.
+    static constexpr size_t chunk_size = 3001;
+
+    auto cached_fd = open("/usr/lib/libc.so", O_RDONLY);
+    EXPECT(cached_fd >= 0);
+    auto direct_fd = open("/usr/lib/libc.so", O_RDONLY | O_DIRECT);
+    EXPECT(direct_fd >= 0);
+
+    u8 cached_buffer[chunk_size];
+    u8 direct_buffer[chunk_size];
+    for (;;) {
+        auto cached_nread = read(cached_fd, cached_buffer, chunk_size);
+        auto direct_nread = read(direct_fd, direct_buffer, chunk_size);
+        EXPECT_EQ(cached_nread, direct_nread);
+        if (cached_nread <= 0)
+            break;
+        EXPECT_EQ(ReadonlyBytes(cached_buffer, cached_nread), ReadonlyBytes(direct_buffer, direct_nread));
+    }
+
+    close(cached_fd);
+    close(direct_fd);
+}
+
+TEST_CASE(sync_writes_back_adjacent_blocks_together)
+{
+    static constexpr size_t file_size = 1 * MiB;
+
+    // NOTE: /tmp is not on the root filesystem, so we need to write somewhere else.
+    char path[] = "/home/anon/.diskcache_test.XXXXXX";
+    auto fd = mkstemp(path);
+    EXPECT(fd >= 0);
+
+    auto data = MUST(ByteBuffer::create_uninitialized(file_size));
+    for (size_t i = 0; i < file_size; ++i)
+        data[i] = static_cast<u8>(i * 7);
+
+    auto before = root_filesystem_cache_statistics();
+    EXPECT_EQ(write(fd, data.data(), data.size()), static_cast<ssize_t>(file_size));
+    sync();
+    auto after = root_filesystem_cache_statistics();
+
+    auto written_back = counter(after, "written_back"sv) - counter(before, "written_back"sv);
+    auto writeback_requests = counter(after, "writeback_requests"sv) - counter(before, "writeback_requests"sv);
+    EXPECT(written_back >= file_size / counter(after, "block_size"sv));
+    EXPECT(writeback_requests < written_back);
+
+    // What made it to the disk must be what we wrote.
+    auto direct_fd = open(path, O_RDONLY | O_DIRECT);
+    EXPECT(direct_fd >= 0);
+    auto readback = MUST(ByteBuffer::create_zeroed(file_size));
+    EXPECT_EQ(read(direct_fd, readback.data(), readback.size()), static_cast<ssize_t>(file_size));
+    EXPECT_EQ(readback, data);
+
+    close(direct_fd);
+    close(fd);
+    unlink(path);
+}
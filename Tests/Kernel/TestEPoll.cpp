@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+static void write_byte(int fd)
+{
+    u8 byte = 0x42;
+    MUST(Core::System::write(fd, { &byte, 1 }));
+}
+
+static void read_byte(int fd)
+{
+    u8 byte = 0;
+    auto nread = MUST(Core::System::read(fd, { &byte, 1 }));
+    EXPECT_EQ(nread, 1u);
+}
+
+static void watch(int epoll_fd, int fd, u32 events, u64 data)
+{
+    epoll_event event {};
+    event.events = events;
+    event.data.u64 = data;
+    MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event));
+}
+
+TEST_CASE(level_triggered)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(EPOLL_CLOEXEC));
+    auto fds = MUST(Core::System::pipe2(0));
+    watch(epoll_fd, fds[0], EPOLLIN, 1234);
+
+    Array<epoll_event, 4> events;
+    EXPECT_EQ(MUST(Core::System::epoll_wait(epoll_fd, events, 0)), 0);
+
+    write_byte(fds[1]);
+    EXPECT_EQ(MUST(Core::System::epoll_wait(epoll_fd, events, 0)), 1);
+    EXPECT_EQ(events[0].events, EPOLLIN);
+    EXPECT_EQ(events[0].data.u64, 1234u);
+
+    // The pipe is still readable, so we must be told again.
+    EXPECT_EQ(MUST(Core::System::epoll_wait(epoll_fd, events, 0)), 1);
+
+    read_byte(fds[0]);
+    EXPECT_EQ(MUST(Core::System::epoll_wait(epoll_fd, events, 0)), 0);
+
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(edge_triggered)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    auto fds = MUST(Core::System::pipe2(0));
+    watch(epoll_fd, fds[0], EPOLLIN | EPOLLET, 1);
+
+    Array<epoll_event, 4> events;
+    write_byte(fds[1]);
+    EXPECT_EQ(MUST(Core::System::epoll_wait(epoll_fd, events, 0)), 1);
+
+    // Nothing changed since the last time we asked.
+    EXPECT_EQ(MUST(Core::System::epoll_wait(epoll_fd, events, 0)), 0);
+
+    write_byte(fds[1]);
+    EXPECT_EQ(MUST(Core::System::epoll_wait(epoll_fd, events, 0)), 1);
+
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(oneshot)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    auto fds = MUST(Core::System::pipe2(0));
+    watch(epoll_fd, fds[0], EPOLLIN | EPOLLONESHOT, 1);
+
+    Array<epoll_event, 4> events;
+    write_byte(fds[1]);
+    EXPECT_EQ(MUST(Core::System::epoll_wait(epoll_fd, events, 0)), 1);
+    EXPECT_EQ(MUST(Core::System::epoll_wait(epoll_fd, events, 0)), 0);
+
+    // Re-arming the entry reports the pending data again.
+    epoll_event event {};
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.u64 = 2;
+    MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fds[0], &event));
+    EXPECT_EQ(MUST(Core::System::epoll_wait(epoll_fd, events, 0)), 1);
+    EXPECT_EQ(events[0].data.u64, 2u);
+
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(batches_and_removal)
+{
+    static constexpr size_t pipe_count = 32;
+
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    Array<Array<int, 2>, pipe_count> pipes;
+    for (size_t i = 0; i < pipe_count; ++i) {
+        pipes[i] = MUST(Core::System::pipe2(0));
+        watch(epoll_fd, pipes[i][0], EPOLLIN, i);
+    }
+
+    // Only the ready half of the pipes should be reported, a few at a time.
+    for (size_t i = 0; i < pipe_count; i += 2)
+        write_byte(pipes[i][1]);
+
+    Array<epoll_event, 4> events;
+    size_t reported = 0;
+    for (;;) {
+        auto count = MUST(Core::System::epoll_wait(epoll_fd, events, 0));
+        if (count == 0)
+            break;
+        EXPECT(static_cast<size_t>(count) <= events.size());
+        for (int i = 0; i < count; ++i) {
+            EXPECT_EQ(events[i].data.u64 % 2, 0u);
+            read_byte(pipes[events[i].data.u64][0]);
+            ++reported;
+        }
+    }
+    EXPECT_EQ(reported, pipe_count / 2);
+
+    // Closing a watched file descriptor removes it from the interest list.
+    write_byte(pipes[0][1]);
+    MUST(Core::System::close(pipes[0][0]));
+    EXPECT_EQ(MUST(Core::System::epoll_wait(epoll_fd, events, 0)), 0);
+
+    // Removing it explicitly does so as well.
+    write_byte(pipes[2][1]);
+    MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipes[2][0], nullptr));
+    EXPECT_EQ(MUST(Core::System::epoll_wait(epoll_fd, events, 0)), 0);
+
+    for (size_t i = 1; i < pipe_count; ++i)
+        MUST(Core::System::close(pipes[i][0]));
+    for (auto& pipe : pipes)
+        MUST(Core::System::close(pipe[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+TEST_CASE(errors)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    auto fds = MUST(Core::System::pipe2(0));
+
+    epoll_event event {};
+    event.events = EPOLLIN;
+    EXPECT_EQ(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fds[0], &event).error().code(), ENOENT);
+    EXPECT_EQ(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fds[0], nullptr).error().code(), ENOENT);
+    EXPECT_EQ(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, epoll_fd, &event).error().code(), EINVAL);
+    EXPECT_EQ(Core::System::epoll_ctl(fds[0], EPOLL_CTL_ADD, fds[1], &event).error().code(), EINVAL);
+
+    MUST(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fds[0], &event));
+    EXPECT_EQ(Core::System::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fds[0], &event).error().code(), EEXIST);
+
+    Array<epoll_event, 1> events;
+    EXPECT_EQ(Core::System::epoll_wait(epoll_fd, events.span().trim(0), 0).error().code(), EINVAL);
+
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
+
+static void* write_after_delay(void* fd_pointer)
+{
+    usleep(50'000);
+    write_byte(*static_cast<int*>(fd_pointer));
+    return nullptr;
+}
+
+TEST_CASE(blocking_wait)
+{
+    auto epoll_fd = MUST(Core::System::epoll_create1(0));
+    auto fds = MUST(Core::System::pipe2(0));
+    watch(epoll_fd, fds[0], EPOLLIN, 7);
+
+    Array<epoll_event, 4> events;
+    EXPECT_EQ(MUST(Core::System::epoll_wait(epoll_fd, events, 10)), 0);
+
+    pthread_t thread;
+    EXPECT_EQ(pthread_create(&thread, nullptr, write_after_delay, &fds[1]), 0);
+    EXPECT_EQ(MUST(Core::System::epoll_wait(epoll_fd, events, -1)), 1);
+    EXPECT_EQ(events[0].data.u64, 7u);
+    EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+    MUST(Core::System::close(epoll_fd));
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObject.h>
+#include <LibCore/File.h>
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <pthread.h>
+
+static JsonObject memory_statistics()
+{
+    auto file = MUST(Core::File::open("/sys/kernel/memstat"sv, Core::File::OpenMode::Read));
+    auto json = MUST(JsonValue::from_string(MUST(file->read_until_eof())));
+    EXPECT(json.is_object());
+    return json.as_object();
+}
+
+static u64 counter(JsonObject const& statistics, StringView name)
+{
+    return statistics.get_u64(name).value();
+}
+
+static void* churn_kernel_heap(void*)
+{
+    // Every pipe comes with a handful of small kernel objects (descriptions, FIFO state, ...).
+    for (size_t i = 0; i < 2000; ++i) {
+        auto fds = MUST(Core::System::pipe2(0));
+        MUST(Core::System::close(fds[0]));
+        MUST(Core::System::close(fds[1]));
+    }
+    return nullptr;
+}
+
+TEST_CASE(most_small_allocations_do_not_take_the_kmalloc_lock)
+{
+    static constexpr size_t thread_count = 4;
+
+    auto before = memory_statistics();
+
+    Array<pthread_t, thread_count> threads;
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, churn_kernel_heap, nullptr), 0);
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    auto after = memory_statistics();
+
+    auto delta = [&](StringView name) { return counter(after, name) - counter(before, name); };
+    auto calls = delta("kmalloc_call_count"sv) + delta("kfree_call_count"sv);
+    auto cached_calls = delta("kmalloc_cached_call_count"sv) + delta("kfree_cached_call_count"sv);
+    auto lock_acquisitions = delta("kmalloc_lock_acquisition_count"sv);
+
+    EXPECT(calls > 0);
+    EXPECT(cached_calls <= calls);
+    EXPECT(cached_calls > calls / 2);
+    EXPECT(lock_acquisitions < calls / 2);
+}
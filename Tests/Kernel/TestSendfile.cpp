@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <LibCore/System.h>
+#include <LibTest/TestCase.h>
+#include <pthread.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int create_file_with_contents(ReadonlyBytes contents)
+{
+    char pattern[] = "/tmp/sendfile.XXXXXX";
+    auto fd = MUST(Core::System::mkstemp(pattern));
+    MUST(Core::System::unlink({ pattern, sizeof(pattern) - 1 }));
+    while (!contents.is_empty()) {
+        auto nwritten = MUST(Core::System::write(fd, contents));
+        contents = contents.slice(nwritten);
+    }
+    MUST(Core::System::lseek(fd, 0, SEEK_SET));
+    return fd;
+}
+
+static ByteBuffer make_pattern(size_t size)
+{
+    auto buffer = MUST(ByteBuffer::create_uninitialized(size));
+    for (size_t i = 0; i < size; ++i)
+        buffer[i] = static_cast<u8>(i * 7 + (i >> 12));
+    return buffer;
+}
+
+static ByteBuffer read_exactly(int fd, size_t size)
+{
+    auto buffer = MUST(ByteBuffer::create_uninitialized(size));
+    size_t nread = 0;
+    while (nread < size) {
+        auto n = MUST(Core::System::read(fd, buffer.bytes().slice(nread)));
+        VERIFY(n > 0);
+        nread += n;
+    }
+    return buffer;
+}
+
+TEST_CASE(explicit_offset)
+{
+    auto contents = make_pattern(3000);
+    auto in_fd = create_file_with_contents(contents);
+    auto fds = MUST(Core::System::pipe2(0));
+
+    off_t offset = 1000;
+    EXPECT_EQ(sendfile(fds[1], in_fd, &offset, 1500), 1500);
+    EXPECT_EQ(offset, 2500);
+    auto received = read_exactly(fds[0], 1500);
+    EXPECT_EQ(received.bytes(), contents.bytes().slice(1000, 1500));
+
+    // The file offset is left alone when one is passed in.
+    EXPECT_EQ(MUST(Core::System::lseek(in_fd, 0, SEEK_CUR)), 0);
+
+    // We stop at the end of the file.
+    EXPECT_EQ(sendfile(fds[1], in_fd, &offset, 1000), 500);
+    EXPECT_EQ(offset, 3000);
+    EXPECT_EQ(sendfile(fds[1], in_fd, &offset, 1000), 0);
+    received = read_exactly(fds[0], 500);
+    EXPECT_EQ(received.bytes(), contents.bytes().slice(2500));
+
+    MUST(Core::System::close(in_fd));
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+}
+
+TEST_CASE(file_offset)
+{
+    auto contents = make_pattern(4096);
+    auto in_fd = create_file_with_contents(contents);
+    auto fds = MUST(Core::System::pipe2(0));
+
+    MUST(Core::System::lseek(in_fd, 96, SEEK_SET));
+    EXPECT_EQ(sendfile(fds[1], in_fd, nullptr, 1000), 1000);
+    EXPECT_EQ(MUST(Core::System::lseek(in_fd, 0, SEEK_CUR)), 1096);
+    auto received = read_exactly(fds[0], 1000);
+    EXPECT_EQ(received.bytes(), contents.bytes().slice(96, 1000));
+
+    MUST(Core::System::close(in_fd));
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+}
+
+TEST_CASE(errors)
+{
+    auto in_fd = create_file_with_contents("hello"sv.bytes());
+    auto fds = MUST(Core::System::pipe2(0));
+
+    // The input has to be something we can read at an offset.
+    off_t offset = 0;
+    EXPECT_EQ(sendfile(fds[1], fds[0], &offset, 1), -1);
+    EXPECT_EQ(errno, ESPIPE);
+
+    EXPECT_EQ(sendfile(fds[0], in_fd, &offset, 1), -1);
+    EXPECT_EQ(errno, EBADF);
+
+    EXPECT_EQ(sendfile(fds[1], -1, &offset, 1), -1);
+    EXPECT_EQ(errno, EBADF);
+
+    offset = -1;
+    EXPECT_EQ(sendfile(fds[1], in_fd, &offset, 1), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    MUST(Core::System::close(in_fd));
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+}
+
+static constexpr size_t benchmark_file_size = 16 * MiB;
+static constexpr size_t benchmark_iterations = 8;
+
+static void* drain_socket(void* fd_pointer)
+{
+    auto fd = *static_cast<int*>(fd_pointer);
+    u8 buffer[64 * KiB];
+    size_t total = 0;
+    while (total < benchmark_file_size * benchmark_iterations) {
+        auto nread = MUST(Core::System::read(fd, { buffer, sizeof(buffer) }));
+        VERIFY(nread > 0);
+        total += nread;
+    }
+    return nullptr;
+}
+
+template<typename Callback>
+static void run_benchmark(Callback send_whole_file)
+{
+    auto in_fd = create_file_with_contents(make_pattern(benchmark_file_size));
+    int fds[2];
+    MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, fds));
+
+    pthread_t thread;
+    EXPECT_EQ(pthread_create(&thread, nullptr, drain_socket, &fds[1]), 0);
+    for (size_t i = 0; i < benchmark_iterations; ++i)
+        send_whole_file(fds[0], in_fd);
+    EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    MUST(Core::System::close(in_fd));
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+}
+
+BENCHMARK_CASE(send_file_with_read_and_write)
+{
+    run_benchmark([](int out_fd, int in_fd) {
+        // This is what WebServer used to do for every file it served.
+        u8 buffer[PAGE_SIZE];
+        off_t offset = 0;
+        while (static_cast<size_t>(offset) < benchmark_file_size) {
+            auto nread = pread(in_fd, buffer, sizeof(buffer), offset);
+            VERIFY(nread > 0);
+            ReadonlyBytes bytes { buffer, static_cast<size_t>(nread) };
+            while (!bytes.is_empty())
+                bytes = bytes.slice(MUST(Core::System::write(out_fd, bytes)));
+            offset += nread;
+        }
+    });
+}
+
+BENCHMARK_CASE(send_file_with_sendfile)
+{
+    run_benchmark([](int out_fd, int in_fd) {
+        off_t offset = 0;
+        while (static_cast<size_t>(offset) < benchmark_file_size)
+            VERIFY(MUST(Core::System::sendfile(out_fd, in_fd, offset, benchmark_file_size - offset)) > 0);
+    });
+}
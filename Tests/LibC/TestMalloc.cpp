@@ -4,11 +4,14 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <LibTest/TestCase.h>
 
 #include <errno.h>
 #include <mallocdefs.h>
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 
 TEST_CASE(malloc_limits)
 {
@@ -38,3 +41,77 @@ TEST_CASE(malloc_limits)
         return Test::Crash::Failure::DidNotCrash;
     });
 }
+
+static constexpr size_t thread_count = 4;
+static constexpr size_t allocations_per_round = 256;
+
+struct ChurnContext {
+    size_t rounds { 0 };
+    Array<void*, allocations_per_round> leftovers {};
+};
+
+static void* churn_small_allocations(void* argument)
+{
+    auto& context = *static_cast<ChurnContext*>(argument);
+    Array<void*, allocations_per_round> pointers;
+    for (size_t round = 0; round < context.rounds; ++round) {
+        for (size_t i = 0; i < allocations_per_round; ++i) {
+            pointers[i] = malloc(8 + (i % 6) * 16);
+            VERIFY(pointers[i]);
+            memset(pointers[i], 0x42, 8);
+        }
+        for (auto* pointer : pointers)
+            free(pointer);
+    }
+
+    // Leave some allocations behind for the main thread to free.
+    for (size_t i = 0; i < allocations_per_round; ++i)
+        context.leftovers[i] = malloc(8 + (i % 6) * 16);
+    return nullptr;
+}
+
+static void run_churn_threads(size_t rounds)
+{
+    Array<pthread_t, thread_count> threads;
+    Array<ChurnContext, thread_count> contexts;
+    for (size_t i = 0; i < thread_count; ++i) {
+        contexts[i].rounds = rounds;
+        EXPECT_EQ(pthread_create(&threads[i], nullptr, churn_small_allocations, &contexts[i]), 0);
+    }
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    for (auto& context : contexts) {
+        for (auto* pointer : context.leftovers) {
+            EXPECT_NE(pointer, nullptr);
+            free(pointer);
+        }
+    }
+}
+
+TEST_CASE(small_allocations_from_many_threads)
+{
+    serenity_malloc_stats before {};
+    serenity_get_malloc_stats(&before);
+
+    run_churn_threads(64);
+
+    serenity_malloc_stats after {};
+    serenity_get_malloc_stats(&after);
+
+    auto malloc_calls = after.malloc_calls - before.malloc_calls;
+    auto free_calls = after.free_calls - before.free_calls;
+    EXPECT(malloc_calls >= thread_count * 65 * allocations_per_round);
+    EXPECT(free_calls >= thread_count * 65 * allocations_per_round);
+
+    // Almost all of the allocations should have been served without taking a lock.
+    auto malloc_hits = after.thread_cache_malloc_hits - before.thread_cache_malloc_hits;
+    auto free_hits = after.thread_cache_free_hits - before.thread_cache_free_hits;
+    EXPECT(malloc_hits > malloc_calls / 2);
+    EXPECT(free_hits > free_calls / 2);
+}
+
+BENCHMARK_CASE(small_allocation_churn_from_many_threads)
+{
+    run_churn_threads(4096);
+}
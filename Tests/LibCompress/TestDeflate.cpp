@@ -156,6 +156,58 @@ TEST_CASE(deflate_round_trip_compress_large)
     EXPECT(uncompressed == original);
 }
 
+TEST_CASE(deflate_round_trip_compress_all_levels)
+{
+    // Text interrupted by random data spanning several blocks, so that the back references reach into the previous
+    // blocks and the higher levels have a reason to split blocks where the statistics of the data change.
+    auto original = ByteBuffer::create_uninitialized(Compress::DeflateCompressor::block_size * 5 + 123).release_value();
+    for (size_t i = 0; i < original.size(); ++i)
+        original[i] = "The quick brown fox jumps over the lazy dog. "[i % 45] ^ ((i / 4099) & 0x3);
+    fill_with_random(original.bytes().slice(Compress::DeflateCompressor::block_size + 2000, 20000));
+
+    for (auto level : { Compress::DeflateCompressor::CompressionLevel::STORE, Compress::DeflateCompressor::CompressionLevel::FAST, Compress::DeflateCompressor::CompressionLevel::GOOD, Compress::DeflateCompressor::CompressionLevel::GREAT, Compress::DeflateCompressor::CompressionLevel::BEST }) {
+        auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original, level));
+        auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+        EXPECT(uncompressed == original);
+    }
+}
+
+TEST_CASE(deflate_round_trip_compress_in_parallel)
+{
+    // Repetitive data whose back references cross the boundaries between the chunks compressed on different threads.
+    auto original = ByteBuffer::create_uninitialized(Compress::DeflateCompressor::parallel_chunk_size * 3 + 1234).release_value();
+    for (size_t i = 0; i < original.size(); ++i)
+        original[i] = "deflate"[i % 7] ^ ((i / 4099) & 0xf);
+
+    size_t chunk_bytes_seen = 0;
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all_in_parallel(original, Compress::DeflateCompressor::CompressionLevel::FAST, 3, [&](size_t, ReadonlyBytes chunk) {
+        AK::atomic_fetch_add(&chunk_bytes_seen, chunk.size());
+    }));
+    EXPECT_EQ(chunk_bytes_seen, original.size());
+
+    auto uncompressed = TRY_OR_FAIL(Compress::DeflateDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+}
+
+TEST_CASE(deflate_decompress_in_small_reads)
+{
+    // Repetitive data with back references across several window slides, read in chunks that do not line up with them.
+    auto original = ByteBuffer::create_uninitialized(300 * KiB).release_value();
+    for (size_t i = 0; i < original.size(); ++i)
+        original[i] = "deflate"[i % 7] ^ ((i / 4099) & 0xf);
+    auto compressed = TRY_OR_FAIL(Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST));
+
+    FixedMemoryStream memory_stream { compressed.bytes() };
+    LittleEndianInputBitStream bit_stream { MaybeOwned<Stream>(memory_stream) };
+    auto deflate_stream = TRY_OR_FAIL(Compress::DeflateDecompressor::construct(MaybeOwned<LittleEndianInputBitStream>(bit_stream)));
+
+    ByteBuffer uncompressed;
+    Array<u8, 1000> buffer;
+    while (!deflate_stream->is_eof())
+        uncompressed.append(TRY_OR_FAIL(deflate_stream->read_some(buffer)));
+    EXPECT(uncompressed == original);
+}
+
 TEST_CASE(deflate_compress_literals)
 {
     // This byte array is known to not produce any back references with our lz77 implementation even at the highest compression settings
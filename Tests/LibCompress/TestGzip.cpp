@@ -94,6 +94,15 @@ TEST_CASE(gzip_round_trip)
     EXPECT(uncompressed == original);
 }
 
+TEST_CASE(gzip_round_trip_in_parallel)
+{
+    auto original = ByteBuffer::create_zeroed(Compress::DeflateCompressor::parallel_chunk_size * 2 + 1024).release_value();
+    fill_with_random(original.bytes().slice(Compress::DeflateCompressor::parallel_chunk_size));
+    auto compressed = TRY_OR_FAIL(Compress::GzipCompressor::compress_all(original, 2));
+    auto uncompressed = TRY_OR_FAIL(Compress::GzipDecompressor::decompress_all(compressed));
+    EXPECT(uncompressed == original);
+}
+
 TEST_CASE(gzip_truncated_uncompressed_block)
 {
     Array<u8, 38> const compressed {
@@ -8,6 +8,7 @@
 
 #include <AK/Array.h>
 #include <AK/MemoryStream.h>
+#include <LibCompress/Deflate.h>
 #include <LibCompress/Zlib.h>
 
 TEST_CASE(zlib_decompress_simple)
@@ -46,6 +47,19 @@ TEST_CASE(zlib_compress_simple)
     EXPECT(freshly_pressed.value().bytes() == compressed.span());
 }
 
+TEST_CASE(zlib_round_trip_in_parallel)
+{
+    auto original = ByteBuffer::create_uninitialized(Compress::DeflateCompressor::parallel_chunk_size * 2 + 1024).release_value();
+    for (size_t i = 0; i < original.size(); ++i)
+        original[i] = "zlib"[i % 4] + (i / 1000);
+
+    auto compressed = TRY_OR_FAIL(Compress::ZlibCompressor::compress_all(original, Compress::ZlibCompressionLevel::Default, 2));
+    auto stream = make<FixedMemoryStream>(compressed.bytes());
+    auto decompressor = TRY_OR_FAIL(Compress::ZlibDecompressor::create(move(stream)));
+    auto decompressed = TRY_OR_FAIL(decompressor->read_until_eof());
+    EXPECT(decompressed == original);
+}
+
 TEST_CASE(zlib_decompress_with_missing_end_bits)
 {
     // This test case has been extracted from compressed PNG data of `/res/icons/16x16/app-masterword.png`.
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/EventLoop.h>
+#include <LibCore/Notifier.h>
+#include <LibCore/System.h>
+#include <LibCore/Timer.h>
+#include <LibTest/TestCase.h>
+
+static void write_byte(int fd)
+{
+    u8 byte = 0x42;
+    MUST(Core::System::write(fd, { &byte, 1 }));
+}
+
+static NonnullRefPtr<Core::Timer> make_reaper()
+{
+    return Core::Timer::create_single_shot(1000, [] {
+        warnln("Timed out waiting for a notifier to fire!");
+        VERIFY_NOT_REACHED();
+    });
+}
+
+TEST_CASE(read_notifier)
+{
+    Core::EventLoop event_loop;
+    auto fds = MUST(Core::System::pipe2(O_CLOEXEC));
+
+    auto notifier = Core::Notifier::construct(fds[0], Core::Notifier::Type::Read);
+    notifier->on_activation = [&] {
+        u8 byte = 0;
+        MUST(Core::System::read(fds[0], { &byte, 1 }));
+        EXPECT_EQ(byte, 0x42);
+        event_loop.quit(0);
+    };
+
+    auto reaper = make_reaper();
+    reaper->start();
+    write_byte(fds[1]);
+    EXPECT_EQ(event_loop.exec(), 0);
+
+    notifier->close();
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+}
+
+TEST_CASE(many_notifiers_only_ready_ones_fire)
+{
+    static constexpr size_t pipe_count = 64;
+
+    Core::EventLoop event_loop;
+    Vector<Array<int, 2>> pipes;
+    Vector<NonnullRefPtr<Core::Notifier>> notifiers;
+    size_t activations = 0;
+
+    for (size_t i = 0; i < pipe_count; ++i) {
+        auto fds = MUST(Core::System::pipe2(O_CLOEXEC));
+        pipes.append(fds);
+        auto notifier = Core::Notifier::construct(fds[0], Core::Notifier::Type::Read);
+        notifier->on_activation = [&, i, fd = fds[0]] {
+            EXPECT_EQ(i % 8, 0u);
+            u8 byte = 0;
+            MUST(Core::System::read(fd, { &byte, 1 }));
+            if (++activations == pipe_count / 8)
+                event_loop.quit(0);
+        };
+        notifiers.append(move(notifier));
+    }
+
+    for (size_t i = 0; i < pipe_count; i += 8)
+        write_byte(pipes[i][1]);
+
+    auto reaper = make_reaper();
+    reaper->start();
+    EXPECT_EQ(event_loop.exec(), 0);
+    EXPECT_EQ(activations, pipe_count / 8);
+
+    for (auto& notifier : notifiers)
+        notifier->close();
+    for (auto& fds : pipes) {
+        MUST(Core::System::close(fds[0]));
+        MUST(Core::System::close(fds[1]));
+    }
+}
+
+TEST_CASE(read_and_write_notifiers_on_the_same_fd)
+{
+    Core::EventLoop event_loop;
+    int fds[2];
+    MUST(Core::System::socketpair(AF_LOCAL, SOCK_STREAM, 0, fds));
+
+    bool did_write = false;
+    bool did_read = false;
+
+    auto write_notifier = Core::Notifier::construct(fds[0], Core::Notifier::Type::Write);
+    write_notifier->on_activation = [&] {
+        write_notifier->set_enabled(false);
+        write_byte(fds[0]);
+        did_write = true;
+    };
+
+    auto read_notifier = Core::Notifier::construct(fds[0], Core::Notifier::Type::Read);
+    read_notifier->on_activation = [&] {
+        u8 byte = 0;
+        MUST(Core::System::read(fds[0], { &byte, 1 }));
+        did_read = true;
+        event_loop.quit(0);
+    };
+
+    // Echo whatever arrives on the other end back to us.
+    auto echo_notifier = Core::Notifier::construct(fds[1], Core::Notifier::Type::Read);
+    echo_notifier->on_activation = [&] {
+        u8 byte = 0;
+        MUST(Core::System::read(fds[1], { &byte, 1 }));
+        MUST(Core::System::write(fds[1], { &byte, 1 }));
+    };
+
+    auto reaper = make_reaper();
+    reaper->start();
+    EXPECT_EQ(event_loop.exec(), 0);
+    EXPECT(did_write);
+    EXPECT(did_read);
+
+    write_notifier->close();
+    read_notifier->close();
+    echo_notifier->close();
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+}
+
+TEST_CASE(disabled_notifier_does_not_fire)
+{
+    Core::EventLoop event_loop;
+    auto fds = MUST(Core::System::pipe2(O_CLOEXEC));
+
+    auto notifier = Core::Notifier::construct(fds[0], Core::Notifier::Type::Read);
+    notifier->on_activation = [] {
+        FAIL("Disabled notifier fired");
+    };
+    notifier->set_enabled(false);
+    write_byte(fds[1]);
+
+    auto timer = Core::Timer::create_single_shot(50, [&] {
+        event_loop.quit(0);
+    });
+    timer->start();
+    EXPECT_EQ(event_loop.exec(), 0);
+
+    notifier->close();
+    MUST(Core::System::close(fds[0]));
+    MUST(Core::System::close(fds[1]));
+}
+
+TEST_CASE(regular_file_is_always_ready)
+{
+    Core::EventLoop event_loop;
+    char pattern[] = "/tmp/notifier.XXXXXX";
+    auto fd = MUST(Core::System::mkstemp(pattern));
+    MUST(Core::System::unlink({ pattern, sizeof(pattern) - 1 }));
+
+    auto notifier = Core::Notifier::construct(fd, Core::Notifier::Type::Read);
+    notifier->on_activation = [&] {
+        event_loop.quit(0);
+    };
+
+    auto reaper = make_reaper();
+    reaper->start();
+    EXPECT_EQ(event_loop.exec(), 0);
+
+    notifier->close();
+    MUST(Core::System::close(fd));
+}
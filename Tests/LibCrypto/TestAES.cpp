@@ -336,6 +336,38 @@ TEST_CASE(test_AES_CTR_128bit_decrypt_16bytes)
     // If encryption works, then decryption works, too.
 }
 
+// Long inputs are encrypted several blocks at a time, which has to agree with encrypting them one block at a time.
+TEST_CASE(test_AES_CTR_long_input_matches_block_by_block_encryption)
+{
+    u8 key[] {
+        0x77, 0x6b, 0xef, 0xf2, 0x85, 0x1d, 0xb0, 0x6f, 0x4c, 0x8a, 0x05, 0x42, 0xc8, 0x69, 0x6f, 0x6c, 0x6a, 0x81, 0xaf, 0x1e, 0xec, 0x96, 0xb4, 0xd3, 0x7f, 0xc1, 0xd6, 0x89, 0xe6, 0xc1, 0xc1, 0x04
+    };
+    // The counter wraps around in the middle of the input.
+    u8 ivec[] {
+        0x00, 0x00, 0x00, 0x60, 0xdb, 0x56, 0x72, 0xc9, 0x7a, 0xa8, 0xf0, 0xb2, 0xff, 0xff, 0xff, 0xfa
+    };
+
+    auto in = ByteBuffer::create_uninitialized(16 * 21 + 5).release_value();
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = i * 7;
+
+    Crypto::Cipher::AESCipher::CTRMode cipher(AS_BB(key), 256, Crypto::Cipher::Intent::Encryption);
+    auto out = ByteBuffer::create_zeroed(in.size()).release_value();
+    auto out_bytes = out.bytes();
+    cipher.encrypt(in, out_bytes, AS_BB(ivec));
+
+    auto expected = ByteBuffer::create_zeroed(in.size()).release_value();
+    u8 next_ivec[16];
+    __builtin_memcpy(next_ivec, ivec, sizeof(ivec));
+    for (size_t offset = 0; offset < in.size(); offset += 16) {
+        auto block_out = expected.bytes().slice(offset);
+        Bytes ivec_out { next_ivec, sizeof(next_ivec) };
+        cipher.encrypt(in.bytes().slice(offset, min<size_t>(16, in.size() - offset)), block_out, AS_BB(next_ivec), &ivec_out);
+    }
+
+    EXPECT_EQ(out, expected);
+}
+
 BENCHMARK_CASE(GCM)
 {
     Crypto::Authentication::GHash ghash("WellHelloFriends"_b);
@@ -465,3 +497,27 @@ TEST_CASE(test_AES_GCM_128bit_decrypt_multiple_blocks_with_aad)
     EXPECT(memcmp(result_pt, out.data(), out.size()) == 0);
     EXPECT_EQ(consistency, Crypto::VerificationConsistency::Consistent);
 }
+
+TEST_CASE(test_AES_GCM_128bit_encrypt_long_input_with_aad)
+{
+    Crypto::Cipher::AESCipher::GCMMode cipher("\xfe\xff\xe9\x92\x86\x65\x73\x1c\x6d\x6a\x8f\x94\x67\x30\x83\x08"_b, 128, Crypto::Cipher::Intent::Encryption);
+    u8 result_tag[] { 0x50, 0x4a, 0xf6, 0x9d, 0xa5, 0x83, 0x87, 0xcf, 0x12, 0x6c, 0xc0, 0x86, 0x11, 0x34, 0x82, 0x27 };
+
+    auto aad = ByteBuffer::create_uninitialized(83).release_value();
+    for (size_t i = 0; i < aad.size(); ++i)
+        aad[i] = i * 3;
+    auto in = ByteBuffer::create_uninitialized(1000).release_value();
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = i * 7;
+
+    auto tag = ByteBuffer::create_uninitialized(16).release_value();
+    auto out = ByteBuffer::create_uninitialized(in.size()).release_value();
+    auto out_bytes = out.bytes();
+    cipher.encrypt(in, out_bytes, "\xca\xfe\xba\xbe\xfa\xce\xdb\xad\xde\xca\xf8\x88\x00\x00\x00\x00"_b, aad, tag);
+    EXPECT(memcmp(result_tag, tag.data(), tag.size()) == 0);
+
+    auto decrypted = ByteBuffer::create_uninitialized(in.size()).release_value();
+    auto consistency = cipher.decrypt(out, decrypted.bytes(), "\xca\xfe\xba\xbe\xfa\xce\xdb\xad\xde\xca\xf8\x88\x00\x00\x00\x00"_b, aad, tag);
+    EXPECT_EQ(consistency, Crypto::VerificationConsistency::Consistent);
+    EXPECT_EQ(decrypted, in);
+}
@@ -139,3 +139,33 @@ TEST_CASE(test_vector_3)
     auto expected = ReadonlyBytes { ciphertext, 127 };
     EXPECT_EQ(result, expected);
 }
+
+// Long inputs are processed several blocks at a time, which has to agree with generating the key stream one block at a time.
+TEST_CASE(long_input_matches_block_by_block_encryption)
+{
+    u8 key[32] {};
+    for (size_t i = 0; i < sizeof(key); ++i)
+        key[i] = i;
+    u8 nonce[12] { 0, 0, 0, 9, 0, 0, 0, 0x4a, 0, 0, 0, 0 };
+
+    // Start close to the end of the 32-bit block counter to also exercise the carry into the next word.
+    u32 initial_block_counter = 0xfffffffa;
+
+    auto plaintext = MUST(ByteBuffer::create_uninitialized(64 * 13 + 7));
+    for (size_t i = 0; i < plaintext.size(); ++i)
+        plaintext[i] = i * 7;
+
+    auto result = MUST(ByteBuffer::create_uninitialized(plaintext.size()));
+    auto output = result.bytes();
+    Crypto::Cipher::ChaCha20 cipher(ReadonlyBytes { key, 32 }, ReadonlyBytes { nonce, 12 }, initial_block_counter);
+    cipher.encrypt(plaintext, output);
+
+    auto expected = MUST(ByteBuffer::create_uninitialized(plaintext.size()));
+    Crypto::Cipher::ChaCha20 block_cipher(ReadonlyBytes { key, 32 }, ReadonlyBytes { nonce, 12 }, initial_block_counter);
+    for (size_t offset = 0; offset < plaintext.size(); offset += 64) {
+        auto block_output = expected.bytes().slice(offset);
+        block_cipher.encrypt(plaintext.bytes().slice(offset, min<size_t>(64, plaintext.size() - offset)), block_output);
+    }
+
+    EXPECT_EQ(result, expected);
+}
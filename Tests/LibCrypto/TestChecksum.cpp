@@ -63,3 +63,81 @@ TEST_CASE(test_crc32)
     do_test("The quick brown fox jumps over the lazy dog"sv.bytes(), 0x414FA339);
     do_test("various CRC algorithms input data"sv.bytes(), 0x9BD366AE);
 }
+
+static ByteBuffer make_checksum_test_input(size_t size)
+{
+    auto buffer = MUST(ByteBuffer::create_uninitialized(size));
+    for (size_t i = 0; i < size; ++i)
+        buffer[i] = static_cast<u8>(i * 7 + i / 256);
+    return buffer;
+}
+
+TEST_CASE(test_crc32_long_inputs)
+{
+    // Lengths around the thresholds of the folding implementations, which also leave various unfolded tails.
+    auto do_test = [](size_t size, u32 expected_result) {
+        auto input = make_checksum_test_input(size);
+        EXPECT_EQ(Crypto::Checksum::CRC32(input).digest(), expected_result);
+
+        // The result must not depend on how the input is split across updates.
+        Crypto::Checksum::CRC32 crc32;
+        for (size_t offset = 0, chunk_size = 1; offset < size; offset += chunk_size, chunk_size = chunk_size * 3 + 1)
+            crc32.update(input.bytes().slice(offset, min(chunk_size, size - offset)));
+        EXPECT_EQ(crc32.digest(), expected_result);
+    };
+
+    do_test(63, 0xfd395ff8);
+    do_test(64, 0xd324a7d4);
+    do_test(100, 0x821d3e85);
+    do_test(255, 0x89b9aecb);
+    do_test(256, 0x1a5c07a3);
+    do_test(1000, 0x668f073d);
+    do_test(4097, 0x839ac3a9);
+    do_test(100003, 0x0b697026);
+}
+
+TEST_CASE(test_crc32_combine)
+{
+    auto input = make_checksum_test_input(100003);
+    auto expected_result = Crypto::Checksum::CRC32(input).digest();
+
+    for (size_t split : { 0uz, 1uz, 64uz, 1000uz, 50000uz, 100003uz }) {
+        auto first = Crypto::Checksum::CRC32(input.bytes().trim(split)).digest();
+        auto second = Crypto::Checksum::CRC32(input.bytes().slice(split)).digest();
+        EXPECT_EQ(Crypto::Checksum::CRC32::combine(first, second, input.size() - split), expected_result);
+    }
+}
+
+TEST_CASE(test_adler32_long_inputs)
+{
+    auto do_test = [](size_t size, u32 expected_result) {
+        auto input = make_checksum_test_input(size);
+        EXPECT_EQ(Crypto::Checksum::Adler32(input).digest(), expected_result);
+
+        Crypto::Checksum::Adler32 adler32;
+        for (size_t offset = 0, chunk_size = 1; offset < size; offset += chunk_size, chunk_size = chunk_size * 3 + 1)
+            adler32.update(input.bytes().slice(offset, min(chunk_size, size - offset)));
+        EXPECT_EQ(adler32.digest(), expected_result);
+    };
+
+    do_test(63, 0x14ac1b68);
+    do_test(64, 0x30cd1c21);
+    do_test(100, 0x8eb22e5b);
+    do_test(255, 0x8a837e88);
+    do_test(256, 0x0a137f81);
+    do_test(1000, 0x379eedfc);
+    do_test(4097, 0x3eadf87a);
+    do_test(100003, 0xaaa69db6);
+}
+
+TEST_CASE(test_adler32_combine)
+{
+    auto input = make_checksum_test_input(100003);
+    auto expected_result = Crypto::Checksum::Adler32(input).digest();
+
+    for (size_t split : { 0uz, 1uz, 64uz, 1000uz, 50000uz, 100003uz }) {
+        auto first = Crypto::Checksum::Adler32(input.bytes().trim(split)).digest();
+        auto second = Crypto::Checksum::Adler32(input.bytes().slice(split)).digest();
+        EXPECT_EQ(Crypto::Checksum::Adler32::combine(first, second, input.size() - split), expected_result);
+    }
+}
@@ -37,6 +37,18 @@ TEST_CASE(test_BLAKE2b_hash_empty_string)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::BLAKE2b::digest_size()) == 0);
 }
 
+TEST_CASE(test_BLAKE2b_hash_multiple_blocks)
+{
+    u8 result[] {
+        0xb4, 0x9d, 0xc7, 0xbf, 0x92, 0x8d, 0x7d, 0xee, 0x87, 0x9f, 0xaf, 0xc6, 0x4c, 0x1c, 0x93, 0x08, 0x88, 0x10, 0xac, 0xc1, 0xf4, 0xa0, 0x22, 0x64, 0xc4, 0xc0, 0x98, 0x09, 0xc0, 0xf3, 0xdb, 0xc7, 0x71, 0xe2, 0x5e, 0x2d, 0xed, 0xce, 0x3d, 0xbb, 0xc0, 0x64, 0x0d, 0xa1, 0x4a, 0xf9, 0xfe, 0x42, 0xfb, 0x42, 0xb0, 0x2c, 0x9f, 0xdf, 0xf7, 0x01, 0xb8, 0x17, 0xf2, 0x21, 0x92, 0xb7, 0xb2, 0xdb
+    };
+    u8 input[1000];
+    for (size_t i = 0; i < sizeof(input); ++i)
+        input[i] = static_cast<u8>(i * 7);
+    auto digest = Crypto::Hash::BLAKE2b::hash(input, sizeof(input));
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::BLAKE2b::digest_size()) == 0);
+}
+
 TEST_CASE(test_BLAKE2b_consecutive_multiple_updates)
 {
     u8 result[] {
@@ -241,6 +253,31 @@ TEST_CASE(test_SHA256_hash_split_into_blocks)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA256_hash_many)
+{
+    // More messages than there are lanes, with lengths around the padding boundaries.
+    constexpr size_t message_sizes[] { 0, 1, 55, 56, 63, 64, 65, 119, 120, 128, 1000, 3, 4096, 200, 0, 64 };
+    Vector<ByteBuffer> buffers;
+    Vector<ReadonlyBytes> messages;
+    for (size_t i = 0; i < array_size(message_sizes); ++i) {
+        auto buffer = MUST(ByteBuffer::create_uninitialized(message_sizes[i]));
+        for (size_t j = 0; j < buffer.size(); ++j)
+            buffer[j] = static_cast<u8>(i * 31 + j);
+        buffers.append(move(buffer));
+    }
+    for (auto& buffer : buffers)
+        messages.append(buffer.bytes());
+
+    Vector<Crypto::Hash::SHA256::DigestType> digests;
+    digests.resize(messages.size());
+    Crypto::Hash::SHA256::hash_many(messages, digests);
+
+    for (size_t i = 0; i < messages.size(); ++i) {
+        auto expected = Crypto::Hash::SHA256::hash(messages[i]);
+        EXPECT_EQ(expected.bytes(), digests[i].bytes());
+    }
+}
+
 TEST_CASE(test_SHA384_name)
 {
     Crypto::Hash::SHA384 sha;
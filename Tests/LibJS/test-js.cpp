@@ -80,6 +80,29 @@ TESTJS_GLOBAL_FUNCTION(mark_as_garbage, markAsGarbage)
     return JS::js_undefined();
 }
 
+TESTJS_GLOBAL_FUNCTION(start_incremental_gc, startIncrementalGC, 0)
+{
+    vm.heap().start_incremental_collection_for_testing();
+    return JS::js_undefined();
+}
+
+TESTJS_GLOBAL_FUNCTION(step_incremental_gc, stepIncrementalGC, 1)
+{
+    auto cell_count = TRY(vm.argument(0).to_index(vm));
+    return JS::Value(vm.heap().run_incremental_marking_slice_for_testing(cell_count));
+}
+
+TESTJS_GLOBAL_FUNCTION(finish_incremental_gc, finishIncrementalGC, 0)
+{
+    vm.heap().finish_incremental_collection_for_testing();
+    return JS::js_undefined();
+}
+
+TESTJS_GLOBAL_FUNCTION(count_write_barrier_violations, countWriteBarrierViolations, 0)
+{
+    return JS::Value(vm.heap().count_write_barrier_violations());
+}
+
 TESTJS_GLOBAL_FUNCTION(detach_array_buffer, detachArrayBuffer)
 {
     auto array_buffer = vm.argument(0);
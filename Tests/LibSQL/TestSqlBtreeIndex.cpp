@@ -317,3 +317,38 @@ TEST_CASE(btree_scan_50_keys)
 {
     insert_into_and_scan_btree(50);
 }
+
+TEST_CASE(btree_read_back_three_levels)
+{
+    // Enough keys for the tree to grow interior nodes below the root, which are read back from disk on lookup
+    constexpr int num_keys = 1000;
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    {
+        auto heap = MUST(SQL::Heap::create("/tmp/test.db"));
+        TRY_OR_FAIL(heap->open());
+        SQL::Serializer serializer(heap);
+        auto btree = setup_btree(serializer);
+
+        for (auto ix = 0; ix < num_keys; ix++) {
+            SQL::Key k(btree->descriptor());
+            k[0] = (ix * 7) % num_keys;
+            k.set_block_index(ix + 1);
+            btree->insert(k);
+        }
+    }
+
+    {
+        auto heap = MUST(SQL::Heap::create("/tmp/test.db"));
+        TRY_OR_FAIL(heap->open());
+        SQL::Serializer serializer(heap);
+        auto btree = setup_btree(serializer);
+
+        for (auto ix = 0; ix < num_keys; ix++) {
+            SQL::Key k(btree->descriptor());
+            k[0] = (ix * 7) % num_keys;
+            auto pointer_opt = btree->get(k);
+            VERIFY(pointer_opt.has_value());
+            EXPECT_EQ(pointer_opt.value(), static_cast<u32>(ix + 1));
+        }
+    }
+}
@@ -192,3 +192,62 @@ TEST_CASE(heap_free_storage)
     auto new_heap_size = MUST(heap->file_size_in_bytes());
     EXPECT(new_heap_size <= heap_size);
 }
+
+TEST_CASE(heap_replay_write_ahead_log)
+{
+    ScopeGuard guard([]() { MUST(Core::System::unlink(db_path)); });
+
+    StringBuilder builder;
+    MUST(builder.try_append_repeated('x', SQL::Block::DATA_SIZE * 4));
+    auto long_string = builder.string_view();
+
+    // Commit some storage, and "crash" before the write-ahead log is checkpointed
+    auto heap = create_heap();
+    auto storage_block_id = heap->request_new_block_index();
+    TRY_OR_FAIL(heap->write_storage(storage_block_id, long_string.bytes()));
+    MUST(heap->flush());
+    (void)heap.leak_ref();
+
+    // Leave a partially written commit at the end of the log
+    {
+        auto wal_file = MUST(Core::File::open(ByteString::formatted("{}-wal", db_path), Core::File::OpenMode::Write | Core::File::OpenMode::Append));
+        MUST(wal_file->write_until_depleted("SWAL\x01\x00\x00\x00garbage"sv.bytes()));
+    }
+
+    heap = create_heap();
+    auto stored_long_string = TRY_OR_FAIL(heap->read_storage(storage_block_id));
+    EXPECT_EQ(long_string.bytes(), stored_long_string.bytes());
+
+    // The discarded commit must not get in the way of the next ones
+    auto second_storage_block_id = heap->request_new_block_index();
+    TRY_OR_FAIL(heap->write_storage(second_storage_block_id, "second"sv.bytes()));
+    MUST(heap->flush());
+    (void)heap.leak_ref();
+
+    heap = create_heap();
+    stored_long_string = TRY_OR_FAIL(heap->read_storage(storage_block_id));
+    EXPECT_EQ(long_string.bytes(), stored_long_string.bytes());
+    auto stored_second_string = TRY_OR_FAIL(heap->read_storage(second_storage_block_id));
+    EXPECT_EQ("second"sv.bytes(), stored_second_string.bytes());
+}
+
+TEST_CASE(heap_read_storage_larger_than_buffer_pool)
+{
+    ScopeGuard guard([]() { MUST(Core::System::unlink(db_path)); });
+    auto heap = create_heap();
+    auto storage_block_id = heap->request_new_block_index();
+
+    // Write storage spanning more blocks than fit in the buffer pool
+    auto data = MUST(ByteBuffer::create_uninitialized(SQL::Block::DATA_SIZE * SQL::Heap::BUFFER_POOL_SIZE * 2));
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = i % 251;
+    TRY_OR_FAIL(heap->write_storage(storage_block_id, data));
+    MUST(heap->flush());
+
+    // Read back twice, before and after checkpointing the write-ahead log
+    auto stored_data = TRY_OR_FAIL(heap->read_storage(storage_block_id));
+    EXPECT_EQ(data.bytes(), stored_data.bytes());
+    MUST(heap->checkpoint());
+    stored_data = TRY_OR_FAIL(heap->read_storage(storage_block_id));
+    EXPECT_EQ(data.bytes(), stored_data.bytes());
+}
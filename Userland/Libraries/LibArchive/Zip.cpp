@@ -122,8 +122,9 @@ ErrorOr<Statistics> Zip::calculate_statistics() const
     return Statistics(file_count, directory_count, uncompressed_bytes);
 }
 
-ZipOutputStream::ZipOutputStream(NonnullOwnPtr<Stream> stream)
+ZipOutputStream::ZipOutputStream(NonnullOwnPtr<Stream> stream, size_t compression_thread_count)
     : m_stream(move(stream))
+    , m_compression_thread_count(compression_thread_count)
 {
 }
 
@@ -158,6 +159,25 @@ ErrorOr<void> ZipOutputStream::add_member(ZipMember const& member)
     return local_file_header.write(*m_stream);
 }
 
+// Compresses the data on several threads, and checksums each chunk of it on the thread that compresses it.
+static ErrorOr<ByteBuffer> compress_in_parallel(ReadonlyBytes data, size_t thread_count, u32& crc32)
+{
+    auto chunk_count = Compress::DeflateCompressor::parallel_chunk_count(data.size());
+    Vector<u32> chunk_checksums;
+    TRY(chunk_checksums.try_resize(chunk_count));
+
+    auto compressed = TRY(Compress::DeflateCompressor::compress_all_in_parallel(data, Compress::DeflateCompressor::CompressionLevel::GOOD, thread_count, [&](size_t chunk_index, ReadonlyBytes chunk) {
+        chunk_checksums[chunk_index] = Crypto::Checksum::CRC32 { chunk }.digest();
+    }));
+
+    crc32 = chunk_checksums[0];
+    for (size_t i = 1; i < chunk_count; ++i) {
+        auto chunk_size = min(Compress::DeflateCompressor::parallel_chunk_size, data.size() - i * Compress::DeflateCompressor::parallel_chunk_size);
+        crc32 = Crypto::Checksum::CRC32::combine(crc32, chunk_checksums[i], chunk_size);
+    }
+    return compressed;
+}
+
 ErrorOr<ZipOutputStream::MemberInformation> ZipOutputStream::add_member_from_stream(StringView path, Stream& stream, Optional<Core::DateTime> const& modification_time)
 {
     auto buffer = TRY(stream.read_until_eof());
@@ -170,7 +190,12 @@ ErrorOr<ZipOutputStream::MemberInformation> ZipOutputStream::add_member_from_str
         member.modification_time = to_packed_dos_time(modification_time->hour(), modification_time->minute(), modification_time->second());
     }
 
-    auto deflate_buffer = Compress::DeflateCompressor::compress_all(buffer);
+    u32 crc32 = 0;
+    auto deflate_buffer = m_compression_thread_count > 1
+        ? compress_in_parallel(buffer, m_compression_thread_count, crc32)
+        : Compress::DeflateCompressor::compress_all(buffer);
+    if (m_compression_thread_count <= 1 || deflate_buffer.is_error())
+        crc32 = Crypto::Checksum::CRC32 { buffer.bytes() }.digest();
     auto compression_ratio = 1.f;
     auto compressed_size = buffer.size();
 
@@ -187,8 +212,7 @@ ErrorOr<ZipOutputStream::MemberInformation> ZipOutputStream::add_member_from_str
 
     member.uncompressed_size = buffer.size();
 
-    Crypto::Checksum::CRC32 checksum { buffer.bytes() };
-    member.crc32 = checksum.digest();
+    member.crc32 = crc32;
     member.is_directory = false;
 
     TRY(add_member(member));
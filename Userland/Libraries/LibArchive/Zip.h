@@ -279,7 +279,8 @@ public:
         size_t compressed_size;
     };
 
-    ZipOutputStream(NonnullOwnPtr<Stream>);
+    // With a thread count larger than one, members are compressed with Compress::DeflateCompressor::compress_all_in_parallel().
+    ZipOutputStream(NonnullOwnPtr<Stream>, size_t compression_thread_count = 1);
 
     ErrorOr<void> add_member(ZipMember const&);
     ErrorOr<MemberInformation> add_member_from_stream(StringView, Stream&, Optional<Core::DateTime> const& = {});
@@ -293,6 +294,7 @@ public:
 private:
     NonnullOwnPtr<Stream> m_stream;
     Vector<ZipMember> m_members;
+    size_t m_compression_thread_count { 1 };
 
     bool m_finished { false };
 };
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <AK/BuiltinWrappers.h>
 #include <AK/Debug.h>
 #include <AK/ScopedValueRollback.h>
@@ -20,17 +21,22 @@
 #include <sys/mman.h>
 #include <syscall.h>
 
+// NOTE: This counts the malloc locks held by all threads, so we can tell when the heap is stable again.
+static Atomic<size_t> s_held_lock_count { 0 };
+
 class PthreadMutexLocker {
 public:
     ALWAYS_INLINE explicit PthreadMutexLocker(pthread_mutex_t& mutex)
         : m_mutex(mutex)
     {
         lock();
+        ++s_held_lock_count;
         __heap_is_stable = false;
     }
     ALWAYS_INLINE ~PthreadMutexLocker()
     {
-        __heap_is_stable = true;
+        if (--s_held_lock_count == 0)
+            __heap_is_stable = true;
         unlock();
     }
     ALWAYS_INLINE void lock() { pthread_mutex_lock(&m_mutex); }
@@ -42,18 +48,29 @@ private:
 
 #define RECYCLE_BIG_ALLOCATIONS
 
-static pthread_mutex_t s_malloc_mutex = PTHREAD_MUTEX_INITIALIZER;
+// Every size class has a lock of its own, see Allocator::mutex.
+// These protect the empty blocks that are shared between size classes, and the recycled big blocks.
+// Lock order: Allocator::mutex -> s_empty_blocks_mutex.
+static pthread_mutex_t s_empty_blocks_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t s_big_allocations_mutex = PTHREAD_MUTEX_INITIALIZER;
 bool __heap_is_stable = true;
 
 constexpr size_t number_of_hot_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_cold_chunked_blocks_to_keep_around = 16;
 constexpr size_t number_of_big_blocks_to_keep_around_per_size_class = 8;
 
+// Chunks of the smallest size classes are cached per thread, see ThreadCache.
+constexpr size_t number_of_thread_cached_size_classes = 6;
+constexpr size_t thread_cache_capacity_per_size_class = 32;
+constexpr size_t thread_cache_batch_size = thread_cache_capacity_per_size_class / 2;
+static_assert(number_of_thread_cached_size_classes <= num_size_classes);
+
 static bool s_log_malloc = false;
 static bool s_scrub_malloc = true;
 static bool s_scrub_free = true;
 static bool s_profiling = false;
 static bool s_in_userspace_emulator = false;
+static bool s_use_thread_caches = true;
 
 ALWAYS_INLINE static void ue_notify_malloc(void const* ptr, size_t size)
 {
@@ -92,30 +109,49 @@ struct MemoryAuditingSuppressor {
     }
 };
 
-struct MallocStats {
-    size_t number_of_malloc_calls;
-
-    size_t number_of_big_allocator_hits;
-    size_t number_of_big_allocator_purge_hits;
-    size_t number_of_big_allocs;
+// NOTE: These are updated under different locks, so they have to be atomic.
+//       The counters that are updated on every call live in the thread caches instead.
+using MallocCounter = Atomic<size_t, AK::MemoryOrder::memory_order_relaxed>;
 
-    size_t number_of_hot_empty_block_hits;
-    size_t number_of_cold_empty_block_hits;
-    size_t number_of_cold_empty_block_purge_hits;
-    size_t number_of_block_allocs;
-    size_t number_of_blocks_full;
+struct MallocStats {
+    MallocCounter number_of_big_allocator_hits;
+    MallocCounter number_of_big_allocator_purge_hits;
+    MallocCounter number_of_big_allocs;
+
+    MallocCounter number_of_hot_empty_block_hits;
+    MallocCounter number_of_cold_empty_block_hits;
+    MallocCounter number_of_cold_empty_block_purge_hits;
+    MallocCounter number_of_block_allocs;
+    MallocCounter number_of_blocks_full;
+
+    MallocCounter number_of_big_allocator_keeps;
+    MallocCounter number_of_big_allocator_frees;
+
+    MallocCounter number_of_freed_full_blocks;
+    MallocCounter number_of_hot_keeps;
+    MallocCounter number_of_cold_keeps;
+    MallocCounter number_of_frees;
+};
+static MallocStats g_malloc_stats = {};
 
+struct ThreadCacheStats {
+    size_t number_of_malloc_calls;
     size_t number_of_free_calls;
+    size_t number_of_thread_cache_malloc_hits;
+    size_t number_of_thread_cache_free_hits;
+    size_t number_of_thread_cache_refills;
+    size_t number_of_thread_cache_drains;
 
-    size_t number_of_big_allocator_keeps;
-    size_t number_of_big_allocator_frees;
-
-    size_t number_of_freed_full_blocks;
-    size_t number_of_hot_keeps;
-    size_t number_of_cold_keeps;
-    size_t number_of_frees;
+    void add(ThreadCacheStats const& other)
+    {
+        number_of_malloc_calls += other.number_of_malloc_calls;
+        number_of_free_calls += other.number_of_free_calls;
+        number_of_thread_cache_malloc_hits += other.number_of_thread_cache_malloc_hits;
+        number_of_thread_cache_free_hits += other.number_of_thread_cache_free_hits;
+        number_of_thread_cache_refills += other.number_of_thread_cache_refills;
+        number_of_thread_cache_drains += other.number_of_thread_cache_drains;
+    }
 };
-static MallocStats g_malloc_stats = {};
 
 static size_t s_hot_empty_block_count { 0 };
 static ChunkedBlock* s_hot_empty_blocks[number_of_hot_chunked_blocks_to_keep_around] { nullptr };
@@ -123,6 +159,7 @@ static size_t s_cold_empty_block_count { 0 };
 static ChunkedBlock* s_cold_empty_blocks[number_of_cold_chunked_blocks_to_keep_around] { nullptr };
 
 struct Allocator {
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
     size_t size { 0 };
     size_t block_count { 0 };
     ChunkedBlock::List usable_blocks;
@@ -290,6 +327,248 @@ enum class CallerWillInitializeMemory {
 
 #ifndef NO_TLS
 __thread bool s_allocation_enabled = true;
+
+// Every thread keeps a stack of free chunks for each of the smallest size classes, so most malloc() and free()
+// calls don't have to take a lock at all. When a stack runs empty (or full), it gets refilled from (or drained
+// into) its size class in a batch, so the size class lock is taken once per batch rather than once per call.
+struct ThreadCache {
+    struct Bin {
+        size_t count;
+        void* chunks[thread_cache_capacity_per_size_class];
+    };
+    Bin bins[number_of_thread_cached_size_classes];
+    ThreadCacheStats stats;
+
+    // NOTE: All live thread caches are linked together, so we can collect their statistics.
+    ThreadCache* previous;
+    ThreadCache* next;
+    bool is_registered;
+    bool is_destroyed;
+};
+
+static __thread ThreadCache s_thread_cache;
+
+static pthread_mutex_t s_thread_caches_mutex = PTHREAD_MUTEX_INITIALIZER;
+static ThreadCache* s_thread_caches_head { nullptr };
+static ThreadCacheStats s_exited_thread_stats {};
+
+static ThreadCache* thread_cache()
+{
+    auto& cache = s_thread_cache;
+    if (!cache.is_registered) [[unlikely]] {
+        // NOTE: Whatever the thread frees on its way out has to go straight back to the size classes.
+        if (cache.is_destroyed)
+            return nullptr;
+        pthread_mutex_lock(&s_thread_caches_mutex);
+        cache.previous = nullptr;
+        cache.next = s_thread_caches_head;
+        if (s_thread_caches_head)
+            s_thread_caches_head->previous = &cache;
+        s_thread_caches_head = &cache;
+        cache.is_registered = true;
+        pthread_mutex_unlock(&s_thread_caches_mutex);
+    }
+    return &cache;
+}
+#else
+static ThreadCacheStats s_thread_stats {};
+#endif
+
+static ThreadCacheStats* current_thread_stats()
+{
+#ifndef NO_TLS
+    if (auto* cache = thread_cache())
+        return &cache->stats;
+    return nullptr;
+#else
+    return &s_thread_stats;
+#endif
+}
+
+static ChunkedBlock* take_empty_block(size_t good_size)
+{
+    PthreadMutexLocker locker(s_empty_blocks_mutex);
+
+    if (s_hot_empty_block_count) {
+        g_malloc_stats.number_of_hot_empty_block_hits++;
+        auto* block = s_hot_empty_blocks[--s_hot_empty_block_count];
+        if (block->m_size != good_size) {
+            new (block) ChunkedBlock(good_size);
+            ue_notify_chunk_size_changed(block, good_size);
+            char buffer[64];
+            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+            set_mmap_name(block, ChunkedBlock::block_size, buffer);
+        }
+        return block;
+    }
+
+    if (s_cold_empty_block_count) {
+        g_malloc_stats.number_of_cold_empty_block_hits++;
+        auto* block = s_cold_empty_blocks[--s_cold_empty_block_count];
+        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
+        bool this_block_was_purged = rc == 1;
+        if (rc < 0) {
+            perror("madvise");
+            VERIFY_NOT_REACHED();
+        }
+        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
+        if (rc < 0) {
+            perror("mprotect");
+            VERIFY_NOT_REACHED();
+        }
+        if (this_block_was_purged || block->m_size != good_size) {
+            if (this_block_was_purged)
+                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
+            new (block) ChunkedBlock(good_size);
+            ue_notify_chunk_size_changed(block, good_size);
+        }
+        return block;
+    }
+
+    return nullptr;
+}
+
+// NOTE: The caller must hold the allocator's mutex.
+static ErrorOr<void*> allocate_chunk(Allocator& allocator, size_t good_size, size_t align)
+{
+    ChunkedBlock* block = nullptr;
+    void* ptr = nullptr;
+    for (auto& current : allocator.usable_blocks) {
+        if (current.free_chunks()) {
+            ptr = try_allocate_chunk_aligned(align, current);
+            if (ptr) {
+                block = &current;
+                break;
+            }
+        }
+    }
+
+    if (!block) {
+        block = take_empty_block(good_size);
+        if (block)
+            allocator.usable_blocks.append(*block);
+    }
+
+    if (!block) {
+        g_malloc_stats.number_of_block_allocs++;
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
+        block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
+        new (block) ChunkedBlock(good_size);
+        allocator.usable_blocks.append(*block);
+        ++allocator.block_count;
+    }
+
+    if (!ptr) {
+        ptr = try_allocate_chunk_aligned(align, *block);
+    }
+
+    VERIFY(ptr);
+    if (block->is_full()) {
+        g_malloc_stats.number_of_blocks_full++;
+        dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
+        allocator.usable_blocks.remove(*block);
+        allocator.full_blocks.append(*block);
+    }
+    dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
+    return ptr;
+}
+
+// NOTE: The caller must hold the allocator's mutex.
+static void free_chunk(Allocator& allocator, ChunkedBlock& block, void* ptr)
+{
+    auto* entry = (FreelistEntry*)ptr;
+    entry->next = block.m_freelist;
+    block.m_freelist = entry;
+
+    if (block.is_full()) {
+        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", &block, allocator.size);
+        g_malloc_stats.number_of_freed_full_blocks++;
+        allocator.full_blocks.remove(block);
+        allocator.usable_blocks.prepend(block);
+    }
+
+    ++block.m_free_chunks;
+
+    if (!block.used_chunks()) {
+        PthreadMutexLocker empty_blocks_locker(s_empty_blocks_mutex);
+        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", &block);
+            g_malloc_stats.number_of_hot_keeps++;
+            allocator.usable_blocks.remove(block);
+            s_hot_empty_blocks[s_hot_empty_block_count++] = &block;
+            return;
+        }
+        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
+            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", &block);
+            g_malloc_stats.number_of_cold_keeps++;
+            allocator.usable_blocks.remove(block);
+            s_cold_empty_blocks[s_cold_empty_block_count++] = &block;
+            mprotect(&block, ChunkedBlock::block_size, PROT_NONE);
+            madvise(&block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
+            return;
+        }
+        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", &block, allocator.size);
+        g_malloc_stats.number_of_frees++;
+        allocator.usable_blocks.remove(block);
+        --allocator.block_count;
+        os_free(&block, ChunkedBlock::block_size);
+    }
+}
+
+static ChunkedBlock& block_for_chunk(void* ptr)
+{
+    return *(ChunkedBlock*)((FlatPtr)ptr & ChunkedBlock::block_mask);
+}
+
+#ifndef NO_TLS
+static void* allocate_from_thread_cache(ThreadCache& cache, size_t size_class_index)
+{
+    auto& bin = cache.bins[size_class_index];
+    if (bin.count == 0) {
+        auto& allocator = allocators()[size_class_index];
+        PthreadMutexLocker locker(allocator.mutex);
+        cache.stats.number_of_thread_cache_refills++;
+        while (bin.count < thread_cache_batch_size) {
+            auto ptr_or_error = allocate_chunk(allocator, allocator.size, 16);
+            if (ptr_or_error.is_error())
+                break;
+            bin.chunks[bin.count++] = ptr_or_error.release_value();
+        }
+        if (bin.count == 0)
+            return nullptr;
+    } else {
+        cache.stats.number_of_thread_cache_malloc_hits++;
+    }
+    return bin.chunks[--bin.count];
+}
+
+// Gives back the chunks that have been sitting in the bin the longest, the recently freed ones are more likely to be cache-hot.
+static void drain_thread_cache_bin(ThreadCache::Bin& bin, size_t size_class_index, size_t count)
+{
+    auto& allocator = allocators()[size_class_index];
+    count = min(count, bin.count);
+    {
+        PthreadMutexLocker locker(allocator.mutex);
+        for (size_t i = 0; i < count; ++i)
+            free_chunk(allocator, block_for_chunk(bin.chunks[i]), bin.chunks[i]);
+    }
+    for (size_t i = count; i < bin.count; ++i)
+        bin.chunks[i - count] = bin.chunks[i];
+    bin.count -= count;
+}
+
+static void free_to_thread_cache(ThreadCache& cache, size_t size_class_index, void* ptr)
+{
+    auto& bin = cache.bins[size_class_index];
+    if (bin.count == thread_cache_capacity_per_size_class) {
+        cache.stats.number_of_thread_cache_drains++;
+        drain_thread_cache_bin(bin, size_class_index, thread_cache_batch_size);
+    } else {
+        cache.stats.number_of_thread_cache_free_hits++;
+    }
+    bin.chunks[bin.count++] = ptr;
+}
 #endif
 
 static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializeMemory caller_will_initialize_memory)
@@ -315,13 +594,13 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
         size = 1;
     }
 
-    g_malloc_stats.number_of_malloc_calls++;
+    auto* stats = current_thread_stats();
+    if (stats)
+        stats->number_of_malloc_calls++;
 
     size_t good_size;
     auto* allocator = allocator_for_size(size, good_size, align);
 
-    PthreadMutexLocker locker(s_malloc_mutex);
-
     if (!allocator) {
         size_t real_size = round_up_to_power_of_two(sizeof(BigAllocationBlock) + size + ((align > 16) ? align : 0), ChunkedBlock::block_size);
         if (real_size < size) {
@@ -330,6 +609,7 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
         }
 #ifdef RECYCLE_BIG_ALLOCATIONS
         if (auto* allocator = big_allocator_for_size(real_size)) {
+            PthreadMutexLocker locker(s_big_allocations_mutex);
             if (!allocator->blocks.is_empty()) {
                 g_malloc_stats.number_of_big_allocator_hits++;
                 auto* block = allocator->blocks.take_last();
@@ -364,79 +644,26 @@ static ErrorOr<void*> malloc_impl(size_t size, size_t align, CallerWillInitializ
         return ptr;
     }
 
-    ChunkedBlock* block = nullptr;
     void* ptr = nullptr;
-    for (auto& current : allocator->usable_blocks) {
-        if (current.free_chunks()) {
-            ptr = try_allocate_chunk_aligned(align, current);
-            if (ptr) {
-                block = &current;
-                break;
-            }
-        }
-    }
-
-    if (!block && s_hot_empty_block_count) {
-        g_malloc_stats.number_of_hot_empty_block_hits++;
-        block = s_hot_empty_blocks[--s_hot_empty_block_count];
-        if (block->m_size != good_size) {
-            new (block) ChunkedBlock(good_size);
-            ue_notify_chunk_size_changed(block, good_size);
-            char buffer[64];
-            snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-            set_mmap_name(block, ChunkedBlock::block_size, buffer);
-        }
-        allocator->usable_blocks.append(*block);
-    }
-
-    if (!block && s_cold_empty_block_count) {
-        g_malloc_stats.number_of_cold_empty_block_hits++;
-        block = s_cold_empty_blocks[--s_cold_empty_block_count];
-        int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
-        bool this_block_was_purged = rc == 1;
-        if (rc < 0) {
-            perror("madvise");
-            VERIFY_NOT_REACHED();
-        }
-        rc = mprotect(block, ChunkedBlock::block_size, PROT_READ | PROT_WRITE);
-        if (rc < 0) {
-            perror("mprotect");
-            VERIFY_NOT_REACHED();
-        }
-        if (this_block_was_purged || block->m_size != good_size) {
-            if (this_block_was_purged)
-                g_malloc_stats.number_of_cold_empty_block_purge_hits++;
-            new (block) ChunkedBlock(good_size);
-            ue_notify_chunk_size_changed(block, good_size);
+#ifndef NO_TLS
+    // NOTE: Every chunk is 16-byte aligned, so anything in the thread cache will do for those allocations.
+    size_t size_class_index = allocator - allocators();
+    if (s_use_thread_caches && align <= 16 && size_class_index < number_of_thread_cached_size_classes) {
+        if (auto* cache = thread_cache()) {
+            ptr = allocate_from_thread_cache(*cache, size_class_index);
+            if (!ptr)
+                return ENOMEM;
         }
-        allocator->usable_blocks.append(*block);
-    }
-
-    if (!block) {
-        g_malloc_stats.number_of_block_allocs++;
-        char buffer[64];
-        snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
-        block = (ChunkedBlock*)TRY(os_alloc(ChunkedBlock::block_size, buffer));
-        new (block) ChunkedBlock(good_size);
-        allocator->usable_blocks.append(*block);
-        ++allocator->block_count;
     }
+#endif
 
     if (!ptr) {
-        ptr = try_allocate_chunk_aligned(align, *block);
+        PthreadMutexLocker locker(allocator->mutex);
+        ptr = TRY(allocate_chunk(*allocator, good_size, align));
     }
 
-    VERIFY(ptr);
-    if (block->is_full()) {
-        g_malloc_stats.number_of_blocks_full++;
-        dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
-        allocator->usable_blocks.remove(*block);
-        allocator->full_blocks.append(*block);
-    }
-    dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
-
     if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
-        memset(ptr, MALLOC_SCRUB_BYTE, block->m_size);
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
 
     ue_notify_malloc(ptr, size);
     return ptr;
@@ -453,17 +680,18 @@ static void free_impl(void* ptr)
     if (!ptr)
         return;
 
-    g_malloc_stats.number_of_free_calls++;
+    auto* stats = current_thread_stats();
+    if (stats)
+        stats->number_of_free_calls++;
 
     void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
     size_t magic = *(size_t*)block_base;
 
-    PthreadMutexLocker locker(s_malloc_mutex);
-
     if (magic == MAGIC_BIGALLOC_HEADER) {
         auto* block = (BigAllocationBlock*)block_base;
 #ifdef RECYCLE_BIG_ALLOCATIONS
         if (auto* allocator = big_allocator_for_size(block->m_size)) {
+            PthreadMutexLocker locker(s_big_allocations_mutex);
             if (allocator->blocks.size() < number_of_big_blocks_to_keep_around_per_size_class) {
                 g_malloc_stats.number_of_big_allocator_keeps++;
                 allocator->blocks.append(block);
@@ -493,46 +721,49 @@ static void free_impl(void* ptr)
     if (s_scrub_free)
         memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
 
-    auto* entry = (FreelistEntry*)ptr;
-    entry->next = block->m_freelist;
-    block->m_freelist = entry;
+    // NOTE: The size of the block can't change under us, since it has at least one chunk in use: ours.
+    size_t good_size;
+    auto* allocator = allocator_for_size(block->m_size, good_size);
+    VERIFY(allocator);
 
-    if (block->is_full()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
-        g_malloc_stats.number_of_freed_full_blocks++;
-        allocator->full_blocks.remove(*block);
-        allocator->usable_blocks.prepend(*block);
+#ifndef NO_TLS
+    size_t size_class_index = allocator - allocators();
+    if (s_use_thread_caches && size_class_index < number_of_thread_cached_size_classes) {
+        if (auto* cache = thread_cache()) {
+            free_to_thread_cache(*cache, size_class_index, ptr);
+            return;
+        }
     }
+#endif
 
-    ++block->m_free_chunks;
+    PthreadMutexLocker locker(allocator->mutex);
+    free_chunk(*allocator, *block, ptr);
+}
 
-    if (!block->used_chunks()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        if (s_hot_empty_block_count < number_of_hot_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping hot block {:p} around", block);
-            g_malloc_stats.number_of_hot_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_hot_empty_blocks[s_hot_empty_block_count++] = block;
-            return;
-        }
-        if (s_cold_empty_block_count < number_of_cold_chunked_blocks_to_keep_around) {
-            dbgln_if(MALLOC_DEBUG, "Keeping cold block {:p} around", block);
-            g_malloc_stats.number_of_cold_keeps++;
-            allocator->usable_blocks.remove(*block);
-            s_cold_empty_blocks[s_cold_empty_block_count++] = block;
-            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
-            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
-            return;
-        }
-        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
-        g_malloc_stats.number_of_frees++;
-        allocator->usable_blocks.remove(*block);
-        --allocator->block_count;
-        os_free(block, ChunkedBlock::block_size);
+void __malloc_destroy_thread_cache()
+{
+#ifndef NO_TLS
+    auto& cache = s_thread_cache;
+    cache.is_destroyed = true;
+    if (!cache.is_registered)
+        return;
+
+    for (size_t i = 0; i < number_of_thread_cached_size_classes; ++i) {
+        if (cache.bins[i].count)
+            drain_thread_cache_bin(cache.bins[i], i, cache.bins[i].count);
     }
+
+    pthread_mutex_lock(&s_thread_caches_mutex);
+    if (cache.previous)
+        cache.previous->next = cache.next;
+    else
+        s_thread_caches_head = cache.next;
+    if (cache.next)
+        cache.next->previous = cache.previous;
+    s_exited_thread_stats.add(cache.stats);
+    cache.is_registered = false;
+    pthread_mutex_unlock(&s_thread_caches_mutex);
+#endif
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/malloc.html
@@ -662,6 +893,8 @@ void __malloc_init()
         // keeps track of heap memory anyway.
         s_scrub_malloc = false;
         s_scrub_free = false;
+        // UE checks every access to the heap, so chunks sitting in a thread cache would look like leaks to it.
+        s_use_thread_caches = false;
     }
 
     if (secure_getenv("LIBC_NOSCRUB_MALLOC"))
@@ -672,6 +905,8 @@ void __malloc_init()
         s_log_malloc = true;
     if (secure_getenv("LIBC_PROFILE_MALLOC"))
         s_profiling = true;
+    if (secure_getenv("LIBC_NO_MALLOC_THREAD_CACHES"))
+        s_use_thread_caches = false;
 
     for (size_t i = 0; i < num_size_classes; ++i) {
         new (&allocators()[i]) Allocator();
@@ -681,28 +916,63 @@ void __malloc_init()
     new (&big_allocators()[0])(BigAllocator);
 }
 
+static ThreadCacheStats collect_thread_cache_stats()
+{
+#ifndef NO_TLS
+    // NOTE: The other threads keep counting while we read their counters, so this is only a snapshot.
+    pthread_mutex_lock(&s_thread_caches_mutex);
+    ThreadCacheStats stats = s_exited_thread_stats;
+    for (auto* cache = s_thread_caches_head; cache; cache = cache->next)
+        stats.add(cache->stats);
+    pthread_mutex_unlock(&s_thread_caches_mutex);
+    return stats;
+#else
+    return s_thread_stats;
+#endif
+}
+
+void serenity_get_malloc_stats(struct serenity_malloc_stats* out_stats)
+{
+    auto stats = collect_thread_cache_stats();
+    out_stats->malloc_calls = stats.number_of_malloc_calls;
+    out_stats->free_calls = stats.number_of_free_calls;
+    out_stats->thread_cache_malloc_hits = stats.number_of_thread_cache_malloc_hits;
+    out_stats->thread_cache_free_hits = stats.number_of_thread_cache_free_hits;
+    out_stats->thread_cache_refills = stats.number_of_thread_cache_refills;
+    out_stats->thread_cache_drains = stats.number_of_thread_cache_drains;
+    out_stats->block_allocs = g_malloc_stats.number_of_block_allocs;
+    out_stats->big_allocs = g_malloc_stats.number_of_big_allocs;
+}
+
 void serenity_dump_malloc_stats()
 {
-    dbgln("# malloc() calls: {}", g_malloc_stats.number_of_malloc_calls);
+    auto stats = collect_thread_cache_stats();
+    dbgln("# malloc() calls: {}", stats.number_of_malloc_calls);
+    dbgln();
+    dbgln("thread cache hits: {}", stats.number_of_thread_cache_malloc_hits);
+    dbgln("thread cache refills: {}", stats.number_of_thread_cache_refills);
+    dbgln();
+    dbgln("big alloc hits: {}", g_malloc_stats.number_of_big_allocator_hits.load());
+    dbgln("big alloc hits that were purged: {}", g_malloc_stats.number_of_big_allocator_purge_hits.load());
+    dbgln("big allocs: {}", g_malloc_stats.number_of_big_allocs.load());
     dbgln();
-    dbgln("big alloc hits: {}", g_malloc_stats.number_of_big_allocator_hits);
-    dbgln("big alloc hits that were purged: {}", g_malloc_stats.number_of_big_allocator_purge_hits);
-    dbgln("big allocs: {}", g_malloc_stats.number_of_big_allocs);
+    dbgln("empty hot block hits: {}", g_malloc_stats.number_of_hot_empty_block_hits.load());
+    dbgln("empty cold block hits: {}", g_malloc_stats.number_of_cold_empty_block_hits.load());
+    dbgln("empty cold block hits that were purged: {}", g_malloc_stats.number_of_cold_empty_block_purge_hits.load());
+    dbgln("block allocs: {}", g_malloc_stats.number_of_block_allocs.load());
+    dbgln("filled blocks: {}", g_malloc_stats.number_of_blocks_full.load());
     dbgln();
-    dbgln("empty hot block hits: {}", g_malloc_stats.number_of_hot_empty_block_hits);
-    dbgln("empty cold block hits: {}", g_malloc_stats.number_of_cold_empty_block_hits);
-    dbgln("empty cold block hits that were purged: {}", g_malloc_stats.number_of_cold_empty_block_purge_hits);
-    dbgln("block allocs: {}", g_malloc_stats.number_of_block_allocs);
-    dbgln("filled blocks: {}", g_malloc_stats.number_of_blocks_full);
+    dbgln("# free() calls: {}", stats.number_of_free_calls);
     dbgln();
-    dbgln("# free() calls: {}", g_malloc_stats.number_of_free_calls);
+    dbgln("thread cache free hits: {}", stats.number_of_thread_cache_free_hits);
+    dbgln("thread cache drains: {}", stats.number_of_thread_cache_drains);
     dbgln();
-    dbgln("big alloc keeps: {}", g_malloc_stats.number_of_big_allocator_keeps);
-    dbgln("big alloc frees: {}", g_malloc_stats.number_of_big_allocator_frees);
+    dbgln("big alloc keeps: {}", g_malloc_stats.number_of_big_allocator_keeps.load());
+    dbgln("big alloc frees: {}", g_malloc_stats.number_of_big_allocator_frees.load());
     dbgln();
-    dbgln("full block frees: {}", g_malloc_stats.number_of_freed_full_blocks);
-    dbgln("number of hot keeps: {}", g_malloc_stats.number_of_hot_keeps);
-    dbgln("number of cold keeps: {}", g_malloc_stats.number_of_cold_keeps);
-    dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+    dbgln("full block frees: {}", g_malloc_stats.number_of_freed_full_blocks.load());
+    dbgln("number of hot keeps: {}", g_malloc_stats.number_of_hot_keeps.load());
+    dbgln("number of cold keeps: {}", g_malloc_stats.number_of_cold_keeps.load());
+    dbgln("number of frees: {}", g_malloc_stats.number_of_frees.load());
 }
 }
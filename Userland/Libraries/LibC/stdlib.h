@@ -29,6 +29,19 @@ __attribute__((malloc)) __attribute__((alloc_size(1, 2))) void* calloc(size_t nm
 size_t malloc_size(void const*);
 size_t malloc_good_size(size_t);
 void serenity_dump_malloc_stats(void);
+
+struct serenity_malloc_stats {
+    size_t malloc_calls;
+    size_t free_calls;
+    size_t thread_cache_malloc_hits;
+    size_t thread_cache_free_hits;
+    size_t thread_cache_refills;
+    size_t thread_cache_drains;
+    size_t block_allocs;
+    size_t big_allocs;
+};
+
+void serenity_get_malloc_stats(struct serenity_malloc_stats*);
 void free(void*);
 __attribute__((alloc_size(2))) void* realloc(void* ptr, size_t);
 char* getenv(char const* name);
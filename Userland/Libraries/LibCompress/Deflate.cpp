@@ -7,12 +7,19 @@
 
 #include <AK/Array.h>
 #include <AK/Assertions.h>
+#include <AK/AtomicRefCounted.h>
 #include <AK/BinarySearch.h>
+#include <AK/BuiltinWrappers.h>
+#include <AK/Math.h>
 #include <AK/MemoryStream.h>
 #include <string.h>
 
 #include <LibCompress/Deflate.h>
 #include <LibCompress/Huffman.h>
+#include <LibCore/System.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/ThreadPool.h>
 
 namespace Compress {
 
@@ -24,29 +31,13 @@ static constexpr int EndOfBlock = 256;
 
 CanonicalCode const& CanonicalCode::fixed_literal_codes()
 {
-    static CanonicalCode code;
-    static bool initialized = false;
-
-    if (initialized)
-        return code;
-
-    code = MUST(CanonicalCode::from_bytes(fixed_literal_bit_lengths));
-    initialized = true;
-
+    static CanonicalCode const code = MUST(CanonicalCode::from_bytes(fixed_literal_bit_lengths));
     return code;
 }
 
 CanonicalCode const& CanonicalCode::fixed_distance_codes()
 {
-    static CanonicalCode code;
-    static bool initialized = false;
-
-    if (initialized)
-        return code;
-
-    code = MUST(CanonicalCode::from_bytes(fixed_distance_bit_lengths));
-    initialized = true;
-
+    static CanonicalCode const code = MUST(CanonicalCode::from_bytes(fixed_distance_bit_lengths));
     return code;
 }
 
@@ -180,50 +171,415 @@ ErrorOr<u32> CanonicalCode::read_symbol(LittleEndianInputBitStream& stream) cons
     return Error::from_string_literal("Symbol exceeds maximum symbol number");
 }
 
-DeflateDecompressor::CompressedBlock::CompressedBlock(DeflateDecompressor& decompressor, CanonicalCode literal_codes, Optional<CanonicalCode> distance_codes)
+// Layout of a decoding table entry:
+//   bits 0-3:   length of the codeword, or the size of the root index for subtable entries
+//   bits 4-7:   number of extra bits following the codeword, or the size of the subtable index for subtable entries
+//   bits 8-11:  flags
+//   bits 16-31: literal byte, base length, base distance or subtable offset
+static constexpr u32 literal_entry_flag = 1 << 8;
+static constexpr u32 subtable_entry_flag = 1 << 9;
+static constexpr u32 end_of_block_entry_flag = 1 << 10;
+static constexpr u32 invalid_entry_flag = 1 << 11;
+
+static constexpr u32 make_decoding_entry(u32 value, u32 codeword_length, u32 extra_bits, u32 flags)
+{
+    return value << 16 | flags | extra_bits << 4 | codeword_length;
+}
+
+ALWAYS_INLINE static u8 entry_codeword_length(u32 entry) { return entry & 0xf; }
+ALWAYS_INLINE static u8 entry_extra_bits(u32 entry) { return (entry >> 4) & 0xf; }
+ALWAYS_INLINE static u32 entry_extra_bits_mask(u32 entry) { return (1u << entry_extra_bits(entry)) - 1; }
+ALWAYS_INLINE static u32 entry_value(u32 entry) { return entry >> 16; }
+
+u32 DeflateDecompressor::DecodingTable::entry_for_symbol(u16 symbol, u8 codeword_length, Alphabet alphabet)
+{
+    if (alphabet == Alphabet::LiteralLength) {
+        if (symbol < EndOfBlock)
+            return make_decoding_entry(symbol, codeword_length, 0, literal_entry_flag);
+        if (symbol == EndOfBlock)
+            return make_decoding_entry(0, codeword_length, 0, end_of_block_entry_flag);
+        if (symbol < 286) {
+            auto const& length_symbol = packed_length_symbols[symbol - 257];
+            return make_decoding_entry(length_symbol.base_length, codeword_length, length_symbol.extra_bits, 0);
+        }
+        return make_decoding_entry(0, codeword_length, 0, invalid_entry_flag);
+    }
+
+    if (symbol < 30) {
+        auto const& distance_symbol = packed_distances[symbol];
+        return make_decoding_entry(distance_symbol.base_distance, codeword_length, distance_symbol.extra_bits, 0);
+    }
+    return make_decoding_entry(0, codeword_length, 0, invalid_entry_flag);
+}
+
+ErrorOr<void> DeflateDecompressor::DecodingTable::build(ReadonlyBytes code_lengths, Alphabet alphabet)
+{
+    VERIFY(code_lengths.size() <= 288);
+
+    Array<u16, 16> length_counts {};
+    for (auto length : code_lengths)
+        length_counts[length]++;
+    length_counts[0] = 0;
+
+    size_t symbol_count = 0;
+    u8 max_length = 0;
+    i32 unused_codewords = 1;
+    for (u8 length = 1; length <= 15; ++length) {
+        symbol_count += length_counts[length];
+        if (length_counts[length] != 0)
+            max_length = length;
+
+        unused_codewords = unused_codewords * 2 - length_counts[length];
+        if (unused_codewords < 0)
+            return Error::from_string_literal("Failed to decode code lengths");
+    }
+
+    m_entries.clear_with_capacity();
+    m_root_bits = 0;
+
+    if (symbol_count == 0) {
+        // A block without back references does not need any distance codes.
+        if (alphabet == Alphabet::LiteralLength)
+            return Error::from_string_literal("Failed to decode code lengths");
+        return {};
+    }
+
+    if (symbol_count == 1) {
+        // A code with a single symbol uses a one-bit codeword, and we accept either value of that bit.
+        auto symbol = static_cast<u16>(code_lengths.size() - 1);
+        while (code_lengths[symbol] == 0)
+            --symbol;
+
+        auto entry = entry_for_symbol(symbol, 1, alphabet);
+        m_root_bits = 1;
+        TRY(m_entries.try_append(entry));
+        TRY(m_entries.try_append(entry));
+        return {};
+    }
+
+    if (unused_codewords != 0)
+        return Error::from_string_literal("Failed to decode code lengths");
+
+    // Canonical codewords are assigned in order of codeword length first and symbol value second.
+    Array<u16, 16> offsets {};
+    for (u8 length = 1; length < 15; ++length)
+        offsets[length + 1] = offsets[length] + length_counts[length];
+
+    Array<u16, 288> sorted_symbols;
+    for (size_t symbol = 0; symbol < code_lengths.size(); ++symbol) {
+        if (code_lengths[symbol] != 0)
+            sorted_symbols[offsets[code_lengths[symbol]]++] = symbol;
+    }
+
+    Array<u16, 288> codewords;
+    u16 next_codeword = 0;
+    for (size_t i = 0, length = 1; length <= 15; ++length, next_codeword <<= 1) {
+        for (size_t j = 0; j < length_counts[length]; ++j)
+            codewords[i++] = next_codeword++;
+    }
+
+    m_root_bits = min(max_length, alphabet == Alphabet::LiteralLength ? 10 : 8);
+    TRY(m_entries.try_resize(1 << m_root_bits));
+    m_entries.span().fill(make_decoding_entry(0, 0, 0, invalid_entry_flag));
+
+    // DEFLATE writes codewords starting from their most significant bit, so every table index is bit-reversed.
+    size_t index = 0;
+    for (; index < symbol_count && code_lengths[sorted_symbols[index]] <= m_root_bits; ++index) {
+        auto length = code_lengths[sorted_symbols[index]];
+        auto entry = entry_for_symbol(sorted_symbols[index], length, alphabet);
+        for (u32 i = fast_reverse16(codewords[index], length); i < (1u << m_root_bits); i += 1u << length)
+            m_entries[i] = entry;
+    }
+
+    // Longer codewords that share the same root bits form a contiguous run, and get a subtable that is just large
+    // enough for the longest of them.
+    while (index < symbol_count) {
+        auto prefix_of = [&](size_t i) { return codewords[i] >> (code_lengths[sorted_symbols[i]] - m_root_bits); };
+
+        auto prefix = prefix_of(index);
+        auto run_end = index + 1;
+        while (run_end < symbol_count && prefix_of(run_end) == prefix)
+            ++run_end;
+
+        u8 subtable_bits = code_lengths[sorted_symbols[run_end - 1]] - m_root_bits;
+        auto subtable_offset = m_entries.size();
+        TRY(m_entries.try_resize(subtable_offset + (1 << subtable_bits)));
+        m_entries[fast_reverse16(prefix, m_root_bits)] = make_decoding_entry(subtable_offset, m_root_bits, subtable_bits, subtable_entry_flag);
+
+        for (; index < run_end; ++index) {
+            u8 length = code_lengths[sorted_symbols[index]] - m_root_bits;
+            auto entry = entry_for_symbol(sorted_symbols[index], length, alphabet);
+            for (u32 i = fast_reverse16(codewords[index] & ((1u << length) - 1), length); i < (1u << subtable_bits); i += 1u << length)
+                m_entries[subtable_offset + i] = entry;
+        }
+    }
+
+    return {};
+}
+
+ErrorOr<u32> DeflateDecompressor::DecodingTable::read_entry(LittleEndianInputBitStream& stream) const
+{
+    VERIFY(!is_empty());
+
+    // Close to the end of the input, fewer bits than the table index is wide may be left. That is fine as long as the
+    // codeword itself is complete, since the bit buffer is zero above its valid bits.
+    TRY(stream.fill_bit_buffer());
+
+    auto entry = m_entries[stream.buffered_bits() & ((1u << m_root_bits) - 1)];
+    if (entry & subtable_entry_flag) {
+        if (stream.buffered_bit_count() < m_root_bits)
+            return Error::from_string_literal("Reached end-of-stream without collecting the required number of bits");
+        stream.discard_previously_peeked_bits(m_root_bits);
+        entry = m_entries[entry_value(entry) + (stream.buffered_bits() & entry_extra_bits_mask(entry))];
+    }
+
+    if (entry_codeword_length(entry) > stream.buffered_bit_count())
+        return Error::from_string_literal("Reached end-of-stream without collecting the required number of bits");
+    stream.discard_previously_peeked_bits(entry_codeword_length(entry));
+
+    return entry;
+}
+
+DeflateDecompressor::DecodingTable const& DeflateDecompressor::DecodingTable::fixed_literal_length_table()
+{
+    static DecodingTable const table = [] {
+        DecodingTable table;
+        MUST(table.build(fixed_literal_bit_lengths, Alphabet::LiteralLength));
+        return table;
+    }();
+    return table;
+}
+
+DeflateDecompressor::DecodingTable const& DeflateDecompressor::DecodingTable::fixed_distance_table()
+{
+    static DecodingTable const table = [] {
+        DecodingTable table;
+        MUST(table.build(fixed_distance_bit_lengths, Alphabet::Distance));
+        return table;
+    }();
+    return table;
+}
+
+// Copies a back reference with wide loads and stores, which may write up to match_copy_overshoot - 1 bytes past the
+// end of the match. The window has room for that, and the bytes are overwritten by the output that follows.
+ALWAYS_INLINE static void copy_match(u8* output, size_t length, size_t distance)
+{
+    u8 const* source = output - distance;
+    u8 const* const end = output + length;
+
+    if (distance >= 16) [[likely]] {
+        // Most matches are short, so copy the first 32 bytes without checking the length.
+        __builtin_memcpy(output, source, 16);
+        __builtin_memcpy(output + 16, source + 16, 16);
+        output += 32;
+        source += 32;
+        while (output < end) {
+            __builtin_memcpy(output, source, 16);
+            output += 16;
+            source += 16;
+        }
+    } else if (distance >= 8) {
+        do {
+            __builtin_memcpy(output, source, 8);
+            output += 8;
+            source += 8;
+        } while (output < end);
+    } else if (distance == 1) {
+        __builtin_memset(output, *source, length);
+    } else {
+        do {
+            *output++ = *source++;
+        } while (output < end);
+    }
+}
+
+DeflateDecompressor::CompressedBlock::CompressedBlock(DeflateDecompressor& decompressor, DecodingTable const& literal_length_table, DecodingTable const& distance_table)
     : m_decompressor(decompressor)
-    , m_literal_codes(literal_codes)
-    , m_distance_codes(distance_codes)
+    , m_literal_length_table(literal_length_table)
+    , m_distance_table(distance_table)
 {
 }
 
+// A copy of the bit stream's buffer that the decoding loop can keep in registers.
+// Unconsumed bits are only handed back to the stream when refilling the buffer, or when the loop stops.
+class LocalBitBuffer {
+public:
+    explicit LocalBitBuffer(LittleEndianInputBitStream& stream)
+        : m_stream(stream)
+    {
+        reload();
+    }
+
+    ALWAYS_INLINE u64 bits() const { return m_bits; }
+    ALWAYS_INLINE u8 count() const { return m_count; }
+
+    ALWAYS_INLINE void consume(u8 count)
+    {
+        m_bits >>= count;
+        m_count -= count;
+    }
+
+    ALWAYS_INLINE void sync() { m_stream.discard_previously_peeked_bits(m_stream.buffered_bit_count() - m_count); }
+
+    ALWAYS_INLINE void reload()
+    {
+        m_bits = m_stream.buffered_bits();
+        m_count = m_stream.buffered_bit_count();
+    }
+
+    ALWAYS_INLINE ErrorOr<void> refill()
+    {
+        sync();
+        TRY(m_stream.fill_bit_buffer());
+        reload();
+        return {};
+    }
+
+private:
+    LittleEndianInputBitStream& m_stream;
+    u64 m_bits;
+    u8 m_count;
+};
+
 ErrorOr<bool> DeflateDecompressor::CompressedBlock::try_read_more()
 {
     if (m_eof == true)
         return false;
 
-    auto const symbol = TRY(m_literal_codes.read_symbol(*m_decompressor.m_input_stream));
+    // A literal/length codeword and its extra bits take at most 15 + 5 bits, a distance codeword and its extra bits
+    // at most 15 + 13. Refilling only when either half might run short means fewer, larger reads from the stream.
+    static constexpr u8 max_literal_length_bits = 20;
+    static constexpr u8 max_distance_bits = 28;
+
+    u8* const window = m_decompressor.m_window.data();
+    u8* output = window + m_decompressor.m_window_write_offset;
+    u8* const output_limit = window + window_decode_limit;
+
+    auto const* literal_length_entries = m_literal_length_table.entries();
+    auto const literal_length_mask = (1u << m_literal_length_table.root_bits()) - 1;
+    auto const* distance_entries = m_distance_table.entries();
+    auto const distance_mask = (1u << m_distance_table.root_bits()) - 1;
+    auto const has_distance_codes = !m_distance_table.is_empty();
+
+    LocalBitBuffer bit_buffer { *m_decompressor.m_input_stream };
+
+    while (output < output_limit) {
+        if (bit_buffer.count() < max_literal_length_bits) {
+            TRY(bit_buffer.refill());
+
+            // Close to the end of the input, let the bit stream check each read.
+            if (bit_buffer.count() < max_literal_length_bits + max_distance_bits) {
+                output = TRY(decode_symbol_near_end_of_input(output));
+                bit_buffer.reload();
+                if (m_eof)
+                    break;
+                continue;
+            }
+        }
+
+        auto entry = literal_length_entries[bit_buffer.bits() & literal_length_mask];
+        if (entry & subtable_entry_flag) [[unlikely]] {
+            bit_buffer.consume(entry_codeword_length(entry));
+            entry = literal_length_entries[entry_value(entry) + (bit_buffer.bits() & entry_extra_bits_mask(entry))];
+        }
 
-    if (symbol >= 286)
-        return Error::from_string_literal("Invalid deflate literal/length symbol");
+        if (entry & literal_entry_flag) {
+            bit_buffer.consume(entry_codeword_length(entry));
+            *output++ = entry_value(entry);
+            continue;
+        }
+
+        if (entry & (end_of_block_entry_flag | invalid_entry_flag)) [[unlikely]] {
+            if (entry & invalid_entry_flag)
+                return Error::from_string_literal("Invalid deflate literal/length symbol");
+
+            bit_buffer.consume(entry_codeword_length(entry));
+            m_eof = true;
+            break;
+        }
+
+        size_t const length = entry_value(entry) + ((bit_buffer.bits() >> entry_codeword_length(entry)) & entry_extra_bits_mask(entry));
+        bit_buffer.consume(entry_codeword_length(entry) + entry_extra_bits(entry));
+
+        if (!has_distance_codes) [[unlikely]]
+            return Error::from_string_literal("Distance codes have not been initialized");
+
+        if (bit_buffer.count() < max_distance_bits) [[unlikely]]
+            TRY(bit_buffer.refill());
+
+        size_t distance;
+        if (bit_buffer.count() >= max_distance_bits) [[likely]] {
+            entry = distance_entries[bit_buffer.bits() & distance_mask];
+            if (entry & subtable_entry_flag) [[unlikely]] {
+                bit_buffer.consume(entry_codeword_length(entry));
+                entry = distance_entries[entry_value(entry) + (bit_buffer.bits() & entry_extra_bits_mask(entry))];
+            }
+
+            if (entry & invalid_entry_flag) [[unlikely]]
+                return Error::from_string_literal("Invalid deflate distance symbol");
+
+            distance = entry_value(entry) + ((bit_buffer.bits() >> entry_codeword_length(entry)) & entry_extra_bits_mask(entry));
+            bit_buffer.consume(entry_codeword_length(entry) + entry_extra_bits(entry));
+        } else {
+            bit_buffer.sync();
+            distance = TRY(read_distance_near_end_of_input());
+            bit_buffer.reload();
+        }
 
-    if (symbol < EndOfBlock) {
-        u8 byte_symbol = symbol;
-        m_decompressor.m_output_buffer.write({ &byte_symbol, sizeof(byte_symbol) });
-        return true;
+        if (distance > static_cast<size_t>(output - window)) [[unlikely]]
+            return Error::from_string_literal("Back reference distance is beyond the start of the output");
+
+        copy_match(output, length, distance);
+        output += length;
+    }
+
+    bit_buffer.sync();
+    m_decompressor.m_window_write_offset = output - window;
+
+    return !m_eof;
+}
+
+ErrorOr<u8*> DeflateDecompressor::CompressedBlock::decode_symbol_near_end_of_input(u8* output)
+{
+    auto& stream = *m_decompressor.m_input_stream;
+
+    auto entry = TRY(m_literal_length_table.read_entry(stream));
+
+    if (entry & literal_entry_flag) {
+        *output++ = entry_value(entry);
+        return output;
     }
 
-    if (symbol == EndOfBlock) {
+    if (entry & invalid_entry_flag)
+        return Error::from_string_literal("Invalid deflate literal/length symbol");
+
+    if (entry & end_of_block_entry_flag) {
         m_eof = true;
-        return false;
+        return output;
     }
 
-    if (!m_distance_codes.has_value())
+    size_t const length = entry_value(entry) + TRY(stream.read_bits(entry_extra_bits(entry)));
+
+    if (m_distance_table.is_empty())
         return Error::from_string_literal("Distance codes have not been initialized");
 
-    auto const length = TRY(m_decompressor.decode_length(symbol));
-    auto const distance_symbol = TRY(m_distance_codes.value().read_symbol(*m_decompressor.m_input_stream));
-    if (distance_symbol >= 30)
-        return Error::from_string_literal("Invalid deflate distance symbol");
+    auto const distance = TRY(read_distance_near_end_of_input());
+    if (distance > static_cast<size_t>(output - m_decompressor.m_window.data()))
+        return Error::from_string_literal("Back reference distance is beyond the start of the output");
 
-    auto const distance = TRY(m_decompressor.decode_distance(distance_symbol));
+    copy_match(output, length, distance);
+    return output + length;
+}
 
-    auto copied_length = TRY(m_decompressor.m_output_buffer.copy_from_seekback(distance, length));
+ErrorOr<size_t> DeflateDecompressor::CompressedBlock::read_distance_near_end_of_input()
+{
+    auto& stream = *m_decompressor.m_input_stream;
 
-    // TODO: What should we do if the output buffer is full?
-    VERIFY(copied_length == length);
+    auto entry = TRY(m_distance_table.read_entry(stream));
+    if (entry & invalid_entry_flag)
+        return Error::from_string_literal("Invalid deflate distance symbol");
 
-    return true;
+    return entry_value(entry) + TRY(stream.read_bits(entry_extra_bits(entry)));
 }
 
 DeflateDecompressor::UncompressedBlock::UncompressedBlock(DeflateDecompressor& decompressor, size_t length)
@@ -240,25 +596,24 @@ ErrorOr<bool> DeflateDecompressor::UncompressedBlock::try_read_more()
     if (m_decompressor.m_input_stream->is_eof())
         return Error::from_string_literal("Input data ends in the middle of an uncompressed DEFLATE block");
 
-    Array<u8, 4096> temporary_buffer;
-    auto readable_bytes = temporary_buffer.span().trim(min(m_bytes_remaining, m_decompressor.m_output_buffer.empty_space()));
+    auto& write_offset = m_decompressor.m_window_write_offset;
+    auto readable_bytes = m_decompressor.m_window.span().slice(write_offset, window_decode_limit - write_offset).trim(m_bytes_remaining);
     auto read_bytes = TRY(m_decompressor.m_input_stream->read_some(readable_bytes));
-    auto written_bytes = m_decompressor.m_output_buffer.write(read_bytes);
-    VERIFY(read_bytes.size() == written_bytes);
 
-    m_bytes_remaining -= written_bytes;
+    write_offset += read_bytes.size();
+    m_bytes_remaining -= read_bytes.size();
     return true;
 }
 
 ErrorOr<NonnullOwnPtr<DeflateDecompressor>> DeflateDecompressor::construct(MaybeOwned<LittleEndianInputBitStream> stream)
 {
-    auto output_buffer = TRY(CircularBuffer::create_empty(32 * KiB));
-    return TRY(adopt_nonnull_own_or_enomem(new (nothrow) DeflateDecompressor(move(stream), move(output_buffer))));
+    auto window = TRY(ByteBuffer::create_uninitialized(window_size));
+    return TRY(adopt_nonnull_own_or_enomem(new (nothrow) DeflateDecompressor(move(stream), move(window))));
 }
 
-DeflateDecompressor::DeflateDecompressor(MaybeOwned<LittleEndianInputBitStream> stream, CircularBuffer output_buffer)
+DeflateDecompressor::DeflateDecompressor(MaybeOwned<LittleEndianInputBitStream> stream, ByteBuffer window)
     : m_input_stream(move(stream))
-    , m_output_buffer(move(output_buffer))
+    , m_window(move(window))
 {
 }
 
@@ -270,11 +625,32 @@ DeflateDecompressor::~DeflateDecompressor()
         m_uncompressed_block.~UncompressedBlock();
 }
 
+void DeflateDecompressor::slide_window()
+{
+    VERIFY(m_window_read_offset == m_window_write_offset);
+
+    if (m_window_write_offset < window_decode_limit)
+        return;
+
+    // Keep the history that later back references may refer to, and start decoding right behind it.
+    memmove(m_window.data(), m_window.data() + m_window_write_offset - window_history_size, window_history_size);
+    m_window_read_offset = m_window_write_offset = window_history_size;
+}
+
 ErrorOr<Bytes> DeflateDecompressor::read_some(Bytes bytes)
 {
     size_t total_read = 0;
     while (total_read < bytes.size()) {
-        auto slice = bytes.slice(total_read);
+        if (m_window_read_offset < m_window_write_offset) {
+            auto decoded = m_window.span().slice(m_window_read_offset, m_window_write_offset - m_window_read_offset);
+            auto nread = decoded.copy_trimmed_to(bytes.slice(total_read));
+
+            m_window_read_offset += nread;
+            total_read += nread;
+            continue;
+        }
+
+        slide_window();
 
         if (m_state == State::Idle) {
             if (m_read_final_block)
@@ -300,18 +676,16 @@ ErrorOr<Bytes> DeflateDecompressor::read_some(Bytes bytes)
 
             if (block_type == 0b01) {
                 m_state = State::ReadingCompressedBlock;
-                new (&m_compressed_block) CompressedBlock(*this, CanonicalCode::fixed_literal_codes(), CanonicalCode::fixed_distance_codes());
+                new (&m_compressed_block) CompressedBlock(*this, DecodingTable::fixed_literal_length_table(), DecodingTable::fixed_distance_table());
 
                 continue;
             }
 
             if (block_type == 0b10) {
-                CanonicalCode literal_codes;
-                Optional<CanonicalCode> distance_codes;
-                TRY(decode_codes(literal_codes, distance_codes));
+                TRY(decode_codes(m_literal_length_table, m_distance_table));
 
                 m_state = State::ReadingCompressedBlock;
-                new (&m_compressed_block) CompressedBlock(*this, literal_codes, distance_codes);
+                new (&m_compressed_block) CompressedBlock(*this, m_literal_length_table, m_distance_table);
 
                 continue;
             }
@@ -320,36 +694,20 @@ ErrorOr<Bytes> DeflateDecompressor::read_some(Bytes bytes)
         }
 
         if (m_state == State::ReadingCompressedBlock) {
-            auto nread = m_output_buffer.read(slice).size();
-
-            while (nread < slice.size() && TRY(m_compressed_block.try_read_more())) {
-                nread += m_output_buffer.read(slice.slice(nread)).size();
+            if (!TRY(m_compressed_block.try_read_more())) {
+                m_compressed_block.~CompressedBlock();
+                m_state = State::Idle;
             }
 
-            total_read += nread;
-            if (nread == slice.size())
-                break;
-
-            m_compressed_block.~CompressedBlock();
-            m_state = State::Idle;
-
             continue;
         }
 
         if (m_state == State::ReadingUncompressedBlock) {
-            auto nread = m_output_buffer.read(slice).size();
-
-            while (nread < slice.size() && TRY(m_uncompressed_block.try_read_more())) {
-                nread += m_output_buffer.read(slice.slice(nread)).size();
+            if (!TRY(m_uncompressed_block.try_read_more())) {
+                m_uncompressed_block.~UncompressedBlock();
+                m_state = State::Idle;
             }
 
-            total_read += nread;
-            if (nread == slice.size())
-                break;
-
-            m_uncompressed_block.~UncompressedBlock();
-            m_state = State::Idle;
-
             continue;
         }
 
@@ -359,7 +717,7 @@ ErrorOr<Bytes> DeflateDecompressor::read_some(Bytes bytes)
     return bytes.slice(0, total_read);
 }
 
-bool DeflateDecompressor::is_eof() const { return m_state == State::Idle && m_read_final_block; }
+bool DeflateDecompressor::is_eof() const { return m_state == State::Idle && m_read_final_block && m_window_read_offset == m_window_write_offset; }
 
 ErrorOr<size_t> DeflateDecompressor::write_some(ReadonlyBytes)
 {
@@ -380,39 +738,10 @@ ErrorOr<ByteBuffer> DeflateDecompressor::decompress_all(ReadonlyBytes bytes)
     FixedMemoryStream memory_stream { bytes };
     LittleEndianInputBitStream bit_stream { MaybeOwned<Stream>(memory_stream) };
     auto deflate_stream = TRY(DeflateDecompressor::construct(MaybeOwned<LittleEndianInputBitStream>(bit_stream)));
-    return deflate_stream->read_until_eof(4096);
-}
-
-ErrorOr<u32> DeflateDecompressor::decode_length(u32 symbol)
-{
-    if (symbol <= 264)
-        return symbol - 254;
-
-    if (symbol <= 284) {
-        auto extra_bits = (symbol - 261) / 4;
-        return (((symbol - 265) % 4 + 4) << extra_bits) + 3 + TRY(m_input_stream->read_bits(extra_bits));
-    }
-
-    if (symbol == 285)
-        return DeflateDecompressor::max_back_reference_length;
-
-    VERIFY_NOT_REACHED();
+    return deflate_stream->read_until_eof(64 * KiB);
 }
 
-ErrorOr<u32> DeflateDecompressor::decode_distance(u32 symbol)
-{
-    if (symbol <= 3)
-        return symbol + 1;
-
-    if (symbol <= 29) {
-        auto extra_bits = (symbol / 2) - 1;
-        return ((symbol % 2 + 2) << extra_bits) + 1 + TRY(m_input_stream->read_bits(extra_bits));
-    }
-
-    VERIFY_NOT_REACHED();
-}
-
-ErrorOr<void> DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code)
+ErrorOr<void> DeflateDecompressor::decode_codes(DecodingTable& literal_length_table, DecodingTable& distance_table)
 {
     auto literal_code_count = TRY(m_input_stream->read_bits(5)) + 257;
     auto distance_code_count = TRY(m_input_stream->read_bits(5)) + 1;
@@ -459,20 +788,14 @@ ErrorOr<void> DeflateDecompressor::decode_codes(CanonicalCode& literal_code, Opt
         return Error::from_string_literal("Number of code lengths does not match the sum of codes");
 
     // Now we extract the code that was used to encode literals and lengths in the block.
-    literal_code = TRY(CanonicalCode::from_bytes(code_lengths.span().trim(literal_code_count)));
+    TRY(literal_length_table.build(code_lengths.span().trim(literal_code_count), DecodingTable::Alphabet::LiteralLength));
 
     // Now we extract the code that was used to encode distances in the block.
 
-    if (distance_code_count == 1) {
-        auto length = code_lengths[literal_code_count];
+    if (distance_code_count == 1 && code_lengths[literal_code_count] > 1)
+        return Error::from_string_literal("Length for a single distance code is longer than 1");
 
-        if (length == 0)
-            return {};
-        else if (length != 1)
-            return Error::from_string_literal("Length for a single distance code is longer than 1");
-    }
-
-    distance_code = TRY(CanonicalCode::from_bytes(code_lengths.span().slice(literal_code_count)));
+    TRY(distance_table.build(code_lengths.span().slice(literal_code_count), DecodingTable::Alphabet::Distance));
 
     return {};
 }
@@ -481,6 +804,13 @@ ErrorOr<NonnullOwnPtr<DeflateCompressor>> DeflateCompressor::construct(MaybeOwne
 {
     auto bit_stream = TRY(try_make<LittleEndianOutputBitStream>(move(stream)));
     auto deflate_compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DeflateCompressor(move(bit_stream), compression_level)));
+
+    if (deflate_compressor->m_compression_constants.parsing == MatchParsing::Optimal) {
+        TRY(deflate_compressor->m_tree_children.try_resize(2 * window_size));
+        TRY(deflate_compressor->m_match_counts.try_resize(block_size));
+        TRY(deflate_compressor->m_path.try_resize(block_size + 1));
+    }
+
     return deflate_compressor;
 }
 
@@ -491,6 +821,12 @@ DeflateCompressor::DeflateCompressor(NonnullOwnPtr<LittleEndianOutputBitStream>
 {
     m_symbol_frequencies.fill(0);
     m_distance_frequencies.fill(0);
+
+    // initialize chained hash tables
+    for (auto& slot : m_hash_head)
+        slot = empty_slot;
+    for (auto& slot : m_short_hash_head)
+        slot = empty_slot;
 }
 
 DeflateCompressor::~DeflateCompressor()
@@ -542,30 +878,54 @@ u16 DeflateCompressor::hash_sequence(u8 const* bytes)
     return ((bytes[0] | bytes[1] << 8 | bytes[2] << 16 | bytes[3] << 24) * knuth_constant) >> (32 - hash_bits);
 }
 
+// The same on 3 bytes, for the short match hash table
+u16 DeflateCompressor::short_hash_sequence(u8 const* bytes)
+{
+    constexpr u32 const knuth_constant = 2654435761;
+    return ((bytes[0] | bytes[1] << 8 | bytes[2] << 16) * knuth_constant) >> (32 - short_hash_bits);
+}
+
+size_t DeflateCompressor::common_prefix_length(size_t start, size_t candidate, size_t known_length, size_t maximum_match_length) const
+{
+    // compare 8 bytes at a time, the first differing byte is given by the lowest set bit of the difference
+    size_t length = known_length;
+    while (length + sizeof(u64) <= maximum_match_length) {
+        u64 a;
+        u64 b;
+        __builtin_memcpy(&a, &m_rolling_window[start + length], sizeof(u64));
+        __builtin_memcpy(&b, &m_rolling_window[candidate + length], sizeof(u64));
+        if (auto difference = a ^ b; difference != 0) {
+            if constexpr (AK::HostIsLittleEndian)
+                return length + count_trailing_zeroes(difference) / 8;
+            else
+                return length + count_leading_zeroes(difference) / 8;
+        }
+        length += sizeof(u64);
+    }
+    while (length < maximum_match_length && m_rolling_window[start + length] == m_rolling_window[candidate + length])
+        length++;
+    return length;
+}
+
 size_t DeflateCompressor::compare_match_candidate(size_t start, size_t candidate, size_t previous_match_length, size_t maximum_match_length)
 {
     VERIFY(previous_match_length < maximum_match_length);
 
-    // We firstly check that the match is at least (prev_match_length + 1) long, we check backwards as there's a higher chance the end mismatches
-    for (ssize_t i = previous_match_length; i >= 0; i--) {
-        if (m_rolling_window[start + i] != m_rolling_window[candidate + i])
-            return 0;
-    }
+    // We firstly check that the match is at least (prev_match_length + 1) long, checking the last byte first as there's a higher chance the end mismatches
+    if (m_rolling_window[start + previous_match_length] != m_rolling_window[candidate + previous_match_length])
+        return 0;
 
     // Find the actual length
-    auto match_length = previous_match_length + 1;
-    while (match_length < maximum_match_length && m_rolling_window[start + match_length] == m_rolling_window[candidate + match_length]) {
-        match_length++;
-    }
-
-    VERIFY(match_length > previous_match_length);
-    VERIFY(match_length <= maximum_match_length);
+    auto match_length = common_prefix_length(start, candidate, 0, maximum_match_length);
+    if (match_length <= previous_match_length)
+        return 0;
     return match_length;
 }
 
 size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previous_match_length, size_t maximum_match_length, size_t& match_position)
 {
     auto max_chain_length = m_compression_constants.max_chain;
+    auto has_previous_match = previous_match_length != 0;
     if (previous_match_length == 0)
         previous_match_length = min_match_length - 1; // we only care about matches that are at least min_match_length long
     if (previous_match_length >= maximum_match_length)
@@ -582,7 +942,7 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             break; // no remaining candidates
 
         VERIFY(candidate < start);
-        if (start - candidate > window_size)
+        if (start - candidate > max_distance)
             break; // outside the window
 
         auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
@@ -596,47 +956,145 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
                 return match_length; // bail if we got the maximum possible length
         }
 
-        candidate = m_hash_prev[candidate % window_size];
+        candidate = m_hash_prev[candidate];
+    }
+    if (!match_found) {
+        // we didn't find any matches, but a short match is still better than a literal
+        if (!has_previous_match && m_compression_constants.find_short_matches)
+            return find_short_match(start, match_position);
+        return 0;
     }
-    if (!match_found)
-        return 0;                 // we didn't find any matches
     return previous_match_length; // we found matches, but they were at most previous_match_length long
 }
 
+size_t DeflateCompressor::find_short_match(size_t start, size_t& match_position)
+{
+    auto candidate = m_short_hash_head[short_hash_sequence(&m_rolling_window[start])];
+    if (candidate == empty_slot || start - candidate > max_short_match_distance)
+        return 0;
+    if (m_rolling_window[start] != m_rolling_window[candidate] || m_rolling_window[start + 1] != m_rolling_window[candidate + 1] || m_rolling_window[start + 2] != m_rolling_window[candidate + 2])
+        return 0;
+    match_position = candidate;
+    return short_match_length;
+}
+
+void DeflateCompressor::insert_hash(size_t position, u16 hash)
+{
+    m_hash_prev[position] = m_hash_head[hash];
+    m_hash_head[hash] = position;
+    if (m_compression_constants.find_short_matches)
+        m_short_hash_head[short_hash_sequence(&m_rolling_window[position])] = position;
+    m_next_insert_position = position + 1;
+}
+
+// Visits the binary tree of all earlier positions with the same hash, which is sorted by the bytes following each
+// position, to find the matches for the given position (in order of increasing length), and re-roots the tree there.
+size_t DeflateCompressor::find_tree_matches(size_t position, size_t maximum_match_length, Match* matches)
+{
+    auto* children = m_tree_children.data();
+    auto const* current = &m_rolling_window[position];
+    auto hash = hash_sequence(current);
+    size_t candidate = m_hash_head[hash];
+    m_hash_head[hash] = position;
+    m_next_insert_position = position + 1;
+
+    size_t match_count = 0;
+    if (matches && m_compression_constants.find_short_matches) {
+        size_t short_match_position;
+        if (find_short_match(position, short_match_position) != 0)
+            matches[match_count++] = { static_cast<u16>(short_match_length), static_cast<u16>(position - short_match_position) };
+    }
+    if (m_compression_constants.find_short_matches)
+        m_short_hash_head[short_hash_sequence(current)] = position;
+
+    // the new position becomes the root, everything smaller than it goes to its left, everything larger to its right
+    u16* pending_smaller = &children[2 * position];
+    u16* pending_larger = &children[2 * position + 1];
+    auto nice_length = min(m_compression_constants.great_match_length, maximum_match_length);
+    size_t best_length = min_match_length - 1;
+    size_t smaller_length = 0;
+    size_t larger_length = 0;
+    size_t length = 0;
+    auto remaining_depth = m_compression_constants.max_chain;
+
+    while (candidate != empty_slot && position - candidate <= max_distance && remaining_depth--) {
+        auto const* candidate_bytes = &m_rolling_window[candidate];
+        if (candidate_bytes[length] == current[length]) {
+            length = common_prefix_length(position, candidate, length + 1, nice_length);
+            if (matches && length > best_length) {
+                best_length = length;
+                matches[match_count++] = { static_cast<u16>(length), static_cast<u16>(position - candidate) };
+            }
+            if (length >= nice_length) {
+                if (maximum_match_length < max_match_length) {
+                    // we ran out of known bytes, so we can't tell on which side of the candidate the bytes that arrive
+                    // later on will sort, and have to give up on the candidate's subtree to keep the tree consistent
+                    *pending_smaller = empty_slot;
+                    *pending_larger = empty_slot;
+                    return match_count;
+                }
+                // the candidate is (as far as we care) identical, so it can simply be replaced by the new position
+                *pending_smaller = children[2 * candidate];
+                *pending_larger = children[2 * candidate + 1];
+                return match_count;
+            }
+        }
+
+        if (candidate_bytes[length] < current[length]) {
+            *pending_smaller = candidate;
+            pending_smaller = &children[2 * candidate + 1];
+            candidate = *pending_smaller;
+            smaller_length = length;
+        } else {
+            *pending_larger = candidate;
+            pending_larger = &children[2 * candidate];
+            candidate = *pending_larger;
+            larger_length = length;
+        }
+        // every node in the remaining subtree shares at least this many bytes with the current position
+        length = min(smaller_length, larger_length);
+    }
+
+    *pending_smaller = empty_slot;
+    *pending_larger = empty_slot;
+    return match_count;
+}
+
 ALWAYS_INLINE u8 DeflateCompressor::distance_to_base(u16 distance)
 {
     return (distance <= 256) ? distance_to_base_lo[distance - 1] : distance_to_base_hi[(distance - 1) >> 7];
 }
 
-void DeflateCompressor::lz77_compress_block()
+void DeflateCompressor::insert_history(size_t block_end)
 {
-    for (auto& slot : m_hash_head) { // initialize chained hash table
-        slot = empty_slot;
+    // positions at the very end of the previous block (or in a preset dictionary) can only be hashed once the bytes following them are known
+    auto insert_end = min(block_size, block_end - min_match_length + 1);
+    for (auto position = m_next_insert_position; position < insert_end; position++) {
+        if (m_compression_constants.parsing == MatchParsing::Optimal)
+            (void)find_tree_matches(position, block_end - position, nullptr);
+        else
+            insert_hash(position, hash_sequence(&m_rolling_window[position]));
     }
+}
 
-    auto insert_hash = [&](auto pos, auto hash) {
-        auto window_pos = pos % window_size;
-        m_hash_prev[window_pos] = m_hash_head[hash];
-        m_hash_head[hash] = window_pos;
-    };
-
-    auto emit_literal = [&](auto literal) {
-        VERIFY(m_pending_symbol_size <= block_size + 1);
-        auto index = m_pending_symbol_size++;
-        m_symbol_buffer[index].distance = 0;
-        m_symbol_buffer[index].literal = literal;
-        m_symbol_frequencies[literal]++;
-    };
+void DeflateCompressor::emit_literal(u8 literal)
+{
+    VERIFY(m_pending_symbol_size < block_size);
+    auto index = m_pending_symbol_size++;
+    m_symbol_buffer[index].distance = 0;
+    m_symbol_buffer[index].literal = literal;
+}
 
-    auto emit_back_reference = [&](auto distance, auto length) {
-        VERIFY(m_pending_symbol_size <= block_size + 1);
-        auto index = m_pending_symbol_size++;
-        m_symbol_buffer[index].distance = distance;
-        m_symbol_buffer[index].length = length;
-        m_symbol_frequencies[length_to_symbol[length]]++;
-        m_distance_frequencies[distance_to_base(distance)]++;
-    };
+void DeflateCompressor::emit_back_reference(u16 distance, u16 length)
+{
+    VERIFY(m_pending_symbol_size < block_size);
+    auto index = m_pending_symbol_size++;
+    m_symbol_buffer[index].distance = distance;
+    m_symbol_buffer[index].length = length;
+}
 
+void DeflateCompressor::lz77_compress_block()
+{
     size_t previous_match_length = 0;
     size_t previous_match_position = 0;
 
@@ -644,6 +1102,8 @@ void DeflateCompressor::lz77_compress_block()
 
     // our block starts at block_size and is m_pending_block_size in length
     auto block_end = block_size + m_pending_block_size;
+    insert_history(block_end);
+
     size_t current_position;
     for (current_position = block_size; current_position < block_end - min_match_length + 1; current_position++) {
         auto hash = hash_sequence(&m_rolling_window[current_position]);
@@ -714,11 +1174,11 @@ size_t DeflateCompressor::huffman_block_length(Array<u8, max_huffman_literals> c
     return length;
 }
 
-size_t DeflateCompressor::uncompressed_block_length()
+size_t DeflateCompressor::uncompressed_block_length(size_t input_size)
 {
     auto padding = 8 - ((m_output_stream->bit_offset() + 3) % 8);
     // 3 bit block header + align to byte + 2 * 16 bit length fields + block contents
-    return 3 + padding + (2 * 16) + m_pending_block_size * 8;
+    return 3 + padding + (2 * 16) + input_size * 8;
 }
 
 size_t DeflateCompressor::fixed_block_length()
@@ -751,25 +1211,26 @@ size_t DeflateCompressor::dynamic_block_length(Array<u8, max_huffman_literals> c
     return length + huffman_block_length(literal_bit_lengths, distance_bit_lengths);
 }
 
-ErrorOr<void> DeflateCompressor::write_huffman(CanonicalCode const& literal_code, Optional<CanonicalCode> const& distance_code)
+ErrorOr<void> DeflateCompressor::write_huffman(ReadonlySpan<Symbol> symbols, CanonicalCode const& literal_code, Optional<CanonicalCode> const& distance_code)
 {
     auto has_distances = distance_code.has_value();
-    for (size_t i = 0; i < m_pending_symbol_size; i++) {
-        if (m_symbol_buffer[i].distance == 0) {
-            TRY(literal_code.write_symbol(*m_output_stream, m_symbol_buffer[i].literal));
+    for (auto const& symbol : symbols) {
+        if (symbol.distance == 0) {
+            TRY(literal_code.write_symbol(*m_output_stream, symbol.literal));
             continue;
         }
         VERIFY(has_distances);
-        auto symbol = length_to_symbol[m_symbol_buffer[i].length];
-        TRY(literal_code.write_symbol(*m_output_stream, symbol));
+        auto length_symbol = length_to_symbol[symbol.length];
+        TRY(literal_code.write_symbol(*m_output_stream, length_symbol));
         // Emit extra bits if needed
-        TRY(m_output_stream->write_bits<u16>(m_symbol_buffer[i].length - packed_length_symbols[symbol - 257].base_length, packed_length_symbols[symbol - 257].extra_bits));
+        TRY(m_output_stream->write_bits<u16>(symbol.length - packed_length_symbols[length_symbol - 257].base_length, packed_length_symbols[length_symbol - 257].extra_bits));
 
-        auto base_distance = distance_to_base(m_symbol_buffer[i].distance);
+        auto base_distance = distance_to_base(symbol.distance);
         TRY(distance_code.value().write_symbol(*m_output_stream, base_distance));
         // Emit extra bits if needed
-        TRY(m_output_stream->write_bits<u16>(m_symbol_buffer[i].distance - packed_distances[base_distance].base_distance, packed_distances[base_distance].extra_bits));
+        TRY(m_output_stream->write_bits<u16>(symbol.distance - packed_distances[base_distance].base_distance, packed_distances[base_distance].extra_bits));
     }
+    TRY(literal_code.write_symbol(*m_output_stream, EndOfBlock));
     return {};
 }
 
@@ -838,7 +1299,7 @@ size_t DeflateCompressor::encode_block_lengths(Array<u8, max_huffman_literals> c
     return encode_huffman_lengths(all_lengths.span().trim(literal_code_count + distance_code_count), encoded_lengths);
 }
 
-ErrorOr<void> DeflateCompressor::write_dynamic_huffman(CanonicalCode const& literal_code, size_t literal_code_count, Optional<CanonicalCode> const& distance_code, size_t distance_code_count, Array<u8, 19> const& code_lengths_bit_lengths, size_t code_length_count, Array<code_length_symbol, max_huffman_literals + max_huffman_distances> const& encoded_lengths, size_t encoded_lengths_count)
+ErrorOr<void> DeflateCompressor::write_dynamic_huffman(ReadonlySpan<Symbol> symbols, CanonicalCode const& literal_code, size_t literal_code_count, Optional<CanonicalCode> const& distance_code, size_t distance_code_count, Array<u8, 19> const& code_lengths_bit_lengths, size_t code_length_count, Array<code_length_symbol, max_huffman_literals + max_huffman_distances> const& encoded_lengths, size_t encoded_lengths_count)
 {
     TRY(m_output_stream->write_bits(literal_code_count - 257, 5));
     TRY(m_output_stream->write_bits(distance_code_count - 1, 5));
@@ -861,108 +1322,461 @@ ErrorOr<void> DeflateCompressor::write_dynamic_huffman(CanonicalCode const& lite
         }
     }
 
-    TRY(write_huffman(literal_code, distance_code));
+    TRY(write_huffman(symbols, literal_code, distance_code));
     return {};
 }
 
-ErrorOr<void> DeflateCompressor::flush()
+void DeflateCompressor::count_symbol_frequencies(ReadonlySpan<Symbol> symbols)
 {
-    TRY(m_output_stream->write_bits(m_finished, 1));
-
-    // if this is just an empty block to signify the end of the deflate stream use the smallest block possible (10 bits total)
-    if (m_pending_block_size == 0) {
-        VERIFY(m_finished);                              // we shouldn't be writing empty blocks unless this is the final one
-        TRY(m_output_stream->write_bits(0b01u, 2));      // fixed huffman codes
-        TRY(m_output_stream->write_bits(0b0000000u, 7)); // end of block symbol
-        TRY(m_output_stream->align_to_byte_boundary());
-        return {};
-    }
-
-    auto write_uncompressed = [&]() -> ErrorOr<void> {
-        TRY(m_output_stream->write_bits(0b00u, 2)); // no compression
-        TRY(m_output_stream->align_to_byte_boundary());
-        TRY(m_output_stream->write_value<LittleEndian<u16>>(m_pending_block_size));
-        TRY(m_output_stream->write_value<LittleEndian<u16>>(~m_pending_block_size));
-        TRY(m_output_stream->write_until_depleted(pending_block().slice(0, m_pending_block_size)));
-        return {};
-    };
-
-    if (m_compression_level == CompressionLevel::STORE) { // disabled compression fast path
-        TRY(write_uncompressed());
-        m_pending_block_size = 0;
-        return {};
+    m_symbol_frequencies.fill(0);
+    m_distance_frequencies.fill(0);
+    for (auto const& symbol : symbols) {
+        if (symbol.distance == 0) {
+            m_symbol_frequencies[symbol.literal]++;
+            continue;
+        }
+        m_symbol_frequencies[length_to_symbol[symbol.length]]++;
+        m_distance_frequencies[distance_to_base(symbol.distance)]++;
     }
-
-    // The following implementation of lz77 compression and huffman encoding is based on the reference implementation by Hans Wennborg https://www.hanshq.net/zip.html
-
-    // this reads from the pending block and writes to m_symbol_buffer
-    lz77_compress_block();
-
-    // insert EndOfBlock marker to the symbol buffer
-    m_symbol_buffer[m_pending_symbol_size].distance = 0;
-    m_symbol_buffer[m_pending_symbol_size++].literal = EndOfBlock;
     m_symbol_frequencies[EndOfBlock]++;
+}
 
+void DeflateCompressor::build_dynamic_codes(DynamicCodes& codes)
+{
     // generate optimal dynamic huffman code lengths
-    Array<u8, max_huffman_literals> dynamic_literal_bit_lengths {};
-    Array<u8, max_huffman_distances> dynamic_distance_bit_lengths {};
-    generate_huffman_lengths(dynamic_literal_bit_lengths, m_symbol_frequencies, 15); // deflate data huffman can use up to 15 bits per symbol
-    generate_huffman_lengths(dynamic_distance_bit_lengths, m_distance_frequencies, 15);
+    generate_huffman_lengths(codes.literal_bit_lengths, m_symbol_frequencies, 15); // deflate data huffman can use up to 15 bits per symbol
+    generate_huffman_lengths(codes.distance_bit_lengths, m_distance_frequencies, 15);
 
     // encode literal and distance lengths together in deflate format
-    Array<code_length_symbol, max_huffman_literals + max_huffman_distances> encoded_lengths {};
-    size_t literal_code_count;
-    size_t distance_code_count;
-    auto encoded_lengths_count = encode_block_lengths(dynamic_literal_bit_lengths, dynamic_distance_bit_lengths, encoded_lengths, literal_code_count, distance_code_count);
+    codes.encoded_lengths_count = encode_block_lengths(codes.literal_bit_lengths, codes.distance_bit_lengths, codes.encoded_lengths, codes.literal_code_count, codes.distance_code_count);
 
     // count code length frequencies
-    Array<u16, 19> code_lengths_frequencies { 0 };
-    for (size_t i = 0; i < encoded_lengths_count; i++) {
-        code_lengths_frequencies[encoded_lengths[i].symbol]++;
+    codes.code_lengths_frequencies.fill(0);
+    for (size_t i = 0; i < codes.encoded_lengths_count; i++) {
+        codes.code_lengths_frequencies[codes.encoded_lengths[i].symbol]++;
     }
     // generate optimal huffman code lengths code lengths
-    Array<u8, 19> code_lengths_bit_lengths {};
-    generate_huffman_lengths(code_lengths_bit_lengths, code_lengths_frequencies, 7); // deflate code length huffman can use up to 7 bits per symbol
+    generate_huffman_lengths(codes.code_lengths_bit_lengths, codes.code_lengths_frequencies, 7); // deflate code length huffman can use up to 7 bits per symbol
     // calculate actual code length code lengths count (without trailing zeros)
-    auto code_lengths_count = code_lengths_bit_lengths.size();
-    while (code_lengths_bit_lengths[code_lengths_code_lengths_order[code_lengths_count - 1]] == 0)
-        code_lengths_count--;
+    codes.code_lengths_count = codes.code_lengths_bit_lengths.size();
+    while (codes.code_lengths_bit_lengths[code_lengths_code_lengths_order[codes.code_lengths_count - 1]] == 0)
+        codes.code_lengths_count--;
+}
 
-    auto uncompressed_size = uncompressed_block_length();
+size_t DeflateCompressor::block_length(ReadonlySpan<Symbol> symbols, size_t input_size)
+{
+    count_symbol_frequencies(symbols);
+    DynamicCodes codes;
+    build_dynamic_codes(codes);
+    auto dynamic_huffman_size = dynamic_block_length(codes.literal_bit_lengths, codes.distance_bit_lengths, codes.code_lengths_bit_lengths, codes.code_lengths_frequencies, codes.code_lengths_count);
+    return min(uncompressed_block_length(input_size), min(fixed_block_length(), dynamic_huffman_size));
+}
+
+ErrorOr<void> DeflateCompressor::write_block(ReadonlySpan<Symbol> symbols, ReadonlyBytes input, bool is_final_block)
+{
+    TRY(m_output_stream->write_bits(is_final_block, 1));
+
+    count_symbol_frequencies(symbols);
+    DynamicCodes codes;
+    build_dynamic_codes(codes);
+
+    auto uncompressed_size = uncompressed_block_length(input.size());
     auto fixed_huffman_size = fixed_block_length();
-    auto dynamic_huffman_size = dynamic_block_length(dynamic_literal_bit_lengths, dynamic_distance_bit_lengths, code_lengths_bit_lengths, code_lengths_frequencies, code_lengths_count);
+    auto dynamic_huffman_size = dynamic_block_length(codes.literal_bit_lengths, codes.distance_bit_lengths, codes.code_lengths_bit_lengths, codes.code_lengths_frequencies, codes.code_lengths_count);
 
     // If the compression somehow didn't reduce the size enough, just write out the block uncompressed as it allows for much faster decompression
     if (uncompressed_size <= min(fixed_huffman_size, dynamic_huffman_size)) {
-        TRY(write_uncompressed());
+        TRY(m_output_stream->write_bits(0b00u, 2)); // no compression
+        TRY(m_output_stream->align_to_byte_boundary());
+        TRY(m_output_stream->write_value<LittleEndian<u16>>(input.size()));
+        TRY(m_output_stream->write_value<LittleEndian<u16>>(~input.size()));
+        TRY(m_output_stream->write_until_depleted(input));
     } else if (fixed_huffman_size <= dynamic_huffman_size) {
         // If the fixed and dynamic huffman codes come out the same size, prefer the fixed version, as it takes less time to decode fixed huffman codes.
         TRY(m_output_stream->write_bits(0b01u, 2));
-        TRY(write_huffman(CanonicalCode::fixed_literal_codes(), CanonicalCode::fixed_distance_codes()));
+        TRY(write_huffman(symbols, CanonicalCode::fixed_literal_codes(), CanonicalCode::fixed_distance_codes()));
     } else {
         // dynamic huffman codes
         TRY(m_output_stream->write_bits(0b10u, 2));
-        auto literal_code = MUST(CanonicalCode::from_bytes(dynamic_literal_bit_lengths));
-        auto distance_code_or_error = CanonicalCode::from_bytes(dynamic_distance_bit_lengths);
+        auto literal_code = MUST(CanonicalCode::from_bytes(codes.literal_bit_lengths));
+        auto distance_code_or_error = CanonicalCode::from_bytes(codes.distance_bit_lengths);
         Optional<CanonicalCode> distance_code;
         if (!distance_code_or_error.is_error())
             distance_code = distance_code_or_error.release_value();
-        TRY(write_dynamic_huffman(literal_code, literal_code_count, distance_code, distance_code_count, code_lengths_bit_lengths, code_lengths_count, encoded_lengths, encoded_lengths_count));
+        TRY(write_dynamic_huffman(symbols, literal_code, codes.literal_code_count, distance_code, codes.distance_code_count, codes.code_lengths_bit_lengths, codes.code_lengths_count, codes.encoded_lengths, codes.encoded_lengths_count));
+    }
+    return {};
+}
+
+// Fixed point costs in 1/16th of a bit, which lets the initial estimates be fractional
+static constexpr u32 cost_scale = 16;
+
+// Scaled costs of symbols that did not occur in the previous pass (and so have no code)
+static constexpr u32 unused_literal_cost = 13 * cost_scale;
+static constexpr u32 unused_length_cost = 13 * cost_scale;
+static constexpr u32 unused_distance_cost = 10 * cost_scale;
+
+// Entropy coding a symbol that makes up frequency/total of the data takes log2(total/frequency) bits, so entropy coding
+// all of them takes total * log2(total) - sum(frequency * log2(frequency)) bits. This is the second term (scaled) for
+// every frequency that can occur within a block.
+static Span<u32 const> scaled_frequency_log2_table()
+{
+    static auto const table = [] {
+        Vector<u32> table;
+        table.resize(DeflateCompressor::block_size + 2);
+        for (size_t frequency = 1; frequency < table.size(); ++frequency)
+            table[frequency] = static_cast<u32>(static_cast<double>(frequency) * AK::log2(static_cast<double>(frequency)) * cost_scale);
+        return table;
+    }();
+    return table.span();
+}
+
+void DeflateCompressor::compute_symbol_costs(SymbolCosts& costs, bool from_frequencies)
+{
+    if (from_frequencies) {
+        // the symbols will most likely be about as expensive as they would be with the Huffman codes of the previous pass
+        Array<u8, max_huffman_literals> literal_bit_lengths {};
+        Array<u8, max_huffman_distances> distance_bit_lengths {};
+        generate_huffman_lengths(literal_bit_lengths, m_symbol_frequencies, 15);
+        generate_huffman_lengths(distance_bit_lengths, m_distance_frequencies, 15);
+        for (size_t i = 0; i < 256; i++)
+            costs.literals[i] = literal_bit_lengths[i] != 0 ? literal_bit_lengths[i] * cost_scale : unused_literal_cost;
+        for (size_t i = 257; i < 286; i++)
+            costs.literals[i] = literal_bit_lengths[i] != 0 ? literal_bit_lengths[i] * cost_scale : unused_length_cost;
+        for (size_t i = 0; i < 30; i++)
+            costs.distances[i] = distance_bit_lengths[i] != 0 ? distance_bit_lengths[i] * cost_scale : unused_distance_cost;
+    } else {
+        // for the first pass we guess that the literals are entropy coded according to their frequency in the block,
+        // and that all length and distance codes are about as long as their fixed Huffman codes
+        Array<u32, 256> byte_frequencies {};
+        for (auto byte : pending_block().trim(m_pending_block_size))
+            byte_frequencies[byte]++;
+        auto log2_table = scaled_frequency_log2_table();
+        auto total_log2 = log2_table[m_pending_block_size] / m_pending_block_size;
+        for (size_t i = 0; i < 256; i++) {
+            auto frequency = byte_frequencies[i];
+            costs.literals[i] = frequency != 0 ? max(total_log2 - log2_table[frequency] / frequency, cost_scale) : unused_literal_cost;
+        }
+        for (size_t i = 257; i < 286; i++)
+            costs.literals[i] = (i < 280 ? 7 : 8) * cost_scale;
+        for (size_t i = 0; i < 30; i++)
+            costs.distances[i] = 5 * cost_scale;
+    }
+
+    for (size_t length = short_match_length; length <= max_match_length; length++) {
+        auto symbol = length_to_symbol[length];
+        costs.lengths[length] = costs.literals[symbol] + packed_length_symbols[symbol - 257].extra_bits * cost_scale;
+    }
+    for (size_t i = 0; i < 30; i++)
+        costs.distances[i] += packed_distances[i].extra_bits * cost_scale;
+}
+
+ErrorOr<void> DeflateCompressor::optimal_compress_block()
+{
+    VERIFY(m_compression_constants.max_chain < NumericLimits<u8>::max());
+
+    // our block starts at block_size and is m_pending_block_size in length
+    auto block_end = block_size + m_pending_block_size;
+    insert_history(block_end);
+
+    // find all (increasingly long) matches for every position in the block, except for those inside of a match
+    // that is so long that we will take it anyway
+    m_match_cache.clear_with_capacity();
+    Array<Match, NumericLimits<u8>::max()> position_matches; // the short match, and up to one match for every tree node we visit
+    for (size_t position = block_size; position < block_end;) {
+        auto remaining = block_end - position;
+        if (remaining < min_match_length) {
+            m_match_counts[position++ - block_size] = 0;
+            continue;
+        }
+
+        auto maximum_match_length = min(remaining, max_match_length);
+        auto match_count = find_tree_matches(position, maximum_match_length, position_matches.data());
+        TRY(m_match_cache.try_append(position_matches.data(), match_count));
+        m_match_counts[position++ - block_size] = match_count;
+
+        if (match_count == 0)
+            continue;
+        auto longest_match_length = position_matches[match_count - 1].length;
+        if (longest_match_length < min(m_compression_constants.great_match_length, maximum_match_length))
+            continue;
+        for (auto match_end = position - 1 + longest_match_length; position < match_end; position++) {
+            if (block_end - position >= min_match_length)
+                (void)find_tree_matches(position, min(block_end - position, max_match_length), nullptr);
+            m_match_counts[position - block_size] = 0;
+        }
+    }
+
+    // find the cheapest path through the block according to our cost model, then refine the cost model with the
+    // actual frequencies of the symbols on that path and try again
+    SymbolCosts costs;
+    compute_symbol_costs(costs, false);
+    auto* path = m_path.data();
+    for (size_t pass = 0; pass < m_compression_constants.optimal_parsing_passes; pass++) {
+        if (pass != 0) {
+            count_symbol_frequencies({ m_symbol_buffer, m_pending_symbol_size });
+            compute_symbol_costs(costs, true);
+        }
+
+        path[0].cost = 0;
+        for (size_t i = 1; i <= m_pending_block_size; i++)
+            path[i].cost = NumericLimits<u32>::max();
+
+        auto const* matches = m_match_cache.data();
+        for (size_t i = 0; i < m_pending_block_size; i++) {
+            auto cost = path[i].cost;
+
+            auto literal_cost = cost + costs.literals[m_rolling_window[block_size + i]];
+            if (literal_cost < path[i + 1].cost)
+                path[i + 1] = { literal_cost, { 1, 0 } };
+
+            // every prefix of a match is a match as well
+            size_t length = short_match_length;
+            for (size_t j = 0; j < m_match_counts[i]; j++) {
+                auto match = matches[j];
+                auto distance_cost = cost + costs.distances[distance_to_base(match.distance)];
+                for (; length <= match.length; length++) {
+                    auto match_cost = distance_cost + costs.lengths[length];
+                    if (match_cost < path[i + length].cost)
+                        path[i + length] = { match_cost, { static_cast<u16>(length), match.distance } };
+                }
+            }
+            matches += m_match_counts[i];
+        }
+
+        // walk the path backwards, and leave the step to take from each node on it in place of its (no longer needed) cost
+        for (size_t i = m_pending_block_size; i > 0;) {
+            auto step = path[i].step;
+            i -= step.length;
+            path[i].cost = step.length | step.distance << 16;
+        }
+
+        m_pending_symbol_size = 0;
+        for (size_t i = 0; i < m_pending_block_size;) {
+            u16 length = path[i].cost & 0xffff;
+            u16 distance = path[i].cost >> 16;
+            if (distance == 0)
+                emit_literal(m_rolling_window[block_size + i]);
+            else
+                emit_back_reference(distance, length);
+            i += length;
+        }
+    }
+
+    return {};
+}
+
+Vector<size_t, DeflateCompressor::max_block_splits> DeflateCompressor::split_block()
+{
+    ReadonlySpan<Symbol> symbols { m_symbol_buffer, m_pending_symbol_size };
+    Vector<size_t, max_block_splits> block_ends;
+    block_ends.append(symbols.size());
+
+    // cut the block into segments of roughly equal input size, and gather the symbol frequencies in front of each segment boundary
+    static constexpr size_t min_segment_size = 1 * KiB;
+    auto segment_size = max(ceil_div(m_pending_block_size, max_block_splits), min_segment_size);
+    if (m_pending_block_size < 2 * segment_size)
+        return block_ends;
+
+    static constexpr size_t alphabet_size = 286 + 30;
+    Array<Array<u16, alphabet_size>, max_block_splits + 1> frequencies_before;
+    Array<size_t, max_block_splits + 1> segment_ends;
+    frequencies_before[0].fill(0);
+    segment_ends[0] = 0;
+
+    size_t segment_count = 0;
+    Array<u16, alphabet_size> frequencies {};
+    size_t input_size = 0;
+    for (size_t i = 0; i < symbols.size(); i++) {
+        auto const& symbol = symbols[i];
+        if (symbol.distance == 0) {
+            frequencies[symbol.literal]++;
+            input_size++;
+        } else {
+            frequencies[length_to_symbol[symbol.length]]++;
+            frequencies[286 + distance_to_base(symbol.distance)]++;
+            input_size += symbol.length;
+        }
+        if (input_size >= (segment_count + 1) * segment_size || i == symbols.size() - 1) {
+            segment_count++;
+            frequencies_before[segment_count] = frequencies;
+            segment_ends[segment_count] = i + 1;
+        }
+    }
+
+    // estimate the size of a block made up of the given segments from the entropy of its symbols, and the size of a
+    // dynamic Huffman header with that many different symbols
+    auto log2_table = scaled_frequency_log2_table();
+    auto estimate_block_cost = [&](size_t first_segment, size_t end_segment) {
+        auto const& before = frequencies_before[first_segment];
+        auto const& after = frequencies_before[end_segment];
+        u64 cost = 64 * cost_scale;
+        u32 literal_total = 1; // the end of block symbol
+        u32 distance_total = 0;
+        u64 frequency_log2_sum = 0;
+        size_t used_symbols = 1;
+        for (size_t i = 0; i < alphabet_size; i++) {
+            u32 frequency = after[i] - before[i];
+            if (frequency == 0)
+                continue;
+            (i < 286 ? literal_total : distance_total) += frequency;
+            frequency_log2_sum += log2_table[frequency];
+            used_symbols++;
+        }
+        cost += used_symbols * 5 * cost_scale;
+        cost += log2_table[literal_total] + log2_table[distance_total] - frequency_log2_sum;
+        return cost;
+    };
+
+    // find the cheapest way of grouping the segments into blocks
+    Array<u64, max_block_splits + 1> cheapest_cost;
+    Array<size_t, max_block_splits + 1> cheapest_block_start;
+    cheapest_cost[0] = 0;
+    for (size_t end = 1; end <= segment_count; end++) {
+        cheapest_cost[end] = NumericLimits<u64>::max();
+        for (size_t start = 0; start < end; start++) {
+            auto cost = cheapest_cost[start] + estimate_block_cost(start, end);
+            if (cost < cheapest_cost[end]) {
+                cheapest_cost[end] = cost;
+                cheapest_block_start[end] = start;
+            }
+        }
+    }
+    if (cheapest_block_start[segment_count] == 0)
+        return block_ends;
+
+    Vector<size_t, max_block_splits> split_block_ends;
+    for (auto end = segment_count; end != 0; end = cheapest_block_start[end])
+        split_block_ends.prepend(segment_ends[end]);
+
+    // the estimates are rough, so make sure that splitting the block actually pays off
+    size_t split_length = 0;
+    size_t block_start = 0;
+    for (auto block_end : split_block_ends) {
+        auto block_symbols = symbols.slice(block_start, block_end - block_start);
+        size_t block_input_size = 0;
+        for (auto const& symbol : block_symbols)
+            block_input_size += symbol.distance == 0 ? 1 : symbol.length;
+        split_length += block_length(block_symbols, block_input_size);
+        block_start = block_end;
+    }
+    if (split_length >= block_length(symbols, m_pending_block_size))
+        return block_ends;
+
+    return split_block_ends;
+}
+
+ErrorOr<void> DeflateCompressor::flush()
+{
+    // if this is just an empty block to signify the end of the deflate stream use the smallest block possible (10 bits total)
+    if (m_pending_block_size == 0) {
+        VERIFY(m_finished);                              // we shouldn't be writing empty blocks unless this is the final one
+        TRY(m_output_stream->write_bits(1u, 1));         // final block
+        TRY(m_output_stream->write_bits(0b01u, 2));      // fixed huffman codes
+        TRY(m_output_stream->write_bits(0b0000000u, 7)); // end of block symbol
+        TRY(m_output_stream->align_to_byte_boundary());
+        return {};
+    }
+
+    if (m_compression_level == CompressionLevel::STORE) { // disabled compression fast path
+        TRY(m_output_stream->write_bits(m_finished, 1));
+        TRY(m_output_stream->write_bits(0b00u, 2)); // no compression
+        TRY(m_output_stream->align_to_byte_boundary());
+        TRY(m_output_stream->write_value<LittleEndian<u16>>(m_pending_block_size));
+        TRY(m_output_stream->write_value<LittleEndian<u16>>(~m_pending_block_size));
+        TRY(m_output_stream->write_until_depleted(pending_block().slice(0, m_pending_block_size)));
+        m_pending_block_size = 0;
+        return {};
+    }
+
+    // The following implementation of lz77 compression and huffman encoding is based on the reference implementation by Hans Wennborg https://www.hanshq.net/zip.html
+
+    // this reads from the pending block and writes to m_symbol_buffer
+    if (m_compression_constants.parsing == MatchParsing::Optimal)
+        TRY(optimal_compress_block());
+    else
+        lz77_compress_block();
+
+    ReadonlySpan<Symbol> symbols { m_symbol_buffer, m_pending_symbol_size };
+    if (m_compression_constants.split_blocks) {
+        auto block_ends = split_block();
+        size_t block_start = 0;
+        size_t input_offset = 0;
+        for (auto block_end : block_ends) {
+            auto block_symbols = symbols.slice(block_start, block_end - block_start);
+            size_t block_input_size = 0;
+            for (auto const& symbol : block_symbols)
+                block_input_size += symbol.distance == 0 ? 1 : symbol.length;
+            TRY(write_block(block_symbols, pending_block().slice(input_offset, block_input_size), m_finished && block_end == symbols.size()));
+            block_start = block_end;
+            input_offset += block_input_size;
+        }
+        VERIFY(input_offset == m_pending_block_size);
+    } else {
+        TRY(write_block(symbols, pending_block().trim(m_pending_block_size), m_finished));
     }
     if (m_finished)
         TRY(m_output_stream->align_to_byte_boundary());
 
     // reset all block specific members
+    slide_window();
     m_pending_block_size = 0;
     m_pending_symbol_size = 0;
-    m_symbol_frequencies.fill(0);
-    m_distance_frequencies.fill(0);
-    // On the final block this copy will potentially produce an invalid search window, but since its the final block we dont care
-    pending_block().copy_trimmed_to({ m_rolling_window, block_size });
 
     return {};
 }
 
+void DeflateCompressor::slide_window()
+{
+    // The block we just compressed (and as much of the history in front of it as still fits) becomes the history of
+    // the next block, so every window position moves down by the size of that block.
+    if (!m_compression_constants.keep_history) {
+        // Starting every block from scratch is a lot cheaper than sliding the hash tables along
+        m_history_size = 0;
+        m_next_insert_position = block_size;
+        for (auto& slot : m_hash_head)
+            slot = empty_slot;
+        for (auto& slot : m_short_hash_head)
+            slot = empty_slot;
+        return;
+    }
+
+    auto shift = m_pending_block_size;
+    auto history_size = min(m_history_size + shift, block_size);
+    auto history_start = block_size - history_size;
+    memmove(m_rolling_window + history_start, m_rolling_window + history_start + shift, history_size);
+    m_history_size = history_size;
+    m_next_insert_position = max(m_next_insert_position, history_start + shift) - shift;
+
+    auto rebase = [&](u16 position) -> u16 {
+        if (position == empty_slot || position < history_start + shift)
+            return empty_slot;
+        return position - shift;
+    };
+    for (auto& slot : m_hash_head)
+        slot = rebase(slot);
+    for (auto& slot : m_short_hash_head)
+        slot = rebase(slot);
+    if (m_compression_constants.parsing == MatchParsing::Optimal) {
+        for (size_t position = history_start; position < block_size; position++) {
+            m_tree_children[2 * position] = rebase(m_tree_children[2 * (position + shift)]);
+            m_tree_children[2 * position + 1] = rebase(m_tree_children[2 * (position + shift) + 1]);
+        }
+    } else {
+        for (size_t position = history_start; position < block_size; position++)
+            m_hash_prev[position] = rebase(m_hash_prev[position + shift]);
+    }
+}
+
+void DeflateCompressor::set_dictionary(ReadonlyBytes dictionary)
+{
+    VERIFY(m_pending_block_size == 0 && m_history_size == 0);
+
+    m_history_size = min(dictionary.size(), block_size);
+    m_next_insert_position = block_size - m_history_size;
+    dictionary.slice(dictionary.size() - m_history_size).copy_to({ m_rolling_window + m_next_insert_position, m_history_size });
+}
+
 ErrorOr<void> DeflateCompressor::final_flush()
 {
     VERIFY(!m_finished);
@@ -983,4 +1797,120 @@ ErrorOr<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, Compres
     return output_stream->read_until_eof();
 }
 
+ErrorOr<void> DeflateCompressor::sync_flush()
+{
+    VERIFY(!m_finished);
+    if (m_pending_block_size != 0)
+        TRY(flush());
+
+    // an empty non-final uncompressed block is the cheapest way to reach a byte boundary without ending the stream
+    TRY(m_output_stream->write_bits(0b000u, 3));
+    TRY(m_output_stream->align_to_byte_boundary());
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0x0000));
+    TRY(m_output_stream->write_value<LittleEndian<u16>>(0xffff));
+    TRY(m_output_stream->flush_buffer_to_stream());
+    return {};
+}
+
+size_t DeflateCompressor::parallel_chunk_count(size_t input_size)
+{
+    return max(ceil_div(input_size, parallel_chunk_size), 1uz);
+}
+
+ErrorOr<ByteBuffer> DeflateCompressor::compress_chunk(ReadonlyBytes dictionary, ReadonlyBytes chunk, CompressionLevel compression_level, bool is_last_chunk)
+{
+    auto output_stream = TRY(try_make<AllocatingMemoryStream>());
+    auto deflate_stream = TRY(DeflateCompressor::construct(MaybeOwned<Stream>(*output_stream), compression_level));
+
+    deflate_stream->set_dictionary(dictionary);
+    TRY(deflate_stream->write_until_depleted(chunk));
+    if (is_last_chunk) {
+        TRY(deflate_stream->final_flush());
+    } else {
+        // The stream is continued by the compressor of the next chunk.
+        TRY(deflate_stream->sync_flush());
+        deflate_stream->m_finished = true;
+    }
+
+    return output_stream->read_until_eof();
+}
+
+static Threading::ThreadPool<Function<void()>>& compression_thread_pool()
+{
+    static Threading::ThreadPool<Function<void()>> thread_pool { [](Function<void()> work) { work(); } };
+    return thread_pool;
+}
+
+ErrorOr<ByteBuffer> DeflateCompressor::compress_all_in_parallel(ReadonlyBytes bytes, CompressionLevel compression_level, Optional<size_t> thread_count, ParallelChunkCallback const& chunk_callback)
+{
+    auto chunk_count = parallel_chunk_count(bytes.size());
+
+    // Workers that only get to run once all chunks have been claimed never touch anything but the shared state, which they
+    // keep alive themselves. This way the calling thread (which compresses chunks as well) never has to wait for them.
+    struct State : public AtomicRefCounted<State> {
+        Atomic<size_t> next_chunk_index { 0 };
+        Threading::Mutex mutex;
+        Threading::ConditionVariable all_chunks_done { mutex };
+        size_t remaining_chunk_count { 0 };
+        Vector<ByteBuffer> compressed_chunks;
+        Optional<Error> error;
+        Function<void()> compress_chunks;
+    };
+    auto state = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) State));
+    state->remaining_chunk_count = chunk_count;
+    TRY(state->compressed_chunks.try_resize(chunk_count));
+
+    state->compress_chunks = [&, state = state.ptr(), chunk_count] {
+        for (;;) {
+            auto chunk_index = state->next_chunk_index.fetch_add(1);
+            if (chunk_index >= chunk_count)
+                return;
+
+            auto chunk_start = chunk_index * parallel_chunk_size;
+            auto chunk = bytes.slice(chunk_start, min(parallel_chunk_size, bytes.size() - chunk_start));
+            auto dictionary = bytes.slice(chunk_start - min(chunk_start, max_distance), min(chunk_start, max_distance));
+            if (chunk_callback)
+                chunk_callback(chunk_index, chunk);
+            auto compressed_chunk = compress_chunk(dictionary, chunk, compression_level, chunk_index == chunk_count - 1);
+
+            Threading::MutexLocker locker(state->mutex);
+            if (compressed_chunk.is_error()) {
+                if (!state->error.has_value())
+                    state->error = compressed_chunk.release_error();
+            } else {
+                state->compressed_chunks[chunk_index] = compressed_chunk.release_value();
+            }
+            if (--state->remaining_chunk_count == 0)
+                state->all_chunks_done.signal();
+        }
+    };
+
+    // The calling thread compresses chunks as well, so it only needs help from thread_count - 1 workers.
+    auto used_thread_count = min(thread_count.value_or(Core::System::hardware_concurrency()), chunk_count);
+    for (size_t i = 1; i < used_thread_count; ++i) {
+        compression_thread_pool().submit([state] {
+            state->compress_chunks();
+        });
+    }
+    state->compress_chunks();
+
+    {
+        Threading::MutexLocker locker(state->mutex);
+        state->all_chunks_done.wait_while([&] { return state->remaining_chunk_count > 0; });
+    }
+    if (state->error.has_value())
+        return state->error.release_value();
+
+    size_t total_size = 0;
+    for (auto const& compressed_chunk : state->compressed_chunks)
+        total_size += compressed_chunk.size();
+    auto output = TRY(ByteBuffer::create_uninitialized(total_size));
+    size_t offset = 0;
+    for (auto const& compressed_chunk : state->compressed_chunks) {
+        compressed_chunk.bytes().copy_to(output.bytes().slice(offset));
+        offset += compressed_chunk.size();
+    }
+    return output;
+}
+
 }
@@ -9,10 +9,11 @@
 
 #include <AK/BitStream.h>
 #include <AK/ByteBuffer.h>
-#include <AK/CircularBuffer.h>
 #include <AK/Endian.h>
 #include <AK/Forward.h>
+#include <AK/Function.h>
 #include <AK/MaybeOwned.h>
+#include <AK/Optional.h>
 #include <AK/Stream.h>
 #include <AK/Vector.h>
 #include <LibCompress/DeflateTables.h>
@@ -64,18 +65,52 @@ ALWAYS_INLINE ErrorOr<void> CanonicalCode::write_symbol(LittleEndianOutputBitStr
 
 class DeflateDecompressor final : public Stream {
 private:
+    // A multi-level lookup table for one of the two Huffman codes of a compressed block.
+    // The low bits of the input index the root table, whose entries directly hold what a codeword stands for:
+    // a literal, the base value and extra bit count of a length or distance, or the end of the block.
+    // Codewords that are longer than the root index continue in a subtable.
+    class DecodingTable {
+    public:
+        enum class Alphabet {
+            LiteralLength,
+            Distance,
+        };
+
+        ErrorOr<void> build(ReadonlyBytes code_lengths, Alphabet);
+
+        // Reads a codeword through the bit stream, which will not accept running past the end of the input.
+        ErrorOr<u32> read_entry(LittleEndianInputBitStream&) const;
+
+        bool is_empty() const { return m_entries.is_empty(); }
+        u32 const* entries() const { return m_entries.data(); }
+        u8 root_bits() const { return m_root_bits; }
+
+        static DecodingTable const& fixed_literal_length_table();
+        static DecodingTable const& fixed_distance_table();
+
+    private:
+        static u32 entry_for_symbol(u16 symbol, u8 codeword_length, Alphabet);
+
+        // Root tables use at most 10 (literal/length) or 8 (distance) bits, which keeps the subtables rare and small.
+        Vector<u32, 1536> m_entries;
+        u8 m_root_bits { 0 };
+    };
+
     class CompressedBlock {
     public:
-        CompressedBlock(DeflateDecompressor&, CanonicalCode literal_codes, Optional<CanonicalCode> distance_codes);
+        CompressedBlock(DeflateDecompressor&, DecodingTable const& literal_length_table, DecodingTable const& distance_table);
 
         ErrorOr<bool> try_read_more();
 
     private:
+        ErrorOr<u8*> decode_symbol_near_end_of_input(u8* output);
+        ErrorOr<size_t> read_distance_near_end_of_input();
+
         bool m_eof { false };
 
         DeflateDecompressor& m_decompressor;
-        CanonicalCode m_literal_codes;
-        Optional<CanonicalCode> m_distance_codes;
+        DecodingTable const& m_literal_length_table;
+        DecodingTable const& m_distance_table;
     };
 
     class UncompressedBlock {
@@ -111,14 +146,21 @@ public:
     static ErrorOr<ByteBuffer> decompress_all(ReadonlyBytes);
 
 private:
-    DeflateDecompressor(MaybeOwned<LittleEndianInputBitStream> stream, CircularBuffer buffer);
+    DeflateDecompressor(MaybeOwned<LittleEndianInputBitStream> stream, ByteBuffer window);
 
-    ErrorOr<u32> decode_length(u32);
-    ErrorOr<u32> decode_distance(u32);
-    ErrorOr<void> decode_codes(CanonicalCode& literal_code, Optional<CanonicalCode>& distance_code);
+    ErrorOr<void> decode_codes(DecodingTable& literal_length_table, DecodingTable& distance_table);
+    void slide_window();
 
     static constexpr u16 max_back_reference_length = 258;
 
+    // The output is decoded into a linear window that keeps the last 32 KiB of history in front of the new output.
+    // Back references are copied with wide stores that may overshoot the end of the match, so the window has some
+    // slack behind the point at which decoding stops.
+    static constexpr size_t window_history_size = 32 * KiB;
+    static constexpr size_t window_decode_limit = window_history_size + 64 * KiB;
+    static constexpr size_t match_copy_overshoot = 32;
+    static constexpr size_t window_size = window_decode_limit + max_back_reference_length + match_copy_overshoot;
+
     bool m_read_final_block { false };
 
     State m_state { State::Idle };
@@ -128,7 +170,13 @@ private:
     };
 
     MaybeOwned<LittleEndianInputBitStream> m_input_stream;
-    CircularBuffer m_output_buffer;
+
+    DecodingTable m_literal_length_table;
+    DecodingTable m_distance_table;
+
+    ByteBuffer m_window;
+    size_t m_window_read_offset { 0 };
+    size_t m_window_write_offset { 0 };
 };
 
 class DeflateCompressor final : public Stream {
@@ -136,26 +184,40 @@ public:
     static constexpr size_t block_size = 32 * KiB - 1; // TODO: this can theoretically be increased to 64 KiB - 2
     static constexpr size_t window_size = block_size * 2;
     static constexpr size_t hash_bits = 15;
+    static constexpr size_t short_hash_bits = 12;
     static constexpr size_t max_huffman_literals = 288;
     static constexpr size_t max_huffman_distances = 32;
-    static constexpr size_t min_match_length = 4;   // matches smaller than these are not worth the size of the back reference
-    static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t min_match_length = 4;           // matches smaller than these are not worth the size of the back reference
+    static constexpr size_t short_match_length = 3;         // ...unless they are close enough to make for a cheap back reference
+    static constexpr size_t max_short_match_distance = 256; // (this is where the distance starts taking more than 3 extra bits)
+    static constexpr size_t max_match_length = 258;         // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t max_distance = 32 * KiB;        // back references cannot reach further than this
     static constexpr u16 empty_slot = UINT16_MAX;
 
+    enum class MatchParsing {
+        Lazy,    // Take the longest match found in the hash chains, unless the next byte starts an even longer one
+        Optimal, // Find all matches with binary trees, and pick the cheapest path through them according to the Huffman codes of the previous pass
+    };
+
     struct CompressionConstants {
         size_t good_match_length;  // Once we find a match of at least this length (a good enough match) we reduce max_chain to lower processing time
         size_t max_lazy_length;    // If the match is at least this long we dont defer matching to the next byte (which takes time) as its good enough
         size_t great_match_length; // Once we find a match of at least this length (a great match) we can just stop searching for longer ones
-        size_t max_chain;          // We only check the actual length of the max_chain closest matches
+        size_t max_chain;          // We only check the actual length of the max_chain closest matches (or visit this many binary tree nodes)
+        bool keep_history;         // Whether back references may reach into the previous block (a preset dictionary is always used)
+        bool find_short_matches;   // Whether we also look for short matches in a separate hash table of 3 byte sequences
+        bool split_blocks;         // Whether we end blocks early where the statistics of the data change, so they get their own Huffman codes
+        MatchParsing parsing;
+        size_t optimal_parsing_passes;
     };
 
-    // These constants were shamelessly "borrowed" from zlib
+    // The constants for the lazy levels were shamelessly "borrowed" from zlib
     static constexpr CompressionConstants compression_constants[] = {
-        { 0, 0, 0, 0 },
-        { 4, 4, 8, 4 },
-        { 8, 16, 128, 128 },
-        { 32, 258, 258, 4096 },
-        { max_match_length, max_match_length, max_match_length, 1 << hash_bits } // disable all limits
+        { 0, 0, 0, 0, false, false, false, MatchParsing::Lazy, 0 },
+        { 4, 4, 8, 4, false, false, false, MatchParsing::Lazy, 0 },
+        { 8, 16, 128, 128, true, false, false, MatchParsing::Lazy, 0 },
+        { 32, 258, 258, 1024, true, true, true, MatchParsing::Lazy, 0 },
+        { max_match_length, max_match_length, max_match_length, 128, true, true, true, MatchParsing::Optimal, 2 },
     };
 
     enum class CompressionLevel : int {
@@ -163,7 +225,7 @@ public:
         FAST,
         GOOD,
         GREAT,
-        BEST // WARNING: this one can take an unreasonable amount of time!
+        BEST
     };
 
     static ErrorOr<NonnullOwnPtr<DeflateCompressor>> construct(MaybeOwned<Stream>, CompressionLevel = CompressionLevel::GOOD);
@@ -176,34 +238,101 @@ public:
     virtual void close() override;
     ErrorOr<void> final_flush();
 
+    // Flushes all pending data and ends the output on a byte boundary with an empty stored block, without marking the
+    // end of the stream. This is what zlib calls a "sync flush".
+    ErrorOr<void> sync_flush();
+
+    // Makes the (last 32 KiB of the) given data available to back references from the first block, as if it had been
+    // compressed right before the first byte written to this stream. Must be called before writing anything.
+    void set_dictionary(ReadonlyBytes);
+
     static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD);
 
+    // Splits the input into chunks of parallel_chunk_size bytes, compresses them on up to thread_count threads, each one
+    // primed with the 32 KiB of input in front of it as its dictionary, and stitches the results together into a single
+    // deflate stream. The callback is invoked once for every chunk of input on the thread that compresses it, which
+    // allows computing checksums over the input in parallel as well.
+    static constexpr size_t parallel_chunk_size = 128 * KiB;
+    static size_t parallel_chunk_count(size_t input_size);
+    using ParallelChunkCallback = Function<void(size_t chunk_index, ReadonlyBytes chunk)>;
+    static ErrorOr<ByteBuffer> compress_all_in_parallel(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD, Optional<size_t> thread_count = {}, ParallelChunkCallback const& = nullptr);
+
 private:
     DeflateCompressor(NonnullOwnPtr<LittleEndianOutputBitStream>, CompressionLevel = CompressionLevel::GOOD);
 
     Bytes pending_block() { return { m_rolling_window + block_size, block_size }; }
 
+    static ErrorOr<ByteBuffer> compress_chunk(ReadonlyBytes dictionary, ReadonlyBytes chunk, CompressionLevel, bool is_last_chunk);
+
+    struct [[gnu::packed]] Symbol {
+        u16 distance; // back reference length
+        union {
+            u16 literal; // literal byte or on of block symbol
+            u16 length;  // back reference length (if distance != 0)
+        };
+    };
+
+    struct Match {
+        u16 length;
+        u16 distance;
+    };
+
     // LZ77 Compression
     static u16 hash_sequence(u8 const* bytes);
+    static u16 short_hash_sequence(u8 const* bytes);
+    size_t common_prefix_length(size_t start, size_t candidate, size_t known_length, size_t max_match_length) const;
     size_t compare_match_candidate(size_t start, size_t candidate, size_t prev_match_length, size_t max_match_length);
     size_t find_back_match(size_t start, u16 hash, size_t previous_match_length, size_t max_match_length, size_t& match_position);
+    size_t find_short_match(size_t start, size_t& match_position);
+    void insert_hash(size_t position, u16 hash);
+    size_t find_tree_matches(size_t position, size_t max_match_length, Match* matches);
+    void insert_history(size_t block_end);
+    void emit_literal(u8 literal);
+    void emit_back_reference(u16 distance, u16 length);
     void lz77_compress_block();
+    ErrorOr<void> optimal_compress_block();
+    void slide_window();
 
     // Huffman Coding
     struct code_length_symbol {
         u8 symbol;
         u8 count; // used for special symbols 16-18
     };
+    struct DynamicCodes {
+        Array<u8, max_huffman_literals> literal_bit_lengths {};
+        Array<u8, max_huffman_distances> distance_bit_lengths {};
+        Array<code_length_symbol, max_huffman_literals + max_huffman_distances> encoded_lengths {};
+        size_t encoded_lengths_count { 0 };
+        size_t literal_code_count { 0 };
+        size_t distance_code_count { 0 };
+        Array<u16, 19> code_lengths_frequencies {};
+        Array<u8, 19> code_lengths_bit_lengths {};
+        size_t code_lengths_count { 0 };
+    };
+    struct SymbolCosts {
+        Array<u32, max_huffman_literals> literals;
+        Array<u32, max_match_length + 1> lengths; // including the extra bits
+        Array<u32, max_huffman_distances> distances;
+    };
     static u8 distance_to_base(u16 distance);
     size_t huffman_block_length(Array<u8, max_huffman_literals> const& literal_bit_lengths, Array<u8, max_huffman_distances> const& distance_bit_lengths);
-    ErrorOr<void> write_huffman(CanonicalCode const& literal_code, Optional<CanonicalCode> const& distance_code);
+    ErrorOr<void> write_huffman(ReadonlySpan<Symbol> symbols, CanonicalCode const& literal_code, Optional<CanonicalCode> const& distance_code);
     static size_t encode_huffman_lengths(ReadonlyBytes lengths, Array<code_length_symbol, max_huffman_literals + max_huffman_distances>& encoded_lengths);
     size_t encode_block_lengths(Array<u8, max_huffman_literals> const& literal_bit_lengths, Array<u8, max_huffman_distances> const& distance_bit_lengths, Array<code_length_symbol, max_huffman_literals + max_huffman_distances>& encoded_lengths, size_t& literal_code_count, size_t& distance_code_count);
-    ErrorOr<void> write_dynamic_huffman(CanonicalCode const& literal_code, size_t literal_code_count, Optional<CanonicalCode> const& distance_code, size_t distance_code_count, Array<u8, 19> const& code_lengths_bit_lengths, size_t code_length_count, Array<code_length_symbol, max_huffman_literals + max_huffman_distances> const& encoded_lengths, size_t encoded_lengths_count);
+    ErrorOr<void> write_dynamic_huffman(ReadonlySpan<Symbol> symbols, CanonicalCode const& literal_code, size_t literal_code_count, Optional<CanonicalCode> const& distance_code, size_t distance_code_count, Array<u8, 19> const& code_lengths_bit_lengths, size_t code_length_count, Array<code_length_symbol, max_huffman_literals + max_huffman_distances> const& encoded_lengths, size_t encoded_lengths_count);
 
-    size_t uncompressed_block_length();
+    size_t uncompressed_block_length(size_t input_size);
     size_t fixed_block_length();
     size_t dynamic_block_length(Array<u8, max_huffman_literals> const& literal_bit_lengths, Array<u8, max_huffman_distances> const& distance_bit_lengths, Array<u8, 19> const& code_lengths_bit_lengths, Array<u16, 19> const& code_lengths_frequencies, size_t code_lengths_count);
+    void count_symbol_frequencies(ReadonlySpan<Symbol> symbols);
+    void build_dynamic_codes(DynamicCodes&);
+    void compute_symbol_costs(SymbolCosts&, bool from_frequencies);
+    size_t block_length(ReadonlySpan<Symbol> symbols, size_t input_size);
+    ErrorOr<void> write_block(ReadonlySpan<Symbol> symbols, ReadonlyBytes input, bool is_final_block);
+
+    // Returns the (exclusive) ends of the runs of the symbol buffer that should each be written as a separate block
+    static constexpr size_t max_block_splits = 16;
+    Vector<size_t, max_block_splits> split_block();
     ErrorOr<void> flush();
 
     bool m_finished { false };
@@ -211,16 +340,14 @@ private:
     CompressionConstants m_compression_constants;
     NonnullOwnPtr<LittleEndianOutputBitStream> m_output_stream;
 
+    // The pending block is preceded by up to block_size bytes of history (the previous blocks, or a preset dictionary).
+    // Every window position before m_next_insert_position has been inserted into the hash tables (or binary trees).
     u8 m_rolling_window[window_size];
+    size_t m_history_size { 0 };
+    size_t m_next_insert_position { block_size };
     size_t m_pending_block_size { 0 };
 
-    struct [[gnu::packed]] {
-        u16 distance; // back reference length
-        union {
-            u16 literal; // literal byte or on of block symbol
-            u16 length;  // back reference length (if distance != 0)
-        };
-    } m_symbol_buffer[block_size + 1];
+    Symbol m_symbol_buffer[block_size];
     size_t m_pending_symbol_size { 0 };
     Array<u16, max_huffman_literals> m_symbol_frequencies;    // there are 286 valid symbol values (symbols 286-287 never occur)
     Array<u16, max_huffman_distances> m_distance_frequencies; // there are 30 valid distance values (distances 30-31 never occur)
@@ -228,6 +355,18 @@ private:
     // LZ77 Chained hash table
     u16 m_hash_head[1 << hash_bits];
     u16 m_hash_prev[window_size];
+    u16 m_short_hash_head[1 << short_hash_bits];
+
+    // Only used for optimal parsing: the left and right children of every window position in the binary trees rooted in
+    // m_hash_head, the matches found at every position of the pending block, and the cheapest path through them.
+    Vector<u16> m_tree_children;
+    Vector<Match> m_match_cache;
+    Vector<u8> m_match_counts;
+    struct PathNode {
+        u32 cost;
+        Match step; // how we got here: a literal has length 1 and distance 0
+    };
+    Vector<PathNode> m_path;
 };
 
 }
@@ -187,11 +187,31 @@ ErrorOr<size_t> GzipDecompressor::write_some(ReadonlyBytes)
     return Error::from_errno(EBADF);
 }
 
-GzipCompressor::GzipCompressor(MaybeOwned<Stream> stream)
+GzipCompressor::GzipCompressor(MaybeOwned<Stream> stream, size_t thread_count)
     : m_output_stream(move(stream))
+    , m_thread_count(thread_count)
 {
 }
 
+static ErrorOr<u32> compress_in_parallel(Stream& output_stream, ReadonlyBytes bytes, size_t thread_count)
+{
+    auto chunk_count = DeflateCompressor::parallel_chunk_count(bytes.size());
+    Vector<u32> chunk_checksums;
+    TRY(chunk_checksums.try_resize(chunk_count));
+
+    auto compressed = TRY(DeflateCompressor::compress_all_in_parallel(bytes, DeflateCompressor::CompressionLevel::GOOD, thread_count, [&](size_t chunk_index, ReadonlyBytes chunk) {
+        chunk_checksums[chunk_index] = Crypto::Checksum::CRC32 { chunk }.digest();
+    }));
+    TRY(output_stream.write_until_depleted(compressed));
+
+    u32 checksum = chunk_checksums[0];
+    for (size_t i = 1; i < chunk_count; ++i) {
+        auto chunk_size = min(DeflateCompressor::parallel_chunk_size, bytes.size() - i * DeflateCompressor::parallel_chunk_size);
+        checksum = Crypto::Checksum::CRC32::combine(checksum, chunk_checksums[i], chunk_size);
+    }
+    return checksum;
+}
+
 ErrorOr<Bytes> GzipCompressor::read_some(Bytes)
 {
     return Error::from_errno(EBADF);
@@ -208,12 +228,16 @@ ErrorOr<size_t> GzipCompressor::write_some(ReadonlyBytes bytes)
     header.extra_flags = 3;      // DEFLATE sets 2 for maximum compression and 4 for minimum compression
     header.operating_system = 3; // unix
     TRY(m_output_stream->write_until_depleted({ &header, sizeof(header) }));
-    auto compressed_stream = TRY(DeflateCompressor::construct(MaybeOwned(*m_output_stream)));
-    TRY(compressed_stream->write_until_depleted(bytes));
-    TRY(compressed_stream->final_flush());
-    Crypto::Checksum::CRC32 crc32;
-    crc32.update(bytes);
-    TRY(m_output_stream->write_value<LittleEndian<u32>>(crc32.digest()));
+    u32 checksum;
+    if (m_thread_count > 1) {
+        checksum = TRY(compress_in_parallel(*m_output_stream, bytes, m_thread_count));
+    } else {
+        auto compressed_stream = TRY(DeflateCompressor::construct(MaybeOwned(*m_output_stream)));
+        TRY(compressed_stream->write_until_depleted(bytes));
+        TRY(compressed_stream->final_flush());
+        checksum = Crypto::Checksum::CRC32 { bytes }.digest();
+    }
+    TRY(m_output_stream->write_value<LittleEndian<u32>>(checksum));
     TRY(m_output_stream->write_value<LittleEndian<u32>>(bytes.size()));
     return bytes.size();
 }
@@ -232,10 +256,10 @@ void GzipCompressor::close()
 {
 }
 
-ErrorOr<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes)
+ErrorOr<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes, size_t thread_count)
 {
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
-    GzipCompressor gzip_stream { MaybeOwned<Stream>(*output_stream) };
+    GzipCompressor gzip_stream { MaybeOwned<Stream>(*output_stream), thread_count };
 
     TRY(gzip_stream.write_until_depleted(bytes));
 
@@ -73,7 +73,7 @@ ErrorOr<NonnullOwnPtr<ZlibCompressor>> ZlibCompressor::construct(MaybeOwned<Stre
     auto compressor_stream = TRY(DeflateCompressor::construct(MaybeOwned(*stream), static_cast<DeflateCompressor::CompressionLevel>(compression_level)));
 
     auto zlib_compressor = TRY(adopt_nonnull_own_or_enomem(new (nothrow) ZlibCompressor(move(stream), move(compressor_stream))));
-    TRY(zlib_compressor->write_header(compression_method, compression_level));
+    TRY(write_header(*zlib_compressor->m_output_stream, compression_method, compression_level));
 
     return zlib_compressor;
 }
@@ -89,7 +89,7 @@ ZlibCompressor::~ZlibCompressor()
     VERIFY(m_finished);
 }
 
-ErrorOr<void> ZlibCompressor::write_header(ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
+ErrorOr<void> ZlibCompressor::write_header(Stream& stream, ZlibCompressionMethod compression_method, ZlibCompressionLevel compression_level)
 {
     u8 compression_info = 0;
     if (compression_method == ZlibCompressionMethod::Deflate) {
@@ -108,7 +108,7 @@ ErrorOr<void> ZlibCompressor::write_header(ZlibCompressionMethod compression_met
 
     // FIXME: Support pre-defined dictionaries.
 
-    TRY(m_output_stream->write_value(header.as_u16));
+    TRY(stream.write_value(header.as_u16));
 
     return {};
 }
@@ -156,8 +156,11 @@ ErrorOr<void> ZlibCompressor::finish()
     return {};
 }
 
-ErrorOr<ByteBuffer> ZlibCompressor::compress_all(ReadonlyBytes bytes, ZlibCompressionLevel compression_level)
+ErrorOr<ByteBuffer> ZlibCompressor::compress_all(ReadonlyBytes bytes, ZlibCompressionLevel compression_level, size_t thread_count)
 {
+    if (thread_count > 1)
+        return compress_all_in_parallel(bytes, compression_level, thread_count);
+
     auto output_stream = TRY(try_make<AllocatingMemoryStream>());
     auto zlib_stream = TRY(ZlibCompressor::construct(MaybeOwned<Stream>(*output_stream), compression_level));
 
@@ -168,4 +171,28 @@ ErrorOr<ByteBuffer> ZlibCompressor::compress_all(ReadonlyBytes bytes, ZlibCompre
     return output_stream->read_until_eof();
 }
 
+ErrorOr<ByteBuffer> ZlibCompressor::compress_all_in_parallel(ReadonlyBytes bytes, ZlibCompressionLevel compression_level, size_t thread_count)
+{
+    auto chunk_count = DeflateCompressor::parallel_chunk_count(bytes.size());
+    Vector<u32> chunk_checksums;
+    TRY(chunk_checksums.try_resize(chunk_count));
+
+    auto compressed = TRY(DeflateCompressor::compress_all_in_parallel(bytes, static_cast<DeflateCompressor::CompressionLevel>(compression_level), thread_count, [&](size_t chunk_index, ReadonlyBytes chunk) {
+        chunk_checksums[chunk_index] = Crypto::Checksum::Adler32 { chunk }.digest();
+    }));
+
+    u32 checksum = chunk_checksums[0];
+    for (size_t i = 1; i < chunk_count; ++i) {
+        auto chunk_size = min(DeflateCompressor::parallel_chunk_size, bytes.size() - i * DeflateCompressor::parallel_chunk_size);
+        checksum = Crypto::Checksum::Adler32::combine(checksum, chunk_checksums[i], chunk_size);
+    }
+
+    AllocatingMemoryStream output_stream;
+    TRY(write_header(output_stream, ZlibCompressionMethod::Deflate, compression_level));
+    TRY(output_stream.write_until_depleted(compressed));
+    TRY(output_stream.write_value<NetworkOrdered<u32>>(checksum));
+
+    return output_stream.read_until_eof();
+}
+
 }
@@ -73,11 +73,13 @@ public:
     virtual void close() override;
     ErrorOr<void> finish();
 
-    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, ZlibCompressionLevel = ZlibCompressionLevel::Default);
+    // With a thread count larger than one, the data is compressed with DeflateCompressor::compress_all_in_parallel().
+    static ErrorOr<ByteBuffer> compress_all(ReadonlyBytes bytes, ZlibCompressionLevel = ZlibCompressionLevel::Default, size_t thread_count = 1);
 
 private:
     ZlibCompressor(MaybeOwned<Stream> stream, NonnullOwnPtr<Stream> compressor_stream);
-    ErrorOr<void> write_header(ZlibCompressionMethod, ZlibCompressionLevel);
+    static ErrorOr<void> write_header(Stream&, ZlibCompressionMethod, ZlibCompressionLevel);
+    static ErrorOr<ByteBuffer> compress_all_in_parallel(ReadonlyBytes bytes, ZlibCompressionLevel, size_t thread_count);
 
     bool m_finished { false };
     MaybeOwned<Stream> m_output_stream;
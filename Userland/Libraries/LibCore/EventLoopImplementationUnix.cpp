@@ -5,6 +5,7 @@
  */
 
 #include <AK/BinaryHeap.h>
+#include <AK/HashTable.h>
 #include <AK/Singleton.h>
 #include <AK/TemporaryChange.h>
 #include <AK/Time.h>
@@ -33,6 +34,178 @@ static pthread_rwlock_t* s_thread_data_lock = nullptr;
 thread_local pthread_t s_thread_id;
 thread_local OwnPtr<ThreadData> s_this_thread_data;
 
+bool has_flag(int value, int flag)
+{
+    return (value & flag) == flag;
+}
+
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+u32 notification_type_to_epoll_events(NotificationType type)
+{
+    u32 events = 0;
+    if (has_flag(type, NotificationType::Read))
+        events |= EPOLLIN;
+    if (has_flag(type, NotificationType::Write))
+        events |= EPOLLOUT;
+    return events;
+}
+
+NotificationType epoll_events_to_notification_type(u32 events)
+{
+    NotificationType type = NotificationType::None;
+    if (has_flag(events, EPOLLIN))
+        type |= NotificationType::Read;
+    if (has_flag(events, EPOLLOUT))
+        type |= NotificationType::Write;
+    if (has_flag(events, EPOLLHUP))
+        type |= NotificationType::HangUp;
+    if (has_flag(events, EPOLLERR))
+        type |= NotificationType::Error;
+    return type;
+}
+
+// The set of file descriptors a thread's event loop is waiting on: the wake pipe, and the fds of all registered notifiers.
+// With epoll, the interest list lives in the kernel and only changes when a notifier is (un)registered.
+// Waiting then only costs as much as the number of fds that are actually ready.
+class NotifierSet {
+public:
+    NotifierSet() = default;
+
+    ~NotifierSet()
+    {
+        if (m_epoll_fd != -1)
+            (void)System::close(m_epoll_fd);
+    }
+
+    void initialize(int wake_fd)
+    {
+        if (m_epoll_fd != -1)
+            (void)System::close(m_epoll_fd);
+        m_notifiers_by_fd.clear();
+        m_fds_without_readiness.clear();
+        m_ready_count = 0;
+
+        auto result = System::epoll_create1(EPOLL_CLOEXEC);
+        if (result.is_error()) {
+            warnln("\033[31;1mFailed to create event loop epoll:\033[0m {}", result.error());
+            VERIFY_NOT_REACHED();
+        }
+        m_epoll_fd = result.release_value();
+
+        m_wake_fd = wake_fd;
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.fd = wake_fd;
+        MUST(System::epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, wake_fd, &event));
+    }
+
+    void add(Notifier& notifier)
+    {
+        auto& notifiers = m_notifiers_by_fd.ensure(notifier.fd());
+        notifiers.append(&notifier);
+        update_interest(notifier.fd(), notifiers, notifiers.size() == 1 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD);
+    }
+
+    void remove(Notifier& notifier)
+    {
+        auto it = m_notifiers_by_fd.find(notifier.fd());
+        VERIFY(it != m_notifiers_by_fd.end());
+
+        auto& notifiers = it->value;
+        notifiers.remove_first_matching([&](auto* entry) { return entry == &notifier; });
+        if (!notifiers.is_empty()) {
+            update_interest(notifier.fd(), notifiers, EPOLL_CTL_MOD);
+            return;
+        }
+
+        m_notifiers_by_fd.remove(it);
+        if (m_fds_without_readiness.remove(notifier.fd()))
+            return;
+        // NOTE: This fails if the fd has been closed already, in which case the kernel forgets about it by itself.
+        (void)System::epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, notifier.fd(), nullptr);
+    }
+
+    ErrorOr<int> wait(int timeout)
+    {
+        // Files without a notion of readiness are always ready, so don't sleep if we are watching one.
+        if (!m_fds_without_readiness.is_empty())
+            timeout = 0;
+
+        m_ready_count = 0;
+        m_ready_count = TRY(System::epoll_wait(m_epoll_fd, m_ready_events, timeout));
+        return m_ready_count + m_fds_without_readiness.size();
+    }
+
+    bool wake_fd_is_readable() const
+    {
+        for (int i = 0; i < m_ready_count; ++i) {
+            if (m_ready_events[i].data.fd == m_wake_fd)
+                return has_flag(m_ready_events[i].events, EPOLLIN);
+        }
+        return false;
+    }
+
+    template<typename Callback>
+    void for_each_activation(Callback callback)
+    {
+        for (int i = 0; i < m_ready_count; ++i) {
+            auto& event = m_ready_events[i];
+            if (event.data.fd == m_wake_fd)
+                continue;
+
+            auto it = m_notifiers_by_fd.find(event.data.fd);
+            if (it == m_notifiers_by_fd.end()) {
+                // Someone else is still holding on to the file behind a notifier we have unregistered.
+                (void)System::epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, event.data.fd, nullptr);
+                continue;
+            }
+
+            auto type = epoll_events_to_notification_type(event.events);
+            for (auto* notifier : it->value)
+                callback(*notifier, type);
+        }
+
+        for (auto fd : m_fds_without_readiness) {
+            for (auto* notifier : m_notifiers_by_fd.find(fd)->value)
+                callback(*notifier, NotificationType::Read | NotificationType::Write);
+        }
+    }
+
+private:
+    void update_interest(int fd, Vector<Notifier*, 1> const& notifiers, int operation)
+    {
+        if (m_fds_without_readiness.contains(fd))
+            return;
+
+        NotificationType type = NotificationType::None;
+        for (auto* notifier : notifiers)
+            type |= notifier->type();
+
+        epoll_event event {};
+        event.events = notification_type_to_epoll_events(type);
+        event.data.fd = fd;
+        auto result = System::epoll_ctl(m_epoll_fd, operation, fd, &event);
+        if (result.is_error() && result.error().code() == EPERM) {
+            // Linux refuses to watch regular files and directories, which poll() considers to be always ready.
+            m_fds_without_readiness.set(fd);
+            return;
+        }
+        if (result.is_error()) {
+            dbgln("EventLoopImplementationUnix: Failed to watch fd {}: {}", fd, result.error());
+            VERIFY_NOT_REACHED();
+        }
+    }
+
+    int m_epoll_fd { -1 };
+    int m_wake_fd { -1 };
+
+    HashMap<int, Vector<Notifier*, 1>> m_notifiers_by_fd;
+    HashTable<int> m_fds_without_readiness;
+
+    Array<epoll_event, 64> m_ready_events;
+    int m_ready_count { 0 };
+};
+#else
 short notification_type_to_poll_events(NotificationType type)
 {
     short events = 0;
@@ -43,10 +216,83 @@ short notification_type_to_poll_events(NotificationType type)
     return events;
 }
 
-bool has_flag(int value, int flag)
-{
-    return (value & flag) == flag;
-}
+// The set of file descriptors a thread's event loop is waiting on: the wake pipe, and the fds of all registered notifiers.
+class NotifierSet {
+public:
+    void initialize(int wake_fd)
+    {
+        m_poll_fds.clear();
+        m_notifier_by_ptr.clear();
+        m_notifier_by_index.clear();
+
+        m_poll_fds.append({ .fd = wake_fd, .events = POLLIN, .revents = 0 });
+        m_notifier_by_index.append(nullptr);
+    }
+
+    void add(Notifier& notifier)
+    {
+        m_notifier_by_ptr.set(&notifier, m_poll_fds.size());
+        m_notifier_by_index.append(&notifier);
+        m_poll_fds.append({
+            .fd = notifier.fd(),
+            .events = notification_type_to_poll_events(notifier.type()),
+            .revents = 0,
+        });
+    }
+
+    void remove(Notifier& notifier)
+    {
+        auto it = m_notifier_by_ptr.find(&notifier);
+        VERIFY(it != m_notifier_by_ptr.end());
+
+        size_t notifier_index = it->value;
+        m_notifier_by_ptr.remove(it);
+
+        if (notifier_index + 1 != m_poll_fds.size()) {
+            swap(m_poll_fds[notifier_index], m_poll_fds.last());
+            swap(m_notifier_by_index[notifier_index], m_notifier_by_index.last());
+            m_notifier_by_ptr.set(m_notifier_by_index[notifier_index], notifier_index);
+        }
+        m_poll_fds.take_last();
+        m_notifier_by_index.take_last();
+    }
+
+    ErrorOr<int> wait(int timeout)
+    {
+        return System::poll(m_poll_fds, timeout);
+    }
+
+    bool wake_fd_is_readable() const
+    {
+        return has_flag(m_poll_fds[0].revents, POLLIN);
+    }
+
+    template<typename Callback>
+    void for_each_activation(Callback callback)
+    {
+        for (size_t i = 1; i < m_poll_fds.size(); ++i) {
+            auto& revents = m_poll_fds[i].revents;
+            auto& notifier = *m_notifier_by_index[i];
+
+            NotificationType type = NotificationType::None;
+            if (has_flag(revents, POLLIN))
+                type |= NotificationType::Read;
+            if (has_flag(revents, POLLOUT))
+                type |= NotificationType::Write;
+            if (has_flag(revents, POLLHUP))
+                type |= NotificationType::HangUp;
+            if (has_flag(revents, POLLERR))
+                type |= NotificationType::Error;
+            callback(notifier, type);
+        }
+    }
+
+private:
+    Vector<pollfd> m_poll_fds;
+    HashMap<Notifier*, size_t> m_notifier_by_ptr;
+    Vector<Notifier*> m_notifier_by_index;
+};
+#endif
 
 class EventLoopTimeout {
 public:
@@ -281,17 +527,13 @@ struct ThreadData {
         wake_pipe_fds = result.release_value();
 
         // The wake pipe informs us of POSIX signals as well as manual calls to wake()
-        VERIFY(poll_fds.size() == 0);
-        poll_fds.append({ .fd = wake_pipe_fds[0], .events = POLLIN, .revents = 0 });
-        notifier_by_index.append(nullptr);
+        notifiers.initialize(wake_pipe_fds[0]);
     }
 
     // Each thread has its own timers, notifiers and a wake pipe.
     TimeoutSet timeouts;
 
-    Vector<pollfd> poll_fds;
-    HashMap<Notifier*, size_t> notifier_by_ptr;
-    Vector<Notifier*> notifier_by_index;
+    NotifierSet notifiers;
 
     // The wake pipe is used to notify another event loop that someone has called wake(), or a signal has been received.
     // wake() writes 0i32 into the pipe, signals write the signal number (guaranteed non-zero).
@@ -383,7 +625,7 @@ retry:
 
 try_select_again:
     // select() and wait for file system events, calls to wake(), POSIX signals, or timer expirations.
-    ErrorOr<int> error_or_marked_fd_count = System::poll(thread_data.poll_fds, should_wait_forever ? -1 : timeout);
+    ErrorOr<int> error_or_marked_fd_count = thread_data.notifiers.wait(should_wait_forever ? -1 : timeout);
     auto time_after_poll = MonotonicTime::now_coarse();
     // Because POSIX, we might spuriously return from select() with EINTR; just select again.
     if (error_or_marked_fd_count.is_error()) {
@@ -395,7 +637,7 @@ try_select_again:
 
     // We woke up due to a call to wake() or a POSIX signal.
     // Handle signals and see whether we need to handle events as well.
-    if (has_flag(thread_data.poll_fds[0].revents, POLLIN)) {
+    if (thread_data.notifiers.wake_fd_is_readable()) {
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -426,23 +668,11 @@ try_select_again:
 
     if (error_or_marked_fd_count.value() != 0) {
         // Handle file system notifiers by making them normal events.
-        for (size_t i = 1; i < thread_data.poll_fds.size(); ++i) {
-            auto& revents = thread_data.poll_fds[i].revents;
-            auto& notifier = *thread_data.notifier_by_index[i];
-
-            NotificationType type = NotificationType::None;
-            if (has_flag(revents, POLLIN))
-                type |= NotificationType::Read;
-            if (has_flag(revents, POLLOUT))
-                type |= NotificationType::Write;
-            if (has_flag(revents, POLLHUP))
-                type |= NotificationType::HangUp;
-            if (has_flag(revents, POLLERR))
-                type |= NotificationType::Error;
+        thread_data.notifiers.for_each_activation([](Notifier& notifier, NotificationType type) {
             type &= notifier.type();
             if (type != NotificationType::None)
                 ThreadEventQueue::current().post_event(notifier, make<NotifierActivationEvent>(notifier.fd(), type));
-        }
+        });
     }
 
     // Handle expired timers.
@@ -520,9 +750,6 @@ void EventLoopImplementationUnix::notify_forked_and_in_child()
 {
     auto& thread_data = ThreadData::the();
     thread_data.timeouts.clear();
-    thread_data.poll_fds.clear();
-    thread_data.notifier_by_ptr.clear();
-    thread_data.notifier_by_index.clear();
     thread_data.initialize_wake_pipe();
     if (auto* info = signals_info<false>()) {
         info->signal_handlers.clear();
@@ -677,15 +904,7 @@ void EventLoopManagerUnix::unregister_timer(intptr_t timer_id)
 void EventLoopManagerUnix::register_notifier(Notifier& notifier)
 {
     auto& thread_data = ThreadData::the();
-
-    thread_data.notifier_by_ptr.set(&notifier, thread_data.poll_fds.size());
-    thread_data.notifier_by_index.append(&notifier);
-    thread_data.poll_fds.append({
-        .fd = notifier.fd(),
-        .events = notification_type_to_poll_events(notifier.type()),
-        .revents = 0,
-    });
-
+    thread_data.notifiers.add(notifier);
     notifier.set_owner_thread(s_thread_id);
 }
 
@@ -695,20 +914,7 @@ void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
     if (!thread_data_ptr)
         return;
 
-    auto& thread_data = *thread_data_ptr;
-    auto it = thread_data.notifier_by_ptr.find(&notifier);
-    VERIFY(it != thread_data.notifier_by_ptr.end());
-
-    size_t notifier_index = it->value;
-    thread_data.notifier_by_ptr.remove(it);
-
-    if (notifier_index + 1 != thread_data.poll_fds.size()) {
-        swap(thread_data.poll_fds[notifier_index], thread_data.poll_fds.last());
-        swap(thread_data.notifier_by_index[notifier_index], thread_data.notifier_by_index.last());
-        thread_data.notifier_by_ptr.set(thread_data.notifier_by_index[notifier_index], notifier_index);
-    }
-    thread_data.poll_fds.take_last();
-    thread_data.notifier_by_index.take_last();
+    thread_data_ptr->notifiers.remove(notifier);
 }
 
 void EventLoopManagerUnix::did_post_event()
@@ -134,6 +134,15 @@ ErrorOr<size_t> PosixSocketHelper::write(ReadonlyBytes buffer, int flags)
     return TRY(System::send(m_fd, buffer.data(), buffer.size(), flags));
 }
 
+ErrorOr<size_t> PosixSocketHelper::send_file(int in_fd, off_t& offset, size_t count)
+{
+    if (!is_open()) {
+        return Error::from_errno(ENOTCONN);
+    }
+
+    return TRY(System::sendfile(m_fd, in_fd, offset, count));
+}
+
 void PosixSocketHelper::close()
 {
     if (!is_open()) {
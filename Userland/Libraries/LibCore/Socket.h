@@ -50,6 +50,12 @@ public:
     // enabled, then the socket will be automatically closed by the kernel when
     // an exec call happens.
     virtual ErrorOr<void> set_close_on_exec(bool enabled) = 0;
+    /// Sends up to count bytes of the file referred to by in_fd, starting at
+    /// offset, without copying them through userspace. The offset is advanced
+    /// by the amount of bytes sent. Returns either the amount of bytes sent,
+    /// or an errno in the case of failure. Sockets that can't do this fail
+    /// with ENOTSUP, and the caller should fall back to regular writes.
+    virtual ErrorOr<size_t> send_file(int, off_t&, size_t) { return Error::from_errno(ENOTSUP); }
 
     /// Disables any listening mechanisms that this socket uses.
     /// Can be called with 'false' when `on_ready_to_read` notifications are no longer needed.
@@ -132,6 +138,7 @@ public:
 
     ErrorOr<Bytes> read(Bytes, int flags);
     ErrorOr<size_t> write(ReadonlyBytes, int flags);
+    ErrorOr<size_t> send_file(int in_fd, off_t& offset, size_t count);
 
     bool is_eof() const { return !is_open() || m_last_read_was_eof; }
     void did_reach_eof_on_read();
@@ -188,6 +195,7 @@ public:
     virtual void close() override { m_helper.close(); }
     virtual ErrorOr<size_t> pending_bytes() const override { return m_helper.pending_bytes(); }
     virtual ErrorOr<bool> can_read_without_blocking(int timeout = 0) const override { return m_helper.can_read_without_blocking(timeout); }
+    virtual ErrorOr<size_t> send_file(int in_fd, off_t& offset, size_t count) override { return m_helper.send_file(in_fd, offset, count); }
     virtual void set_notifications_enabled(bool enabled) override
     {
         if (auto notifier = m_helper.notifier())
@@ -323,6 +331,7 @@ public:
     virtual ErrorOr<bool> can_read_without_blocking(int timeout = 0) const override { return m_helper.can_read_without_blocking(timeout); }
     virtual ErrorOr<void> set_blocking(bool enabled) override { return m_helper.set_blocking(enabled); }
     virtual ErrorOr<void> set_close_on_exec(bool enabled) override { return m_helper.set_close_on_exec(enabled); }
+    virtual ErrorOr<size_t> send_file(int in_fd, off_t& offset, size_t count) override { return m_helper.send_file(in_fd, offset, count); }
     virtual void set_notifications_enabled(bool enabled) override
     {
         if (auto notifier = m_helper.notifier())
@@ -419,6 +428,7 @@ public:
     virtual ErrorOr<bool> can_read_without_blocking(int timeout = 0) const override { return m_helper.buffered_data_size() > 0 || TRY(m_helper.stream().can_read_without_blocking(timeout)); }
     virtual ErrorOr<void> set_blocking(bool enabled) override { return m_helper.stream().set_blocking(enabled); }
     virtual ErrorOr<void> set_close_on_exec(bool enabled) override { return m_helper.stream().set_close_on_exec(enabled); }
+    virtual ErrorOr<size_t> send_file(int in_fd, off_t& offset, size_t count) override { return m_helper.stream().send_file(in_fd, offset, count); }
     virtual void set_notifications_enabled(bool enabled) override { m_helper.stream().set_notifications_enabled(enabled); }
 
     virtual ErrorOr<StringView> read_line(Bytes buffer) override { return m_helper.read_line(move(buffer)); }
@@ -505,6 +515,7 @@ public:
     virtual ErrorOr<bool> can_read_without_blocking(int timeout = 0) const override { return m_socket.can_read_without_blocking(timeout); }
     virtual ErrorOr<void> set_blocking(bool enabled) override { return m_socket.set_blocking(enabled); }
     virtual ErrorOr<void> set_close_on_exec(bool enabled) override { return m_socket.set_close_on_exec(enabled); }
+    virtual ErrorOr<size_t> send_file(int in_fd, off_t& offset, size_t count) override { return m_socket.send_file(in_fd, offset, count); }
 
 private:
     BasicReusableSocket(NonnullOwnPtr<T> socket)
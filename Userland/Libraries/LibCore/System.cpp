@@ -48,6 +48,10 @@ static int memfd_create(char const* name, unsigned int flags)
 }
 #endif
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+#    include <sys/sendfile.h>
+#endif
+
 #if defined(AK_OS_MACOS) || defined(AK_OS_IOS)
 #    include <mach-o/dyld.h>
 #    include <sys/mman.h>
@@ -697,6 +701,41 @@ ErrorOr<ssize_t> write(int fd, ReadonlyBytes buffer)
     return rc;
 }
 
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t& offset, size_t count)
+{
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+    ssize_t rc = ::sendfile(out_fd, in_fd, &offset, count);
+    if (rc < 0)
+        return Error::from_syscall("sendfile"sv, -errno);
+    return rc;
+#else
+    // NOTE: The BSDs have a sendfile() with a different signature, so just copy the data ourselves.
+    u8 buffer[PAGE_SIZE];
+    size_t total_nsent = 0;
+    while (total_nsent < count) {
+        auto nread = ::pread(in_fd, buffer, min(count - total_nsent, sizeof(buffer)), offset);
+        if (nread < 0) {
+            if (total_nsent > 0)
+                break;
+            return Error::from_syscall("pread"sv, -errno);
+        }
+        if (nread == 0)
+            break;
+        auto nwritten = ::write(out_fd, buffer, nread);
+        if (nwritten < 0) {
+            if (total_nsent > 0)
+                break;
+            return Error::from_syscall("write"sv, -errno);
+        }
+        offset += nwritten;
+        total_nsent += nwritten;
+        if (nwritten < nread)
+            break;
+    }
+    return total_nsent;
+#endif
+}
+
 ErrorOr<void> kill(pid_t pid, int signal)
 {
     if (::kill(pid, signal) < 0)
@@ -1777,6 +1816,31 @@ ErrorOr<int> poll(Span<struct pollfd> poll_fds, int timeout)
     return { rc };
 }
 
+#if defined(AK_OS_SERENITY) || defined(AK_OS_LINUX)
+ErrorOr<int> epoll_create1(int flags)
+{
+    int fd = ::epoll_create1(flags);
+    if (fd < 0)
+        return Error::from_syscall("epoll_create1"sv, -errno);
+    return fd;
+}
+
+ErrorOr<void> epoll_ctl(int epfd, int op, int fd, struct epoll_event* event)
+{
+    if (::epoll_ctl(epfd, op, fd, event) < 0)
+        return Error::from_syscall("epoll_ctl"sv, -errno);
+    return {};
+}
+
+ErrorOr<int> epoll_wait(int epfd, Span<struct epoll_event> events, int timeout)
+{
+    int rc = ::epoll_wait(epfd, events.data(), events.size(), timeout);
+    if (rc < 0)
+        return Error::from_syscall("epoll_wait"sv, -errno);
+    return rc;
+}
+#endif
+
 #ifdef AK_OS_SERENITY
 ErrorOr<void> posix_fallocate(int fd, off_t offset, off_t length)
 {
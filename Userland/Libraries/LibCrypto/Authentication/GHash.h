@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/ByteReader.h>
+#include <AK/CPUFeatures.h>
 #include <AK/Endian.h>
 #include <AK/Types.h>
 #include <LibCrypto/Hash/HashFunction.h>
@@ -54,9 +55,14 @@ public:
     }
 #endif
 
-    TagType process(ReadonlyBytes aad, ReadonlyBytes cipher);
+    TagType process(ReadonlyBytes aad, ReadonlyBytes cipher) { return (this->*process_dispatched)(aad, cipher); }
 
 private:
+    template<CPUFeatures>
+    TagType process_impl(ReadonlyBytes aad, ReadonlyBytes cipher);
+
+    static TagType (GHash::*const process_dispatched)(ReadonlyBytes aad, ReadonlyBytes cipher);
+
     u32 m_key[4];
 };
 
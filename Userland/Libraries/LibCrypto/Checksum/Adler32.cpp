@@ -4,13 +4,18 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/Adler32.h>
 
 namespace Crypto::Checksum {
 
-void Adler32::update(ReadonlyBytes data)
+static constexpr u32 modulus = 65521;
+
+template<>
+void Adler32::update_impl<CPUFeatures::None>(ReadonlyBytes data)
 {
     // See https://github.com/SerenityOS/serenity/pull/24408#discussion_r1609051678
     constexpr size_t iterations_without_overflow = 380368439;
@@ -32,14 +37,92 @@ void Adler32::update(ReadonlyBytes data)
             state_a += byte;
             state_b += state_a;
         }
-        state_a %= 65521;
-        state_b %= 65521;
+        state_a %= modulus;
+        state_b %= modulus;
         data = data.slice(chunk.size());
     }
     m_state_a = state_a;
     m_state_b = state_b;
 }
 
+#if AK_CAN_CODEGEN_FOR_X86_AVX2
+ALWAYS_INLINE static u64 sum(AK::SIMD::u32x8 vector)
+{
+    u64 result = 0;
+    for (size_t i = 0; i < 8; ++i)
+        result += vector[i];
+    return result;
+}
+
+template<>
+[[gnu::target("avx2")]] void Adler32::update_impl<CPUFeatures::X86_AVX2>(ReadonlyBytes data)
+{
+    using namespace AK::SIMD;
+
+    // Each block of 32 bytes adds the sum of its bytes to a, and 32 * a plus the bytes weighted by 32, 31, ..., 1 to b.
+    constexpr size_t block_size = 32;
+    // prefix_sums grows quadratically with the number of blocks; its lanes stay below 2^32 for up to 2052 blocks.
+    constexpr size_t max_blocks_between_reductions = 2048;
+
+    constexpr c8x32 weights { 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 };
+    constexpr i16x16 ones { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+    u64 state_a = m_state_a;
+    u64 state_b = m_state_b;
+    while (data.size() >= block_size) {
+        size_t block_count = min(data.size() / block_size, max_blocks_between_reductions);
+
+        u32x8 byte_sums {};
+        u32x8 prefix_sums {};
+        u32x8 weighted_sums {};
+        for (size_t i = 0; i < block_count; ++i) {
+            auto bytes = load_unaligned<c8x32>(data.offset(i * block_size));
+            // The sum of the bytes of all the preceding blocks, which each contribute 32 times to b.
+            prefix_sums += byte_sums;
+            byte_sums += bit_cast<u32x8>(__builtin_ia32_psadbw256(bytes, c8x32 {}));
+            weighted_sums += bit_cast<u32x8>(__builtin_ia32_pmaddwd256(__builtin_ia32_pmaddubsw256(bytes, weights), ones));
+        }
+
+        state_b += state_a * block_count * block_size + sum(prefix_sums) * block_size + sum(weighted_sums);
+        state_a += sum(byte_sums);
+        state_a %= modulus;
+        state_b %= modulus;
+
+        data = data.slice(block_count * block_size);
+    }
+    m_state_a = state_a;
+    m_state_b = state_b;
+
+    update_impl<CPUFeatures::None>(data);
+}
+#endif
+
+decltype(Adler32::update_dispatched) Adler32::update_dispatched = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_AVX2)) {
+        if (has_flag(features, CPUFeatures::X86_AVX2))
+            return &Adler32::update_impl<CPUFeatures::X86_AVX2>;
+    }
+
+    return &Adler32::update_impl<CPUFeatures::None>;
+}();
+
+u32 Adler32::combine(u32 first_adler, u32 second_adler, u64 second_length)
+{
+    // Appending n bytes adds their sum to a, and adds n * a plus the second input's own b to b. Both a's start at 1, so
+    // one of them has to be subtracted again, from a and from each of the n terms of b.
+    u64 first_a = first_adler & 0xffff;
+    u64 first_b = first_adler >> 16;
+    u64 second_a = second_adler & 0xffff;
+    u64 second_b = second_adler >> 16;
+    u64 length = second_length % modulus;
+
+    u64 a = (first_a + second_a + modulus - 1) % modulus;
+    u64 b = (first_b + second_b + length * first_a + modulus - length) % modulus;
+    return (b << 16) | a;
+}
+
 u32 Adler32::digest()
 {
     return (m_state_b << 16) | m_state_a;
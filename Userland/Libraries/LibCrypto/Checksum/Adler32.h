@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/CPUFeatures.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/ChecksumFunction.h>
@@ -27,10 +28,19 @@ public:
         update(data);
     }
 
-    virtual void update(ReadonlyBytes data) override;
+    virtual void update(ReadonlyBytes data) override { return (this->*update_dispatched)(data); }
     virtual u32 digest() override;
 
+    // Returns the Adler-32 of the concatenation of two inputs, given the Adler-32 of each of them and the length of the
+    // second. This allows independent chunks of an input to be checksummed in parallel.
+    static u32 combine(u32 first_adler, u32 second_adler, u64 second_length);
+
 private:
+    template<CPUFeatures>
+    void update_impl(ReadonlyBytes data);
+
+    static void (Adler32::*const update_dispatched)(ReadonlyBytes data);
+
     u32 m_state_a { 1 };
     u32 m_state_b { 0 };
 };
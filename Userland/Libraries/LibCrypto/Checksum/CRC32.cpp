@@ -6,6 +6,8 @@
 
 #include <AK/Array.h>
 #include <AK/NumericLimits.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <LibCrypto/Checksum/CRC32.h>
@@ -16,8 +18,12 @@
 
 namespace Crypto::Checksum {
 
+// The CRC32 polynomial, bit-reflected.
+static constexpr u32 ethernet_polynomial = 0xEDB88320;
+
 #if defined(__ARM_ACLE) && __ARM_ARCH >= 8 && defined(__ARM_FEATURE_CRC32)
-void CRC32::update(ReadonlyBytes span)
+template<>
+void CRC32::update_impl<CPUFeatures::None>(ReadonlyBytes span)
 {
     // FIXME: Does this require runtime checking on rpi?
     //        (Maybe the instruction is present on the rpi4 but not on the rpi3?)
@@ -50,8 +56,6 @@ void CRC32::update(ReadonlyBytes span)
 
 #else
 
-static constexpr size_t ethernet_polynomial = 0xEDB88320;
-
 #    if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
 
 // This implements Intel's slicing-by-8 algorithm. Their original paper is no longer on their website,
@@ -104,7 +108,8 @@ static constexpr u32 single_byte_crc(u32 crc, u8 byte)
     return (crc >> 8) ^ table[0][(crc & 0xff) ^ byte];
 }
 
-void CRC32::update(ReadonlyBytes data)
+template<>
+void CRC32::update_impl<CPUFeatures::None>(ReadonlyBytes data)
 {
     // The provided data may not be aligned to a 4-byte boundary, required to reinterpret its address
     // into a u32 in the loop below. So we split the bytes into two segments: the misaligned bytes
@@ -159,7 +164,8 @@ static constexpr auto generate_table()
 
 static constexpr auto table = generate_table();
 
-void CRC32::update(ReadonlyBytes data)
+template<>
+void CRC32::update_impl<CPUFeatures::None>(ReadonlyBytes data)
 {
     for (size_t i = 0; i < data.size(); i++) {
         m_state = table[(m_state ^ data.at(i)) & 0xFF] ^ (m_state >> 8);
@@ -169,6 +175,210 @@ void CRC32::update(ReadonlyBytes data)
 #    endif
 #endif
 
+// Multiplies two polynomials modulo the CRC32 polynomial. Both of them, and the product, are bit-reflected, which makes
+// x^0 the most significant bit.
+static constexpr u32 multiply_modulo_polynomial(u32 a, u32 b)
+{
+    u32 product = 0;
+    for (u32 bit = 1u << 31; bit != 0; bit >>= 1) {
+        if (a & bit)
+            product ^= b;
+        b = (b >> 1) ^ ((b & 1) * ethernet_polynomial);
+    }
+    return product;
+}
+
+// x^(2^n) modulo the CRC32 polynomial, bit-reflected.
+static constexpr auto powers_of_x_to_powers_of_two = [] {
+    Array<u32, 64> powers {};
+    u32 power = 1u << 30;
+    for (auto& entry : powers) {
+        entry = power;
+        power = multiply_modulo_polynomial(power, power);
+    }
+    return powers;
+}();
+
+#if AK_CAN_CODEGEN_FOR_X86_PCLMUL
+// The folding below follows "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" (Intel, 2009).
+// Folding a 128-bit chunk of the input forward by `distance` bits multiplies its low half by x^(distance + 32) and its
+// high half by x^(distance - 32), in the reflected representation and shifted left by one bit.
+static constexpr u64 fold_constant(size_t exponent)
+{
+    u32 power = 1u << 31;
+    for (size_t i = 0; i < exponent; ++i)
+        power = (power >> 1) ^ ((power & 1) * ethernet_polynomial);
+    return static_cast<u64>(power) << 1;
+}
+
+static_assert(fold_constant(4 * 128 + 32) == 0x1'5444'2bd4);
+static_assert(fold_constant(128 - 32) == 0x0'ccaa'009e);
+
+using AK::SIMD::u64x2;
+
+static constexpr u64x2 fold_constants(size_t distance)
+{
+    return u64x2 { fold_constant(distance + 32), fold_constant(distance - 32) };
+}
+
+template<int selector>
+[[gnu::target("pclmul")]] static u64x2 carryless_multiply(u64x2 a, u64x2 b)
+{
+    using illx2 = signed long long int __attribute__((vector_size(16)));
+    return bit_cast<u64x2>(__builtin_ia32_pclmulqdq128(bit_cast<illx2>(a), bit_cast<illx2>(b), selector));
+}
+
+[[gnu::target("pclmul")]] static u64x2 fold(u64x2 value, u64x2 constants, u64x2 next)
+{
+    return carryless_multiply<0x00>(value, constants) ^ carryless_multiply<0x11>(value, constants) ^ next;
+}
+
+// Folds the remaining 16-byte chunks into `value`, and reduces it to the 32-bit CRC state.
+[[gnu::target("pclmul")]] static u32 fold_and_reduce(u64x2 value, u8 const* data, size_t length)
+{
+    constexpr auto fold_by_one = fold_constants(128);
+    for (; length >= 16; data += 16, length -= 16)
+        value = fold(value, fold_by_one, AK::SIMD::load_unaligned<u64x2>(data));
+
+    constexpr u64 low_32_bits = 0xffff'ffff;
+    constexpr u64 fold_96_to_64_bits = fold_constant(64);
+
+    // Fold the 128 bits down to 96, and then to 64.
+    value = u64x2 { value[1], 0 } ^ carryless_multiply<0x10>(value, fold_by_one);
+    u64x2 high_96_bits = bit_cast<u64x2>(__builtin_shufflevector(bit_cast<AK::SIMD::u32x4>(value), AK::SIMD::u32x4 {}, 1, 2, 3, 4));
+    value = carryless_multiply<0x00>(value & u64x2 { low_32_bits, 0 }, u64x2 { fold_96_to_64_bits, 0 }) ^ high_96_bits;
+
+    // Barrett reduction to 32 bits: the bit-reflected polynomial (with its x^32 term) and floor(x^64 / P).
+    constexpr u64x2 barrett_constants { 0x1'db71'0641, 0x1'f701'1641 };
+    auto quotient = carryless_multiply<0x10>(value & u64x2 { low_32_bits, 0 }, barrett_constants);
+    value ^= carryless_multiply<0x00>(quotient & u64x2 { low_32_bits, 0 }, barrett_constants);
+    return bit_cast<AK::SIMD::u32x4>(value)[1];
+}
+
+template<>
+[[gnu::target("pclmul")]] void CRC32::update_impl<CPUFeatures::X86_PCLMUL>(ReadonlyBytes data)
+{
+    if (data.size() < 64)
+        return update_impl<CPUFeatures::None>(data);
+
+    // Four chunks of 16 bytes are folded forward in parallel, each by 64 bytes at a time.
+    auto const* bytes = data.data();
+    size_t length = data.size() & ~15;
+
+    u64x2 chunks[4];
+    for (size_t i = 0; i < 4; ++i)
+        chunks[i] = AK::SIMD::load_unaligned<u64x2>(bytes + i * 16);
+    chunks[0] ^= u64x2 { m_state, 0 };
+    bytes += 64;
+    length -= 64;
+
+    constexpr auto fold_by_four = fold_constants(4 * 128);
+    for (; length >= 64; bytes += 64, length -= 64) {
+        for (size_t i = 0; i < 4; ++i)
+            chunks[i] = fold(chunks[i], fold_by_four, AK::SIMD::load_unaligned<u64x2>(bytes + i * 16));
+    }
+
+    constexpr auto fold_by_one = fold_constants(128);
+    auto value = fold(chunks[0], fold_by_one, chunks[1]);
+    value = fold(value, fold_by_one, chunks[2]);
+    value = fold(value, fold_by_one, chunks[3]);
+    m_state = fold_and_reduce(value, bytes, length);
+
+    update_impl<CPUFeatures::None>(data.slice_from_end(data.size() % 16));
+}
+#endif
+
+#if AK_CAN_CODEGEN_FOR_X86_VPCLMULQDQ && AK_CAN_CODEGEN_FOR_X86_AVX512F && AK_CAN_CODEGEN_FOR_X86_PCLMUL
+using u64x8 = u64 __attribute__((vector_size(64)));
+
+template<int selector>
+[[gnu::target("avx512f,vpclmulqdq")]] static u64x8 carryless_multiply(u64x8 a, u64x8 b)
+{
+    using illx8 = signed long long int __attribute__((vector_size(64)));
+    return bit_cast<u64x8>(__builtin_ia32_vpclmulqdq_v8di(bit_cast<illx8>(a), bit_cast<illx8>(b), selector));
+}
+
+[[gnu::target("avx512f,vpclmulqdq")]] static u64x8 fold(u64x8 value, u64x8 constants, u64x8 next)
+{
+    return carryless_multiply<0x00>(value, constants) ^ carryless_multiply<0x11>(value, constants) ^ next;
+}
+
+[[gnu::target("avx512f,vpclmulqdq")]] static u64x8 broadcast(u64x2 constants)
+{
+    return __builtin_shufflevector(constants, constants, 0, 1, 0, 1, 0, 1, 0, 1);
+}
+
+template<>
+[[gnu::target("avx512f,vpclmulqdq,pclmul")]] void CRC32::update_impl<CPUFeatures::X86_AVX512F | CPUFeatures::X86_VPCLMULQDQ | CPUFeatures::X86_PCLMUL>(ReadonlyBytes data)
+{
+    if (data.size() < 256)
+        return update_impl<CPUFeatures::X86_PCLMUL>(data);
+
+    // The same folding as above, but with four 128-bit chunks in each of the four ZMM registers, so sixteen chunks are
+    // folded forward by 256 bytes at a time.
+    auto const* bytes = data.data();
+    size_t length = data.size() & ~15;
+
+    u64x8 chunks[4];
+    for (size_t i = 0; i < 4; ++i)
+        chunks[i] = AK::SIMD::load_unaligned<u64x8>(bytes + i * 64);
+    chunks[0] ^= u64x8 { m_state, 0, 0, 0, 0, 0, 0, 0 };
+    bytes += 256;
+    length -= 256;
+
+    constexpr auto fold_by_sixteen = fold_constants(16 * 128);
+    for (; length >= 256; bytes += 256, length -= 256) {
+        for (size_t i = 0; i < 4; ++i)
+            chunks[i] = fold(chunks[i], broadcast(fold_by_sixteen), AK::SIMD::load_unaligned<u64x8>(bytes + i * 64));
+    }
+
+    constexpr auto fold_by_four = fold_constants(4 * 128);
+    auto value = fold(chunks[0], broadcast(fold_by_four), chunks[1]);
+    value = fold(value, broadcast(fold_by_four), chunks[2]);
+    value = fold(value, broadcast(fold_by_four), chunks[3]);
+
+    // Fold the four chunks in the register into the last one.
+    constexpr auto fold_by_three = fold_constants(3 * 128);
+    constexpr auto fold_by_two = fold_constants(2 * 128);
+    constexpr auto fold_by_one = fold_constants(128);
+    auto last = __builtin_shufflevector(value, value, 6, 7);
+    last = fold(__builtin_shufflevector(value, value, 0, 1), fold_by_three, last);
+    last = fold(__builtin_shufflevector(value, value, 2, 3), fold_by_two, last);
+    last = fold(__builtin_shufflevector(value, value, 4, 5), fold_by_one, last);
+    m_state = fold_and_reduce(last, bytes, length);
+
+    update_impl<CPUFeatures::None>(data.slice_from_end(data.size() % 16));
+}
+#endif
+
+decltype(CRC32::update_dispatched) CRC32::update_dispatched = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_AVX512F | CPUFeatures::X86_VPCLMULQDQ | CPUFeatures::X86_PCLMUL)) {
+        if (has_flag(features, CPUFeatures::X86_AVX512F | CPUFeatures::X86_VPCLMULQDQ | CPUFeatures::X86_PCLMUL))
+            return &CRC32::update_impl<CPUFeatures::X86_AVX512F | CPUFeatures::X86_VPCLMULQDQ | CPUFeatures::X86_PCLMUL>;
+    }
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_PCLMUL)) {
+        if (has_flag(features, CPUFeatures::X86_PCLMUL))
+            return &CRC32::update_impl<CPUFeatures::X86_PCLMUL>;
+    }
+
+    return &CRC32::update_impl<CPUFeatures::None>;
+}();
+
+u32 CRC32::combine(u32 first_crc, u32 second_crc, u64 second_length)
+{
+    // Appending n bytes to an input multiplies its CRC by x^(8n), and the initial and final inversions of the CRCs
+    // cancel out, so the CRC of the second input can simply be added to that.
+    u32 shift = 1u << 31;
+    for (size_t i = 3; second_length != 0 && i < powers_of_x_to_powers_of_two.size(); second_length >>= 1, ++i) {
+        if (second_length & 1)
+            shift = multiply_modulo_polynomial(powers_of_x_to_powers_of_two[i], shift);
+    }
+    return multiply_modulo_polynomial(shift, first_crc) ^ second_crc;
+}
+
 u32 CRC32::digest()
 {
     return ~m_state;
@@ -5,7 +5,9 @@
  */
 
 #include <AK/ByteReader.h>
+#include <AK/CPUFeatures.h>
 #include <AK/Endian.h>
+#include <AK/SIMD.h>
 #include <LibCrypto/Cipher/ChaCha20.h>
 
 namespace Crypto::Cipher {
@@ -111,20 +113,136 @@ void ChaCha20::do_quarter_round(u32& a, u32& b, u32& c, u32& d)
     rotl(b, 7);
 }
 
-void ChaCha20::run_cipher(ReadonlyBytes input, Bytes& output)
+void ChaCha20::increment_counter(u32 block_count)
+{
+    // Increment the block counter, and carry over to block 13
+    m_state[12] += block_count;
+    if (m_state[12] < block_count) {
+        m_state[13]++;
+    }
+}
+
+template<typename VectorType>
+ALWAYS_INLINE static void rotl(VectorType& x, u32 n)
+{
+    x = (x << n) | (x >> (32 - n));
+}
+
+template<typename VectorType>
+ALWAYS_INLINE static void do_vector_quarter_round(VectorType& a, VectorType& b, VectorType& c, VectorType& d)
+{
+    a += b;
+    d ^= a;
+    rotl(d, 16);
+
+    c += d;
+    b ^= c;
+    rotl(b, 12);
+
+    a += b;
+    d ^= a;
+    rotl(d, 8);
+
+    c += d;
+    b ^= c;
+    rotl(b, 7);
+}
+
+// Computes one block per vector lane: word i of every block lives in x[i], so the rounds are plain vector operations.
+template<typename VectorType>
+ALWAYS_INLINE static void run_cipher_on_vector_of_blocks(u32 const (&state)[16], u8 const* input, u8* output)
+{
+    constexpr size_t block_count = AK::SIMD::vector_length<VectorType>;
+
+    VectorType initial[16];
+    for (size_t i = 0; i < 16; ++i)
+        initial[i] = VectorType {} + state[i];
+
+    // Each lane gets its own block counter, carrying over to word 13 like the scalar path does.
+    VectorType lane_index;
+    for (size_t i = 0; i < block_count; ++i)
+        lane_index[i] = i;
+    initial[12] += lane_index;
+    initial[13] -= bit_cast<VectorType>(initial[12] < state[12]);
+
+    VectorType x[16];
+    for (size_t i = 0; i < 16; ++i)
+        x[i] = initial[i];
+
+    for (u32 i = 0; i < 20; i += 2) {
+        // Column rounds
+        do_vector_quarter_round(x[0], x[4], x[8], x[12]);
+        do_vector_quarter_round(x[1], x[5], x[9], x[13]);
+        do_vector_quarter_round(x[2], x[6], x[10], x[14]);
+        do_vector_quarter_round(x[3], x[7], x[11], x[15]);
+
+        // Diagonal rounds
+        do_vector_quarter_round(x[0], x[5], x[10], x[15]);
+        do_vector_quarter_round(x[1], x[6], x[11], x[12]);
+        do_vector_quarter_round(x[2], x[7], x[8], x[13]);
+        do_vector_quarter_round(x[3], x[4], x[9], x[14]);
+    }
+
+    for (size_t i = 0; i < 16; ++i)
+        x[i] += initial[i];
+
+    for (size_t block = 0; block < block_count; ++block) {
+        for (size_t word = 0; word < 16; ++word) {
+            auto offset = block * 64 + word * 4;
+            u32 key_word = AK::convert_between_host_and_little_endian(x[word][block]);
+            ByteReader::store(output + offset, ByteReader::load32(input + offset) ^ key_word);
+        }
+    }
+}
+
+template<>
+size_t ChaCha20::run_cipher_on_blocks_impl<CPUFeatures::None>(ReadonlyBytes input, Bytes output)
+{
+    constexpr size_t batch_size = 4 * 64;
+
+    size_t offset = 0;
+    for (; offset + batch_size <= input.size(); offset += batch_size) {
+        run_cipher_on_vector_of_blocks<AK::SIMD::u32x4>(m_state, input.offset(offset), output.offset(offset));
+        increment_counter(4);
+    }
+    return offset;
+}
+
+#if AK_CAN_CODEGEN_FOR_X86_AVX2
+template<>
+[[gnu::target("avx2")]] size_t ChaCha20::run_cipher_on_blocks_impl<CPUFeatures::X86_AVX2>(ReadonlyBytes input, Bytes output)
 {
+    constexpr size_t batch_size = 8 * 64;
+
     size_t offset = 0;
+    for (; offset + batch_size <= input.size(); offset += batch_size) {
+        run_cipher_on_vector_of_blocks<AK::SIMD::u32x8>(m_state, input.offset(offset), output.offset(offset));
+        increment_counter(8);
+    }
+    return offset + run_cipher_on_blocks_impl<CPUFeatures::None>(input.slice(offset), output.slice(offset));
+}
+#endif
+
+decltype(ChaCha20::run_cipher_on_blocks_dispatched) ChaCha20::run_cipher_on_blocks_dispatched = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_AVX2)) {
+        if (has_flag(features, CPUFeatures::X86_AVX2))
+            return &ChaCha20::run_cipher_on_blocks_impl<CPUFeatures::X86_AVX2>;
+    }
+
+    return &ChaCha20::run_cipher_on_blocks_impl<CPUFeatures::None>;
+}();
+
+void ChaCha20::run_cipher(ReadonlyBytes input, Bytes& output)
+{
+    size_t offset = (this->*run_cipher_on_blocks_dispatched)(input, output);
     size_t block_offset = 0;
     while (offset < input.size()) {
         if (block_offset == 0 || block_offset >= 64) {
             // Generate a new XOR block
             generate_block();
-
-            // Increment the block counter, and carry over to block 13
-            m_state[12]++;
-            if (m_state[12] == 0) {
-                m_state[13]++;
-            }
+            increment_counter(1);
 
             block_offset = 0;
         }
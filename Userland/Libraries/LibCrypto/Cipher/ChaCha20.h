@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/CPUFeatures.h>
 
 namespace Crypto::Cipher {
 
@@ -26,6 +27,15 @@ private:
     void run_cipher(ReadonlyBytes input, Bytes& output);
     ALWAYS_INLINE void do_quarter_round(u32& a, u32& b, u32& c, u32& d);
 
+    // Encrypts as many whole batches of blocks as fit in the input, several blocks at a time, and returns the number of
+    // bytes that were processed.
+    template<CPUFeatures>
+    size_t run_cipher_on_blocks_impl(ReadonlyBytes input, Bytes output);
+
+    static size_t (ChaCha20::*const run_cipher_on_blocks_dispatched)(ReadonlyBytes input, Bytes output);
+
+    void increment_counter(u32 block_count);
+
     u32 m_state[16] {};
     u32 m_block[16] {};
 };
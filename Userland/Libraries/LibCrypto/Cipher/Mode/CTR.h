@@ -170,6 +170,32 @@ protected:
         size_t offset { 0 };
         auto block_size = cipher.block_size();
 
+        // If the cipher can encrypt several blocks in one go, hand it a batch of counter blocks at a time.
+        if constexpr (requires { cipher.encrypt_blocks(ReadonlyBytes {}, Bytes {}); }) {
+            constexpr size_t batch_size = 8 * T::BlockSizeInBits / 8;
+            u8 counters[batch_size];
+            u8 key_stream[batch_size];
+
+            while (length >= batch_size) {
+                for (size_t i = 0; i < batch_size; i += block_size) {
+                    __builtin_memcpy(counters + i, iv.data(), block_size);
+                    increment(iv);
+                }
+                cipher.encrypt_blocks({ counters, batch_size }, { key_stream, batch_size });
+
+                if (in) {
+                    auto const* input = in->offset(offset);
+                    for (size_t i = 0; i < batch_size; ++i)
+                        key_stream[i] ^= input[i];
+                }
+                VERIFY(offset + batch_size <= out.size());
+                __builtin_memcpy(out.offset(offset), key_stream, batch_size);
+
+                length -= batch_size;
+                offset += batch_size;
+            }
+        }
+
         while (length > 0) {
             m_cipher_block.overwrite(iv.slice(0, block_size));
 
@@ -5,6 +5,8 @@
  */
 
 #include <AK/ByteReader.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <LibCrypto/Hash/BLAKE2b.h>
 
 namespace Crypto::Hash {
@@ -67,13 +69,13 @@ void BLAKE2b::increment_counter_by(u64 const amount)
     m_internal_state.message_byte_offset[1] += (m_internal_state.message_byte_offset[0] < amount);
 }
 
-void BLAKE2b::mix(u64* work_array, u64 a, u64 b, u64 c, u64 d, u64 x, u64 y)
-{
-    constexpr auto rotation_constant_1 = 32;
-    constexpr auto rotation_constant_2 = 24;
-    constexpr auto rotation_constant_3 = 16;
-    constexpr auto rotation_constant_4 = 63;
+constexpr auto rotation_constant_1 = 32;
+constexpr auto rotation_constant_2 = 24;
+constexpr auto rotation_constant_3 = 16;
+constexpr auto rotation_constant_4 = 63;
 
+ALWAYS_INLINE static void mix(u64 (&work_array)[16], size_t a, size_t b, size_t c, size_t d, u64 x, u64 y)
+{
     work_array[a] = work_array[a] + work_array[b] + x;
     work_array[d] = ROTRIGHT(work_array[d] ^ work_array[a], rotation_constant_1);
     work_array[c] = work_array[c] + work_array[d];
@@ -84,7 +86,8 @@ void BLAKE2b::mix(u64* work_array, u64 a, u64 b, u64 c, u64 d, u64 x, u64 y)
     work_array[b] = ROTRIGHT(work_array[b] ^ work_array[c], rotation_constant_4);
 }
 
-void BLAKE2b::transform(u8 const* block)
+template<>
+void BLAKE2b::transform_impl<CPUFeatures::None>(u8 const* block)
 {
     u64 m[16];
     u64 v[16];
@@ -104,23 +107,120 @@ void BLAKE2b::transform(u8 const* block)
     v[14] = SHA512Constants::InitializationHashes[6] ^ m_internal_state.is_at_last_block;
     v[15] = SHA512Constants::InitializationHashes[7];
 
+    // Note: Fully unrolled, so that the message words are picked with constant indices and the work vector can live
+    //       in registers.
+#pragma GCC unroll 12
     for (size_t i = 0; i < 12; ++i) {
-        u64 sigma_selection[16];
-        for (size_t j = 0; j < 16; ++j)
-            sigma_selection[j] = BLAKE2bSigma[i % 10][j];
-        mix(v, 0, 4, 8, 12, m[sigma_selection[0]], m[sigma_selection[1]]);
-        mix(v, 1, 5, 9, 13, m[sigma_selection[2]], m[sigma_selection[3]]);
-        mix(v, 2, 6, 10, 14, m[sigma_selection[4]], m[sigma_selection[5]]);
-        mix(v, 3, 7, 11, 15, m[sigma_selection[6]], m[sigma_selection[7]]);
-
-        mix(v, 0, 5, 10, 15, m[sigma_selection[8]], m[sigma_selection[9]]);
-        mix(v, 1, 6, 11, 12, m[sigma_selection[10]], m[sigma_selection[11]]);
-        mix(v, 2, 7, 8, 13, m[sigma_selection[12]], m[sigma_selection[13]]);
-        mix(v, 3, 4, 9, 14, m[sigma_selection[14]], m[sigma_selection[15]]);
+        auto const& sigma = BLAKE2bSigma[i];
+        mix(v, 0, 4, 8, 12, m[sigma[0]], m[sigma[1]]);
+        mix(v, 1, 5, 9, 13, m[sigma[2]], m[sigma[3]]);
+        mix(v, 2, 6, 10, 14, m[sigma[4]], m[sigma[5]]);
+        mix(v, 3, 7, 11, 15, m[sigma[6]], m[sigma[7]]);
+
+        mix(v, 0, 5, 10, 15, m[sigma[8]], m[sigma[9]]);
+        mix(v, 1, 6, 11, 12, m[sigma[10]], m[sigma[11]]);
+        mix(v, 2, 7, 8, 13, m[sigma[12]], m[sigma[13]]);
+        mix(v, 3, 4, 9, 14, m[sigma[14]], m[sigma[15]]);
     }
 
     for (size_t i = 0; i < 8; ++i)
         m_internal_state.hash_state[i] = m_internal_state.hash_state[i] ^ v[i] ^ v[i + 8];
 }
 
+#if AK_CAN_CODEGEN_FOR_X86_AVX2
+// The rotations by whole bytes are byte shuffles within each 64-bit lane.
+ALWAYS_INLINE static AK::SIMD::u64x4 rotate_right_by_32(AK::SIMD::u64x4 x)
+{
+    auto words = bit_cast<AK::SIMD::u32x8>(x);
+    return bit_cast<AK::SIMD::u64x4>(__builtin_shufflevector(words, words, 1, 0, 3, 2, 5, 4, 7, 6));
+}
+
+ALWAYS_INLINE static AK::SIMD::u64x4 rotate_right_by_24(AK::SIMD::u64x4 x)
+{
+    auto bytes = bit_cast<AK::SIMD::u8x32>(x);
+    return bit_cast<AK::SIMD::u64x4>(__builtin_shufflevector(bytes, bytes,
+        3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+        19, 20, 21, 22, 23, 16, 17, 18, 27, 28, 29, 30, 31, 24, 25, 26));
+}
+
+ALWAYS_INLINE static AK::SIMD::u64x4 rotate_right_by_16(AK::SIMD::u64x4 x)
+{
+    auto bytes = bit_cast<AK::SIMD::u8x32>(x);
+    return bit_cast<AK::SIMD::u64x4>(__builtin_shufflevector(bytes, bytes,
+        2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+        18, 19, 20, 21, 22, 23, 16, 17, 26, 27, 28, 29, 30, 31, 24, 25));
+}
+
+ALWAYS_INLINE static AK::SIMD::u64x4 rotate_right_by_63(AK::SIMD::u64x4 x)
+{
+    return (x >> 63) | (x + x);
+}
+
+// Mixes all four columns (or diagonals) at once, with one column in each lane of the rows.
+ALWAYS_INLINE static void mix_rows(AK::SIMD::u64x4& a, AK::SIMD::u64x4& b, AK::SIMD::u64x4& c, AK::SIMD::u64x4& d, AK::SIMD::u64x4 x, AK::SIMD::u64x4 y)
+{
+    a = a + b + x;
+    d = rotate_right_by_32(d ^ a);
+    c = c + d;
+    b = rotate_right_by_24(b ^ c);
+    a = a + b + y;
+    d = rotate_right_by_16(d ^ a);
+    c = c + d;
+    b = rotate_right_by_63(b ^ c);
+}
+
+template<>
+[[gnu::target("avx2")]] void BLAKE2b::transform_impl<CPUFeatures::X86_AVX2>(u8 const* block)
+{
+    using AK::SIMD::u64x4;
+
+    u64 m[16];
+    for (size_t i = 0; i < 16; ++i)
+        m[i] = ByteReader::load64(block + i * sizeof(m[i]));
+
+    auto& hash_state = m_internal_state.hash_state;
+    auto a = AK::SIMD::load_unaligned<u64x4>(&hash_state[0]);
+    auto b = AK::SIMD::load_unaligned<u64x4>(&hash_state[4]);
+    auto c = AK::SIMD::load_unaligned<u64x4>(&SHA512Constants::InitializationHashes[0]);
+    auto d = AK::SIMD::load_unaligned<u64x4>(&SHA512Constants::InitializationHashes[4])
+        ^ u64x4 { m_internal_state.message_byte_offset[0], m_internal_state.message_byte_offset[1], m_internal_state.is_at_last_block, 0 };
+
+    // Note: Fully unrolled, so that the message words are picked with constant indices.
+#pragma GCC unroll 12
+    for (size_t i = 0; i < 12; ++i) {
+        auto const& sigma = BLAKE2bSigma[i];
+        mix_rows(a, b, c, d,
+            u64x4 { m[sigma[0]], m[sigma[2]], m[sigma[4]], m[sigma[6]] },
+            u64x4 { m[sigma[1]], m[sigma[3]], m[sigma[5]], m[sigma[7]] });
+
+        // Rotate the rows so that the diagonals line up in the lanes.
+        b = __builtin_shufflevector(b, b, 1, 2, 3, 0);
+        c = __builtin_shufflevector(c, c, 2, 3, 0, 1);
+        d = __builtin_shufflevector(d, d, 3, 0, 1, 2);
+
+        mix_rows(a, b, c, d,
+            u64x4 { m[sigma[8]], m[sigma[10]], m[sigma[12]], m[sigma[14]] },
+            u64x4 { m[sigma[9]], m[sigma[11]], m[sigma[13]], m[sigma[15]] });
+
+        b = __builtin_shufflevector(b, b, 3, 0, 1, 2);
+        c = __builtin_shufflevector(c, c, 2, 3, 0, 1);
+        d = __builtin_shufflevector(d, d, 1, 2, 3, 0);
+    }
+
+    AK::SIMD::store_unaligned(&hash_state[0], AK::SIMD::load_unaligned<u64x4>(&hash_state[0]) ^ a ^ c);
+    AK::SIMD::store_unaligned(&hash_state[4], AK::SIMD::load_unaligned<u64x4>(&hash_state[4]) ^ b ^ d);
+}
+#endif
+
+decltype(BLAKE2b::transform_dispatched) BLAKE2b::transform_dispatched = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_AVX2)) {
+        if (has_flag(features, CPUFeatures::X86_AVX2))
+            return &BLAKE2b::transform_impl<CPUFeatures::X86_AVX2>;
+    }
+
+    return &BLAKE2b::transform_impl<CPUFeatures::None>;
+}();
+
 }
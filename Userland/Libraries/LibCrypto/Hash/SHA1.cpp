@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteReader.h>
 #include <AK/CPUFeatures.h>
 #include <AK/Endian.h>
 #include <AK/Memory.h>
@@ -22,55 +23,51 @@ static constexpr auto ROTATE_LEFT(u32 value, size_t bits)
 }
 
 template<>
-void SHA1::transform_impl<CPUFeatures::None>()
+void SHA1::transform_impl<CPUFeatures::None>(u8 const* data, size_t block_count)
 {
-    auto& data = m_data_buffer;
-
     u32 blocks[80];
-    for (size_t i = 0; i < 16; ++i)
-        blocks[i] = AK::convert_between_host_and_network_endian(((u32 const*)data)[i]);
-
-    // w[i] = (w[i-3] xor w[i-8] xor w[i-14] xor w[i-16]) leftrotate 1
-    for (size_t i = 16; i < Rounds; ++i)
-        blocks[i] = ROTATE_LEFT(blocks[i - 3] ^ blocks[i - 8] ^ blocks[i - 14] ^ blocks[i - 16], 1);
-
-    auto a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3], e = m_state[4];
-    u32 f, k;
-
-    for (size_t i = 0; i < Rounds; ++i) {
-        if (i <= 19) {
-            f = (b & c) | ((~b) & d);
-            k = SHA1Constants::RoundConstants[0];
-        } else if (i <= 39) {
-            f = b ^ c ^ d;
-            k = SHA1Constants::RoundConstants[1];
-        } else if (i <= 59) {
-            f = (b & c) | (b & d) | (c & d);
-            k = SHA1Constants::RoundConstants[2];
-        } else {
-            f = b ^ c ^ d;
-            k = SHA1Constants::RoundConstants[3];
+
+    for (; block_count > 0; --block_count, data += BlockSize) {
+        for (size_t i = 0; i < 16; ++i)
+            blocks[i] = AK::convert_between_host_and_network_endian(ByteReader::load32(data + i * 4));
+
+        // w[i] = (w[i-3] xor w[i-8] xor w[i-14] xor w[i-16]) leftrotate 1
+        for (size_t i = 16; i < Rounds; ++i)
+            blocks[i] = ROTATE_LEFT(blocks[i - 3] ^ blocks[i - 8] ^ blocks[i - 14] ^ blocks[i - 16], 1);
+
+        auto a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3], e = m_state[4];
+        u32 f, k;
+
+        for (size_t i = 0; i < Rounds; ++i) {
+            if (i <= 19) {
+                f = (b & c) | ((~b) & d);
+                k = SHA1Constants::RoundConstants[0];
+            } else if (i <= 39) {
+                f = b ^ c ^ d;
+                k = SHA1Constants::RoundConstants[1];
+            } else if (i <= 59) {
+                f = (b & c) | (b & d) | (c & d);
+                k = SHA1Constants::RoundConstants[2];
+            } else {
+                f = b ^ c ^ d;
+                k = SHA1Constants::RoundConstants[3];
+            }
+            auto temp = ROTATE_LEFT(a, 5) + f + e + k + blocks[i];
+            e = d;
+            d = c;
+            c = ROTATE_LEFT(b, 30);
+            b = a;
+            a = temp;
         }
-        auto temp = ROTATE_LEFT(a, 5) + f + e + k + blocks[i];
-        e = d;
-        d = c;
-        c = ROTATE_LEFT(b, 30);
-        b = a;
-        a = temp;
-    }
 
-    m_state[0] += a;
-    m_state[1] += b;
-    m_state[2] += c;
-    m_state[3] += d;
-    m_state[4] += e;
+        m_state[0] += a;
+        m_state[1] += b;
+        m_state[2] += c;
+        m_state[3] += d;
+        m_state[4] += e;
+    }
 
     // "security" measures, as if SHA1 is secure
-    a = 0;
-    b = 0;
-    c = 0;
-    d = 0;
-    e = 0;
     secure_zero(blocks, 16 * sizeof(u32));
 }
 
@@ -80,12 +77,11 @@ void SHA1::transform_impl<CPUFeatures::None>()
 //      ~https://en.wikipedia.org/wiki/Intel_SHA_extensions
 #if AK_CAN_CODEGEN_FOR_X86_SHA && AK_CAN_CODEGEN_FOR_X86_SSE42
 template<>
-[[gnu::target("sha,sse4.2")]] void SHA1::transform_impl<CPUFeatures::X86_SHA | CPUFeatures::X86_SSE42>()
+[[gnu::target("sha,sse4.2")]] void SHA1::transform_impl<CPUFeatures::X86_SHA | CPUFeatures::X86_SSE42>(u8 const* data, size_t block_count)
 {
 #    define SHA_TARGET gnu::target("sha"), gnu::always_inline
 
     auto& state = m_state;
-    auto& data = m_data_buffer;
 
     using AK::SIMD::u32x4, AK::SIMD::i32x4;
     // Note: These need to be unsigned, as we add to them and expect them to wrap around,
@@ -106,6 +102,8 @@ template<>
     auto sha_rnds4 = []<int i> [[SHA_TARGET]] (u32x4 a, u32x4 b) { return bit_cast<u32x4>(__builtin_ia32_sha1rnds4(bit_cast<i32x4>(a), bit_cast<i32x4>(b), i)); };
 
     auto group = [&]<int i_group> [[SHA_TARGET]] () {
+        // Note: Fully unrolled, so that msgs and abcd are indexed with constants and can live in registers.
+#    pragma GCC unroll 5
         for (size_t i_pack = 0; i_pack != 5; ++i_pack) {
             size_t i_msg = i_group * 5 + i_pack;
             if (i_msg < 4) {
@@ -125,15 +123,19 @@ template<>
         }
     };
 
-    auto old_abcd = abcd[0];
-    auto old_e = e;
-    group.operator()<0>();
-    group.operator()<1>();
-    group.operator()<2>();
-    group.operator()<3>();
-    e = sha_next_e(abcd[1], u32x4 {});
-    abcd[0] += old_abcd;
-    e += old_e;
+    // The state stays in registers across all the blocks; e only has to be rebuilt from the previous block's
+    // final round.
+    for (; block_count > 0; --block_count, data += BlockSize) {
+        auto old_abcd = abcd[0];
+        auto old_e = e;
+        group.operator()<0>();
+        group.operator()<1>();
+        group.operator()<2>();
+        group.operator()<3>();
+        e = sha_next_e(abcd[1], u32x4 {});
+        abcd[0] += old_abcd;
+        e += old_e;
+    }
 
     abcd[0] = AK::SIMD::item_reverse(abcd[0]);
     AK::SIMD::store_unaligned(&state[0], abcd[0]);
@@ -157,13 +159,23 @@ decltype(SHA1::transform_dispatched) SHA1::transform_dispatched = [] {
 void SHA1::update(u8 const* message, size_t length)
 {
     while (length > 0) {
+        // Whole blocks are hashed straight from the message, without going through the buffer.
+        if (m_data_length == 0 && length >= BlockSize) {
+            size_t block_count = length / BlockSize;
+            transform(message, block_count);
+            m_bit_length += block_count * BlockSize * 8;
+            message += block_count * BlockSize;
+            length -= block_count * BlockSize;
+            continue;
+        }
+
         size_t copy_bytes = AK::min(length, BlockSize - m_data_length);
         __builtin_memcpy(m_data_buffer + m_data_length, message, copy_bytes);
         message += copy_bytes;
         length -= copy_bytes;
         m_data_length += copy_bytes;
         if (m_data_length == BlockSize) {
-            transform();
+            transform(m_data_buffer);
             m_bit_length += BlockSize * 8;
             m_data_length = 0;
         }
@@ -198,7 +210,7 @@ SHA1::DigestType SHA1::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform();
+        transform(m_data_buffer);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -215,7 +227,7 @@ SHA1::DigestType SHA1::peek()
     m_data_buffer[BlockSize - 7] = m_bit_length >> 48;
     m_data_buffer[BlockSize - 8] = m_bit_length >> 56;
 
-    transform();
+    transform(m_data_buffer);
 
     for (i = 0; i < 4; ++i) {
         digest.data[i + 0] = (m_state[0] >> (24 - i * 8)) & 0x000000ff;
@@ -69,10 +69,10 @@ public:
 
 private:
     template<CPUFeatures>
-    void transform_impl();
+    void transform_impl(u8 const* data, size_t block_count);
 
-    static void (SHA1::*const transform_dispatched)();
-    void transform() { return (this->*transform_dispatched)(); }
+    static void (SHA1::*const transform_dispatched)(u8 const* data, size_t block_count);
+    void transform(u8 const* data, size_t block_count = 1) { return (this->*transform_dispatched)(data, block_count); }
 
     u8 m_data_buffer[BlockSize] {};
     size_t m_data_length { 0 };
@@ -5,7 +5,9 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ByteReader.h>
 #include <AK/CPUFeatures.h>
+#include <AK/Endian.h>
 #include <AK/Platform.h>
 #include <AK/SIMD.h>
 #include <AK/SIMDExtras.h>
@@ -21,6 +23,22 @@ constexpr static auto EP1(u32 x) { return ROTRIGHT(x, 6) ^ ROTRIGHT(x, 11) ^ ROT
 constexpr static auto SIGN0(u32 x) { return ROTRIGHT(x, 7) ^ ROTRIGHT(x, 18) ^ (x >> 3); }
 constexpr static auto SIGN1(u32 x) { return ROTRIGHT(x, 17) ^ ROTRIGHT(x, 19) ^ (x >> 10); }
 
+// Lane-wise versions of the above, used to hash several messages at once.
+template<AK::SIMD::SIMDVector V>
+ALWAYS_INLINE static V ROTRIGHT(V a, size_t b) { return (a >> b) | (a << (32 - b)); }
+template<AK::SIMD::SIMDVector V>
+ALWAYS_INLINE static V CH(V x, V y, V z) { return (x & y) ^ (z & ~x); }
+template<AK::SIMD::SIMDVector V>
+ALWAYS_INLINE static V MAJ(V x, V y, V z) { return (x & y) ^ (x & z) ^ (y & z); }
+template<AK::SIMD::SIMDVector V>
+ALWAYS_INLINE static V EP0(V x) { return ROTRIGHT(x, 2) ^ ROTRIGHT(x, 13) ^ ROTRIGHT(x, 22); }
+template<AK::SIMD::SIMDVector V>
+ALWAYS_INLINE static V EP1(V x) { return ROTRIGHT(x, 6) ^ ROTRIGHT(x, 11) ^ ROTRIGHT(x, 25); }
+template<AK::SIMD::SIMDVector V>
+ALWAYS_INLINE static V SIGN0(V x) { return ROTRIGHT(x, 7) ^ ROTRIGHT(x, 18) ^ (x >> 3); }
+template<AK::SIMD::SIMDVector V>
+ALWAYS_INLINE static V SIGN1(V x) { return ROTRIGHT(x, 17) ^ ROTRIGHT(x, 19) ^ (x >> 10); }
+
 constexpr static auto ROTRIGHT(u64 a, size_t b) { return (a >> b) | (a << (64 - b)); }
 constexpr static auto CH(u64 x, u64 y, u64 z) { return (x & y) ^ (z & ~x); }
 constexpr static auto MAJ(u64 x, u64 y, u64 z) { return (x & y) ^ (x & z) ^ (y & z); }
@@ -30,47 +48,47 @@ constexpr static auto SIGN0(u64 x) { return ROTRIGHT(x, 1) ^ ROTRIGHT(x, 8) ^ (x
 constexpr static auto SIGN1(u64 x) { return ROTRIGHT(x, 19) ^ ROTRIGHT(x, 61) ^ (x >> 6); }
 
 template<>
-void SHA256::transform_impl<CPUFeatures::None>()
+void SHA256::transform_impl<CPUFeatures::None>(u8 const* data, size_t block_count)
 {
-    auto& data = m_data_buffer;
-
     u32 m[BlockSize];
 
-    size_t i = 0;
-    for (size_t j = 0; i < 16; ++i, j += 4) {
-        m[i] = (data[j] << 24) | (data[j + 1] << 16) | (data[j + 2] << 8) | data[j + 3];
-    }
+    for (; block_count > 0; --block_count, data += BlockSize) {
+        size_t i = 0;
+        for (size_t j = 0; i < 16; ++i, j += 4) {
+            m[i] = (data[j] << 24) | (data[j + 1] << 16) | (data[j + 2] << 8) | data[j + 3];
+        }
 
-    for (; i < BlockSize; ++i) {
-        m[i] = SIGN1(m[i - 2]) + m[i - 7] + SIGN0(m[i - 15]) + m[i - 16];
-    }
+        for (; i < BlockSize; ++i) {
+            m[i] = SIGN1(m[i - 2]) + m[i - 7] + SIGN0(m[i - 15]) + m[i - 16];
+        }
 
-    auto a = m_state[0], b = m_state[1],
-         c = m_state[2], d = m_state[3],
-         e = m_state[4], f = m_state[5],
-         g = m_state[6], h = m_state[7];
+        auto a = m_state[0], b = m_state[1],
+             c = m_state[2], d = m_state[3],
+             e = m_state[4], f = m_state[5],
+             g = m_state[6], h = m_state[7];
+
+        for (i = 0; i < Rounds; ++i) {
+            auto temp0 = h + EP1(e) + CH(e, f, g) + SHA256Constants::RoundConstants[i] + m[i];
+            auto temp1 = EP0(a) + MAJ(a, b, c);
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp0;
+            d = c;
+            c = b;
+            b = a;
+            a = temp0 + temp1;
+        }
 
-    for (i = 0; i < Rounds; ++i) {
-        auto temp0 = h + EP1(e) + CH(e, f, g) + SHA256Constants::RoundConstants[i] + m[i];
-        auto temp1 = EP0(a) + MAJ(a, b, c);
-        h = g;
-        g = f;
-        f = e;
-        e = d + temp0;
-        d = c;
-        c = b;
-        b = a;
-        a = temp0 + temp1;
+        m_state[0] += a;
+        m_state[1] += b;
+        m_state[2] += c;
+        m_state[3] += d;
+        m_state[4] += e;
+        m_state[5] += f;
+        m_state[6] += g;
+        m_state[7] += h;
     }
-
-    m_state[0] += a;
-    m_state[1] += b;
-    m_state[2] += c;
-    m_state[3] += d;
-    m_state[4] += e;
-    m_state[5] += f;
-    m_state[6] += g;
-    m_state[7] += h;
 }
 
 // Note: The SHA extension was introduced with
@@ -79,12 +97,11 @@ void SHA256::transform_impl<CPUFeatures::None>()
 //      ~https://en.wikipedia.org/wiki/Intel_SHA_extensions
 #if AK_CAN_CODEGEN_FOR_X86_SHA && AK_CAN_CODEGEN_FOR_X86_SSE42
 template<>
-[[gnu::target("sha,sse4.2")]] void SHA256::transform_impl<CPUFeatures::X86_SHA | CPUFeatures::X86_SSE42>()
+[[gnu::target("sha,sse4.2")]] void SHA256::transform_impl<CPUFeatures::X86_SHA | CPUFeatures::X86_SSE42>(u8 const* data, size_t block_count)
 {
     using AK::SIMD::i32x4, AK::SIMD::u32x4;
 
     auto& state = m_state;
-    auto& data = m_data_buffer;
 
     u32x4 states[2] {};
     states[0] = AK::SIMD::load_unaligned<u32x4>(&state[0]);
@@ -94,29 +111,34 @@ template<>
     states[0] = u32x4 { states[1][2], states[1][3], tmp[0], tmp[1] };
     states[1] = u32x4 { states[1][0], states[1][1], tmp[2], tmp[3] };
 
-    u32x4 msgs[4] {};
-    u32x4 old[2] { states[0], states[1] };
-    for (int i = 0; i != 16; ++i) {
-        u32x4 msg {};
-        if (i < 4) {
-            msgs[i] = AK::SIMD::load_unaligned<u32x4>(&data[i * 16]);
-            msgs[i] = AK::SIMD::elementwise_byte_reverse(msgs[i]);
-            tmp = AK::SIMD::load_unaligned<u32x4>(&SHA256Constants::RoundConstants[i * 4]);
-            msg = msgs[i] + tmp;
-        } else {
-            msgs[(i + 0) % 4] = bit_cast<u32x4>(__builtin_ia32_sha256msg1(bit_cast<i32x4>(msgs[(i + 0) % 4]), bit_cast<i32x4>(msgs[(i + 1) % 4])));
-            tmp = u32x4 { msgs[(i + 2) % 4][1], msgs[(i + 2) % 4][2], msgs[(i + 2) % 4][3], msgs[(i + 3) % 4][0] };
-            msgs[(i + 0) % 4] += tmp;
-            msgs[(i + 0) % 4] = bit_cast<u32x4>(__builtin_ia32_sha256msg2(bit_cast<i32x4>(msgs[(i + 0) % 4]), bit_cast<i32x4>(msgs[(i + 3) % 4])));
-            tmp = AK::SIMD::load_unaligned<u32x4>(&SHA256Constants::RoundConstants[i * 4]);
-            msg = msgs[(i + 0) % 4] + tmp;
+    // The state stays in the ABEF/CDGH layout the SHA instructions want across all the blocks.
+    for (; block_count > 0; --block_count, data += BlockSize) {
+        u32x4 msgs[4] {};
+        u32x4 old[2] { states[0], states[1] };
+        // Note: Fully unrolled, so that msgs is indexed with constants and can live in registers.
+#pragma GCC unroll 16
+        for (int i = 0; i != 16; ++i) {
+            u32x4 msg {};
+            if (i < 4) {
+                msgs[i] = AK::SIMD::load_unaligned<u32x4>(&data[i * 16]);
+                msgs[i] = AK::SIMD::elementwise_byte_reverse(msgs[i]);
+                tmp = AK::SIMD::load_unaligned<u32x4>(&SHA256Constants::RoundConstants[i * 4]);
+                msg = msgs[i] + tmp;
+            } else {
+                msgs[(i + 0) % 4] = bit_cast<u32x4>(__builtin_ia32_sha256msg1(bit_cast<i32x4>(msgs[(i + 0) % 4]), bit_cast<i32x4>(msgs[(i + 1) % 4])));
+                tmp = __builtin_shufflevector(msgs[(i + 2) % 4], msgs[(i + 3) % 4], 1, 2, 3, 4);
+                msgs[(i + 0) % 4] += tmp;
+                msgs[(i + 0) % 4] = bit_cast<u32x4>(__builtin_ia32_sha256msg2(bit_cast<i32x4>(msgs[(i + 0) % 4]), bit_cast<i32x4>(msgs[(i + 3) % 4])));
+                tmp = AK::SIMD::load_unaligned<u32x4>(&SHA256Constants::RoundConstants[i * 4]);
+                msg = msgs[(i + 0) % 4] + tmp;
+            }
+            states[1] = bit_cast<u32x4>(__builtin_ia32_sha256rnds2(bit_cast<i32x4>(states[1]), bit_cast<i32x4>(states[0]), bit_cast<i32x4>(msg)));
+            msg = __builtin_shufflevector(msg, u32x4 {}, 2, 3, 4, 5);
+            states[0] = bit_cast<u32x4>(__builtin_ia32_sha256rnds2(bit_cast<i32x4>(states[0]), bit_cast<i32x4>(states[1]), bit_cast<i32x4>(msg)));
         }
-        states[1] = bit_cast<u32x4>(__builtin_ia32_sha256rnds2(bit_cast<i32x4>(states[1]), bit_cast<i32x4>(states[0]), bit_cast<i32x4>(msg)));
-        msg = u32x4 { msg[2], msg[3], 0, 0 };
-        states[0] = bit_cast<u32x4>(__builtin_ia32_sha256rnds2(bit_cast<i32x4>(states[0]), bit_cast<i32x4>(states[1]), bit_cast<i32x4>(msg)));
+        states[0] += old[0];
+        states[1] += old[1];
     }
-    states[0] += old[0];
-    states[1] += old[1];
 
     tmp = u32x4 { states[0][3], states[0][2], states[0][1], states[0][0] };
     states[1] = u32x4 { states[1][1], states[1][0], states[1][3], states[1][2] };
@@ -138,6 +160,180 @@ decltype(SHA256::transform_dispatched) SHA256::transform_dispatched = [] {
     return &SHA256::transform_impl<CPUFeatures::None>;
 }();
 
+// Gathers the big-endian word at `offset` of every lane's block into one vector.
+template<typename VectorType, size_t... Lanes>
+ALWAYS_INLINE static VectorType sha256_load_word_from_lanes(u8 const* const* blocks, size_t offset, IndexSequence<Lanes...>)
+{
+    return VectorType { AK::convert_between_host_and_big_endian(ByteReader::load32(blocks[Lanes] + offset))... };
+}
+
+// Runs the compression function on one block per lane.
+template<typename VectorType>
+ALWAYS_INLINE static void sha256_transform_lanes(VectorType (&state)[8], u8 const* const* blocks)
+{
+    constexpr size_t lane_count = AK::SIMD::vector_length<VectorType>;
+
+    VectorType m[16];
+    for (size_t i = 0; i < 16; ++i)
+        m[i] = sha256_load_word_from_lanes<VectorType>(blocks, i * 4, MakeIndexSequence<lane_count>());
+
+    auto a = state[0], b = state[1],
+         c = state[2], d = state[3],
+         e = state[4], f = state[5],
+         g = state[6], h = state[7];
+
+    for (size_t round = 0; round < 64; round += 16) {
+        // Note: Unrolled sixteen times, so that the message schedule is indexed with constants. Unrolling all 64 rounds
+        //       makes the loop too large to run from the decoded instruction cache.
+#pragma GCC unroll 16
+        for (size_t j = 0; j < 16; ++j) {
+            if (round > 0)
+                m[j] += SIGN1(m[(j + 14) % 16]) + m[(j + 9) % 16] + SIGN0(m[(j + 1) % 16]);
+
+            auto temp0 = h + EP1(e) + CH(e, f, g) + SHA256Constants::RoundConstants[round + j] + m[j];
+            auto temp1 = EP0(a) + MAJ(a, b, c);
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp0;
+            d = c;
+            c = b;
+            b = a;
+            a = temp0 + temp1;
+        }
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+// Hashes the messages in the lanes of VectorType. Each lane works through one message at a time, and picks up the next
+// message as soon as it is done with its current one, so messages of different lengths keep all the lanes busy.
+template<typename VectorType>
+ALWAYS_INLINE static void sha256_hash_many_in_lanes(ReadonlySpan<ReadonlyBytes> messages, Span<SHA256::DigestType> digests)
+{
+    constexpr size_t lane_count = AK::SIMD::vector_length<VectorType>;
+    constexpr size_t block_size = SHA256::block_size();
+
+    struct Lane {
+        Optional<size_t> message_index;
+        u8 const* next_block { nullptr };
+        size_t message_blocks_left { 0 };
+        // Whatever is left of the message after its last whole block, followed by the padding and the message length.
+        u8 tail[2 * block_size] {};
+        size_t tail_blocks_left { 0 };
+    };
+
+    static constexpr u8 idle_block[block_size] {};
+
+    VectorType state[8];
+    Lane lanes[lane_count];
+    size_t next_message_index = 0;
+    size_t busy_lane_count = 0;
+
+    auto start_next_message = [&](size_t lane_index) {
+        auto& lane = lanes[lane_index];
+        if (next_message_index == messages.size()) {
+            if (lane.message_index.has_value())
+                --busy_lane_count;
+            lane.message_index = {};
+            return;
+        }
+        if (!lane.message_index.has_value())
+            ++busy_lane_count;
+
+        auto message = messages[next_message_index];
+        lane.message_index = next_message_index++;
+        lane.next_block = message.data();
+        lane.message_blocks_left = message.size() / block_size;
+
+        size_t tail_size = message.size() % block_size;
+        __builtin_memset(lane.tail, 0, sizeof(lane.tail));
+        if (tail_size > 0)
+            __builtin_memcpy(lane.tail, message.data() + message.size() - tail_size, tail_size);
+        lane.tail[tail_size] = 0x80;
+        lane.tail_blocks_left = tail_size < block_size - 8 ? 1 : 2;
+        ByteReader::store(lane.tail + lane.tail_blocks_left * block_size - 8, AK::convert_between_host_and_big_endian<u64>(message.size() * 8));
+
+        for (size_t i = 0; i < 8; ++i)
+            state[i][lane_index] = SHA256Constants::InitializationHashes[i];
+    };
+
+    for (size_t i = 0; i < lane_count; ++i)
+        start_next_message(i);
+
+    while (busy_lane_count > 0) {
+        u8 const* blocks[lane_count];
+        for (size_t i = 0; i < lane_count; ++i) {
+            auto& lane = lanes[i];
+            if (!lane.message_index.has_value()) {
+                blocks[i] = idle_block;
+                continue;
+            }
+            if (lane.message_blocks_left == 0) {
+                lane.next_block = lane.tail;
+                lane.message_blocks_left = exchange(lane.tail_blocks_left, 0);
+            }
+            blocks[i] = lane.next_block;
+            lane.next_block += block_size;
+            --lane.message_blocks_left;
+        }
+
+        sha256_transform_lanes(state, blocks);
+
+        for (size_t i = 0; i < lane_count; ++i) {
+            auto& lane = lanes[i];
+            if (!lane.message_index.has_value() || lane.message_blocks_left > 0 || lane.tail_blocks_left > 0)
+                continue;
+
+            auto& digest = digests[*lane.message_index];
+            for (size_t word = 0; word < 8; ++word)
+                ByteReader::store(digest.data + word * 4, AK::convert_between_host_and_big_endian<u32>(state[word][i]));
+            start_next_message(i);
+        }
+    }
+}
+
+template<>
+void SHA256::hash_many_impl<CPUFeatures::None>(ReadonlySpan<ReadonlyBytes> messages, Span<DigestType> digests)
+{
+    // Note: Four lanes of SSE2 are slower than hashing the messages one after the other.
+    for (size_t i = 0; i < messages.size(); ++i)
+        digests[i] = hash(messages[i].data(), messages[i].size());
+}
+
+#if AK_CAN_CODEGEN_FOR_X86_AVX2
+template<>
+[[gnu::target("avx2")]] void SHA256::hash_many_impl<CPUFeatures::X86_AVX2>(ReadonlySpan<ReadonlyBytes> messages, Span<DigestType> digests)
+{
+    sha256_hash_many_in_lanes<AK::SIMD::u32x8>(messages, digests);
+}
+#endif
+
+decltype(SHA256::hash_many_dispatched) SHA256::hash_many_dispatched = [] {
+    CPUFeatures features = detect_cpu_features();
+
+    // Note: The SHA instructions hash a single message faster than eight lanes of AVX2 hash eight of them, so there is
+    //       nothing to gain from interleaving the messages.
+    if constexpr (is_valid_feature(CPUFeatures::X86_SHA | CPUFeatures::X86_SSE42)) {
+        if (has_flag(features, CPUFeatures::X86_SHA | CPUFeatures::X86_SSE42))
+            return &SHA256::hash_many_impl<CPUFeatures::None>;
+    }
+
+    if constexpr (is_valid_feature(CPUFeatures::X86_AVX2)) {
+        if (has_flag(features, CPUFeatures::X86_AVX2))
+            return &SHA256::hash_many_impl<CPUFeatures::X86_AVX2>;
+    }
+
+    return &SHA256::hash_many_impl<CPUFeatures::None>;
+}();
+
 template<size_t BlockSize, typename Callback>
 void update_buffer(u8* buffer, u8 const* input, size_t length, size_t& data_length, Callback callback)
 {
@@ -156,10 +352,28 @@ void update_buffer(u8* buffer, u8 const* input, size_t length, size_t& data_leng
 
 void SHA256::update(u8 const* message, size_t length)
 {
-    update_buffer<BlockSize>(m_data_buffer, message, length, m_data_length, [&]() {
-        transform();
-        m_bit_length += BlockSize * 8;
-    });
+    auto update_through_buffer = [&](size_t count) {
+        update_buffer<BlockSize>(m_data_buffer, message, count, m_data_length, [&]() {
+            transform(m_data_buffer);
+            m_bit_length += BlockSize * 8;
+        });
+        message += count;
+        length -= count;
+    };
+
+    if (m_data_length > 0)
+        update_through_buffer(AK::min(length, BlockSize - m_data_length));
+
+    // Whole blocks are hashed straight from the message, without going through the buffer.
+    if (length >= BlockSize) {
+        size_t block_count = length / BlockSize;
+        transform(message, block_count);
+        m_bit_length += block_count * BlockSize * 8;
+        message += block_count * BlockSize;
+        length -= block_count * BlockSize;
+    }
+
+    update_through_buffer(length);
 }
 
 SHA256::DigestType SHA256::digest()
@@ -183,7 +397,7 @@ SHA256::DigestType SHA256::peek()
         m_data_buffer[i++] = 0x80;
         while (i < BlockSize)
             m_data_buffer[i++] = 0x00;
-        transform();
+        transform(m_data_buffer);
 
         // Then start another block with BlockSize - 8 bytes of zeros
         __builtin_memset(m_data_buffer, 0, FinalBlockDataSize);
@@ -200,7 +414,7 @@ SHA256::DigestType SHA256::peek()
     m_data_buffer[BlockSize - 7] = m_bit_length >> 48;
     m_data_buffer[BlockSize - 8] = m_bit_length >> 56;
 
-    transform();
+    transform(m_data_buffer);
 
     // SHA uses big-endian and we assume little-endian
     // FIXME: looks like a thing for AK::NetworkOrdered,
@@ -314,12 +314,12 @@ public:
         return delta_alpha * delta_alpha / (2.0f * 255 * 255) + rgb_distance * alpha() * other.alpha() / (255 * 255);
     }
 
-    constexpr u8 luminosity() const
+    u8 luminosity() const
     {
         return round_to<u8>(red() * 0.2126f + green() * 0.7152f + blue() * 0.0722f);
     }
 
-    constexpr float contrast_ratio(Color other)
+    float contrast_ratio(Color other)
     {
         auto l1 = luminosity();
         auto l2 = other.luminosity();
@@ -328,7 +328,7 @@ public:
         return (brightest + 0.05) / (darkest + 0.05);
     }
 
-    constexpr Color to_grayscale() const
+    Color to_grayscale() const
     {
         auto gray = luminosity();
         return Color(gray, gray, gray, alpha());
@@ -513,7 +513,7 @@ public:
         return Color(out_r, out_g, out_b);
     }
 
-    constexpr Color suggested_foreground_color() const
+    Color suggested_foreground_color() const
     {
         return luminosity() < 128 ? Color::White : Color::Black;
     }
@@ -202,32 +202,44 @@ struct X86_64Assembler {
 
     void emit_modrm(ModRM raw, Operand rm, Patchable patchable)
     {
-        // FIXME: rm:100 (RSP) is reserved as the SIB marker
         VERIFY(rm.type != Operand::Type::Imm);
 
         switch (rm.type) {
         case Operand::Type::FReg:
         case Operand::Type::Reg:
-            // FIXME: There is mod:00,rm:101(EBP?) -> disp32, that might be something else
             raw.mode = ModRM::Reg;
             emit8(raw.raw);
             break;
         case Operand::Type::Mem64BaseAndOffset: {
             auto disp = rm.offset_or_immediate;
+
+            // NOTE: rm:100 (RSP/R12) means "a SIB byte follows", so those bases need one.
+            //       mod:00,rm:101 (RBP/R13) means "RIP + disp32", so those bases always need a displacement.
+            bool needs_sib = encode_reg(rm.reg) == 0b100;
+            bool needs_displacement = encode_reg(rm.reg) == 0b101;
+            auto emit_sib_if_needed = [&] {
+                if (needs_sib)
+                    emit8(0x24); // scale:00, index:100 (none), base:100
+            };
+
             if (patchable == Patchable::Yes) {
                 raw.mode = ModRM::MemDisp32;
                 emit8(raw.raw);
+                emit_sib_if_needed();
                 emit32(disp);
-            } else if (disp == 0) {
+            } else if (disp == 0 && !needs_displacement) {
                 raw.mode = ModRM::Mem;
                 emit8(raw.raw);
-            } else if (static_cast<i64>(disp) >= -128 && disp <= 127) {
+                emit_sib_if_needed();
+            } else if (static_cast<i64>(disp) >= -128 && static_cast<i64>(disp) <= 127) {
                 raw.mode = ModRM::MemDisp8;
                 emit8(raw.raw);
+                emit_sib_if_needed();
                 emit8(disp & 0xff);
             } else {
                 raw.mode = ModRM::MemDisp32;
                 emit8(raw.raw);
+                emit_sib_if_needed();
                 emit32(disp);
             }
             break;
@@ -4,16 +4,21 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/HashFunctions.h>
 #include <LibJS/Bytecode/BasicBlock.h>
 #include <LibJS/Bytecode/Executable.h>
 #include <LibJS/Bytecode/Instruction.h>
 #include <LibJS/Bytecode/RegexTable.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <LibJS/Runtime/Shape.h>
 #include <LibJS/SourceCode.h>
 
 namespace JS::Bytecode {
 
 JS_DEFINE_ALLOCATOR(Executable);
 
+bool g_dump_property_lookup_cache_statistics = false;
+
 Executable::Executable(
     Vector<u8> bytecode,
     NonnullOwnPtr<IdentifierTable> identifier_table,
@@ -38,7 +43,11 @@ Executable::Executable(
     global_variable_caches.resize(number_of_global_variable_caches);
 }
 
-Executable::~Executable() = default;
+Executable::~Executable()
+{
+    if (g_dump_property_lookup_cache_statistics)
+        dump_property_lookup_cache_statistics();
+}
 
 void Executable::dump() const
 {
@@ -83,6 +92,43 @@ void Executable::dump() const
     warnln("");
 }
 
+PropertyLookupCacheStatistics Executable::property_lookup_cache_statistics() const
+{
+    PropertyLookupCacheStatistics statistics;
+    for (auto const& cache : property_lookup_caches) {
+        size_t number_of_shapes = 0;
+        for (auto const& entry : cache.entries) {
+            if (!entry.shape.is_null())
+                ++number_of_shapes;
+        }
+
+        ++statistics.number_of_sites;
+        if (cache.is_megamorphic)
+            ++statistics.number_of_megamorphic_sites;
+        else if (number_of_shapes > 1)
+            ++statistics.number_of_polymorphic_sites;
+        statistics.hits += cache.hits;
+        statistics.misses += cache.misses;
+    }
+    return statistics;
+}
+
+void Executable::dump_property_lookup_cache_statistics() const
+{
+    auto statistics = property_lookup_cache_statistics();
+    auto lookups = statistics.hits + statistics.misses;
+    if (lookups == 0)
+        return;
+    warnln("Property lookup caches for \"{}\": {} sites ({} polymorphic, {} megamorphic), {} lookups, {} hits ({:.1}%)",
+        name,
+        statistics.number_of_sites,
+        statistics.number_of_polymorphic_sites,
+        statistics.number_of_megamorphic_sites,
+        lookups,
+        statistics.hits,
+        100.0 * statistics.hits / lookups);
+}
+
 void Executable::visit_edges(Visitor& visitor)
 {
     Base::visit_edges(visitor);
@@ -98,6 +144,27 @@ Optional<Executable::ExceptionHandlers const&> Executable::exception_handlers_fo
     return {};
 }
 
+static u32 megamorphic_cache_index(Shape const& shape, DeprecatedFlyString const& property_name, size_t number_of_entries)
+{
+    return pair_int_hash(ptr_hash(&shape), property_name.hash()) & (number_of_entries - 1);
+}
+
+MegamorphicPropertyLookupCache::Entry* MegamorphicPropertyLookupCache::find(Shape const& shape, DeprecatedFlyString const& property_name)
+{
+    auto& entry = m_entries[megamorphic_cache_index(shape, property_name, number_of_entries)];
+    if (entry.shape != &shape || entry.property_name != property_name)
+        return nullptr;
+    return &entry;
+}
+
+MegamorphicPropertyLookupCache::Entry& MegamorphicPropertyLookupCache::slot_for(Shape const& shape, DeprecatedFlyString const& property_name)
+{
+    auto& entry = m_entries[megamorphic_cache_index(shape, property_name, number_of_entries)];
+    entry = {};
+    entry.property_name = property_name;
+    return entry;
+}
+
 UnrealizedSourceRange Executable::source_range_at(size_t offset) const
 {
     if (offset >= bytecode.size())
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/DeprecatedFlyString.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
@@ -22,18 +23,60 @@
 
 namespace JS::Bytecode {
 
-struct PropertyLookupCache {
+struct PropertyLookupCacheEntry {
     WeakPtr<Shape> shape;
     Optional<u32> property_offset;
     WeakPtr<Object> prototype;
     WeakPtr<PrototypeChainValidity> prototype_chain_validity;
 };
 
-struct GlobalVariableCache : public PropertyLookupCache {
+// A polymorphic inline cache for one property access site.
+// It remembers up to `max_number_of_shapes` shapes. Once a site sees more than that, it turns megamorphic
+// for good, and lookups go through the interpreter's MegamorphicPropertyLookupCache instead.
+struct PropertyLookupCache {
+    static constexpr size_t max_number_of_shapes = 4;
+
+    AK::Array<PropertyLookupCacheEntry, max_number_of_shapes> entries;
+    bool is_megamorphic { false };
+
+    u64 hits { 0 };
+    u64 misses { 0 };
+};
+
+// Shared by all megamorphic access sites, indexed by (shape, property name).
+class MegamorphicPropertyLookupCache {
+public:
+    struct Entry : public PropertyLookupCacheEntry {
+        DeprecatedFlyString property_name;
+    };
+
+    Entry* find(Shape const&, DeprecatedFlyString const& property_name);
+    Entry& slot_for(Shape const&, DeprecatedFlyString const& property_name);
+
+private:
+    static constexpr size_t number_of_entries = 1024;
+    static_assert(is_power_of_two(number_of_entries));
+
+    AK::Array<Entry, number_of_entries> m_entries;
+};
+
+struct PropertyLookupCacheStatistics {
+    size_t number_of_sites { 0 };
+    size_t number_of_polymorphic_sites { 0 };
+    size_t number_of_megamorphic_sites { 0 };
+    u64 hits { 0 };
+    u64 misses { 0 };
+};
+
+struct GlobalVariableCache {
+    WeakPtr<Shape> shape;
+    Optional<u32> property_offset;
     u64 environment_serial_number { 0 };
     Optional<u32> environment_binding_index;
 };
 
+extern bool g_dump_property_lookup_cache_statistics;
+
 struct SourceRecord {
     u32 source_start_offset {};
     u32 source_end_offset {};
@@ -88,6 +131,11 @@ public:
 
     Optional<IdentifierTableIndex> length_identifier;
 
+    // Tiering state for the baseline JIT, see Interpreter::run_native_code().
+    u32 hotness { 0 };
+    bool did_try_jitting { false };
+    OwnPtr<JIT::NativeExecutable> native_executable;
+
     ByteString const& get_string(StringTableIndex index) const { return string_table->get(index); }
     DeprecatedFlyString const& get_identifier(IdentifierTableIndex index) const { return identifier_table->get(index); }
 
@@ -102,7 +150,10 @@ public:
 
     [[nodiscard]] UnrealizedSourceRange source_range_at(size_t offset) const;
 
+    [[nodiscard]] PropertyLookupCacheStatistics property_lookup_cache_statistics() const;
+
     void dump() const;
+    void dump_property_lookup_cache_statistics() const;
 
 private:
     virtual void visit_edges(Visitor&) override;
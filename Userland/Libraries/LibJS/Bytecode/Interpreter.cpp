@@ -14,6 +14,7 @@
 #include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Bytecode/Label.h>
 #include <LibJS/Bytecode/Op.h>
+#include <LibJS/JIT/Compiler.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/BigInt.h>
@@ -38,6 +39,7 @@
 namespace JS::Bytecode {
 
 bool g_dump_bytecode = false;
+bool g_jit_enabled = false;
 
 static ByteString format_operand(StringView name, Operand operand, Bytecode::Executable const& executable)
 {
@@ -154,6 +156,14 @@ Interpreter::~Interpreter()
 {
 }
 
+MegamorphicPropertyLookupCache& Interpreter::megamorphic_property_lookup_cache(PropertyAccess access)
+{
+    auto& cache = access == PropertyAccess::Get ? m_megamorphic_get_cache : m_megamorphic_put_cache;
+    if (!cache)
+        cache = make<MegamorphicPropertyLookupCache>();
+    return *cache;
+}
+
 ALWAYS_INLINE Value Interpreter::get(Operand op) const
 {
     return m_registers_and_constants_and_locals.data()[op.index()];
@@ -331,6 +341,20 @@ Interpreter::HandleExceptionResponse Interpreter::handle_exception(size_t& progr
     VERIFY_NOT_REACHED();
 }
 
+bool Interpreter::run_native_code(size_t& program_counter)
+{
+    auto& executable = current_executable();
+    if (!executable.native_executable) {
+        if (executable.did_try_jitting || ++executable.hotness < JIT::Compiler::hotness_threshold)
+            return false;
+        executable.did_try_jitting = true;
+        executable.native_executable = JIT::Compiler::compile(executable);
+        if (!executable.native_executable)
+            return false;
+    }
+    return executable.native_executable->run(*this, m_registers_and_constants_and_locals.data(), running_execution_context().arguments.data(), program_counter);
+}
+
 // FIXME: GCC takes a *long* time to compile with flattening, and it will time out our CI. :|
 #if defined(AK_COMPILER_CLANG)
 #    define FLATTEN_ON_CLANG FLATTEN
@@ -355,6 +379,9 @@ FLATTEN_ON_CLANG void Interpreter::run_bytecode(size_t entry_point)
 
     TemporaryChange change(m_program_counter, Optional<size_t&>(program_counter));
 
+    if (g_jit_enabled && run_native_code(program_counter))
+        return;
+
     // Declare a lookup table for computed goto with each of the `handle_*` labels
     // to avoid the overhead of a switch statement.
     // This is a GCC extension, but it's also supported by Clang.
@@ -375,6 +402,17 @@ FLATTEN_ON_CLANG void Interpreter::run_bytecode(size_t entry_point)
         goto* bytecode_dispatch_table[static_cast<size_t>(next_instruction.type())];                \
     } while (0)
 
+    // Loop back-edges count towards the executable's hotness, so long-running loops get compiled too.
+#define JUMP_TO(target)                                                                              \
+    do {                                                                                             \
+        auto new_program_counter = (target);                                                         \
+        bool is_backward_jump = new_program_counter <= program_counter;                              \
+        program_counter = new_program_counter;                                                       \
+        if (g_jit_enabled && is_backward_jump && run_native_code(program_counter))                   \
+            return;                                                                                  \
+        goto start;                                                                                  \
+    } while (0)
+
     for (;;) {
     start:
         for (;;) {
@@ -406,44 +444,35 @@ FLATTEN_ON_CLANG void Interpreter::run_bytecode(size_t entry_point)
 
         handle_Jump: {
             auto& instruction = *reinterpret_cast<Op::Jump const*>(&bytecode[program_counter]);
-            program_counter = instruction.target().address();
-            goto start;
+            JUMP_TO(instruction.target().address());
         }
 
         handle_JumpIf: {
             auto& instruction = *reinterpret_cast<Op::JumpIf const*>(&bytecode[program_counter]);
             if (get(instruction.condition()).to_boolean())
-                program_counter = instruction.true_target().address();
-            else
-                program_counter = instruction.false_target().address();
-            goto start;
+                JUMP_TO(instruction.true_target().address());
+            JUMP_TO(instruction.false_target().address());
         }
 
         handle_JumpTrue: {
             auto& instruction = *reinterpret_cast<Op::JumpTrue const*>(&bytecode[program_counter]);
-            if (get(instruction.condition()).to_boolean()) {
-                program_counter = instruction.target().address();
-                goto start;
-            }
+            if (get(instruction.condition()).to_boolean())
+                JUMP_TO(instruction.target().address());
             DISPATCH_NEXT(JumpTrue);
         }
 
         handle_JumpFalse: {
             auto& instruction = *reinterpret_cast<Op::JumpFalse const*>(&bytecode[program_counter]);
-            if (!get(instruction.condition()).to_boolean()) {
-                program_counter = instruction.target().address();
-                goto start;
-            }
+            if (!get(instruction.condition()).to_boolean())
+                JUMP_TO(instruction.target().address());
             DISPATCH_NEXT(JumpFalse);
         }
 
         handle_JumpNullish: {
             auto& instruction = *reinterpret_cast<Op::JumpNullish const*>(&bytecode[program_counter]);
             if (get(instruction.condition()).is_nullish())
-                program_counter = instruction.true_target().address();
-            else
-                program_counter = instruction.false_target().address();
-            goto start;
+                JUMP_TO(instruction.true_target().address());
+            JUMP_TO(instruction.false_target().address());
         }
 
 #define HANDLE_COMPARISON_OP(op_TitleCase, op_snake_case, numeric_operator)                                             \
@@ -459,8 +488,7 @@ FLATTEN_ON_CLANG void Interpreter::run_bytecode(size_t entry_point)
             } else {                                                                                                    \
                 result = lhs.as_double() numeric_operator rhs.as_double();                                              \
             }                                                                                                           \
-            program_counter = result ? instruction.true_target().address() : instruction.false_target().address();      \
-            goto start;                                                                                                 \
+            JUMP_TO(result ? instruction.true_target().address() : instruction.false_target().address());               \
         }                                                                                                               \
         auto result = op_snake_case(vm(), get(instruction.lhs()), get(instruction.rhs()));                              \
         if (result.is_error()) {                                                                                        \
@@ -469,10 +497,8 @@ FLATTEN_ON_CLANG void Interpreter::run_bytecode(size_t entry_point)
             goto start;                                                                                                 \
         }                                                                                                               \
         if (result.value().to_boolean())                                                                                \
-            program_counter = instruction.true_target().address();                                                      \
-        else                                                                                                            \
-            program_counter = instruction.false_target().address();                                                     \
-        goto start;                                                                                                     \
+            JUMP_TO(instruction.true_target().address());                                                               \
+        JUMP_TO(instruction.false_target().address());                                                                  \
     }
 
             JS_ENUMERATE_COMPARISON_OPS(HANDLE_COMPARISON_OP)
@@ -481,10 +507,8 @@ FLATTEN_ON_CLANG void Interpreter::run_bytecode(size_t entry_point)
         handle_JumpUndefined: {
             auto& instruction = *reinterpret_cast<Op::JumpUndefined const*>(&bytecode[program_counter]);
             if (get(instruction.condition()).is_undefined())
-                program_counter = instruction.true_target().address();
-            else
-                program_counter = instruction.false_target().address();
-            goto start;
+                JUMP_TO(instruction.true_target().address());
+            JUMP_TO(instruction.false_target().address());
         }
 
         handle_EnterUnwindContext: {
@@ -955,6 +979,53 @@ ALWAYS_INLINE ThrowCompletionOr<NonnullGCPtr<Object>> base_object_for_get(VM& vm
     return throw_null_or_undefined_property_get(vm, base_value, base_identifier, property, executable);
 }
 
+static ALWAYS_INLINE Optional<Value> get_from_property_lookup_cache_entry(PropertyLookupCacheEntry const& entry, Object const& object)
+{
+    if (entry.shape != &object.shape())
+        return {};
+    if (!entry.prototype)
+        return object.get_direct(entry.property_offset.value());
+
+    // OPTIMIZATION: If the prototype chain hasn't been mutated in a way that would invalidate the cache, we can use it.
+    if (!entry.prototype_chain_validity || !entry.prototype_chain_validity->is_valid())
+        return {};
+    return entry.prototype->get_direct(entry.property_offset.value());
+}
+
+static void update_property_lookup_cache(Interpreter& interpreter, Interpreter::PropertyAccess access, PropertyLookupCache& cache, Shape& shape, DeprecatedFlyString const& property_name, CacheablePropertyMetadata const& cacheable_metadata)
+{
+    if (cacheable_metadata.type == CacheablePropertyMetadata::Type::NotCacheable)
+        return;
+
+    auto fill_entry = [&](PropertyLookupCacheEntry& entry) {
+        entry = {};
+        entry.shape = shape;
+        entry.property_offset = cacheable_metadata.property_offset.value();
+        if (cacheable_metadata.type == CacheablePropertyMetadata::Type::InPrototypeChain) {
+            entry.prototype = *cacheable_metadata.prototype;
+            entry.prototype_chain_validity = *cacheable_metadata.prototype->shape().prototype_chain_validity();
+        }
+    };
+
+    if (cache.is_megamorphic) {
+        fill_entry(interpreter.megamorphic_property_lookup_cache(access).slot_for(shape, property_name));
+        return;
+    }
+
+    // Reuse the entry for this shape if it went stale, or an entry whose shape has been garbage collected.
+    for (auto& entry : cache.entries) {
+        if (entry.shape.is_null() || entry.shape == &shape) {
+            fill_entry(entry);
+            return;
+        }
+    }
+
+    // This site has seen too many shapes to check them one by one, so hand it over to the shared cache.
+    cache.entries = {};
+    cache.is_megamorphic = true;
+    fill_entry(interpreter.megamorphic_property_lookup_cache(access).slot_for(shape, property_name));
+}
+
 enum class GetByIdMode {
     Normal,
     Length,
@@ -979,39 +1050,28 @@ inline ThrowCompletionOr<Value> get_by_id(VM& vm, Optional<IdentifierTableIndex>
     }
 
     auto& shape = base_obj->shape();
-
-    if (cache.prototype) {
-        // OPTIMIZATION: If the prototype chain hasn't been mutated in a way that would invalidate the cache, we can use it.
-        bool can_use_cache = [&]() -> bool {
-            if (&shape != cache.shape)
-                return false;
-            if (!cache.prototype_chain_validity)
-                return false;
-            if (!cache.prototype_chain_validity->is_valid())
-                return false;
-            return true;
-        }();
-        if (can_use_cache)
-            return cache.prototype->get_direct(cache.property_offset.value());
-    } else if (&shape == cache.shape) {
-        // OPTIMIZATION: If the shape of the object hasn't changed, we can use the cached property offset.
-        return base_obj->get_direct(cache.property_offset.value());
+    auto const& property_name = executable.get_identifier(property);
+
+    // OPTIMIZATION: If we've seen an object with this shape here before, we can use the cached property offset.
+    if (!cache.is_megamorphic) {
+        for (auto const& entry : cache.entries) {
+            if (auto value = get_from_property_lookup_cache_entry(entry, *base_obj); value.has_value()) {
+                ++cache.hits;
+                return *value;
+            }
+        }
+    } else if (auto const* entry = vm.bytecode_interpreter().megamorphic_property_lookup_cache(Interpreter::PropertyAccess::Get).find(shape, property_name)) {
+        if (auto value = get_from_property_lookup_cache_entry(*entry, *base_obj); value.has_value()) {
+            ++cache.hits;
+            return *value;
+        }
     }
+    ++cache.misses;
 
     CacheablePropertyMetadata cacheable_metadata;
-    auto value = TRY(base_obj->internal_get(executable.get_identifier(property), this_value, &cacheable_metadata));
+    auto value = TRY(base_obj->internal_get(property_name, this_value, &cacheable_metadata));
 
-    if (cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-        cache = {};
-        cache.shape = shape;
-        cache.property_offset = cacheable_metadata.property_offset.value();
-    } else if (cacheable_metadata.type == CacheablePropertyMetadata::Type::InPrototypeChain) {
-        cache = {};
-        cache.shape = &base_obj->shape();
-        cache.property_offset = cacheable_metadata.property_offset.value();
-        cache.prototype = *cacheable_metadata.prototype;
-        cache.prototype_chain_validity = *cacheable_metadata.prototype->shape().prototype_chain_validity();
-    }
+    update_property_lookup_cache(vm.bytecode_interpreter(), Interpreter::PropertyAccess::Get, cache, shape, property_name, cacheable_metadata);
 
     return value;
 }
@@ -1177,18 +1237,33 @@ inline ThrowCompletionOr<void> put_by_property_key(VM& vm, Value base, Value thi
         break;
     }
     case Op::PropertyKind::KeyValue: {
-        if (cache && cache->shape == &object->shape()) {
-            object->put_direct(*cache->property_offset, value);
-            return {};
+        // NOTE: Only own data properties end up in the cache for puts, so we can overwrite the value in place.
+        if (cache && name.is_string()) {
+            auto& shape = object->shape();
+            PropertyLookupCacheEntry const* matching_entry = nullptr;
+            if (!cache->is_megamorphic) {
+                for (auto const& entry : cache->entries) {
+                    if (entry.shape == &shape) {
+                        matching_entry = &entry;
+                        break;
+                    }
+                }
+            } else {
+                matching_entry = vm.bytecode_interpreter().megamorphic_property_lookup_cache(Interpreter::PropertyAccess::Put).find(shape, name.as_string());
+            }
+            if (matching_entry) {
+                ++cache->hits;
+                object->put_direct(*matching_entry->property_offset, value);
+                return {};
+            }
+            ++cache->misses;
         }
 
         CacheablePropertyMetadata cacheable_metadata;
         bool succeeded = TRY(object->internal_set(name, value, this_value, &cacheable_metadata));
 
-        if (succeeded && cache && cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty) {
-            cache->shape = object->shape();
-            cache->property_offset = cacheable_metadata.property_offset.value();
-        }
+        if (succeeded && cache && name.is_string() && cacheable_metadata.type == CacheablePropertyMetadata::Type::OwnProperty)
+            update_property_lookup_cache(vm.bytecode_interpreter(), Interpreter::PropertyAccess::Put, *cache, object->shape(), name.as_string(), cacheable_metadata);
 
         if (!succeeded && vm.in_strict_mode()) {
             if (base.is_object())
@@ -1290,6 +1365,7 @@ inline ThrowCompletionOr<void> put_by_value(VM& vm, Value base, Optional<Depreca
                 auto existing_value = maybe_value->value;
                 if (!existing_value.is_accessor()) {
                     storage->put(index, value);
+                    object.write_barrier(value);
                     return {};
                 }
             }
@@ -1608,11 +1684,13 @@ inline ThrowCompletionOr<void> append(VM& vm, Value lhs, Value rhs, bool is_spre
         size_t i = lhs_size;
         TRY(get_iterator_values(vm, rhs, [&i, &lhs_array](Value iterator_value) -> Optional<Completion> {
             lhs_array.indexed_properties().put(i, iterator_value, default_attributes);
+            lhs_array.write_barrier(iterator_value);
             ++i;
             return {};
         }));
     } else {
         lhs_array.indexed_properties().put(lhs_size, rhs, default_attributes);
+        lhs_array.write_barrier(rhs);
     }
 
     return {};
@@ -2041,7 +2119,9 @@ void NewArray::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto array = MUST(Array::create(interpreter.realm(), 0));
     for (size_t i = 0; i < m_element_count; i++) {
-        array->indexed_properties().put(i, interpreter.get(m_elements[i]), default_attributes);
+        auto value = interpreter.get(m_elements[i]);
+        array->indexed_properties().put(i, value, default_attributes);
+        array->write_barrier(value);
     }
     interpreter.set(dst(), array);
 }
@@ -2049,8 +2129,10 @@ void NewArray::execute_impl(Bytecode::Interpreter& interpreter) const
 void NewPrimitiveArray::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto array = MUST(Array::create(interpreter.realm(), 0));
-    for (size_t i = 0; i < m_element_count; i++)
+    for (size_t i = 0; i < m_element_count; i++) {
         array->indexed_properties().put(i, m_elements[i], default_attributes);
+        array->write_barrier(m_elements[i]);
+    }
     interpreter.set(dst(), array);
 }
 
@@ -2252,8 +2334,10 @@ ThrowCompletionOr<void> CreateRestParams::execute_impl(Bytecode::Interpreter& in
     auto const& arguments = interpreter.running_execution_context().arguments;
     auto arguments_count = interpreter.running_execution_context().passed_argument_count;
     auto array = MUST(Array::create(interpreter.realm(), 0));
-    for (size_t rest_index = m_rest_index; rest_index < arguments_count; ++rest_index)
+    for (size_t rest_index = m_rest_index; rest_index < arguments_count; ++rest_index) {
         array->indexed_properties().append(arguments[rest_index]);
+        array->write_barrier(arguments[rest_index]);
+    }
     interpreter.set(m_dst, array);
     return {};
 }
@@ -80,8 +80,17 @@ public:
 
     ExecutionContext& running_execution_context() { return *m_running_execution_context; }
 
+    // Shared by all property access sites that have seen too many shapes for their own cache.
+    // Gets and puts are kept apart, since a get may cache a property that can't be written to.
+    enum class PropertyAccess {
+        Get,
+        Put,
+    };
+    MegamorphicPropertyLookupCache& megamorphic_property_lookup_cache(PropertyAccess);
+
 private:
     void run_bytecode(size_t entry_point);
+    [[nodiscard]] bool run_native_code(size_t& program_counter);
 
     enum class HandleExceptionResponse {
         ExitFromExecutable,
@@ -99,9 +108,12 @@ private:
     Span<Value> m_arguments;
     Span<Value> m_registers_and_constants_and_locals;
     ExecutionContext* m_running_execution_context { nullptr };
+    OwnPtr<MegamorphicPropertyLookupCache> m_megamorphic_get_cache;
+    OwnPtr<MegamorphicPropertyLookupCache> m_megamorphic_put_cache;
 };
 
 extern bool g_dump_bytecode;
+extern bool g_jit_enabled;
 
 ThrowCompletionOr<NonnullGCPtr<Bytecode::Executable>> compile(VM&, ASTNode const&, JS::FunctionKind kind, DeprecatedFlyString const& name);
 ThrowCompletionOr<NonnullGCPtr<Bytecode::Executable>> compile(VM&, ECMAScriptFunctionObject const&);
@@ -21,4 +21,9 @@ void JS::Cell::Visitor::visit(JS::Value value)
         visit_impl(value.as_cell());
 }
 
+void JS::Cell::write_barrier_slow_path(JS::Cell& cell)
+{
+    heap().write_barrier_slow_path({}, *this, cell);
+}
+
 }
@@ -28,6 +28,13 @@ public:                                            \
     }                                              \
     friend class JS::Heap;
 
+// Declares that every reference a cell of this class stores to another cell, after its constructor has run, is
+// followed by a call to Cell::write_barrier(). The garbage collector relies on that to skip these cells when it looks
+// for references it hasn't been told about. This is not inherited, so subclasses with their own edges can't break it.
+#define JS_DECLARE_WRITE_BARRIER_PROTECTED(class_) \
+public:                                           \
+    using WriteBarrierProtectedCell = class_;
+
 class Cell : public Weakable<Cell> {
     AK_MAKE_NONCOPYABLE(Cell);
     AK_MAKE_NONMOVABLE(Cell);
@@ -39,9 +46,44 @@ public:
     bool is_marked() const { return m_mark; }
     void set_marked(bool b) { m_mark = b; }
 
-    enum class State : bool {
+    // Cells that have survived a garbage collection belong to the old generation.
+    bool is_old() const { return m_old; }
+    void set_old(bool b) { m_old = b; }
+
+    // See JS_DECLARE_WRITE_BARRIER_PROTECTED.
+    bool is_write_barrier_protected() const { return m_write_barrier_protected; }
+    void set_write_barrier_protected(Badge<Heap>, bool b) { m_write_barrier_protected = b; }
+
+    // Old cells that young generation collections have to look at, since they may reference young cells.
+    bool is_remembered() const { return m_remembered; }
+    void set_remembered(Badge<Heap>, bool b) { m_remembered = b; }
+
+    // Has to be called after this cell starts referencing another cell, unless that happens in the constructor.
+    // An old cell referencing a young one has to be remembered for young generation collections, and a cell that an
+    // incremental collection has already marked can't be allowed to hide an unmarked one from it.
+#ifdef AK_COMPILER_GCC
+#    pragma GCC diagnostic push
+//   NOTE: Once inlined into write_barrier(Value), GCC can look at what the pointer bits of non-cell values would be,
+//         without realizing that those never get here.
+#    pragma GCC diagnostic ignored "-Warray-bounds"
+#endif
+    ALWAYS_INLINE void write_barrier(Cell* cell)
+    {
+        if (!cell)
+            return;
+        if ((m_old && !cell->m_old && !m_remembered) || (m_mark && !cell->m_mark)) [[unlikely]]
+            write_barrier_slow_path(*cell);
+    }
+#ifdef AK_COMPILER_GCC
+#    pragma GCC diagnostic pop
+#endif
+    ALWAYS_INLINE void write_barrier(Value);
+
+    enum class State : u8 {
         Live,
         Dead,
+        // Found to be unreachable and finalized by an incremental collection, but not swept yet.
+        PendingSweep,
     };
 
     State state() const { return m_state; }
@@ -160,6 +202,9 @@ public:
 
     bool overrides_must_survive_garbage_collection(Badge<Heap>) const { return m_overrides_must_survive_garbage_collection; }
 
+    // Dead cells that don't get destroyed right away must not be reachable through weak pointers in the meantime.
+    void revoke_weak_ptrs(Badge<Heap>) { Weakable::revoke_weak_ptrs(); }
+
     ALWAYS_INLINE Heap& heap() const { return HeapBlockBase::from_cell(this)->heap(); }
     ALWAYS_INLINE VM& vm() const { return bit_cast<HeapBase*>(&heap())->vm(); }
 
@@ -169,9 +214,14 @@ protected:
     void set_overrides_must_survive_garbage_collection(bool b) { m_overrides_must_survive_garbage_collection = b; }
 
 private:
+    void write_barrier_slow_path(Cell&);
+
     bool m_mark : 1 { false };
+    bool m_old : 1 { false };
+    bool m_write_barrier_protected : 1 { false };
+    bool m_remembered : 1 { false };
     bool m_overrides_must_survive_garbage_collection : 1 { false };
-    State m_state : 1 { State::Live };
+    State m_state : 2 { State::Live };
 };
 
 }
@@ -69,17 +69,39 @@ Heap::~Heap()
 
 void Heap::will_allocate(size_t size)
 {
+    if (m_incremental_collection_phase != IncrementalCollectionPhase::Idle) {
+        // NOTE: While an incremental collection is underway, allocating is what moves it along.
+        m_allocated_bytes_since_last_incremental_slice += size;
+        m_allocated_bytes_since_last_gc += size;
+        if (m_gc_deferrals)
+            return;
+        if (should_collect_on_every_allocation() || m_allocated_bytes_since_last_incremental_slice > INCREMENTAL_SLICE_BYTES_THRESHOLD) {
+            m_allocated_bytes_since_last_incremental_slice = 0;
+            run_incremental_collection_slice();
+        }
+        return;
+    }
+
     if (should_collect_on_every_allocation()) {
         m_allocated_bytes_since_last_gc = 0;
-        collect_garbage();
+        collect_garbage(collection_type_for_automatic_collection(), m_should_print_collection_reports);
     } else if (m_allocated_bytes_since_last_gc + size > m_gc_bytes_threshold) {
         m_allocated_bytes_since_last_gc = 0;
-        collect_garbage();
+        collect_garbage(collection_type_for_automatic_collection(), m_should_print_collection_reports);
     }
 
     m_allocated_bytes_since_last_gc += size;
 }
 
+Heap::CollectionType Heap::collection_type_for_automatic_collection() const
+{
+    // Most cells die young, so we only look at the cells allocated since the last collection,
+    // until the old generation has grown enough to be worth looking at as well.
+    if (m_old_generation_bytes > m_old_generation_bytes_threshold)
+        return m_should_collect_incrementally ? CollectionType::CollectGarbageIncrementally : CollectionType::CollectGarbage;
+    return CollectionType::CollectYoungGeneration;
+}
+
 static void add_possible_value(HashMap<FlatPtr, HeapRoot>& possible_pointers, FlatPtr data, HeapRoot origin, FlatPtr min_block_address, FlatPtr max_block_address)
 {
     if constexpr (sizeof(FlatPtr*) == sizeof(Value)) {
@@ -269,21 +291,55 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
     perf_event(PERF_EVENT_SIGNPOST, gc_perf_string_id, global_gc_counter++);
 #endif
 
-    Core::ElapsedTimer collection_measurement_timer;
+    Core::ElapsedTimer collection_measurement_timer { Core::TimerType::Precise };
     if (print_report)
         collection_measurement_timer.start();
 
-    if (collection_type == CollectionType::CollectGarbage) {
-        if (m_gc_deferrals) {
-            m_should_gc_when_deferral_ends = true;
+    if (collection_type != CollectionType::CollectEverything && m_gc_deferrals) {
+        // NOTE: If anyone asked for a full collection in the meantime, that's what we'll do.
+        if (!m_collection_type_when_deferral_ends.has_value() || collection_type == CollectionType::CollectGarbage)
+            m_collection_type_when_deferral_ends = collection_type;
+        else if (collection_type == CollectionType::CollectGarbageIncrementally && m_collection_type_when_deferral_ends == CollectionType::CollectYoungGeneration)
+            m_collection_type_when_deferral_ends = collection_type;
+        return;
+    }
+
+    if (m_incremental_collection_phase != IncrementalCollectionPhase::Idle) {
+        // NOTE: The incremental collection that's already underway will get to the young generation as well.
+        if (collection_type == CollectionType::CollectYoungGeneration || collection_type == CollectionType::CollectGarbageIncrementally)
             return;
-        }
+        // Anything else has to start from a clean slate, so we get the current collection over with first.
+        // NOTE: We only collect everything when the VM is going away, at which point there are no roots left to gather.
+        //       Everything is garbage anyway, so we just forget about what's been marked so far.
+        if (collection_type == CollectionType::CollectEverything && m_incremental_collection_phase == IncrementalCollectionPhase::Marking)
+            abandon_incremental_marking();
+        finish_incremental_collection(print_report);
+    }
+
+    if (collection_type == CollectionType::CollectGarbageIncrementally) {
+        start_incremental_collection();
+        return;
+    }
+
+    CollectionStatistics statistics;
+    if (collection_type == CollectionType::CollectYoungGeneration) {
         HashMap<Cell*, HeapRoot> roots;
         gather_roots(roots);
-        mark_live_cells(roots);
+        mark_live_young_cells(roots);
+        finalize_unmarked_young_cells();
+        statistics = sweep_dead_young_cells();
+    } else {
+        if (collection_type == CollectionType::CollectGarbage) {
+            HashMap<Cell*, HeapRoot> roots;
+            gather_roots(roots);
+            mark_live_cells(roots);
+        }
+        finalize_unmarked_cells();
+        statistics = sweep_dead_cells();
     }
-    finalize_unmarked_cells();
-    sweep_dead_cells(print_report, collection_measurement_timer);
+
+    if (print_report)
+        print_collection_report(collection_type, statistics, collection_measurement_timer);
 }
 
 void Heap::gather_roots(HashMap<Cell*, HeapRoot>& roots)
@@ -389,15 +445,31 @@ NO_SANITIZE_ADDRESS void Heap::gather_conservative_roots(HashMap<Cell*, HeapRoot
 
 class MarkingVisitor final : public Cell::Visitor {
 public:
-    explicit MarkingVisitor(Heap& heap, HashMap<Cell*, HeapRoot> const& roots)
+    enum class Generation {
+        All,
+        Young,
+    };
+
+    explicit MarkingVisitor(Heap& heap, HashMap<Cell*, HeapRoot> const& roots, Generation generation = Generation::All)
         : m_heap(heap)
+        , m_generation(generation)
     {
+        find_live_heap_blocks();
+        visit_roots(roots);
+    }
+
+    void find_live_heap_blocks()
+    {
+        m_all_live_heap_blocks.clear();
         m_heap.find_min_and_max_block_addresses(m_min_block_address, m_max_block_address);
         m_heap.for_each_block([&](auto& block) {
             m_all_live_heap_blocks.set(&block);
             return IterationDecision::Continue;
         });
+    }
 
+    void visit_roots(HashMap<Cell*, HeapRoot> const& roots)
+    {
         for (auto* root : roots.keys()) {
             visit(root);
         }
@@ -407,6 +479,9 @@ public:
     {
         if (cell.is_marked())
             return;
+        // NOTE: When collecting the young generation, the old generation is considered live, so we don't trace through it.
+        if (m_generation == Generation::Young && cell.is_old())
+            return;
         dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
 
         cell.set_marked(true);
@@ -426,6 +501,8 @@ public:
                 return;
             if (cell->state() != Cell::State::Live)
                 return;
+            if (m_generation == Generation::Young && cell->is_old())
+                return;
             cell->set_marked(true);
             m_work_queue.append(*cell);
         });
@@ -438,8 +515,19 @@ public:
         }
     }
 
+    // Returns true once there's nothing left to mark.
+    bool mark_some_live_cells(size_t max_cell_count)
+    {
+        for (size_t i = 0; i < max_cell_count && !m_work_queue.is_empty(); ++i)
+            m_work_queue.take_last()->visit_edges(*this);
+        return m_work_queue.is_empty();
+    }
+
+    bool has_grey_cells() const { return !m_work_queue.is_empty(); }
+
 private:
     Heap& m_heap;
+    Generation m_generation { Generation::All };
     Vector<NonnullGCPtr<Cell>> m_work_queue;
     HashTable<HeapBlock*> m_all_live_heap_blocks;
     FlatPtr m_min_block_address;
@@ -460,6 +548,318 @@ void Heap::mark_live_cells(HashMap<Cell*, HeapRoot> const& roots)
     m_uprooted_cells.clear();
 }
 
+void Heap::mark_live_young_cells(HashMap<Cell*, HeapRoot> const& roots)
+{
+    dbgln_if(HEAP_DEBUG, "mark_live_young_cells:");
+
+    MarkingVisitor visitor(*this, roots, MarkingVisitor::Generation::Young);
+
+    // NOTE: The only old cells that can point into the young generation are the ones the write barrier remembered,
+    //       and the ones that don't have a write barrier at all. They get to visit their edges, but we don't trace
+    //       any further through them.
+    for (auto* cell : m_remembered_cells)
+        cell->visit_edges(visitor);
+    for (auto* cell : m_old_cells_without_write_barrier)
+        cell->visit_edges(visitor);
+
+    visitor.mark_all_live_cells();
+
+    // NOTE: Old cells can only be uprooted by a full collection, so we hold on to them until then.
+    m_uprooted_cells.remove_all_matching([](auto& inverse_root) {
+        if (inverse_root->is_old())
+            return false;
+        inverse_root->set_marked(false);
+        return true;
+    });
+}
+
+void Heap::forget_remembered_cells()
+{
+    // NOTE: This is called whenever the young generation has just been emptied, so there's nothing left to remember.
+    for (auto* cell : m_remembered_cells)
+        cell->set_remembered({}, false);
+    m_remembered_cells.clear_with_capacity();
+}
+
+void Heap::write_barrier_slow_path(Badge<Cell>, Cell& cell, Cell& stored_cell)
+{
+    if (cell.is_old() && !stored_cell.is_old() && !cell.is_remembered()) {
+        VERIFY(cell.is_write_barrier_protected());
+        cell.set_remembered({}, true);
+        m_remembered_cells.append(&cell);
+    }
+
+    // NOTE: This is what keeps incremental marking from missing anything: a marked cell never points to an unmarked
+    //       one without the latter being in the grey set, so nothing reachable can end up hidden behind a marked cell.
+    if (cell.is_marked() && !stored_cell.is_marked() && m_incremental_marking_visitor)
+        m_incremental_marking_visitor->visit(stored_cell);
+}
+
+void Heap::did_construct_cell_while_marking(Cell& cell)
+{
+    // NOTE: Cells allocated while an incremental collection is marking are considered live by that collection.
+    //       They start out grey, since their constructors didn't go through the write barrier.
+    m_incremental_marking_visitor->visit(cell);
+}
+
+void Heap::start_incremental_collection()
+{
+    dbgln_if(HEAP_DEBUG, "start_incremental_collection:");
+    VERIFY(m_incremental_collection_phase == IncrementalCollectionPhase::Idle);
+
+    HashMap<Cell*, HeapRoot> roots;
+    gather_roots(roots);
+    m_incremental_marking_visitor = make<MarkingVisitor>(*this, roots);
+    m_incremental_collection_phase = IncrementalCollectionPhase::Marking;
+    m_allocated_bytes_since_last_incremental_slice = 0;
+}
+
+void Heap::run_incremental_collection_slice()
+{
+    VERIFY(!m_collecting_garbage);
+    TemporaryChange change(m_collecting_garbage, true);
+
+    Core::ElapsedTimer slice_measurement_timer { Core::TimerType::Precise };
+    if (m_should_print_collection_reports)
+        slice_measurement_timer.start();
+
+    if (m_incremental_collection_phase == IncrementalCollectionPhase::Marking) {
+        if (m_incremental_marking_visitor->mark_some_live_cells(INCREMENTAL_MARKING_SLICE_CELL_COUNT)) {
+            auto statistics = finish_incremental_marking();
+            if (m_should_print_collection_reports)
+                print_collection_report(CollectionType::CollectGarbageIncrementally, statistics, slice_measurement_timer);
+            return;
+        }
+        if (m_should_print_collection_reports)
+            dbgln("Incremental marking slice: {} us", slice_measurement_timer.elapsed_time().to_microseconds());
+        return;
+    }
+
+    VERIFY(m_incremental_collection_phase == IncrementalCollectionPhase::Sweeping);
+    sweep_pending_blocks(INCREMENTAL_SWEEPING_SLICE_BLOCK_COUNT);
+    if (m_should_print_collection_reports)
+        dbgln("Incremental sweeping slice: {} us", slice_measurement_timer.elapsed_time().to_microseconds());
+}
+
+Heap::CollectionStatistics Heap::finish_incremental_marking()
+{
+    dbgln_if(HEAP_DEBUG, "finish_incremental_marking:");
+    VERIFY(m_incremental_collection_phase == IncrementalCollectionPhase::Marking);
+
+    auto& visitor = *m_incremental_marking_visitor;
+    visitor.mark_all_live_cells();
+
+    // NOTE: The write barrier kept the grey set up to date with everything the mutator stored into marked cells since
+    //       marking started, except for the roots, which don't have a write barrier, and the cells that don't call it.
+    //       So we gather the roots again, and let every marked cell without a write barrier visit its edges once more.
+    HashMap<Cell*, HeapRoot> roots;
+    gather_roots(roots);
+    visitor.find_live_heap_blocks();
+    visitor.visit_roots(roots);
+    for (auto* cell : m_old_cells_without_write_barrier) {
+        if (cell->is_marked())
+            cell->visit_edges(visitor);
+    }
+    for (auto* cell : m_young_cells) {
+        if (cell->is_marked() && !cell->is_write_barrier_protected())
+            cell->visit_edges(visitor);
+    }
+    visitor.mark_all_live_cells();
+    m_incremental_marking_visitor = nullptr;
+
+    for (auto& inverse_root : m_uprooted_cells)
+        inverse_root->set_marked(false);
+    m_uprooted_cells.clear();
+
+    finalize_unmarked_cells();
+
+    // NOTE: Dead cells are only destroyed once their block gets swept, but nobody can reach them anymore after this.
+    //       That includes weak references, so we revoke those right away.
+    CollectionStatistics statistics;
+    forget_remembered_cells();
+    m_old_cells_without_write_barrier.remove_all_matching([](Cell* cell) {
+        return !cell->is_marked() && !cell_must_survive_garbage_collection(*cell);
+    });
+    m_blocks_pending_sweep.clear_with_capacity();
+    for_each_block([&](auto& block) {
+        block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell)) {
+                cell->revoke_weak_ptrs({});
+                cell->set_state(Cell::State::PendingSweep);
+                ++statistics.collected_cells;
+                statistics.collected_cell_bytes += block.cell_size();
+            } else {
+                did_promote_cell(*cell);
+                ++statistics.live_cells;
+                statistics.live_cell_bytes += block.cell_size();
+            }
+        });
+        m_blocks_pending_sweep.append(&block);
+        return IterationDecision::Continue;
+    });
+
+    for (auto& weak_container : m_weak_containers)
+        weak_container.remove_dead_cells({});
+
+    m_young_cells.clear_with_capacity();
+    m_old_generation_bytes = statistics.live_cell_bytes;
+    m_old_generation_bytes_threshold = max(m_old_generation_bytes * 2, GC_MIN_BYTES_THRESHOLD);
+
+    m_gc_bytes_threshold = statistics.live_cell_bytes > GC_MIN_BYTES_THRESHOLD ? statistics.live_cell_bytes : GC_MIN_BYTES_THRESHOLD;
+    m_allocated_bytes_since_last_gc = 0;
+
+    m_incremental_collection_phase = IncrementalCollectionPhase::Sweeping;
+    return statistics;
+}
+
+void Heap::abandon_incremental_marking()
+{
+    dbgln_if(HEAP_DEBUG, "abandon_incremental_marking:");
+    VERIFY(m_incremental_collection_phase == IncrementalCollectionPhase::Marking);
+
+    m_incremental_marking_visitor = nullptr;
+    for_each_block([&](auto& block) {
+        block.template for_each_cell_in_state<Cell::State::Live>([](Cell* cell) {
+            cell->set_marked(false);
+        });
+        return IterationDecision::Continue;
+    });
+    m_incremental_collection_phase = IncrementalCollectionPhase::Idle;
+}
+
+void Heap::sweep_pending_blocks(size_t max_block_count)
+{
+    dbgln_if(HEAP_DEBUG, "sweep_pending_blocks:");
+    VERIFY(m_incremental_collection_phase == IncrementalCollectionPhase::Sweeping);
+
+    for (size_t i = 0; i < max_block_count && !m_blocks_pending_sweep.is_empty(); ++i) {
+        auto& block = *m_blocks_pending_sweep.take_last();
+        bool block_has_live_cells = false;
+        bool block_was_full = block.is_full();
+        block.for_each_cell([&](Cell* cell) {
+            if (cell->state() == Cell::State::PendingSweep) {
+                dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
+                block.deallocate(cell);
+            } else if (cell->state() == Cell::State::Live) {
+                cell->set_marked(false);
+                block_has_live_cells = true;
+            }
+        });
+        if (!block_has_live_cells) {
+            dbgln_if(HEAP_DEBUG, " - HeapBlock empty @ {}: cell_size={}", &block, block.cell_size());
+            block.cell_allocator().block_did_become_empty({}, block);
+        } else if (block_was_full != block.is_full()) {
+            dbgln_if(HEAP_DEBUG, " - HeapBlock usable again @ {}: cell_size={}", &block, block.cell_size());
+            block.cell_allocator().block_did_become_usable({}, block);
+        }
+    }
+
+    if (m_blocks_pending_sweep.is_empty())
+        m_incremental_collection_phase = IncrementalCollectionPhase::Idle;
+}
+
+void Heap::finish_incremental_collection(bool print_report)
+{
+    if (m_incremental_collection_phase == IncrementalCollectionPhase::Marking) {
+        Core::ElapsedTimer measurement_timer { Core::TimerType::Precise };
+        if (print_report)
+            measurement_timer.start();
+        auto statistics = finish_incremental_marking();
+        if (print_report)
+            print_collection_report(CollectionType::CollectGarbageIncrementally, statistics, measurement_timer);
+    }
+    if (m_incremental_collection_phase == IncrementalCollectionPhase::Sweeping)
+        sweep_pending_blocks(NumericLimits<size_t>::max());
+    VERIFY(m_incremental_collection_phase == IncrementalCollectionPhase::Idle);
+}
+
+void Heap::did_promote_cell(Cell& cell)
+{
+    if (cell.is_old())
+        return;
+    cell.set_old(true);
+
+    // NOTE: Cells without a write barrier stay remembered for as long as they live, so they never call into it.
+    if (!cell.is_write_barrier_protected()) {
+        cell.set_remembered({}, true);
+        m_old_cells_without_write_barrier.append(&cell);
+    }
+}
+
+void Heap::start_incremental_collection_for_testing()
+{
+    finish_incremental_collection_for_testing();
+    collect_garbage(CollectionType::CollectGarbageIncrementally);
+}
+
+bool Heap::run_incremental_marking_slice_for_testing(size_t max_cell_count)
+{
+    if (m_incremental_collection_phase != IncrementalCollectionPhase::Marking)
+        return true;
+    TemporaryChange change(m_collecting_garbage, true);
+    return m_incremental_marking_visitor->mark_some_live_cells(max_cell_count);
+}
+
+void Heap::finish_incremental_collection_for_testing()
+{
+    if (m_incremental_collection_phase == IncrementalCollectionPhase::Idle)
+        return;
+    TemporaryChange change(m_collecting_garbage, true);
+    finish_incremental_collection(false);
+}
+
+class WriteBarrierVerifier final : public Cell::Visitor {
+public:
+    WriteBarrierVerifier(Cell& cell, bool is_marking)
+        : m_cell(cell)
+        , m_is_marking(is_marking)
+    {
+    }
+
+    virtual void visit_impl(Cell& stored_cell) override
+    {
+        if (stored_cell.state() != Cell::State::Live)
+            return;
+        if (m_cell.is_old() && !m_cell.is_remembered() && !stored_cell.is_old()) {
+            dbgln("Write barrier violation: old {} @ {} points to young {} @ {}", m_cell.class_name(), &m_cell, stored_cell.class_name(), &stored_cell);
+            ++m_violation_count;
+        }
+        if (m_is_marking && m_cell.is_marked() && !stored_cell.is_marked()) {
+            dbgln("Write barrier violation: marked {} @ {} points to unmarked {} @ {}", m_cell.class_name(), &m_cell, stored_cell.class_name(), &stored_cell);
+            ++m_violation_count;
+        }
+    }
+
+    virtual void visit_possible_values(ReadonlyBytes) override { }
+
+    size_t violation_count() const { return m_violation_count; }
+
+private:
+    Cell& m_cell;
+    bool m_is_marking { false };
+    size_t m_violation_count { 0 };
+};
+
+size_t Heap::count_write_barrier_violations()
+{
+    // NOTE: While there are grey cells left, we can't tell which of the marked cells have already visited their edges,
+    //       so we can only check the marking invariant in between slices that have emptied the grey set.
+    bool is_marking = m_incremental_collection_phase == IncrementalCollectionPhase::Marking && !m_incremental_marking_visitor->has_grey_cells();
+
+    size_t violation_count = 0;
+    for_each_block([&](auto& block) {
+        block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+            if (!cell->is_write_barrier_protected())
+                return;
+            WriteBarrierVerifier verifier(*cell, is_marking);
+            cell->visit_edges(verifier);
+            violation_count += verifier.violation_count();
+        });
+        return IterationDecision::Continue;
+    });
+    return violation_count;
+}
+
 bool Heap::cell_must_survive_garbage_collection(Cell const& cell)
 {
     if (!cell.overrides_must_survive_garbage_collection({}))
@@ -478,16 +878,26 @@ void Heap::finalize_unmarked_cells()
     });
 }
 
-void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measurement_timer)
+void Heap::finalize_unmarked_young_cells()
+{
+    for (auto* cell : m_young_cells) {
+        if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell))
+            cell->finalize();
+    }
+}
+
+Heap::CollectionStatistics Heap::sweep_dead_cells()
 {
     dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
     Vector<HeapBlock*, 32> empty_blocks;
     Vector<HeapBlock*, 32> full_blocks_that_became_usable;
 
-    size_t collected_cells = 0;
-    size_t live_cells = 0;
-    size_t collected_cell_bytes = 0;
-    size_t live_cell_bytes = 0;
+    CollectionStatistics statistics;
+
+    forget_remembered_cells();
+    m_old_cells_without_write_barrier.remove_all_matching([](Cell* cell) {
+        return !cell->is_marked() && !cell_must_survive_garbage_collection(*cell);
+    });
 
     for_each_block([&](auto& block) {
         bool block_has_live_cells = false;
@@ -496,13 +906,14 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
             if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell)) {
                 dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
                 block.deallocate(cell);
-                ++collected_cells;
-                collected_cell_bytes += block.cell_size();
+                ++statistics.collected_cells;
+                statistics.collected_cell_bytes += block.cell_size();
             } else {
                 cell->set_marked(false);
+                did_promote_cell(*cell);
                 block_has_live_cells = true;
-                ++live_cells;
-                live_cell_bytes += block.cell_size();
+                ++statistics.live_cells;
+                statistics.live_cell_bytes += block.cell_size();
             }
         });
         if (!block_has_live_cells)
@@ -532,25 +943,114 @@ void Heap::sweep_dead_cells(bool print_report, Core::ElapsedTimer const& measure
         });
     }
 
-    m_gc_bytes_threshold = live_cell_bytes > GC_MIN_BYTES_THRESHOLD ? live_cell_bytes : GC_MIN_BYTES_THRESHOLD;
+    // Everything that survived is in the old generation now.
+    m_young_cells.clear_with_capacity();
+    m_old_generation_bytes = statistics.live_cell_bytes;
+    m_old_generation_bytes_threshold = max(m_old_generation_bytes * 2, GC_MIN_BYTES_THRESHOLD);
 
-    if (print_report) {
-        Duration const time_spent = measurement_timer.elapsed_time();
-        size_t live_block_count = 0;
-        for_each_block([&](auto&) {
-            ++live_block_count;
-            return IterationDecision::Continue;
+    m_gc_bytes_threshold = statistics.live_cell_bytes > GC_MIN_BYTES_THRESHOLD ? statistics.live_cell_bytes : GC_MIN_BYTES_THRESHOLD;
+
+    statistics.freed_blocks = empty_blocks.size();
+    return statistics;
+}
+
+Heap::CollectionStatistics Heap::sweep_dead_young_cells()
+{
+    dbgln_if(HEAP_DEBUG, "sweep_dead_young_cells:");
+    HashMap<HeapBlock*, bool> block_was_full;
+    Vector<HeapBlock*, 32> empty_blocks;
+    Vector<HeapBlock*, 32> full_blocks_that_became_usable;
+
+    CollectionStatistics statistics;
+
+    for (auto* cell : m_young_cells) {
+        auto* block = HeapBlock::from_cell(cell);
+        block_was_full.ensure(block, [&] { return block->is_full(); });
+
+        if (!cell->is_marked() && !cell_must_survive_garbage_collection(*cell)) {
+            dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
+            block->deallocate(cell);
+            ++statistics.collected_cells;
+            statistics.collected_cell_bytes += block->cell_size();
+        } else {
+            cell->set_marked(false);
+            did_promote_cell(*cell);
+            ++statistics.live_cells;
+            statistics.live_cell_bytes += block->cell_size();
+        }
+    }
+    m_young_cells.clear_with_capacity();
+    forget_remembered_cells();
+
+    for (auto& [block, was_full] : block_was_full) {
+        bool block_has_live_cells = false;
+        block->for_each_cell_in_state<Cell::State::Live>([&](Cell*) {
+            block_has_live_cells = true;
         });
+        if (!block_has_live_cells)
+            empty_blocks.append(block);
+        else if (was_full != block->is_full())
+            full_blocks_that_became_usable.append(block);
+    }
+
+    for (auto& weak_container : m_weak_containers)
+        weak_container.remove_dead_cells({});
 
-        dbgln("Garbage collection report");
-        dbgln("=============================================");
-        dbgln("     Time spent: {} ms", time_spent.to_milliseconds());
-        dbgln("     Live cells: {} ({} bytes)", live_cells, live_cell_bytes);
-        dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
-        dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
-        dbgln("   Freed blocks: {} ({} bytes)", empty_blocks.size(), empty_blocks.size() * HeapBlock::block_size);
-        dbgln("=============================================");
+    for (auto* block : empty_blocks) {
+        dbgln_if(HEAP_DEBUG, " - HeapBlock empty @ {}: cell_size={}", block, block->cell_size());
+        block->cell_allocator().block_did_become_empty({}, *block);
     }
+
+    for (auto* block : full_blocks_that_became_usable) {
+        dbgln_if(HEAP_DEBUG, " - HeapBlock usable again @ {}: cell_size={}", block, block->cell_size());
+        block->cell_allocator().block_did_become_usable({}, *block);
+    }
+
+    // NOTE: The live cells counted here are only the survivors that got promoted. The cells that were already old
+    //       weren't looked at, so the threshold for the next collection is based on the whole old generation instead.
+    m_old_generation_bytes += statistics.live_cell_bytes;
+    m_gc_bytes_threshold = m_old_generation_bytes > GC_MIN_BYTES_THRESHOLD ? m_old_generation_bytes : GC_MIN_BYTES_THRESHOLD;
+
+    statistics.freed_blocks = empty_blocks.size();
+    return statistics;
+}
+
+void Heap::print_collection_report(CollectionType collection_type, CollectionStatistics const& statistics, Core::ElapsedTimer const& measurement_timer)
+{
+    Duration const time_spent = measurement_timer.elapsed_time();
+    size_t live_block_count = 0;
+    for_each_block([&](auto&) {
+        ++live_block_count;
+        return IterationDecision::Continue;
+    });
+
+    auto collection_type_name = [&] {
+        switch (collection_type) {
+        case CollectionType::CollectGarbage:
+            return "Full"sv;
+        case CollectionType::CollectEverything:
+            return "Everything"sv;
+        case CollectionType::CollectYoungGeneration:
+            return "Young generation"sv;
+        case CollectionType::CollectGarbageIncrementally:
+            return "Incremental (final pause)"sv;
+        }
+        VERIFY_NOT_REACHED();
+    }();
+
+    dbgln("Garbage collection report");
+    dbgln("=============================================");
+    dbgln("     Collection: {}", collection_type_name);
+    dbgln("     Time spent: {} ms ({} us)", time_spent.to_milliseconds(), time_spent.to_microseconds());
+    if (collection_type == CollectionType::CollectYoungGeneration)
+        dbgln(" Promoted cells: {} ({} bytes)", statistics.live_cells, statistics.live_cell_bytes);
+    else
+        dbgln("     Live cells: {} ({} bytes)", statistics.live_cells, statistics.live_cell_bytes);
+    dbgln("Collected cells: {} ({} bytes)", statistics.collected_cells, statistics.collected_cell_bytes);
+    dbgln(" Old generation: {} bytes", m_old_generation_bytes);
+    dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
+    dbgln("   Freed blocks: {} ({} bytes)", statistics.freed_blocks, statistics.freed_blocks * HeapBlock::block_size);
+    dbgln("=============================================");
 }
 
 void Heap::defer_gc()
@@ -564,9 +1064,10 @@ void Heap::undefer_gc()
     --m_gc_deferrals;
 
     if (!m_gc_deferrals) {
-        if (m_should_gc_when_deferral_ends)
-            collect_garbage();
-        m_should_gc_when_deferral_ends = false;
+        if (auto collection_type = m_collection_type_when_deferral_ends; collection_type.has_value()) {
+            m_collection_type_when_deferral_ends.clear();
+            collect_garbage(*collection_type, m_should_print_collection_reports);
+        }
     }
 }
 
@@ -11,6 +11,8 @@
 #include <AK/IntrusiveList.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/OwnPtr.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
@@ -28,6 +30,8 @@
 
 namespace JS {
 
+class MarkingVisitor;
+
 class Heap : public HeapBase {
     AK_MAKE_NONCOPYABLE(Heap);
     AK_MAKE_NONMOVABLE(Heap);
@@ -42,6 +46,7 @@ public:
         auto* memory = allocate_cell<T>();
         defer_gc();
         new (memory) T(forward<Args>(args)...);
+        did_construct_cell(*memory, is_write_barrier_protected<T>());
         undefer_gc();
         return *static_cast<T*>(memory);
     }
@@ -52,6 +57,7 @@ public:
         auto* memory = allocate_cell<T>();
         defer_gc();
         new (memory) T(forward<Args>(args)...);
+        did_construct_cell(*memory, is_write_barrier_protected<T>());
         undefer_gc();
         auto* cell = static_cast<T*>(memory);
         memory->initialize(realm);
@@ -61,6 +67,8 @@ public:
     enum class CollectionType {
         CollectGarbage,
         CollectEverything,
+        CollectYoungGeneration,
+        CollectGarbageIncrementally,
     };
 
     void collect_garbage(CollectionType = CollectionType::CollectGarbage, bool print_report = false);
@@ -69,6 +77,12 @@ public:
     bool should_collect_on_every_allocation() const { return m_should_collect_on_every_allocation; }
     void set_should_collect_on_every_allocation(bool b) { m_should_collect_on_every_allocation = b; }
 
+    bool should_print_collection_reports() const { return m_should_print_collection_reports; }
+    void set_should_print_collection_reports(bool b) { m_should_print_collection_reports = b; }
+
+    bool should_collect_incrementally() const { return m_should_collect_incrementally; }
+    void set_should_collect_incrementally(bool b) { m_should_collect_incrementally = b; }
+
     void did_create_handle(Badge<HandleImpl>, HandleImpl&);
     void did_destroy_handle(Badge<HandleImpl>, HandleImpl&);
 
@@ -88,6 +102,15 @@ public:
 
     void uproot_cell(Cell* cell);
 
+    void write_barrier_slow_path(Badge<Cell>, Cell& cell, Cell& stored_cell);
+
+    // These let tests drive an incremental collection one slice at a time, and check that the write barrier has
+    // told the collector about every edge it would otherwise miss.
+    void start_incremental_collection_for_testing();
+    bool run_incremental_marking_slice_for_testing(size_t max_cell_count);
+    void finish_incremental_collection_for_testing();
+    size_t count_write_barrier_violations();
+
 private:
     friend class MarkingVisitor;
     friend class GraphConstructorVisitor;
@@ -102,23 +125,76 @@ private:
     Cell* allocate_cell()
     {
         will_allocate(sizeof(T));
+        auto* cell = cell_allocator_for<T>().allocate_cell(*this);
+        m_young_cells.append(cell);
+        return cell;
+    }
+
+    template<typename T>
+    CellAllocator& cell_allocator_for()
+    {
         if constexpr (requires { T::cell_allocator.allocator.get().allocate_cell(*this); }) {
             if constexpr (IsSame<T, typename decltype(T::cell_allocator)::CellType>) {
-                return T::cell_allocator.allocator.get().allocate_cell(*this);
+                return T::cell_allocator.allocator.get();
             }
         }
-        return allocator_for_size(sizeof(T)).allocate_cell(*this);
+        return allocator_for_size(sizeof(T));
     }
 
     void will_allocate(size_t);
+    CollectionType collection_type_for_automatic_collection() const;
+
+    template<typename T>
+    static constexpr bool is_write_barrier_protected()
+    {
+        if constexpr (requires { typename T::WriteBarrierProtectedCell; })
+            return IsSame<T, typename T::WriteBarrierProtectedCell>;
+        else
+            return false;
+    }
+
+    ALWAYS_INLINE void did_construct_cell(Cell& cell, bool is_write_barrier_protected)
+    {
+        cell.set_write_barrier_protected({}, is_write_barrier_protected);
+        if (m_incremental_collection_phase == IncrementalCollectionPhase::Marking) [[unlikely]]
+            did_construct_cell_while_marking(cell);
+    }
+    void did_construct_cell_while_marking(Cell&);
+
+    struct CollectionStatistics {
+        size_t live_cells { 0 };
+        size_t live_cell_bytes { 0 };
+        size_t collected_cells { 0 };
+        size_t collected_cell_bytes { 0 };
+        size_t freed_blocks { 0 };
+    };
 
     void find_min_and_max_block_addresses(FlatPtr& min_address, FlatPtr& max_address);
     void gather_roots(HashMap<Cell*, HeapRoot>&);
     void gather_conservative_roots(HashMap<Cell*, HeapRoot>&);
     void gather_asan_fake_stack_roots(HashMap<FlatPtr, HeapRoot>&, FlatPtr, FlatPtr min_block_address, FlatPtr max_block_address);
     void mark_live_cells(HashMap<Cell*, HeapRoot> const& live_cells);
+    void mark_live_young_cells(HashMap<Cell*, HeapRoot> const& live_cells);
+    void forget_remembered_cells();
+    void did_promote_cell(Cell&);
     void finalize_unmarked_cells();
-    void sweep_dead_cells(bool print_report, Core::ElapsedTimer const&);
+    void finalize_unmarked_young_cells();
+    CollectionStatistics sweep_dead_cells();
+    CollectionStatistics sweep_dead_young_cells();
+    void print_collection_report(CollectionType, CollectionStatistics const&, Core::ElapsedTimer const&);
+
+    enum class IncrementalCollectionPhase {
+        Idle,
+        Marking,
+        Sweeping,
+    };
+
+    void start_incremental_collection();
+    void run_incremental_collection_slice();
+    CollectionStatistics finish_incremental_marking();
+    void abandon_incremental_marking();
+    void sweep_pending_blocks(size_t max_block_count);
+    void finish_incremental_collection(bool print_report);
 
     ALWAYS_INLINE CellAllocator& allocator_for_size(size_t cell_size)
     {
@@ -145,6 +221,30 @@ private:
     size_t m_allocated_bytes_since_last_gc { 0 };
 
     bool m_should_collect_on_every_allocation { false };
+    bool m_should_print_collection_reports { false };
+    bool m_should_collect_incrementally { false };
+
+    // An incremental collection marks and sweeps in small slices, driven by allocations. We never let go of the
+    // marking visitor in between slices, since its work queue is the grey set.
+    static constexpr size_t INCREMENTAL_SLICE_BYTES_THRESHOLD { 128 * 1024 };
+    static constexpr size_t INCREMENTAL_MARKING_SLICE_CELL_COUNT { 8192 };
+    static constexpr size_t INCREMENTAL_SWEEPING_SLICE_BLOCK_COUNT { 256 };
+    IncrementalCollectionPhase m_incremental_collection_phase { IncrementalCollectionPhase::Idle };
+    OwnPtr<MarkingVisitor> m_incremental_marking_visitor;
+    Vector<HeapBlock*> m_blocks_pending_sweep;
+    size_t m_allocated_bytes_since_last_incremental_slice { 0 };
+
+    // Every cell allocated since the last collection. A young generation collection only sweeps these,
+    // and promotes the survivors to the old generation.
+    Vector<Cell*> m_young_cells;
+
+    // The old cells that may point into the young generation. Write barrier protected cells end up in here when
+    // they store a young cell, while the others never call the write barrier, so we have to assume they always do.
+    Vector<Cell*> m_remembered_cells;
+    Vector<Cell*> m_old_cells_without_write_barrier;
+
+    size_t m_old_generation_bytes { 0 };
+    size_t m_old_generation_bytes_threshold { GC_MIN_BYTES_THRESHOLD };
 
     Vector<NonnullOwnPtr<CellAllocator>> m_size_based_cell_allocators;
     CellAllocator::List m_all_cell_allocators;
@@ -157,7 +257,7 @@ private:
     Vector<GCPtr<Cell>> m_uprooted_cells;
 
     size_t m_gc_deferrals { 0 };
-    bool m_should_gc_when_deferral_ends { false };
+    Optional<CollectionType> m_collection_type_when_deferral_ends;
 
     bool m_collecting_garbage { false };
 };
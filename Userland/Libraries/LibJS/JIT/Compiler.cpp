@@ -0,0 +1,795 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Weakable.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/JIT/Compiler.h>
+#include <LibJS/Runtime/Object.h>
+#include <LibJS/Runtime/ValueInlines.h>
+#include <sys/mman.h>
+
+#ifdef JIT_ARCH_SUPPORTED
+
+namespace JS::JIT {
+
+using Assembler = ::JIT::Assembler;
+using Operand = Assembler::Operand;
+
+static constexpr auto GPR0 = Assembler::Reg::RAX;
+static constexpr auto GPR1 = Assembler::Reg::RCX;
+static constexpr auto GPR2 = Assembler::Reg::RDX;
+static constexpr auto SCRATCH = Assembler::Reg::R11;
+
+static constexpr auto ARG0 = Assembler::Reg::RDI;
+static constexpr auto ARG1 = Assembler::Reg::RSI;
+static constexpr auto ARG2 = Assembler::Reg::RDX;
+static constexpr auto ARG3 = Assembler::Reg::RCX;
+static constexpr auto ARG4 = Assembler::Reg::R8;
+
+// These are callee-saved, so they survive calls into the runtime.
+static constexpr auto REGISTER_ARRAY_BASE = Assembler::Reg::RBX;
+static constexpr auto PROGRAM_COUNTER = Assembler::Reg::R13;
+static constexpr auto ARGUMENTS_BASE = Assembler::Reg::R14;
+static constexpr auto INTERPRETER = Assembler::Reg::R15;
+
+// The inline caches below read these straight out of memory.
+static_assert(sizeof(WeakPtr<Shape>) == sizeof(void*));
+static_assert(sizeof(WeakPtr<Object>) == sizeof(void*));
+static_assert(sizeof(GCPtr<Shape>) == sizeof(void*));
+static_assert(sizeof(Optional<u32>) == 2 * sizeof(u32), "We expect the cached property offset to live at the start of the Optional");
+
+// Returned by helpers that can throw. The exception has already been stored in the exception register.
+static constexpr u64 helper_threw = 2;
+
+void Compiler::store_program_counter()
+{
+    // NOTE: Runtime code may look at the program counter, e.g. to figure out source locations for stack traces.
+    m_assembler.mov(Operand::Register(GPR0), Operand::Imm(m_current_offset));
+    m_assembler.mov(Operand::Mem64BaseAndOffset(PROGRAM_COUNTER, 0), Operand::Register(GPR0));
+}
+
+void Compiler::load_vm_register(Assembler::Reg dst, Bytecode::Operand src)
+{
+    m_assembler.mov(Operand::Register(dst), Operand::Mem64BaseAndOffset(REGISTER_ARRAY_BASE, src.index() * sizeof(Value)));
+}
+
+void Compiler::store_vm_register(Bytecode::Operand dst, Assembler::Reg src)
+{
+    m_assembler.mov(Operand::Mem64BaseAndOffset(REGISTER_ARRAY_BASE, dst.index() * sizeof(Value)), Operand::Register(src));
+}
+
+void Compiler::load_address_of_vm_register(Assembler::Reg dst, Bytecode::Operand operand)
+{
+    m_assembler.mov(Operand::Register(dst), Operand::Register(REGISTER_ARRAY_BASE));
+    m_assembler.add(Operand::Register(dst), Operand::Imm(operand.index() * sizeof(Value)));
+}
+
+void Compiler::extract_tag(Assembler::Reg dst, Assembler::Reg value)
+{
+    m_assembler.mov(Operand::Register(dst), Operand::Register(value));
+    m_assembler.shift_right(Operand::Register(dst), Operand::Imm(TAG_SHIFT));
+}
+
+void Compiler::branch_if_not_tag(Assembler::Reg value, u64 tag, Assembler::Label& label)
+{
+    extract_tag(SCRATCH, value);
+    m_assembler.jump_if(Operand::Register(SCRATCH), Assembler::Condition::NotEqualTo, Operand::Imm(tag), label);
+}
+
+void Compiler::branch_if_not_object(Assembler::Reg value, Assembler::Label& label)
+{
+    branch_if_not_tag(value, OBJECT_TAG, label);
+}
+
+void Compiler::extract_object_pointer(Assembler::Reg reg)
+{
+    // See Value::extract_pointer_bits(): the top 16 bits have to sign-extend bit 47.
+    m_assembler.shift_left(Operand::Register(reg), Operand::Imm(16));
+    m_assembler.arithmetic_right_shift(Operand::Register(reg), Operand::Imm(16));
+}
+
+void Compiler::box_int32(Assembler::Reg reg)
+{
+    // NOTE: This expects the result of a 32-bit operation, which clears the upper half of the register.
+    m_assembler.mov(Operand::Register(SCRATCH), Operand::Imm(SHIFTED_INT32_TAG));
+    m_assembler.bitwise_or(Operand::Register(reg), Operand::Register(SCRATCH));
+}
+
+void Compiler::box_boolean(Assembler::Reg reg)
+{
+    m_assembler.bitwise_and(Operand::Register(reg), Operand::Imm(1));
+    m_assembler.mov(Operand::Register(SCRATCH), Operand::Imm(SHIFTED_BOOLEAN_TAG));
+    m_assembler.bitwise_or(Operand::Register(reg), Operand::Register(SCRATCH));
+}
+
+void Compiler::native_call(void* function)
+{
+    m_assembler.native_call(bit_cast<u64>(function));
+}
+
+void Compiler::leave_if_helper_threw()
+{
+    m_assembler.jump_if(Operand::Register(GPR0), Assembler::Condition::EqualTo, Operand::Imm(helper_threw), m_exit_label);
+}
+
+Assembler::Label& Compiler::label_for(Bytecode::Label const& label)
+{
+    auto it = m_block_labels.find(label.address());
+    VERIFY(it != m_block_labels.end());
+    return it->value;
+}
+
+template<typename OpType>
+static u64 cxx_execute(Bytecode::Interpreter& interpreter, OpType const& instruction)
+{
+    if constexpr (IsSame<decltype(instruction.execute_impl(interpreter)), void>) {
+        instruction.execute_impl(interpreter);
+    } else {
+        auto result = instruction.execute_impl(interpreter);
+        if (result.is_error()) [[unlikely]] {
+            interpreter.reg(Bytecode::Register::exception()) = result.error_value();
+            return helper_threw;
+        }
+    }
+    return 0;
+}
+
+template<typename OpType>
+void Compiler::compile_generic(OpType const& instruction)
+{
+    store_program_counter();
+    m_assembler.mov(Operand::Register(ARG0), Operand::Register(INTERPRETER));
+    m_assembler.mov(Operand::Register(ARG1), Operand::Imm(reinterpret_cast<FlatPtr>(&instruction)));
+    native_call((void*)cxx_execute<OpType>);
+
+    if constexpr (!IsSame<decltype(instruction.execute_impl(declval<Bytecode::Interpreter&>())), void>)
+        leave_if_helper_threw();
+}
+
+template<typename OpType>
+void Compiler::compile_instruction(OpType const& instruction)
+{
+    if constexpr (requires(Bytecode::Interpreter& interpreter) { instruction.execute_impl(interpreter); })
+        compile_generic(instruction);
+    else
+        VERIFY_NOT_REACHED();
+}
+
+void Compiler::compile_instruction(Bytecode::Op::Mov const& instruction)
+{
+    load_vm_register(GPR0, instruction.src());
+    store_vm_register(instruction.dst(), GPR0);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::GetArgument const& instruction)
+{
+    m_assembler.mov(Operand::Register(GPR0), Operand::Mem64BaseAndOffset(ARGUMENTS_BASE, instruction.index() * sizeof(Value)));
+    store_vm_register(instruction.dst(), GPR0);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::SetArgument const& instruction)
+{
+    load_vm_register(GPR0, instruction.src());
+    m_assembler.mov(Operand::Mem64BaseAndOffset(ARGUMENTS_BASE, instruction.index() * sizeof(Value)), Operand::Register(GPR0));
+}
+
+void Compiler::compile_instruction(Bytecode::Op::End const& instruction)
+{
+    load_vm_register(GPR0, instruction.value());
+    store_vm_register(Bytecode::Operand(Bytecode::Register::accumulator()), GPR0);
+    m_assembler.jump(m_exit_label);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::Return const& instruction)
+{
+    // NOTE: This is Interpreter::do_return(), which every call ends in, so it's not worth a call into the runtime.
+    if (instruction.value().has_value())
+        load_vm_register(GPR0, *instruction.value());
+    else
+        m_assembler.mov(Operand::Register(GPR0), Operand::Imm(js_undefined().encoded()));
+    store_vm_register(Bytecode::Operand(Bytecode::Register::return_value()), GPR0);
+    m_assembler.mov(Operand::Register(GPR0), Operand::Imm(Value().encoded()));
+    store_vm_register(Bytecode::Operand(Bytecode::Register::exception()), GPR0);
+    m_assembler.jump(m_exit_label);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::Jump const& instruction)
+{
+    m_assembler.jump(label_for(instruction.target()));
+}
+
+static u64 cxx_to_boolean(Value const* value)
+{
+    return value->to_boolean();
+}
+
+void Compiler::compile_to_boolean_and_jump(Bytecode::Operand condition, Assembler::Label& true_target, Assembler::Label& false_target)
+{
+    Assembler::Label not_boolean;
+    Assembler::Label slow_case;
+
+    load_vm_register(GPR0, condition);
+    extract_tag(GPR1, GPR0);
+
+    // OPTIMIZATION: Booleans and Int32s don't need a call into the runtime.
+    m_assembler.jump_if(Operand::Register(GPR1), Assembler::Condition::NotEqualTo, Operand::Imm(BOOLEAN_TAG), not_boolean);
+    m_assembler.test(Operand::Register(GPR0), Operand::Imm(1));
+    m_assembler.jump_if(Assembler::Condition::NotEqualTo, true_target);
+    m_assembler.jump(false_target);
+
+    not_boolean.link(m_assembler);
+    m_assembler.jump_if(Operand::Register(GPR1), Assembler::Condition::NotEqualTo, Operand::Imm(INT32_TAG), slow_case);
+    m_assembler.mov32(Operand::Register(GPR0), Operand::Register(GPR0));
+    m_assembler.jump_if(Operand::Register(GPR0), Assembler::Condition::NotEqualTo, Operand::Imm(0), true_target);
+    m_assembler.jump(false_target);
+
+    slow_case.link(m_assembler);
+    load_address_of_vm_register(ARG0, condition);
+    native_call((void*)cxx_to_boolean);
+    m_assembler.jump_if(Operand::Register(GPR0), Assembler::Condition::NotEqualTo, Operand::Imm(0), true_target);
+    m_assembler.jump(false_target);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::JumpIf const& instruction)
+{
+    compile_to_boolean_and_jump(instruction.condition(), label_for(instruction.true_target()), label_for(instruction.false_target()));
+}
+
+void Compiler::compile_instruction(Bytecode::Op::JumpTrue const& instruction)
+{
+    Assembler::Label fallthrough;
+    compile_to_boolean_and_jump(instruction.condition(), label_for(instruction.target()), fallthrough);
+    fallthrough.link(m_assembler);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::JumpFalse const& instruction)
+{
+    Assembler::Label fallthrough;
+    compile_to_boolean_and_jump(instruction.condition(), fallthrough, label_for(instruction.target()));
+    fallthrough.link(m_assembler);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::JumpNullish const& instruction)
+{
+    load_vm_register(GPR0, instruction.condition());
+    m_assembler.shift_right(Operand::Register(GPR0), Operand::Imm(TAG_SHIFT));
+    m_assembler.bitwise_and(Operand::Register(GPR0), Operand::Imm(IS_NULLISH_EXTRACT_PATTERN));
+    m_assembler.jump_if(Operand::Register(GPR0), Assembler::Condition::EqualTo, Operand::Imm(IS_NULLISH_PATTERN), label_for(instruction.true_target()));
+    m_assembler.jump(label_for(instruction.false_target()));
+}
+
+void Compiler::compile_instruction(Bytecode::Op::JumpUndefined const& instruction)
+{
+    load_vm_register(GPR0, instruction.condition());
+    m_assembler.shift_right(Operand::Register(GPR0), Operand::Imm(TAG_SHIFT));
+    m_assembler.jump_if(Operand::Register(GPR0), Assembler::Condition::EqualTo, Operand::Imm(UNDEFINED_TAG), label_for(instruction.true_target()));
+    m_assembler.jump(label_for(instruction.false_target()));
+}
+
+void Compiler::compare_int32_operands(Bytecode::Operand lhs, Bytecode::Operand rhs, Assembler::Label& slow_case)
+{
+    load_vm_register(GPR0, lhs);
+    load_vm_register(GPR1, rhs);
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    branch_if_not_tag(GPR1, INT32_TAG, slow_case);
+    m_assembler.sign_extend_32_to_64_bits(GPR0);
+    m_assembler.sign_extend_32_to_64_bits(GPR1);
+    m_assembler.cmp(Operand::Register(GPR0), Operand::Register(GPR1));
+}
+
+static constexpr Assembler::Condition condition_for_numeric_operator(StringView numeric_operator)
+{
+    if (numeric_operator == "<"sv)
+        return Assembler::Condition::SignedLessThan;
+    if (numeric_operator == "<="sv)
+        return Assembler::Condition::SignedLessThanOrEqualTo;
+    if (numeric_operator == ">"sv)
+        return Assembler::Condition::SignedGreaterThan;
+    if (numeric_operator == ">="sv)
+        return Assembler::Condition::SignedGreaterThanOrEqualTo;
+    if (numeric_operator == "=="sv)
+        return Assembler::Condition::EqualTo;
+    if (numeric_operator == "!="sv)
+        return Assembler::Condition::NotEqualTo;
+    VERIFY_NOT_REACHED();
+}
+
+static ThrowCompletionOr<Value> loosely_equals(VM& vm, Value lhs, Value rhs)
+{
+    return Value(TRY(is_loosely_equal(vm, lhs, rhs)));
+}
+
+static ThrowCompletionOr<Value> loosely_inequals(VM& vm, Value lhs, Value rhs)
+{
+    return Value(!TRY(is_loosely_equal(vm, lhs, rhs)));
+}
+
+static ThrowCompletionOr<Value> strict_equals(VM&, Value lhs, Value rhs)
+{
+    return Value(is_strictly_equal(lhs, rhs));
+}
+
+static ThrowCompletionOr<Value> strict_inequals(VM&, Value lhs, Value rhs)
+{
+    return Value(!is_strictly_equal(lhs, rhs));
+}
+
+#    define DO_COMPILE_JUMP_COMPARISON(op_TitleCase, op_snake_case, numeric_operator)                                 \
+        static u64 cxx_jump_##op_snake_case(Bytecode::Interpreter& interpreter, Value const* lhs, Value const* rhs)    \
+        {                                                                                                              \
+            auto result = op_snake_case(interpreter.vm(), *lhs, *rhs);                                                 \
+            if (result.is_error()) [[unlikely]] {                                                                      \
+                interpreter.reg(Bytecode::Register::exception()) = result.error_value();                               \
+                return helper_threw;                                                                                   \
+            }                                                                                                          \
+            return result.value().to_boolean();                                                                        \
+        }                                                                                                              \
+                                                                                                                       \
+        void Compiler::compile_instruction(Bytecode::Op::Jump##op_TitleCase const& instruction)                        \
+        {                                                                                                              \
+            auto& true_target = label_for(instruction.true_target());                                                  \
+            auto& false_target = label_for(instruction.false_target());                                                \
+            Assembler::Label slow_case;                                                                                \
+                                                                                                                       \
+            compare_int32_operands(instruction.lhs(), instruction.rhs(), slow_case);                                   \
+            m_assembler.jump_if(condition_for_numeric_operator(#numeric_operator ""sv), true_target);                   \
+            m_assembler.jump(false_target);                                                                            \
+                                                                                                                       \
+            slow_case.link(m_assembler);                                                                               \
+            store_program_counter();                                                                                   \
+            m_assembler.mov(Operand::Register(ARG0), Operand::Register(INTERPRETER));                                  \
+            load_address_of_vm_register(ARG1, instruction.lhs());                                                      \
+            load_address_of_vm_register(ARG2, instruction.rhs());                                                      \
+            native_call((void*)cxx_jump_##op_snake_case);                                                              \
+            leave_if_helper_threw();                                                                                   \
+            m_assembler.jump_if(Operand::Register(GPR0), Assembler::Condition::NotEqualTo, Operand::Imm(0), true_target); \
+            m_assembler.jump(false_target);                                                                            \
+        }
+
+JS_ENUMERATE_COMPARISON_OPS(DO_COMPILE_JUMP_COMPARISON)
+#    undef DO_COMPILE_JUMP_COMPARISON
+
+// The Int32 fast paths below have to produce exactly what the interpreter's fast paths produce.
+// Anything they don't handle (including overflow) falls back to the instruction's execute_impl().
+
+void Compiler::compile_instruction(Bytecode::Op::Add const& instruction)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_register(GPR0, instruction.lhs());
+    load_vm_register(GPR1, instruction.rhs());
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    branch_if_not_tag(GPR1, INT32_TAG, slow_case);
+    m_assembler.add32(Operand::Register(GPR0), Operand::Register(GPR1), slow_case);
+    box_int32(GPR0);
+    store_vm_register(instruction.dst(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::Sub const& instruction)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_register(GPR0, instruction.lhs());
+    load_vm_register(GPR1, instruction.rhs());
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    branch_if_not_tag(GPR1, INT32_TAG, slow_case);
+    m_assembler.sub32(Operand::Register(GPR0), Operand::Register(GPR1), slow_case);
+    box_int32(GPR0);
+    store_vm_register(instruction.dst(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::Mul const& instruction)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_register(GPR0, instruction.lhs());
+    load_vm_register(GPR1, instruction.rhs());
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    branch_if_not_tag(GPR1, INT32_TAG, slow_case);
+    m_assembler.mul32(Operand::Register(GPR0), Operand::Register(GPR1), slow_case);
+    box_int32(GPR0);
+    store_vm_register(instruction.dst(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::BitwiseAnd const& instruction)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_register(GPR0, instruction.lhs());
+    load_vm_register(GPR1, instruction.rhs());
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    branch_if_not_tag(GPR1, INT32_TAG, slow_case);
+    // NOTE: Both tags are the same, so this leaves the tag intact.
+    m_assembler.bitwise_and(Operand::Register(GPR0), Operand::Register(GPR1));
+    store_vm_register(instruction.dst(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::BitwiseOr const& instruction)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_register(GPR0, instruction.lhs());
+    load_vm_register(GPR1, instruction.rhs());
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    branch_if_not_tag(GPR1, INT32_TAG, slow_case);
+    // NOTE: Both tags are the same, so this leaves the tag intact.
+    m_assembler.bitwise_or(Operand::Register(GPR0), Operand::Register(GPR1));
+    store_vm_register(instruction.dst(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::BitwiseXor const& instruction)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_register(GPR0, instruction.lhs());
+    load_vm_register(GPR1, instruction.rhs());
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    branch_if_not_tag(GPR1, INT32_TAG, slow_case);
+    m_assembler.bitwise_xor32(Operand::Register(GPR0), Operand::Register(GPR1));
+    box_int32(GPR0);
+    store_vm_register(instruction.dst(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+// NOTE: The shift count has to be in CL, and x86 masks 32-bit shift counts to 5 bits like JS does.
+static_assert(GPR1 == Assembler::Reg::RCX);
+
+void Compiler::compile_instruction(Bytecode::Op::LeftShift const& instruction)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_register(GPR0, instruction.lhs());
+    load_vm_register(GPR1, instruction.rhs());
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    branch_if_not_tag(GPR1, INT32_TAG, slow_case);
+    m_assembler.shift_left32(Operand::Register(GPR0), {});
+    box_int32(GPR0);
+    store_vm_register(instruction.dst(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::RightShift const& instruction)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_register(GPR0, instruction.lhs());
+    load_vm_register(GPR1, instruction.rhs());
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    branch_if_not_tag(GPR1, INT32_TAG, slow_case);
+    m_assembler.arithmetic_right_shift32(Operand::Register(GPR0), {});
+    box_int32(GPR0);
+    store_vm_register(instruction.dst(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::UnsignedRightShift const& instruction)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_register(GPR0, instruction.lhs());
+    load_vm_register(GPR1, instruction.rhs());
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    branch_if_not_tag(GPR1, INT32_TAG, slow_case);
+    m_assembler.shift_right32(Operand::Register(GPR0), {});
+    // Results that don't fit in an i32 become doubles, so leave those to the slow path.
+    m_assembler.jump_if(Operand::Register(GPR0), Assembler::Condition::UnsignedGreaterThan, Operand::Imm(NumericLimits<i32>::max()), slow_case);
+    box_int32(GPR0);
+    store_vm_register(instruction.dst(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+#    define DO_COMPILE_INT32_COMPARISON(OpTitleCase, numeric_operator)                                   \
+        void Compiler::compile_instruction(Bytecode::Op::OpTitleCase const& instruction)                \
+        {                                                                                               \
+            Assembler::Label slow_case;                                                                 \
+            Assembler::Label end;                                                                       \
+                                                                                                        \
+            compare_int32_operands(instruction.lhs(), instruction.rhs(), slow_case);                    \
+            m_assembler.set_if(condition_for_numeric_operator(#numeric_operator ""sv), Operand::Register(GPR0)); \
+            box_boolean(GPR0);                                                                          \
+            store_vm_register(instruction.dst(), GPR0);                                                 \
+            m_assembler.jump(end);                                                                      \
+                                                                                                        \
+            slow_case.link(m_assembler);                                                                \
+            compile_generic(instruction);                                                               \
+            end.link(m_assembler);                                                                      \
+        }
+
+DO_COMPILE_INT32_COMPARISON(LessThan, <)
+DO_COMPILE_INT32_COMPARISON(LessThanEquals, <=)
+DO_COMPILE_INT32_COMPARISON(GreaterThan, >)
+DO_COMPILE_INT32_COMPARISON(GreaterThanEquals, >=)
+#    undef DO_COMPILE_INT32_COMPARISON
+
+void Compiler::compile_instruction(Bytecode::Op::Increment const& instruction)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_register(GPR0, instruction.dst());
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    m_assembler.inc32(Operand::Register(GPR0), slow_case);
+    box_int32(GPR0);
+    store_vm_register(instruction.dst(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::PostfixIncrement const& instruction)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_register(GPR0, instruction.src());
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    store_vm_register(instruction.dst(), GPR0);
+    m_assembler.inc32(Operand::Register(GPR0), slow_case);
+    box_int32(GPR0);
+    store_vm_register(instruction.src(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::Decrement const& instruction)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_register(GPR0, instruction.dst());
+    branch_if_not_tag(GPR0, INT32_TAG, slow_case);
+    m_assembler.dec32(Operand::Register(GPR0), slow_case);
+    box_int32(GPR0);
+    store_vm_register(instruction.dst(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+void Compiler::load_address_of_cached_property(Bytecode::PropertyLookupCache const& cache, Assembler::Label& slow_case)
+{
+    Assembler::Label found;
+
+    // OPTIMIZATION: Check the own property entries of the cache inline, one after another.
+    //               Properties from the prototype chain and megamorphic sites take the slow path.
+    m_assembler.mov(Operand::Register(GPR2), Operand::Imm(reinterpret_cast<FlatPtr>(&cache)));
+    for (size_t i = 0; i < Bytecode::PropertyLookupCache::max_number_of_shapes; ++i) {
+        Assembler::Label next_entry;
+        auto entry_offset = OFFSET_OF(Bytecode::PropertyLookupCache, entries) + i * sizeof(Bytecode::PropertyLookupCacheEntry);
+
+        m_assembler.mov(Operand::Register(GPR1), Operand::Mem64BaseAndOffset(GPR2, entry_offset + OFFSET_OF(Bytecode::PropertyLookupCacheEntry, prototype)));
+        m_assembler.jump_if(Operand::Register(GPR1), Assembler::Condition::NotEqualTo, Operand::Imm(0), next_entry);
+        m_assembler.mov(Operand::Register(GPR1), Operand::Mem64BaseAndOffset(GPR2, entry_offset + OFFSET_OF(Bytecode::PropertyLookupCacheEntry, shape)));
+        m_assembler.jump_if(Operand::Register(GPR1), Assembler::Condition::EqualTo, Operand::Imm(0), next_entry);
+        m_assembler.mov(Operand::Register(GPR1), Operand::Mem64BaseAndOffset(GPR1, AK::WeakLink::ptr_offset()));
+        m_assembler.cmp(Operand::Mem64BaseAndOffset(GPR0, Object::shape_offset()), Operand::Register(GPR1));
+        m_assembler.jump_if(Assembler::Condition::NotEqualTo, next_entry);
+        m_assembler.mov32(Operand::Register(GPR1), Operand::Mem64BaseAndOffset(GPR2, entry_offset + OFFSET_OF(Bytecode::PropertyLookupCacheEntry, property_offset)));
+        m_assembler.jump(found);
+
+        next_entry.link(m_assembler);
+    }
+    m_assembler.jump(slow_case);
+
+    found.link(m_assembler);
+    m_assembler.add(Operand::Mem64BaseAndOffset(GPR2, OFFSET_OF(Bytecode::PropertyLookupCache, hits)), Operand::Imm(1));
+    m_assembler.shift_left(Operand::Register(GPR1), Operand::Imm(3));
+    m_assembler.mov(Operand::Register(GPR0), Operand::Mem64BaseAndOffset(GPR0, Object::storage_offset() + Vector<Value>::outline_buffer_offset()));
+    m_assembler.add(Operand::Register(GPR0), Operand::Register(GPR1));
+}
+
+void Compiler::compile_instruction(Bytecode::Op::GetById const& instruction)
+{
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    load_vm_register(GPR0, instruction.base());
+    branch_if_not_object(GPR0, slow_case);
+    extract_object_pointer(GPR0);
+    load_address_of_cached_property(m_bytecode_executable.property_lookup_caches[instruction.cache_index()], slow_case);
+    m_assembler.mov(Operand::Register(GPR0), Operand::Mem64BaseAndOffset(GPR0, 0));
+    store_vm_register(instruction.dst(), GPR0);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+static void cxx_write_barrier(Value* base, Value const* value)
+{
+    base->as_object().write_barrier(*value);
+}
+
+void Compiler::compile_instruction(Bytecode::Op::PutById const& instruction)
+{
+    if (instruction.kind() != Bytecode::Op::PropertyKind::KeyValue) {
+        compile_generic(instruction);
+        return;
+    }
+
+    Assembler::Label slow_case;
+    Assembler::Label end;
+
+    // NOTE: Put caches only ever hold own data properties that we're allowed to overwrite in place.
+    load_vm_register(GPR0, instruction.base());
+    branch_if_not_object(GPR0, slow_case);
+    extract_object_pointer(GPR0);
+    load_address_of_cached_property(m_bytecode_executable.property_lookup_caches[instruction.cache_index()], slow_case);
+    load_vm_register(GPR1, instruction.src());
+    m_assembler.mov(Operand::Mem64BaseAndOffset(GPR0, 0), Operand::Register(GPR1));
+
+    // OPTIMIZATION: Only cells need to go through the write barrier.
+    extract_tag(GPR1, GPR1);
+    m_assembler.bitwise_and(Operand::Register(GPR1), Operand::Imm(IS_CELL_PATTERN));
+    m_assembler.jump_if(Operand::Register(GPR1), Assembler::Condition::NotEqualTo, Operand::Imm(IS_CELL_PATTERN), end);
+    load_address_of_vm_register(ARG0, instruction.base());
+    load_address_of_vm_register(ARG1, instruction.src());
+    native_call((void*)cxx_write_barrier);
+    m_assembler.jump(end);
+
+    slow_case.link(m_assembler);
+    compile_generic(instruction);
+    end.link(m_assembler);
+}
+
+bool Compiler::can_compile(Bytecode::Executable const& bytecode_executable)
+{
+    // FIXME: Support exception handlers, finally blocks and generators.
+    if (!bytecode_executable.exception_handlers.is_empty())
+        return false;
+
+    for (Bytecode::InstructionStreamIterator it(bytecode_executable.bytecode); !it.at_end(); ++it) {
+        switch ((*it).type()) {
+        case Bytecode::Instruction::Type::Await:
+        case Bytecode::Instruction::Type::Catch:
+        case Bytecode::Instruction::Type::ContinuePendingUnwind:
+        case Bytecode::Instruction::Type::EnterUnwindContext:
+        case Bytecode::Instruction::Type::LeaveFinally:
+        case Bytecode::Instruction::Type::LeaveUnwindContext:
+        case Bytecode::Instruction::Type::PrepareYield:
+        case Bytecode::Instruction::Type::RestoreScheduledJump:
+        case Bytecode::Instruction::Type::ScheduleJump:
+        case Bytecode::Instruction::Type::Yield:
+            return false;
+        default:
+            break;
+        }
+    }
+    return true;
+}
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable& bytecode_executable)
+{
+    if (!can_compile(bytecode_executable))
+        return nullptr;
+
+    Compiler compiler { bytecode_executable };
+    auto& assembler = compiler.m_assembler;
+
+    for (auto offset : bytecode_executable.basic_block_start_offsets)
+        compiler.m_block_labels.set(offset, {});
+
+    // The native code is entered at the start of a basic block, passed in as the last argument.
+    assembler.enter();
+    assembler.mov(Operand::Register(REGISTER_ARRAY_BASE), Operand::Register(ARG0));
+    assembler.mov(Operand::Register(INTERPRETER), Operand::Register(ARG1));
+    assembler.mov(Operand::Register(ARGUMENTS_BASE), Operand::Register(ARG2));
+    assembler.mov(Operand::Register(PROGRAM_COUNTER), Operand::Register(ARG3));
+    assembler.jump(Operand::Register(ARG4));
+
+    for (Bytecode::InstructionStreamIterator it(bytecode_executable.bytecode); !it.at_end(); ++it) {
+        auto const& instruction = *it;
+        compiler.m_current_offset = it.offset();
+
+        if (auto label = compiler.m_block_labels.find(it.offset()); label != compiler.m_block_labels.end()) {
+            label->value.link(assembler);
+            compiler.m_block_entry_offsets.set(it.offset(), compiler.m_output.size());
+        }
+
+        switch (instruction.type()) {
+#    define __BYTECODE_OP(op)                                                                     \
+    case Bytecode::Instruction::Type::op:                                                         \
+        compiler.compile_instruction(static_cast<Bytecode::Op::op const&>(instruction)); \
+        break;
+            ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#    undef __BYTECODE_OP
+        }
+    }
+
+    // NOTE: Every basic block ends in a terminator, so we should never run off the end.
+    assembler.verify_not_reached();
+
+    compiler.m_exit_label.link(assembler);
+    assembler.exit();
+
+    auto* code = mmap(nullptr, compiler.m_output.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        dbgln("JIT: Failed to allocate memory for native code: {}", AK::Error::from_errno(errno));
+        return nullptr;
+    }
+    memcpy(code, compiler.m_output.data(), compiler.m_output.size());
+    if (mprotect(code, compiler.m_output.size(), PROT_READ | PROT_EXEC) < 0) {
+        dbgln("JIT: Failed to make native code executable: {}", AK::Error::from_errno(errno));
+        munmap(code, compiler.m_output.size());
+        return nullptr;
+    }
+
+    return make<NativeExecutable>(code, compiler.m_output.size(), move(compiler.m_block_entry_offsets));
+}
+
+}
+
+#else
+
+namespace JS::JIT {
+
+OwnPtr<NativeExecutable> Compiler::compile(Bytecode::Executable&)
+{
+    return nullptr;
+}
+
+}
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/OwnPtr.h>
+#include <LibJIT/Assembler.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/JIT/NativeExecutable.h>
+
+namespace JS::JIT {
+
+// A baseline compiler: every bytecode instruction turns into a fixed sequence of machine code.
+// Common instructions get inline fast paths (Int32 arithmetic, property lookup caches),
+// everything else calls back into the instruction's regular implementation.
+class Compiler {
+public:
+    // How often an executable has to be entered (or loop back) before we compile it.
+    static constexpr u32 hotness_threshold = 16;
+
+    static OwnPtr<NativeExecutable> compile(Bytecode::Executable&);
+
+#ifdef JIT_ARCH_SUPPORTED
+private:
+    using Assembler = ::JIT::Assembler;
+
+    explicit Compiler(Bytecode::Executable& bytecode_executable)
+        : m_bytecode_executable(bytecode_executable)
+    {
+    }
+
+    static bool can_compile(Bytecode::Executable const&);
+
+    void compile_instruction(Bytecode::Op::Mov const&);
+    void compile_instruction(Bytecode::Op::GetArgument const&);
+    void compile_instruction(Bytecode::Op::SetArgument const&);
+    void compile_instruction(Bytecode::Op::End const&);
+    void compile_instruction(Bytecode::Op::Return const&);
+    void compile_instruction(Bytecode::Op::Jump const&);
+    void compile_instruction(Bytecode::Op::JumpIf const&);
+    void compile_instruction(Bytecode::Op::JumpTrue const&);
+    void compile_instruction(Bytecode::Op::JumpFalse const&);
+    void compile_instruction(Bytecode::Op::JumpNullish const&);
+    void compile_instruction(Bytecode::Op::JumpUndefined const&);
+    void compile_instruction(Bytecode::Op::Increment const&);
+    void compile_instruction(Bytecode::Op::PostfixIncrement const&);
+    void compile_instruction(Bytecode::Op::Decrement const&);
+    void compile_instruction(Bytecode::Op::GetById const&);
+    void compile_instruction(Bytecode::Op::PutById const&);
+
+#    define DECLARE_COMPILE_JUMP_COMPARISON(op_TitleCase, op_snake_case, numeric_operator) \
+        void compile_instruction(Bytecode::Op::Jump##op_TitleCase const&);
+    JS_ENUMERATE_COMPARISON_OPS(DECLARE_COMPILE_JUMP_COMPARISON)
+#    undef DECLARE_COMPILE_JUMP_COMPARISON
+
+#    define DECLARE_COMPILE_OP(OpTitleCase, op_snake_case) \
+        void compile_instruction(Bytecode::Op::OpTitleCase const&);
+    JS_ENUMERATE_COMMON_BINARY_OPS_WITH_FAST_PATH(DECLARE_COMPILE_OP)
+#    undef DECLARE_COMPILE_OP
+
+    // Everything without a fast path calls the instruction's execute_impl(), and leaves the executable if it threw.
+    template<typename OpType>
+    void compile_instruction(OpType const&);
+
+    template<typename OpType>
+    void compile_generic(OpType const&);
+
+    void compare_int32_operands(Bytecode::Operand lhs, Bytecode::Operand rhs, Assembler::Label& slow_case);
+    // Expects an object pointer in GPR0, and leaves the address of the cached property's value there.
+    void load_address_of_cached_property(Bytecode::PropertyLookupCache const&, Assembler::Label& slow_case);
+    void compile_to_boolean_and_jump(Bytecode::Operand condition, Assembler::Label& true_target, Assembler::Label& false_target);
+
+    void store_program_counter();
+    void load_vm_register(Assembler::Reg dst, Bytecode::Operand);
+    void store_vm_register(Bytecode::Operand, Assembler::Reg src);
+    void load_address_of_vm_register(Assembler::Reg dst, Bytecode::Operand);
+    void extract_tag(Assembler::Reg dst, Assembler::Reg value);
+    void branch_if_not_tag(Assembler::Reg value, u64 tag, Assembler::Label&);
+    void branch_if_not_object(Assembler::Reg value, Assembler::Label&);
+    void extract_object_pointer(Assembler::Reg);
+    void box_int32(Assembler::Reg);
+    void box_boolean(Assembler::Reg);
+    void native_call(void* function);
+    void leave_if_helper_threw();
+
+    Assembler::Label& label_for(Bytecode::Label const&);
+
+    Bytecode::Executable& m_bytecode_executable;
+    size_t m_current_offset { 0 };
+
+    Vector<u8> m_output;
+    Assembler m_assembler { m_output };
+    Assembler::Label m_exit_label;
+
+    // NOTE: Filled in before we start emitting code, so references into it stay valid.
+    HashMap<size_t, Assembler::Label> m_block_labels;
+    HashMap<size_t, size_t> m_block_entry_offsets;
+#endif
+};
+
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJIT/GDB.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/JIT/NativeExecutable.h>
+#include <sys/mman.h>
+
+namespace JS::JIT {
+
+NativeExecutable::NativeExecutable(void* code, size_t size, HashMap<size_t, size_t> block_entry_offsets)
+    : m_code(code)
+    , m_size(size)
+    , m_block_entry_offsets(move(block_entry_offsets))
+    , m_start_entry_offset(m_block_entry_offsets.get(0))
+{
+    // Let GDB know about the code, so it shows up in backtraces.
+    ReadonlyBytes code_bytes { static_cast<u8 const*>(m_code), m_size };
+    m_gdb_object = ::JIT::GDB::build_gdb_image(code_bytes, "LibJS JIT"sv, "NativeExecutable"sv);
+    if (m_gdb_object.has_value())
+        ::JIT::GDB::register_into_gdb(m_gdb_object->span());
+}
+
+NativeExecutable::~NativeExecutable()
+{
+    if (m_gdb_object.has_value())
+        ::JIT::GDB::unregister_from_gdb(m_gdb_object->span());
+    munmap(m_code, m_size);
+}
+
+bool NativeExecutable::run(Bytecode::Interpreter& interpreter, Value* registers_and_constants_and_locals, Value* arguments, size_t& program_counter) const
+{
+    Optional<size_t> entry_offset = m_start_entry_offset;
+    if (program_counter != 0)
+        entry_offset = m_block_entry_offsets.get(program_counter).copy();
+    if (!entry_offset.has_value())
+        return false;
+
+    using JITCode = void (*)(Value* registers_and_constants_and_locals, Bytecode::Interpreter*, Value* arguments, size_t* program_counter, u8 const* entry_point);
+    auto* code = static_cast<u8 const*>(m_code);
+    ((JITCode)m_code)(registers_and_constants_and_locals, &interpreter, arguments, &program_counter, code + *entry_offset);
+    return true;
+}
+
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/FixedArray.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/Types.h>
+#include <LibJS/Forward.h>
+
+namespace JS::JIT {
+
+// Machine code for a whole Bytecode::Executable, as produced by JIT::Compiler.
+// It can be entered at the start of any basic block, so a hot loop can switch over mid-execution.
+class NativeExecutable {
+    AK_MAKE_NONCOPYABLE(NativeExecutable);
+    AK_MAKE_NONMOVABLE(NativeExecutable);
+
+public:
+    NativeExecutable(void* code, size_t size, HashMap<size_t, size_t> block_entry_offsets);
+    ~NativeExecutable();
+
+    // Runs until the executable returns or throws, starting at the basic block at `program_counter`.
+    // The program counter is kept up to date whenever native code calls back into the runtime.
+    // Returns false (without running anything) if there is no native code for that block.
+    [[nodiscard]] bool run(Bytecode::Interpreter&, Value* registers_and_constants_and_locals, Value* arguments, size_t& program_counter) const;
+
+    size_t size() const { return m_size; }
+
+private:
+    void* m_code { nullptr };
+    size_t m_size { 0 };
+    HashMap<size_t, size_t> m_block_entry_offsets;
+    // Calls always enter at the very first block, so that one doesn't need a hash lookup.
+    Optional<size_t> m_start_entry_offset;
+    Optional<FixedArray<u8>> m_gdb_object;
+};
+
+}
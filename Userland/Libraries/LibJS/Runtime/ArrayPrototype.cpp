@@ -9,6 +9,7 @@
 
 #include <AK/Function.h>
 #include <AK/HashTable.h>
+#include <AK/QuickSort.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
 #include <LibJS/Runtime/AbstractOperations.h>
@@ -19,6 +20,7 @@
 #include <LibJS/Runtime/Error.h>
 #include <LibJS/Runtime/FunctionObject.h>
 #include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/IndexedProperties.h>
 #include <LibJS/Runtime/Map.h>
 #include <LibJS/Runtime/ObjectPrototype.h>
 #include <LibJS/Runtime/Realm.h>
@@ -31,6 +33,51 @@ JS_DEFINE_ALLOCATOR(ArrayPrototype);
 
 static HashTable<NonnullGCPtr<Object>> s_array_join_seen_objects;
 
+// OPTIMIZATION: Every index below the length of an array with packed simple storage is an own, writable data property.
+//               This means its elements can be read (and overwritten) directly, without going through [[HasProperty]],
+//               [[Get]] and [[Set]]: neither the prototype chain nor any getters or setters could observe the difference.
+static SimpleIndexedPropertyStorage* packed_array_storage(Object& object)
+{
+    if (!is<Array>(object) || object.may_interfere_with_indexed_property_access())
+        return nullptr;
+    auto* storage = object.indexed_properties().storage();
+    if (!storage || !storage->is_simple_storage())
+        return nullptr;
+    auto* simple_storage = static_cast<SimpleIndexedPropertyStorage*>(storage);
+    if (!simple_storage->is_packed())
+        return nullptr;
+    return simple_storage;
+}
+
+static Optional<Value> get_packed_array_element(Object& object, size_t index)
+{
+    auto const* storage = packed_array_storage(object);
+    if (!storage || index >= storage->array_like_size())
+        return {};
+    auto value = storage->elements().data()[index];
+    if (value.is_accessor())
+        return {};
+    return value;
+}
+
+// OPTIMIZATION: A plain, extensible array with a writable length accepts any new indexed data property,
+//               so CreateDataPropertyOrThrow() can go straight to its indexed property storage.
+static bool create_data_property_in_array_directly(Object& object, size_t index, Value value)
+{
+    if (!is<Array>(object) || object.may_interfere_with_indexed_property_access())
+        return false;
+    if (!static_cast<Array&>(object).length_is_writable() || !MUST(object.is_extensible()))
+        return false;
+    if (index > NumericLimits<u32>::max() - 1)
+        return false;
+    auto const* storage = object.indexed_properties().storage();
+    if (storage && !storage->is_simple_storage())
+        return false;
+    object.indexed_properties().put(index, value);
+    object.write_barrier(value);
+    return true;
+}
+
 ArrayPrototype::ArrayPrototype(Realm& realm)
     : Array(realm.intrinsics().object_prototype())
 {
@@ -379,6 +426,13 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::fill)
     else
         to = min(relative_end, length);
 
+    // OPTIMIZATION: Overwrite the elements of packed arrays in one go.
+    if (auto* storage = packed_array_storage(this_object); storage && from < to && to <= storage->array_like_size()) {
+        storage->fill(from, to, vm.argument(0));
+        this_object->write_barrier(vm.argument(0));
+        return this_object;
+    }
+
     for (u64 i = from; i < to; i++)
         TRY(this_object->set(i, vm.argument(0), Object::ShouldThrowExceptions::Yes));
 
@@ -412,16 +466,19 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::filter)
 
     // 7. Repeat, while k < len,
     for (; k < length; ++k) {
+        // NOTE: The callback may change the array in any way, so we have to check for packed storage on every iteration.
+        auto packed_element = get_packed_array_element(object, k);
+
         // a. Let Pk be ! ToString(𝔽(k)).
         auto property_key = PropertyKey { k };
 
         // b. Let kPresent be ? HasProperty(O, Pk).
-        auto k_present = TRY(object->has_property(property_key));
+        auto k_present = packed_element.has_value() || TRY(object->has_property(property_key));
 
         // c. If kPresent is true, then
         if (k_present) {
             // i. Let kValue be ? Get(O, Pk).
-            auto k_value = TRY(object->get(k));
+            auto k_value = packed_element.has_value() ? *packed_element : TRY(object->get(k));
 
             // ii. Let selected be ToBoolean(? Call(callbackfn, thisArg, « kValue, 𝔽(k), O »)).
             auto selected = TRY(call(vm, callback_function.as_function(), this_arg, k_value, Value(k), object)).to_boolean();
@@ -429,7 +486,8 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::filter)
             // iii. If selected is true, then
             if (selected) {
                 // 1. Perform ? CreateDataPropertyOrThrow(A, ! ToString(𝔽(to)), kValue).
-                TRY(array->create_data_property_or_throw(to, k_value));
+                if (!create_data_property_in_array_directly(*array, to, k_value))
+                    TRY(array->create_data_property_or_throw(to, k_value));
 
                 // 2. Set to to to + 1.
                 ++to;
@@ -795,6 +853,43 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::index_of)
         k = max(length + n, 0);
     }
 
+    // OPTIMIZATION: Nothing in the loop below has side effects, so we can search packed arrays with a loop
+    //               specialized for their element kind.
+    if (auto const* storage = packed_array_storage(object); storage && length <= storage->array_like_size()) {
+        auto elements = storage->elements().span().slice(0, length);
+        switch (storage->element_kind()) {
+        case ElementKind::PackedInt32: {
+            if (!search_element.is_integral_number())
+                return Value(-1);
+            auto search_value = search_element.as_double();
+            if (search_value < NumericLimits<i32>::min() || search_value > NumericLimits<i32>::max())
+                return Value(-1);
+            auto search_int = static_cast<i32>(search_value);
+            for (; k < length; ++k) {
+                if (elements[k].as_i32() == search_int)
+                    return Value(k);
+            }
+            return Value(-1);
+        }
+        case ElementKind::PackedDouble: {
+            if (!search_element.is_number())
+                return Value(-1);
+            auto search_value = search_element.as_double();
+            for (; k < length; ++k) {
+                if (elements[k].as_double() == search_value)
+                    return Value(k);
+            }
+            return Value(-1);
+        }
+        default:
+            for (; k < length && !elements[k].is_accessor(); ++k) {
+                if (is_strictly_equal(search_element, elements[k]))
+                    return Value(k);
+            }
+            break;
+        }
+    }
+
     // 10. Repeat, while k < len,
     for (; k < length; ++k) {
         auto property_key = PropertyKey { k };
@@ -955,22 +1050,26 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::map)
     // 5. Let k be 0.
     // 6. Repeat, while k < len,
     for (size_t k = 0; k < length; ++k) {
+        // NOTE: The callback may change the array in any way, so we have to check for packed storage on every iteration.
+        auto packed_element = get_packed_array_element(object, k);
+
         // a. Let Pk be ! ToString(𝔽(k)).
         auto property_key = PropertyKey { k };
 
         // b. Let kPresent be ? HasProperty(O, Pk).
-        auto k_present = TRY(object->has_property(property_key));
+        auto k_present = packed_element.has_value() || TRY(object->has_property(property_key));
 
         // c. If kPresent is true, then
         if (k_present) {
             // i. Let kValue be ? Get(O, Pk).
-            auto k_value = TRY(object->get(property_key));
+            auto k_value = packed_element.has_value() ? *packed_element : TRY(object->get(property_key));
 
             // ii. Let mappedValue be ? Call(callbackfn, thisArg, « kValue, 𝔽(k), O »).
             auto mapped_value = TRY(call(vm, callback_function.as_function(), this_arg, k_value, Value(k), object));
 
             // iii. Perform ? CreateDataPropertyOrThrow(A, Pk, mappedValue).
-            TRY(array->create_data_property_or_throw(property_key, mapped_value));
+            if (!create_data_property_in_array_directly(*array, k, mapped_value))
+                TRY(array->create_data_property_or_throw(property_key, mapped_value));
         }
 
         // d. Set k to k + 1.
@@ -1395,6 +1494,48 @@ ThrowCompletionOr<void> array_merge_sort(VM& vm, Function<ThrowCompletionOr<doub
     return {};
 }
 
+// Sorts the elements of a packed Int32 array the way Array.prototype.sort() does without a comparator, i.e. by their
+// string representations. Elements with the same string representation are equal, so we don't need a stable sort.
+static void sort_packed_int32_array(SimpleIndexedPropertyStorage& storage)
+{
+    struct SortEntry {
+        i32 value { 0 };
+        u8 length { 0 };
+        AK::Array<char, 11> characters;
+
+        StringView string() const { return { characters.data(), length }; }
+    };
+
+    auto length = storage.array_like_size();
+    Vector<SortEntry> entries;
+    entries.ensure_capacity(length);
+
+    for (size_t i = 0; i < length; ++i) {
+        SortEntry entry;
+        entry.value = storage.elements()[i].as_i32();
+
+        AK::Array<char, 10> reversed_digits;
+        size_t digit_count = 0;
+        auto magnitude = entry.value < 0 ? 0u - static_cast<u32>(entry.value) : static_cast<u32>(entry.value);
+        do {
+            reversed_digits[digit_count++] = '0' + (magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude != 0);
+
+        if (entry.value < 0)
+            entry.characters[entry.length++] = '-';
+        while (digit_count > 0)
+            entry.characters[entry.length++] = reversed_digits[--digit_count];
+
+        entries.unchecked_append(entry);
+    }
+
+    quick_sort(entries, [](auto const& a, auto const& b) { return a.string() < b.string(); });
+
+    for (size_t i = 0; i < length; ++i)
+        storage.put(i, Value(entries[i].value));
+}
+
 // 23.1.3.30 Array.prototype.sort ( comparefn ), https://tc39.es/ecma262/#sec-array.prototype.sort
 JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
 {
@@ -1409,6 +1550,14 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
     // 3. Let len be ? LengthOfArrayLike(obj).
     auto length = TRY(length_of_array_like(vm, object));
 
+    // OPTIMIZATION: Without a comparator, packed Int32 arrays can be sorted without calling back into the engine.
+    if (comparefn.is_undefined()) {
+        if (auto* storage = packed_array_storage(object); storage && storage->element_kind() == ElementKind::PackedInt32 && storage->array_like_size() == length) {
+            sort_packed_int32_array(*storage);
+            return object;
+        }
+    }
+
     // 4. Let SortCompare be a new Abstract Closure with parameters (x, y) that captures comparefn and performs the following steps when called:
     Function<ThrowCompletionOr<double>(Value, Value)> sort_compare = [&](auto x, auto y) -> ThrowCompletionOr<double> {
         // a. Return ? CompareArrayElements(x, y, comparefn).
@@ -10,6 +10,15 @@
 
 namespace JS {
 
+static ElementKind element_type_of(Value value)
+{
+    if (value.is_int32())
+        return ElementKind::PackedInt32;
+    if (value.is_number())
+        return ElementKind::PackedDouble;
+    return ElementKind::PackedGeneric;
+}
+
 constexpr size_t const SPARSE_ARRAY_HOLE_THRESHOLD = 200;
 constexpr size_t const LENGTH_SETTER_GENERIC_STORAGE_THRESHOLD = 4 * MiB;
 
@@ -18,6 +27,12 @@ SimpleIndexedPropertyStorage::SimpleIndexedPropertyStorage(Vector<Value>&& initi
     , m_array_size(initial_values.size())
     , m_packed_elements(move(initial_values))
 {
+    for (auto value : m_packed_elements) {
+        if (value.is_empty())
+            ++m_hole_count;
+        else
+            m_element_type = max(m_element_type, element_type_of(value));
+    }
 }
 
 bool SimpleIndexedPropertyStorage::has_index(u32 index) const
@@ -43,39 +58,73 @@ void SimpleIndexedPropertyStorage::grow_storage_if_needed()
     }
 }
 
+void SimpleIndexedPropertyStorage::set_element(size_t index, Value value)
+{
+    auto& element = m_packed_elements.data()[index];
+    if (element.is_empty())
+        --m_hole_count;
+    if (value.is_empty())
+        ++m_hole_count;
+    else
+        m_element_type = max(m_element_type, element_type_of(value));
+    element = value;
+}
+
 void SimpleIndexedPropertyStorage::put(u32 index, Value value, PropertyAttributes attributes)
 {
     VERIFY(attributes == default_attributes);
 
     if (index >= m_array_size) {
+        // Everything from the old end up to and including the new element starts out as a hole.
+        m_hole_count += index - m_array_size + 1;
         m_array_size = index + 1;
         grow_storage_if_needed();
     }
-    m_packed_elements[index] = value;
+    set_element(index, value);
+}
+
+void SimpleIndexedPropertyStorage::fill(size_t from, size_t to, Value value)
+{
+    VERIFY(from <= to && to <= m_array_size);
+    for (size_t i = from; i < to; ++i)
+        set_element(i, value);
 }
 
 void SimpleIndexedPropertyStorage::remove(u32 index)
 {
     VERIFY(index < m_array_size);
-    m_packed_elements[index] = {};
+    set_element(index, {});
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_first()
 {
     m_array_size--;
-    return { m_packed_elements.take_first(), default_attributes };
+    auto first_element = m_packed_elements.take_first();
+    if (first_element.is_empty())
+        --m_hole_count;
+    return { first_element, default_attributes };
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 {
     m_array_size--;
     auto last_element = m_packed_elements[m_array_size];
+    if (last_element.is_empty())
+        --m_hole_count;
     m_packed_elements[m_array_size] = {};
     return { last_element, default_attributes };
 }
 
 bool SimpleIndexedPropertyStorage::set_array_like_size(size_t new_size)
 {
+    if (new_size > m_array_size) {
+        m_hole_count += new_size - m_array_size;
+    } else {
+        for (size_t i = new_size; i < m_array_size; ++i) {
+            if (m_packed_elements[i].is_empty())
+                --m_hole_count;
+        }
+    }
     m_array_size = new_size;
     m_packed_elements.resize_and_keep_capacity(new_size);
     return true;
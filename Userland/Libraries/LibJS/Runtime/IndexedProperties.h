@@ -23,6 +23,20 @@ class IndexedProperties;
 class IndexedPropertyIterator;
 class GenericIndexedPropertyStorage;
 
+// What we know about the elements of a SimpleIndexedPropertyStorage, so builtins can pick a specialized loop.
+// "Packed" means there are no holes below the array-like size. "Double" means every element is a Number.
+// The element type only ever gets more general, e.g. storing a string into an Int32 array makes it Generic for good.
+enum class ElementKind : u8 {
+    PackedInt32 = 0,
+    PackedDouble = 1,
+    PackedGeneric = 2,
+    HoleyInt32 = 4,
+    HoleyDouble = 5,
+    HoleyGeneric = 6,
+};
+
+constexpr bool is_packed(ElementKind kind) { return (to_underlying(kind) & 4) == 0; }
+
 class IndexedPropertyStorage {
 public:
     virtual ~IndexedPropertyStorage() = default;
@@ -74,6 +88,12 @@ public:
 
     Vector<Value> const& elements() const { return m_packed_elements; }
 
+    ElementKind element_kind() const { return static_cast<ElementKind>(to_underlying(m_element_type) | (m_hole_count > 0 ? 4 : 0)); }
+    bool is_packed() const { return m_hole_count == 0; }
+
+    // Overwrites the existing elements in [from, to), which has to be inside the array-like size.
+    void fill(size_t from, size_t to, Value);
+
     [[nodiscard]] bool inline_has_index(u32 index) const
     {
         return index < m_array_size && !m_packed_elements.data()[index].is_empty();
@@ -90,9 +110,16 @@ private:
     friend GenericIndexedPropertyStorage;
 
     void grow_storage_if_needed();
+    void set_element(size_t index, Value);
 
     size_t m_array_size { 0 };
     Vector<Value> m_packed_elements;
+
+    // One of the packed element kinds, describing all non-empty elements.
+    ElementKind m_element_type { ElementKind::PackedInt32 };
+
+    // The number of empty elements below m_array_size.
+    size_t m_hole_count { 0 };
 };
 
 class GenericIndexedPropertyStorage final : public IndexedPropertyStorage {
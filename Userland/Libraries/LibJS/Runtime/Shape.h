@@ -37,6 +37,7 @@ struct TransitionKey {
 class PrototypeChainValidity final : public Cell {
     JS_CELL(PrototypeChainValidity, Cell);
     JS_DECLARE_ALLOCATOR(PrototypeChainValidity);
+    JS_DECLARE_WRITE_BARRIER_PROTECTED(PrototypeChainValidity);
 
 public:
     [[nodiscard]] bool is_valid() const { return m_valid; }
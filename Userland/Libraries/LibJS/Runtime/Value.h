@@ -18,6 +18,7 @@
 #include <AK/String.h>
 #include <AK/Types.h>
 #include <LibJS/Forward.h>
+#include <LibJS/Heap/Cell.h>
 #include <LibJS/Heap/GCPtr.h>
 #include <math.h>
 
@@ -589,6 +590,12 @@ double string_to_number(StringView);
 
 inline bool Value::operator==(Value const& value) const { return same_value(*this, value); }
 
+ALWAYS_INLINE void Cell::write_barrier(Value value)
+{
+    if (value.is_cell())
+        write_barrier(&value.as_cell());
+}
+
 }
 
 namespace AK {
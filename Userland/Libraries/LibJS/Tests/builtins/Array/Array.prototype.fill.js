@@ -16,9 +16,33 @@ test("basic functionality", () => {
     expect([1, 2, 3].fill(4, -3, -2)).toEqual([4, 2, 3]);
     expect([1, 2, 3].fill(4, NaN, NaN)).toEqual([1, 2, 3]);
     expect([1, 2, 3].fill(4, 3, 5)).toEqual([1, 2, 3]);
+    expect([1, 2, 3].fill(4, 2, 1)).toEqual([1, 2, 3]);
+    expect([1, 2, 3].fill(4, -1, -2)).toEqual([1, 2, 3]);
     expect(Array(3).fill(4)).toEqual([4, 4, 4]);
 });
 
+test("arrays with holes are filled through setters on the prototype chain", () => {
+    var setterCalls = 0;
+    Object.defineProperty(Array.prototype, 1, {
+        set() {
+            ++setterCalls;
+        },
+        configurable: true,
+    });
+    var array = [1, , 3];
+    array.fill(0);
+    delete Array.prototype[1];
+    expect(setterCalls).toBe(1);
+    expect(array).toEqual([0, undefined, 0]);
+    expect(1 in array).toBeFalse();
+});
+
+test("frozen arrays", () => {
+    var array = Object.freeze([1, 2, 3]);
+    expect(() => array.fill(0)).toThrowWithMessage(TypeError, "Object's [[Set]] method returned false");
+    expect(array).toEqual([1, 2, 3]);
+});
+
 test("is unscopable", () => {
     expect(Array.prototype[Symbol.unscopables].fill).toBeTrue();
     const array = [];
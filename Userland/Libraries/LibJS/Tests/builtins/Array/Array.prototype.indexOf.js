@@ -23,3 +23,38 @@ test("basic functionality", () => {
     expect([].indexOf()).toBe(-1);
     expect([undefined].indexOf()).toBe(0);
 });
+
+test("arrays of numbers", () => {
+    var ints = [3, 1, 0, 2, -5];
+    expect(ints.indexOf(2)).toBe(3);
+    expect(ints.indexOf(2.0)).toBe(3);
+    expect(ints.indexOf(-0)).toBe(2);
+    expect(ints.indexOf(-5)).toBe(4);
+    expect(ints.indexOf(1.5)).toBe(-1);
+    expect(ints.indexOf(NaN)).toBe(-1);
+    expect(ints.indexOf("2")).toBe(-1);
+    expect(ints.indexOf(4294967298)).toBe(-1);
+    expect(ints.indexOf(2147483648)).toBe(-1);
+    expect(ints.indexOf(-2147483649)).toBe(-1);
+    expect(ints.indexOf(1e300)).toBe(-1);
+    expect(ints.indexOf(Infinity)).toBe(-1);
+    expect(ints.indexOf(-Infinity)).toBe(-1);
+
+    var extremes = [2147483647, -2147483648];
+    expect(extremes.indexOf(2147483647)).toBe(0);
+    expect(extremes.indexOf(-2147483648)).toBe(1);
+
+    var doubles = [0.5, 1, -0, NaN, Infinity];
+    expect(doubles.indexOf(1)).toBe(1);
+    expect(doubles.indexOf(0)).toBe(2);
+    expect(doubles.indexOf(NaN)).toBe(-1);
+    expect(doubles.indexOf(Infinity)).toBe(4);
+    expect(doubles.indexOf(Infinity, -1)).toBe(4);
+    expect(doubles.indexOf("0.5")).toBe(-1);
+});
+
+test("arrays with holes", () => {
+    var array = [1, , 3];
+    expect(array.indexOf(undefined)).toBe(-1);
+    expect(array.indexOf(3)).toBe(2);
+});
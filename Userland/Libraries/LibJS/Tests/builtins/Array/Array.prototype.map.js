@@ -49,3 +49,16 @@ describe("normal behavior", () => {
         expect(squaredNumbers).toEqual([0, 1, 4, 9, 16]);
     });
 });
+
+test("callback changing the array", () => {
+    var array = [1, 2, 3, 4];
+    var result = array.map((value, index) => {
+        if (index === 0) {
+            array.length = 2;
+            array.push("x");
+        }
+        return value;
+    });
+    expect(result).toEqual([1, 2, "x", undefined]);
+    expect(3 in result).toBeFalse();
+});
@@ -202,3 +202,11 @@ describe("Array.prototype.sort", () => {
         Array.prototype.sort.call(obj);
     });
 });
+
+test("integer arrays are sorted by their string representation", () => {
+    expect([10, 9, 1, -1, -10, 0, 100, 2147483647, -2147483648].sort()).toEqual([
+        -1, -10, -2147483648, 0, 1, 10, 100, 2147483647, 9,
+    ]);
+    expect([3, 2, 1].sort((a, b) => a - b)).toEqual([1, 2, 3]);
+    expect([3, 2, , 1].sort()).toEqual([1, 2, 3, undefined]);
+});
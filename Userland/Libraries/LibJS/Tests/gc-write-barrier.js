@@ -0,0 +1,97 @@
+test("old cells remember the young cells stored into them", () => {
+    class WithPrivateField {
+        #field = null;
+        setField(value) {
+            this.#field = value;
+        }
+        getField() {
+            return this.#field;
+        }
+    }
+
+    // Everything that survives a full collection is in the old generation.
+    const object = {};
+    const array = [1, 2, 3];
+    const withPrivateField = new WithPrivateField();
+    gc();
+
+    object.property = { name: "property" };
+    object[0] = { name: "indexed" };
+    Object.setPrototypeOf(object, { name: "prototype" });
+    array.push({ name: "pushed" });
+    array[0] = { name: "stored" };
+    array.fill(`filled ${array.length}`, 1, 3);
+    withPrivateField.setField({ name: "private" });
+    expect(countWriteBarrierViolations()).toBe(0);
+
+    // Allocate enough short-lived garbage to trigger a few young generation collections.
+    for (let i = 0; i < 100_000; ++i) {
+        const garbage = { index: i };
+    }
+
+    expect(object.property.name).toBe("property");
+    expect(object[0].name).toBe("indexed");
+    expect(Object.getPrototypeOf(object).name).toBe("prototype");
+    expect(array[0].name).toBe("stored");
+    expect(array[1]).toBe("filled 4");
+    expect(array[2]).toBe("filled 4");
+    expect(array[3].name).toBe("pushed");
+    expect(withPrivateField.getField().name).toBe("private");
+    expect(countWriteBarrierViolations()).toBe(0);
+});
+
+test("cells moved between marked and unmarked cells during incremental marking survive", () => {
+    const holders = [];
+    for (let i = 0; i < 200; ++i) holders.push({ value: { index: i }, list: [{ index: i }] });
+    gc();
+
+    startIncrementalGC();
+    for (let round = 0; round < 100; ++round) {
+        stepIncrementalGC(16);
+
+        // Every value moves into the previous holder, which may already have been marked, while the holder it came
+        // from may not have been. Only the write barrier can tell the collector about that.
+        const first = holders[0].value;
+        const firstListEntry = holders[0].list[0];
+        for (let i = 0; i < holders.length - 1; ++i) {
+            holders[i].value = holders[i + 1].value;
+            holders[i].list[0] = holders[i + 1].list[0];
+        }
+        holders[holders.length - 1].value = first;
+        holders[holders.length - 1].list[0] = firstListEntry;
+
+        holders[round].fresh = { round };
+    }
+
+    while (!stepIncrementalGC(16)) {}
+    expect(countWriteBarrierViolations()).toBe(0);
+    finishIncrementalGC();
+
+    for (let i = 0; i < holders.length; ++i) {
+        expect(holders[i].value.index).toBe((i + 100) % holders.length);
+        expect(holders[i].list[0].index).toBe((i + 100) % holders.length);
+    }
+    for (let round = 0; round < 100; ++round) expect(holders[round].fresh.round).toBe(round);
+});
+
+test("cells stored into cells allocated during incremental marking survive", () => {
+    gc();
+
+    startIncrementalGC();
+    const allocatedWhileMarking = [];
+    for (let i = 0; i < 100; ++i) {
+        stepIncrementalGC(16);
+        const object = { index: i };
+        allocatedWhileMarking.push(object);
+        object.child = { index: i };
+    }
+
+    while (!stepIncrementalGC(16)) {}
+    expect(countWriteBarrierViolations()).toBe(0);
+    finishIncrementalGC();
+
+    for (let i = 0; i < allocatedWhileMarking.length; ++i) {
+        expect(allocatedWhileMarking[i].index).toBe(i);
+        expect(allocatedWhileMarking[i].child.index).toBe(i);
+    }
+});
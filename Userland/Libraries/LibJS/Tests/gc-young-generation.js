@@ -0,0 +1,36 @@
+test("young cells stored into old cells survive a young generation collection", () => {
+    // Everything that survives a full collection is in the old generation.
+    const old = { children: [] };
+    gc();
+
+    // Allocate enough short-lived garbage to trigger a few young generation collections,
+    // while the old object keeps a handful of young ones alive.
+    for (let i = 0; i < 200_000; ++i) {
+        const young = { index: i, name: `object ${i}` };
+        if (i % 1000 === 0) old.children.push(young);
+    }
+
+    expect(old.children).toHaveLength(200);
+    for (let i = 0; i < old.children.length; ++i) {
+        expect(old.children[i].index).toBe(i * 1000);
+        expect(old.children[i].name).toBe(`object ${i * 1000}`);
+    }
+});
+
+test("young cells only reachable through other young cells survive", () => {
+    const old = {};
+    gc();
+
+    let chain = null;
+    for (let i = 0; i < 100_000; ++i) {
+        chain = { next: chain, value: i };
+        if (i % 10_000 === 0) old.latest = chain;
+    }
+
+    let length = 0;
+    for (let link = old.latest; link; link = link.next) {
+        expect(link.value).toBe(90_000 - length);
+        ++length;
+    }
+    expect(length).toBe(90_001);
+});
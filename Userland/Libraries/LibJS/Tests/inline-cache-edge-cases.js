@@ -16,3 +16,92 @@ test("Inline cache invalidated by deleting property from unique shape", () => {
     expect(first).toBe(2);
     expect(second).toBeUndefined();
 });
+
+test("Polymorphic inline cache returns the right property for each shape", () => {
+    const objects = [{ x: 1 }, { a: 0, x: 2 }, { a: 0, b: 0, x: 3 }, { a: 0, b: 0, c: 0, x: 4 }];
+
+    function ic(o) {
+        return o.x;
+    }
+
+    for (let i = 0; i < 3; ++i) {
+        for (let j = 0; j < objects.length; ++j) expect(ic(objects[j])).toBe(j + 1);
+    }
+});
+
+test("Megamorphic inline cache returns the right property for each shape", () => {
+    const objects = [];
+    for (let i = 0; i < 16; ++i) {
+        const o = {};
+        for (let j = 0; j < i; ++j) o["p" + j] = j;
+        o.x = i;
+        objects.push(o);
+    }
+
+    function get(o) {
+        return o.x;
+    }
+
+    function put(o, value) {
+        o.x = value;
+    }
+
+    for (let i = 0; i < 3; ++i) {
+        for (let j = 0; j < objects.length; ++j) {
+            put(objects[j], j * 2 + i);
+            expect(get(objects[j])).toBe(j * 2 + i);
+        }
+    }
+    expect(get({ y: 1 })).toBeUndefined();
+});
+
+test("Megamorphic put cache does not write to non-writable properties", () => {
+    const objects = [];
+    for (let i = 0; i < 8; ++i) {
+        const o = {};
+        for (let j = 0; j < i; ++j) o["p" + j] = j;
+        o.x = i;
+        objects.push(o);
+    }
+
+    function get(o) {
+        return o.x;
+    }
+
+    function put(o, value) {
+        o.x = value;
+    }
+
+    const frozen = Object.freeze({ x: "frozen" });
+    for (const o of objects) {
+        put(o, 1);
+        get(o);
+    }
+    expect(get(frozen)).toBe("frozen");
+    put(frozen, 1);
+    expect(get(frozen)).toBe("frozen");
+});
+
+test("Polymorphic inline cache for prototype chain properties is invalidated", () => {
+    class A {
+        method() {
+            return "A";
+        }
+    }
+    class B {
+        method() {
+            return "B";
+        }
+    }
+    const objects = [new A(), new B()];
+
+    function call(o) {
+        return o.method();
+    }
+
+    expect(call(objects[0])).toBe("A");
+    expect(call(objects[1])).toBe("B");
+    A.prototype.method = () => "changed";
+    expect(call(objects[0])).toBe("changed");
+    expect(call(objects[1])).toBe("B");
+});
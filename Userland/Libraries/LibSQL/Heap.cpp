@@ -9,11 +9,23 @@
 #include <AK/Format.h>
 #include <AK/QuickSort.h>
 #include <LibCore/System.h>
+#include <LibCrypto/Checksum/CRC32.h>
 #include <LibSQL/Heap.h>
 #include <sys/stat.h>
 
 namespace SQL {
 
+// Every commit is appended to the write-ahead log as a single record: a header with a magic number and the number of
+// blocks in it, the index and contents of each of those blocks, and a CRC32 of all that to recognize torn writes.
+constexpr static u32 WAL_RECORD_MAGIC = 0x4c415753; // "SWAL"
+constexpr static size_t WAL_RECORD_HEADER_SIZE = 2 * sizeof(u32);
+constexpr static size_t WAL_RECORD_ENTRY_SIZE = sizeof(Block::Index) + Block::SIZE;
+
+static ByteString write_ahead_log_name(StringView heap_name)
+{
+    return ByteString::formatted("{}-wal", heap_name);
+}
+
 ErrorOr<NonnullRefPtr<Heap>> Heap::create(ByteString file_name)
 {
     return adopt_nonnull_ref_or_enomem(new (nothrow) Heap(move(file_name)));
@@ -26,10 +38,16 @@ Heap::Heap(ByteString file_name)
 
 Heap::~Heap()
 {
-    if (m_file && !m_write_ahead_log.is_empty()) {
-        if (auto maybe_error = flush(); maybe_error.is_error())
-            warnln("~Heap({}): {}", name(), maybe_error.error());
-    }
+    if (!m_file)
+        return;
+
+    // Leave a heap file behind that doesn't need its write-ahead log
+    if (auto maybe_error = flush(); maybe_error.is_error())
+        warnln("~Heap({}): {}", name(), maybe_error.error());
+    else if (auto maybe_error = checkpoint(); maybe_error.is_error())
+        warnln("~Heap({}): {}", name(), maybe_error.error());
+    else if (auto maybe_error = Core::System::unlink(write_ahead_log_name(name())); maybe_error.is_error())
+        warnln("~Heap({}): {}", name(), maybe_error.error());
 }
 
 ErrorOr<void> Heap::open()
@@ -50,37 +68,53 @@ ErrorOr<void> Heap::open()
         file_size = stat_buffer.st_size;
     }
 
+    if (file_size > 0 && file_size < Block::SIZE) {
+        warnln("Heap::open({}): file is too small to be a heap file"sv, name());
+        return Error::from_string_literal("Heap::open(): file is too small to be a heap file");
+    }
+
     if (file_size > 0) {
         m_next_block = file_size / Block::SIZE;
         m_highest_block_written = m_next_block - 1;
     }
 
-    auto file = TRY(Core::File::open(name(), Core::File::OpenMode::ReadWrite));
-    m_file = TRY(Core::InputBufferedFile::create(move(file)));
+    if (m_buffer_pool.is_empty())
+        m_buffer_pool = TRY(ByteBuffer::create_uninitialized(BUFFER_POOL_SIZE * Block::SIZE));
+
+    m_file = TRY(Core::File::open(name(), Core::File::OpenMode::ReadWrite));
+
+    // Make sure that this is a heap file before we create a write-ahead log next to it
+    auto open_existing_file = [&]() -> ErrorOr<void> {
+        if (file_size > 0)
+            TRY(read_zero_block());
+        TRY(open_write_ahead_log());
+        if (m_wal_block_offsets.contains(0))
+            TRY(read_zero_block());
+        return {};
+    };
+    if (auto error_maybe = open_existing_file(); error_maybe.is_error()) {
+        close_files();
+        return error_maybe.release_error();
+    }
 
-    if (file_size > 0) {
-        if (auto error_maybe = read_zero_block(); error_maybe.is_error()) {
-            m_file = nullptr;
-            return error_maybe.release_error();
-        }
-    } else {
+    if (file_size == 0 && !m_wal_block_offsets.contains(0))
         TRY(initialize_zero_block());
-    }
 
     // FIXME: We should more gracefully handle version incompatibilities. For now, we drop the database.
     if (m_version != VERSION) {
         dbgln_if(SQL_DEBUG, "Heap file {} opened has incompatible version {}. Deleting for version {}.", name(), m_version, VERSION);
-        m_file = nullptr;
+        close_files();
 
         TRY(Core::System::unlink(name()));
+        TRY(Core::System::unlink(write_ahead_log_name(name())));
         return open();
     }
 
     // Perform a heap scan to find all free blocks
     // FIXME: this is very inefficient; store free blocks in a persistent heap structure
     for (Block::Index index = 1; index <= m_highest_block_written; ++index) {
-        auto block_data = TRY(read_raw_block(index));
-        auto size_in_bytes = *reinterpret_cast<u32*>(block_data.data());
+        auto block = TRY(read_raw_block(index));
+        auto size_in_bytes = *reinterpret_cast<u32 const*>(block.bytes().data());
         if (size_in_bytes == 0)
             TRY(m_free_block_indices.try_append(index));
     }
@@ -89,15 +123,83 @@ ErrorOr<void> Heap::open()
     return {};
 }
 
+ErrorOr<void> Heap::open_write_ahead_log()
+{
+    m_wal_file = TRY(Core::File::open(write_ahead_log_name(name()), Core::File::OpenMode::ReadWrite));
+    TRY(replay_write_ahead_log());
+
+    if (!m_wal_block_offsets.is_empty())
+        m_next_block = max(m_next_block, m_highest_block_written + 1);
+
+    // The blocks in the log supersede anything we might have read from the heap file itself
+    m_buffer_pool_frame_indices.clear();
+    m_buffer_pool_frames.fill({});
+    return {};
+}
+
+ErrorOr<void> Heap::replay_write_ahead_log()
+{
+    // Every commit that made it into the log completely is part of the heap, everything after the first one that didn't
+    // (because we crashed while writing it) is discarded.
+    auto log = TRY(m_wal_file->read_until_eof());
+    size_t offset = 0;
+    while (log.size() - offset >= WAL_RECORD_HEADER_SIZE) {
+        auto magic = *reinterpret_cast<u32 const*>(log.offset_pointer(offset));
+        size_t block_count = *reinterpret_cast<u32 const*>(log.offset_pointer(offset + sizeof(u32)));
+        if (magic != WAL_RECORD_MAGIC || block_count == 0)
+            break;
+
+        auto record_size = WAL_RECORD_HEADER_SIZE + block_count * WAL_RECORD_ENTRY_SIZE + sizeof(u32);
+        if (log.size() - offset < record_size)
+            break;
+        auto checksum = *reinterpret_cast<u32 const*>(log.offset_pointer(offset + record_size - sizeof(u32)));
+        if (Crypto::Checksum::CRC32 { log.bytes().slice(offset, record_size - sizeof(u32)) }.digest() != checksum)
+            break;
+
+        for (size_t i = 0; i < block_count; ++i) {
+            auto entry_offset = offset + WAL_RECORD_HEADER_SIZE + i * WAL_RECORD_ENTRY_SIZE;
+            auto index = *reinterpret_cast<Block::Index const*>(log.offset_pointer(entry_offset));
+            TRY(m_wal_block_offsets.try_set(index, entry_offset + sizeof(Block::Index)));
+            if (index > m_highest_block_written)
+                m_highest_block_written = index;
+        }
+        offset += record_size;
+    }
+
+    if (offset != log.size()) {
+        dbgln_if(SQL_DEBUG, "Discarding {} bytes of incomplete commits at the end of the WAL of {}", log.size() - offset, name());
+        TRY(m_wal_file->truncate(offset));
+    }
+    m_wal_size = offset;
+
+    dbgln_if(SQL_DEBUG, "Replayed WAL of {}; number of blocks = {}", name(), m_wal_block_offsets.size());
+    return {};
+}
+
+void Heap::close_files()
+{
+    m_file = nullptr;
+    m_wal_file = nullptr;
+    m_next_block = 1;
+    m_highest_block_written = 0;
+    m_free_block_indices.clear();
+    m_uncommitted_blocks.clear();
+    m_wal_block_offsets.clear();
+    m_wal_size = 0;
+    m_buffer_pool_frame_indices.clear();
+    m_buffer_pool_frames.fill({});
+    m_clock_hand = 0;
+}
+
 ErrorOr<size_t> Heap::file_size_in_bytes() const
 {
-    TRY(m_file->seek(0, SeekMode::FromEndPosition));
-    return TRY(m_file->tell());
+    // Blocks that are still in the write-ahead log end up in the heap file once it is checkpointed
+    return (static_cast<size_t>(m_highest_block_written) + 1) * Block::SIZE;
 }
 
 bool Heap::has_block(Block::Index index) const
 {
-    return (index <= m_highest_block_written || m_write_ahead_log.contains(index))
+    return (index <= m_highest_block_written || m_uncommitted_blocks.contains(index))
         && !m_free_block_indices.contains_slow(index);
 }
 
@@ -115,9 +217,9 @@ ErrorOr<ByteBuffer> Heap::read_storage(Block::Index index)
     // Reconstruct the data storage from a potential chain of blocks
     ByteBuffer data;
     while (index > 0) {
-        auto block = TRY(read_block(index));
+        auto block = TRY(read_raw_block(index));
         dbgln_if(SQL_DEBUG, "  -> {} bytes", block.size_in_bytes());
-        TRY(data.try_append(block.data().bytes().slice(0, block.size_in_bytes())));
+        TRY(data.try_append(block.data()));
         index = block.next_block();
     }
     return data;
@@ -141,16 +243,9 @@ ErrorOr<void> Heap::write_storage(Block::Index index, ReadonlyBytes data)
         auto block_data_size = AK::min(remaining_size, Block::DATA_SIZE);
         remaining_size -= block_data_size;
 
-        ByteBuffer block_data;
-        if (has_block(index)) {
-            auto existing_block = TRY(read_block(index));
-            block_data = existing_block.data();
-            TRY(block_data.try_resize(block_data_size));
-            existing_next_block_index = existing_block.next_block();
-        } else {
-            block_data = TRY(ByteBuffer::create_uninitialized(block_data_size));
-            existing_next_block_index = 0;
-        }
+        // The block's data gets overwritten entirely, we only need to know where its chain continues
+        existing_next_block_index = has_block(index) ? TRY(read_raw_block(index)).next_block() : 0;
+        auto block_data = TRY(ByteBuffer::create_uninitialized(block_data_size));
 
         Block::Index next_block_index = existing_next_block_index;
         if (next_block_index == 0 && remaining_size > 0)
@@ -172,30 +267,97 @@ ErrorOr<void> Heap::write_storage(Block::Index index, ReadonlyBytes data)
     return {};
 }
 
-ErrorOr<ByteBuffer> Heap::read_raw_block(Block::Index index)
+Heap::PinnedBlock::PinnedBlock(Heap& heap, Optional<size_t> frame_index, ReadonlyBytes bytes)
+    : m_heap(&heap)
+    , m_frame_index(frame_index)
+    , m_bytes(bytes)
+{
+}
+
+Heap::PinnedBlock::PinnedBlock(PinnedBlock&& other)
+    : m_heap(exchange(other.m_heap, nullptr))
+    , m_frame_index(exchange(other.m_frame_index, {}))
+    , m_bytes(other.m_bytes)
+{
+}
+
+Heap::PinnedBlock::~PinnedBlock()
+{
+    if (m_heap && m_frame_index.has_value())
+        m_heap->unpin_frame(*m_frame_index);
+}
+
+ErrorOr<Heap::PinnedBlock> Heap::read_raw_block(Block::Index index)
 {
     VERIFY(m_file);
     VERIFY(index < m_next_block);
 
-    if (auto wal_entry = m_write_ahead_log.get(index); wal_entry.has_value())
-        return wal_entry.value();
+    if (auto uncommitted_block = m_uncommitted_blocks.find(index); uncommitted_block != m_uncommitted_blocks.end())
+        return PinnedBlock { *this, {}, uncommitted_block->value.bytes() };
 
-    TRY(m_file->seek(index * Block::SIZE, SeekMode::SetPosition));
-    auto buffer = TRY(ByteBuffer::create_uninitialized(Block::SIZE));
-    TRY(m_file->read_until_filled(buffer));
-    return buffer;
+    size_t frame_index;
+    if (auto cached_frame_index = m_buffer_pool_frame_indices.get(index); cached_frame_index.has_value()) {
+        frame_index = cached_frame_index.value();
+    } else {
+        frame_index = TRY(find_free_frame());
+        auto& frame = m_buffer_pool_frames[frame_index];
+        if (frame.is_valid) {
+            m_buffer_pool_frame_indices.remove(frame.index);
+            frame.is_valid = false;
+        }
+
+        TRY(read_committed_block(index, m_buffer_pool.bytes().slice(frame_index * Block::SIZE, Block::SIZE)));
+        TRY(m_buffer_pool_frame_indices.try_set(index, frame_index));
+        frame.index = index;
+        frame.is_valid = true;
+    }
+
+    auto& frame = m_buffer_pool_frames[frame_index];
+    frame.pin_count++;
+    frame.is_referenced = true;
+    return PinnedBlock { *this, frame_index, m_buffer_pool.bytes().slice(frame_index * Block::SIZE, Block::SIZE) };
 }
 
-ErrorOr<Block> Heap::read_block(Block::Index index)
+ErrorOr<void> Heap::read_committed_block(Block::Index index, Bytes buffer)
 {
-    dbgln_if(SQL_DEBUG, "{}({})", __FUNCTION__, index);
+    VERIFY(buffer.size() == Block::SIZE);
+
+    if (auto wal_offset = m_wal_block_offsets.get(index); wal_offset.has_value()) {
+        TRY(m_wal_file->seek(wal_offset.value(), SeekMode::SetPosition));
+        TRY(m_wal_file->read_until_filled(buffer));
+        return {};
+    }
+
+    TRY(m_file->seek(static_cast<u64>(index) * Block::SIZE, SeekMode::SetPosition));
+    TRY(m_file->read_until_filled(buffer));
+    return {};
+}
 
-    auto buffer = TRY(read_raw_block(index));
-    auto size_in_bytes = *reinterpret_cast<u32*>(buffer.offset_pointer(0));
-    auto next_block = *reinterpret_cast<Block::Index*>(buffer.offset_pointer(sizeof(u32)));
-    auto data = TRY(buffer.slice(Block::HEADER_SIZE, Block::DATA_SIZE));
+ErrorOr<size_t> Heap::find_free_frame()
+{
+    // Sweep the clock hand across the frames, giving every recently used one a second chance by clearing its reference
+    // bit. Two rounds are enough to come across an unpinned frame that hasn't been used since, if there is one.
+    for (size_t i = 0; i < 2 * BUFFER_POOL_SIZE; ++i) {
+        auto frame_index = m_clock_hand;
+        m_clock_hand = (m_clock_hand + 1) % BUFFER_POOL_SIZE;
+
+        auto& frame = m_buffer_pool_frames[frame_index];
+        if (frame.pin_count > 0)
+            continue;
+        if (frame.is_valid && frame.is_referenced) {
+            frame.is_referenced = false;
+            continue;
+        }
+        return frame_index;
+    }
+    return Error::from_string_literal("Heap::find_free_frame(): all blocks in the buffer pool are pinned");
+}
 
-    return Block { index, size_in_bytes, next_block, move(data) };
+void Heap::unpin_frame(size_t frame_index)
+{
+    auto& frame = m_buffer_pool_frames[frame_index];
+    VERIFY(frame.pin_count > 0);
+    frame.pin_count--;
 }
 
 ErrorOr<void> Heap::write_raw_block(Block::Index index, ReadonlyBytes data)
@@ -205,12 +367,8 @@ ErrorOr<void> Heap::write_raw_block(Block::Index index, ReadonlyBytes data)
     VERIFY(m_file);
     VERIFY(data.size() == Block::SIZE);
 
-    TRY(m_file->seek(index * Block::SIZE, SeekMode::SetPosition));
+    TRY(m_file->seek(static_cast<u64>(index) * Block::SIZE, SeekMode::SetPosition));
     TRY(m_file->write_until_depleted(data));
-
-    if (index > m_highest_block_written)
-        m_highest_block_written = index;
-
     return {};
 }
 
@@ -220,7 +378,7 @@ ErrorOr<void> Heap::write_raw_block_to_wal(Block::Index index, ByteBuffer&& data
     VERIFY(index < m_next_block);
     VERIFY(data.size() == Block::SIZE);
 
-    TRY(m_write_ahead_log.try_set(index, move(data)));
+    TRY(m_uncommitted_blocks.try_set(index, move(data)));
 
     return {};
 }
@@ -251,16 +409,16 @@ ErrorOr<void> Heap::free_storage(Block::Index index)
     VERIFY(index > 0);
 
     while (index > 0) {
-        auto block = TRY(read_block(index));
-        TRY(free_block(block));
-        index = block.next_block();
+        // NOTE: Freeing the block changes the uncommitted blocks, so it must not be pinned anymore by then.
+        auto next_block = TRY(read_raw_block(index)).next_block();
+        TRY(free_block(index));
+        index = next_block;
     }
     return {};
 }
 
-ErrorOr<void> Heap::free_block(Block const& block)
+ErrorOr<void> Heap::free_block(Block::Index index)
 {
-    auto index = block.index();
     dbgln_if(SQL_DEBUG, "{}({})", __FUNCTION__, index);
 
     VERIFY(index > 0);
@@ -276,15 +434,76 @@ ErrorOr<void> Heap::free_block(Block const& block)
 ErrorOr<void> Heap::flush()
 {
     VERIFY(m_file);
-    auto indices = m_write_ahead_log.keys();
+    if (m_uncommitted_blocks.is_empty())
+        return {};
+
+    auto indices = m_uncommitted_blocks.keys();
+    quick_sort(indices);
+
+    // All blocks of a commit go into a single record, so they take a single write and a single sync to become durable
+    auto record_size = WAL_RECORD_HEADER_SIZE + indices.size() * WAL_RECORD_ENTRY_SIZE + sizeof(u32);
+    auto record = TRY(ByteBuffer::create_uninitialized(record_size));
+    u32 magic = WAL_RECORD_MAGIC;
+    u32 block_count = indices.size();
+    record.overwrite(0, &magic, sizeof(magic));
+    record.overwrite(sizeof(magic), &block_count, sizeof(block_count));
+    for (size_t i = 0; i < indices.size(); ++i) {
+        auto entry_offset = WAL_RECORD_HEADER_SIZE + i * WAL_RECORD_ENTRY_SIZE;
+        record.overwrite(entry_offset, &indices[i], sizeof(Block::Index));
+        record.overwrite(entry_offset + sizeof(Block::Index), m_uncommitted_blocks.get(indices[i])->data(), Block::SIZE);
+    }
+    u32 checksum = Crypto::Checksum::CRC32 { record.bytes().trim(record_size - sizeof(u32)) }.digest();
+    record.overwrite(record_size - sizeof(u32), &checksum, sizeof(checksum));
+
+    TRY(m_wal_file->seek(m_wal_size, SeekMode::SetPosition));
+    TRY(m_wal_file->write_until_depleted(record));
+    TRY(Core::System::fsync(m_wal_file->fd()));
+
+    for (size_t i = 0; i < indices.size(); ++i) {
+        auto index = indices[i];
+        TRY(m_wal_block_offsets.try_set(index, m_wal_size + WAL_RECORD_HEADER_SIZE + i * WAL_RECORD_ENTRY_SIZE + sizeof(Block::Index)));
+        if (auto frame_index = m_buffer_pool_frame_indices.get(index); frame_index.has_value())
+            m_uncommitted_blocks.get(index)->bytes().copy_to(m_buffer_pool.bytes().slice(frame_index.value() * Block::SIZE, Block::SIZE));
+        if (index > m_highest_block_written)
+            m_highest_block_written = index;
+    }
+    m_wal_size += record_size;
+    m_uncommitted_blocks.clear();
+    dbgln_if(SQL_DEBUG, "Committed {} blocks to the WAL; new number of blocks = {}", indices.size(), m_highest_block_written);
+
+    if (m_wal_size >= WAL_CHECKPOINT_SIZE)
+        TRY(checkpoint());
+    return {};
+}
+
+ErrorOr<void> Heap::checkpoint()
+{
+    VERIFY(m_file);
+    if (m_wal_block_offsets.is_empty())
+        return {};
+
+    auto indices = m_wal_block_offsets.keys();
     quick_sort(indices);
+
+    auto buffer = TRY(ByteBuffer::create_uninitialized(Block::SIZE));
     for (auto index : indices) {
-        dbgln_if(SQL_DEBUG, "Flushing block {}", index);
-        auto& data = m_write_ahead_log.get(index).value();
-        TRY(write_raw_block(index, data));
+        dbgln_if(SQL_DEBUG, "Checkpointing block {}", index);
+        if (auto frame_index = m_buffer_pool_frame_indices.get(index); frame_index.has_value()) {
+            TRY(write_raw_block(index, m_buffer_pool.bytes().slice(frame_index.value() * Block::SIZE, Block::SIZE)));
+            continue;
+        }
+        TRY(read_committed_block(index, buffer));
+        TRY(write_raw_block(index, buffer));
     }
-    m_write_ahead_log.clear();
-    dbgln_if(SQL_DEBUG, "WAL flushed; new number of blocks = {}", m_highest_block_written);
+
+    // Only drop the log once its blocks are safely in the heap file; if we crash before that, they are simply replayed again
+    TRY(Core::System::fsync(m_file->fd()));
+    TRY(m_wal_file->truncate(0));
+    TRY(Core::System::fsync(m_wal_file->fd()));
+    m_wal_block_offsets.clear();
+    m_wal_size = 0;
+
+    dbgln_if(SQL_DEBUG, "WAL checkpointed; number of blocks = {}", m_highest_block_written);
     return {};
 }
 
@@ -299,27 +518,27 @@ ErrorOr<void> Heap::read_zero_block()
 {
     dbgln_if(SQL_DEBUG, "Read zero block from {}", name());
 
-    auto block = TRY(read_raw_block(0));
-    auto file_id_buffer = TRY(block.slice(0, FILE_ID.length()));
-    auto file_id = StringView(file_id_buffer);
+    auto pinned_block = TRY(read_raw_block(0));
+    auto block = pinned_block.bytes();
+    auto file_id = StringView(block.trim(FILE_ID.length()));
     if (file_id != FILE_ID) {
         warnln("{}: Zero page corrupt. This is probably not a {} heap file"sv, name(), FILE_ID);
         return Error::from_string_literal("Heap()::read_zero_block(): Zero page corrupt. This is probably not a SerenitySQL heap file");
     }
 
-    memcpy(&m_version, block.offset_pointer(VERSION_OFFSET), sizeof(u32));
+    memcpy(&m_version, block.offset(VERSION_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Version: {}.{}", (m_version & 0xFFFF0000) >> 16, (m_version & 0x0000FFFF));
 
-    memcpy(&m_schemas_root, block.offset_pointer(SCHEMAS_ROOT_OFFSET), sizeof(u32));
+    memcpy(&m_schemas_root, block.offset(SCHEMAS_ROOT_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Schemas root node: {}", m_schemas_root);
 
-    memcpy(&m_tables_root, block.offset_pointer(TABLES_ROOT_OFFSET), sizeof(u32));
+    memcpy(&m_tables_root, block.offset(TABLES_ROOT_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Tables root node: {}", m_tables_root);
 
-    memcpy(&m_table_columns_root, block.offset_pointer(TABLE_COLUMNS_ROOT_OFFSET), sizeof(u32));
+    memcpy(&m_table_columns_root, block.offset(TABLE_COLUMNS_ROOT_OFFSET), sizeof(u32));
     dbgln_if(SQL_DEBUG, "Table columns root node: {}", m_table_columns_root);
 
-    memcpy(m_user_values.data(), block.offset_pointer(USER_VALUES_OFFSET), m_user_values.size() * sizeof(u32));
+    memcpy(m_user_values.data(), block.offset(USER_VALUES_OFFSET), m_user_values.size() * sizeof(u32));
     for (auto ix = 0u; ix < m_user_values.size(); ix++) {
         if (m_user_values[ix])
             dbgln_if(SQL_DEBUG, "User value {}: {}", ix, m_user_values[ix]);
@@ -63,10 +63,23 @@ private:
  *
  * A Heap can be thought of the backing storage of a single database. It's
  * assumed that a single SQL database is backed by a single Heap.
+ *
+ * Blocks that are written are kept in memory until they are committed by
+ * flush(), which appends them to a write-ahead log file next to the heap
+ * file (named like it, with "-wal" appended) and syncs it to disk. The log
+ * is replayed when the heap is opened again, and its blocks are copied into
+ * the heap file itself once it grows larger than WAL_CHECKPOINT_SIZE (a
+ * "checkpoint"), and when the heap is destroyed.
+ *
+ * Reads go through a buffer pool of BUFFER_POOL_SIZE blocks. Blocks that are
+ * in use are pinned in the pool, and the others are evicted in the order of
+ * the clock algorithm (which approximates evicting the least recently used).
  */
 class Heap : public RefCounted<Heap> {
 public:
     static constexpr u32 VERSION = 5;
+    static constexpr size_t BUFFER_POOL_SIZE = 1024;
+    static constexpr size_t WAL_CHECKPOINT_SIZE = 4 * MiB;
 
     static ErrorOr<NonnullRefPtr<Heap>> create(ByteString);
     virtual ~Heap();
@@ -120,17 +133,55 @@ public:
     ErrorOr<void> free_storage(Block::Index);
 
     ErrorOr<void> flush();
+    ErrorOr<void> checkpoint();
 
 private:
     explicit Heap(ByteString);
 
-    ErrorOr<ByteBuffer> read_raw_block(Block::Index);
+    // A block in the buffer pool (or one that has not been committed yet) that can't be evicted until this goes out of scope
+    class PinnedBlock {
+        AK_MAKE_NONCOPYABLE(PinnedBlock);
+
+    public:
+        PinnedBlock(PinnedBlock&&);
+        ~PinnedBlock();
+
+        ReadonlyBytes bytes() const { return m_bytes; }
+
+        // The header and data of a block that is part of a chain of storage
+        u32 size_in_bytes() const { return *reinterpret_cast<u32 const*>(m_bytes.offset(0)); }
+        Block::Index next_block() const { return *reinterpret_cast<Block::Index const*>(m_bytes.offset(sizeof(u32))); }
+        ReadonlyBytes data() const { return m_bytes.slice(Block::HEADER_SIZE, size_in_bytes()); }
+
+    private:
+        friend class Heap;
+        PinnedBlock(Heap&, Optional<size_t> frame_index, ReadonlyBytes);
+
+        Heap* m_heap { nullptr };
+        Optional<size_t> m_frame_index;
+        ReadonlyBytes m_bytes;
+    };
+
+    struct BufferPoolFrame {
+        Block::Index index { 0 };
+        u32 pin_count { 0 };
+        bool is_valid { false };
+        bool is_referenced { false };
+    };
+
+    ErrorOr<PinnedBlock> read_raw_block(Block::Index);
+    ErrorOr<void> read_committed_block(Block::Index, Bytes);
+    ErrorOr<size_t> find_free_frame();
+    void unpin_frame(size_t frame_index);
     ErrorOr<void> write_raw_block(Block::Index, ReadonlyBytes);
     ErrorOr<void> write_raw_block_to_wal(Block::Index, ByteBuffer&&);
 
-    ErrorOr<Block> read_block(Block::Index);
+    ErrorOr<void> open_write_ahead_log();
+    ErrorOr<void> replay_write_ahead_log();
+    void close_files();
+
     ErrorOr<void> write_block(Block const&);
-    ErrorOr<void> free_block(Block const&);
+    ErrorOr<void> free_block(Block::Index);
 
     ErrorOr<void> read_zero_block();
     ErrorOr<void> initialize_zero_block();
@@ -138,7 +189,8 @@ private:
 
     ByteString m_name;
 
-    OwnPtr<Core::InputBufferedFile> m_file;
+    OwnPtr<Core::File> m_file;
+    OwnPtr<Core::File> m_wal_file;
     Block::Index m_highest_block_written { 0 };
     Block::Index m_next_block { 1 };
     Block::Index m_schemas_root { 0 };
@@ -146,8 +198,19 @@ private:
     Block::Index m_table_columns_root { 0 };
     u32 m_version { VERSION };
     Array<u32, 16> m_user_values { 0 };
-    HashMap<Block::Index, ByteBuffer> m_write_ahead_log;
     Vector<Block::Index> m_free_block_indices;
+
+    // Blocks that have been written since the last commit
+    HashMap<Block::Index, ByteBuffer> m_uncommitted_blocks;
+
+    // The offset in the write-ahead log of the latest committed version of every block that has not been checkpointed yet
+    HashMap<Block::Index, u64> m_wal_block_offsets;
+    u64 m_wal_size { 0 };
+
+    ByteBuffer m_buffer_pool;
+    Array<BufferPoolFrame, BUFFER_POOL_SIZE> m_buffer_pool_frames;
+    HashMap<Block::Index, size_t> m_buffer_pool_frame_indices;
+    size_t m_clock_hand { 0 };
 };
 
 }
@@ -106,6 +106,8 @@ void TreeNode::deserialize(Serializer& serializer)
     auto nodes = serializer.deserialize<u32>();
     dbgln_if(SQL_DEBUG, "Deserializing node. Size {}", nodes);
     if (nodes > 0) {
+        // Nodes that are read back are constructed as empty leaves, with a single down pointer that we replace here
+        m_down.clear();
         for (u32 i = 0; i < nodes; i++) {
             auto left = serializer.deserialize<u32>();
             dbgln_if(SQL_DEBUG, "Down[{}] {}", i, left);
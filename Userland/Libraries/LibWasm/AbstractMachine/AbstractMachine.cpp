@@ -21,7 +21,7 @@ Optional<FunctionAddress> Store::allocate(ModuleInstance& module, CodeSection::C
         return {};
 
     auto& type = module.types()[type_index.value()];
-    m_functions.empend(WasmFunction { type, module, code });
+    m_functions.empend(WasmFunction { type, module, code, BytecodeInterpreter::compile(code.func().body()) });
     return address;
 }
 
@@ -327,23 +327,34 @@ private:
     Vector<ExportInstance> m_exports;
 };
 
+// A function body, translated ahead of time into the form BytecodeInterpreter runs.
+// There's one entry per instruction (plus one past the end), so instruction pointers mean the same thing in both forms.
+struct CompiledInstruction {
+    u32 handler { 0 };
+    u32 immediate { 0 };
+    u64 wide_immediate { 0 };
+};
+
 class WasmFunction {
 public:
-    explicit WasmFunction(FunctionType const& type, ModuleInstance const& module, CodeSection::Code const& code)
+    explicit WasmFunction(FunctionType const& type, ModuleInstance const& module, CodeSection::Code const& code, Vector<CompiledInstruction> compiled_body = {})
         : m_type(type)
         , m_module(module)
         , m_code(code)
+        , m_compiled_body(move(compiled_body))
     {
     }
 
     auto& type() const { return m_type; }
     auto& module() const { return m_module; }
     auto& code() const { return m_code; }
+    ReadonlySpan<CompiledInstruction> compiled_body() const { return m_compiled_body; }
 
 private:
     FunctionType m_type;
     ModuleInstance const& m_module;
     CodeSection::Code const& m_code;
+    Vector<CompiledInstruction> m_compiled_body;
 };
 
 class HostFunction {
@@ -579,10 +590,11 @@ private:
 
 class Frame {
 public:
-    explicit Frame(ModuleInstance const& module, Vector<Value> locals, Expression const& expression, size_t arity)
+    explicit Frame(ModuleInstance const& module, Vector<Value> locals, Expression const& expression, size_t arity, ReadonlySpan<CompiledInstruction> compiled_body = {})
         : m_module(module)
         , m_locals(move(locals))
         , m_expression(expression)
+        , m_compiled_body(compiled_body)
         , m_arity(arity)
     {
     }
@@ -591,12 +603,14 @@ public:
     auto& locals() const { return m_locals; }
     auto& locals() { return m_locals; }
     auto& expression() const { return m_expression; }
+    auto compiled_body() const { return m_compiled_body; }
     auto arity() const { return m_arity; }
 
 private:
     ModuleInstance const& m_module;
     Vector<Value> m_locals;
     Expression const& m_expression;
+    ReadonlySpan<CompiledInstruction> m_compiled_body;
     size_t m_arity { 0 };
 };
 
@@ -37,9 +37,373 @@ namespace Wasm {
         }                                                                                      \
     } while (false)
 
+// Handlers of the pre-translated form. Instructions without a handler of their own go through Generic, i.e. through
+// interpret(Configuration&, InstructionPointer&, Instruction const&). The ones after I32Store are fused sequences.
+#define ENUMERATE_COMPILED_HANDLERS(H) \
+    H(Generic)                         \
+    H(Exit)                            \
+    H(Nop)                             \
+    H(LocalGet)                        \
+    H(LocalSet)                        \
+    H(LocalTee)                        \
+    H(I32Const)                        \
+    H(I64Const)                        \
+    H(Br)                              \
+    H(BrIf)                            \
+    H(I32Eqz)                          \
+    H(I32Eq)                           \
+    H(I32Ne)                           \
+    H(I32LtS)                          \
+    H(I32LtU)                          \
+    H(I32GtS)                          \
+    H(I32GtU)                          \
+    H(I32LeS)                          \
+    H(I32LeU)                          \
+    H(I32GeS)                          \
+    H(I32GeU)                          \
+    H(I32Add)                          \
+    H(I32Sub)                          \
+    H(I32Mul)                          \
+    H(I32And)                          \
+    H(I32Or)                           \
+    H(I32Xor)                          \
+    H(I32Shl)                          \
+    H(I32ShrS)                         \
+    H(I32ShrU)                         \
+    H(I64Add)                          \
+    H(I64Sub)                          \
+    H(I64Mul)                          \
+    H(I32Load)                         \
+    H(I32Store)                        \
+    H(LocalGetLocalGet)                \
+    H(LocalGetI32Add)                  \
+    H(LocalGetLocalGetI32Add)          \
+    H(LocalGetI32ConstI32Add)          \
+    H(LocalGetI32ConstI32Sub)          \
+    H(I32ConstI32Add)                  \
+    H(LocalSetLocalGet)                \
+    H(LocalTeeLocalGet)
+
+enum class CompiledHandler : u32 {
+#define __ENUMERATE_COMPILED_HANDLER(name) name,
+    ENUMERATE_COMPILED_HANDLERS(__ENUMERATE_COMPILED_HANDLER)
+#undef __ENUMERATE_COMPILED_HANDLER
+};
+
+Vector<CompiledInstruction> BytecodeInterpreter::compile(Expression const& expression)
+{
+    auto& instructions = expression.instructions();
+    Vector<CompiledInstruction> compiled_body;
+    compiled_body.resize(instructions.size() + 1);
+
+    auto followed_by = [&](size_t index, auto... opcodes) {
+        size_t offset = 1;
+        return (... && (index + offset < instructions.size() && instructions[index + offset++].opcode() == opcodes));
+    };
+    auto local_index = [&](size_t index) { return static_cast<u32>(instructions[index].arguments().get<LocalIndex>().value()); };
+    auto i32_immediate = [&](size_t index) { return bit_cast<u32>(instructions[index].arguments().get<i32>()); };
+    auto entry = [](CompiledHandler handler, u32 immediate = 0, u64 wide_immediate = 0) {
+        return CompiledInstruction { to_underlying(handler), immediate, wide_immediate };
+    };
+
+    // NOTE: Every entry only looks ahead, and a fused sequence never contains anything that can be branched to (or
+    //       away from) in the middle. Branching to the middle of one simply starts at that instruction's own entry.
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        auto& instruction = instructions[i];
+        auto& compiled = compiled_body[i];
+        switch (instruction.opcode().value()) {
+        case Instructions::nop.value():
+            compiled = entry(CompiledHandler::Nop);
+            break;
+        case Instructions::local_get.value():
+            if (followed_by(i, Instructions::local_get, Instructions::i32_add))
+                compiled = entry(CompiledHandler::LocalGetLocalGetI32Add, local_index(i), local_index(i + 1));
+            else if (followed_by(i, Instructions::i32_const, Instructions::i32_add))
+                compiled = entry(CompiledHandler::LocalGetI32ConstI32Add, local_index(i), i32_immediate(i + 1));
+            else if (followed_by(i, Instructions::i32_const, Instructions::i32_sub))
+                compiled = entry(CompiledHandler::LocalGetI32ConstI32Sub, local_index(i), i32_immediate(i + 1));
+            else if (followed_by(i, Instructions::local_get))
+                compiled = entry(CompiledHandler::LocalGetLocalGet, local_index(i), local_index(i + 1));
+            else if (followed_by(i, Instructions::i32_add))
+                compiled = entry(CompiledHandler::LocalGetI32Add, local_index(i));
+            else
+                compiled = entry(CompiledHandler::LocalGet, local_index(i));
+            break;
+        case Instructions::local_set.value():
+            if (followed_by(i, Instructions::local_get))
+                compiled = entry(CompiledHandler::LocalSetLocalGet, local_index(i), local_index(i + 1));
+            else
+                compiled = entry(CompiledHandler::LocalSet, local_index(i));
+            break;
+        case Instructions::local_tee.value():
+            if (followed_by(i, Instructions::local_get))
+                compiled = entry(CompiledHandler::LocalTeeLocalGet, local_index(i), local_index(i + 1));
+            else
+                compiled = entry(CompiledHandler::LocalTee, local_index(i));
+            break;
+        case Instructions::i32_const.value():
+            if (followed_by(i, Instructions::i32_add))
+                compiled = entry(CompiledHandler::I32ConstI32Add, i32_immediate(i));
+            else
+                compiled = entry(CompiledHandler::I32Const, i32_immediate(i));
+            break;
+        case Instructions::i64_const.value():
+            compiled = entry(CompiledHandler::I64Const, 0, bit_cast<u64>(instruction.arguments().get<i64>()));
+            break;
+        case Instructions::br.value():
+            compiled = entry(CompiledHandler::Br, static_cast<u32>(instruction.arguments().get<LabelIndex>().value()));
+            break;
+        case Instructions::br_if.value():
+            compiled = entry(CompiledHandler::BrIf, static_cast<u32>(instruction.arguments().get<LabelIndex>().value()));
+            break;
+#define __COMPILE_SIMPLE_INSTRUCTION(opcode, handler) \
+    case Instructions::opcode.value():                \
+        compiled = entry(CompiledHandler::handler);   \
+        break;
+            __COMPILE_SIMPLE_INSTRUCTION(i32_eqz, I32Eqz)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_eq, I32Eq)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_ne, I32Ne)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_lts, I32LtS)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_ltu, I32LtU)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_gts, I32GtS)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_gtu, I32GtU)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_les, I32LeS)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_leu, I32LeU)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_ges, I32GeS)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_geu, I32GeU)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_add, I32Add)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_sub, I32Sub)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_mul, I32Mul)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_and, I32And)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_or, I32Or)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_xor, I32Xor)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_shl, I32Shl)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_shrs, I32ShrS)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_shru, I32ShrU)
+            __COMPILE_SIMPLE_INSTRUCTION(i64_add, I64Add)
+            __COMPILE_SIMPLE_INSTRUCTION(i64_sub, I64Sub)
+            __COMPILE_SIMPLE_INSTRUCTION(i64_mul, I64Mul)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_load, I32Load)
+            __COMPILE_SIMPLE_INSTRUCTION(i32_store, I32Store)
+#undef __COMPILE_SIMPLE_INSTRUCTION
+        default:
+            compiled = entry(CompiledHandler::Generic);
+            break;
+        }
+    }
+
+    compiled_body.last() = entry(CompiledHandler::Exit);
+    return compiled_body;
+}
+
+static ALWAYS_INLINE i32 wrapping_add(Value const& lhs, i32 rhs)
+{
+    return static_cast<i32>(*lhs.to<u32>() + static_cast<u32>(rhs));
+}
+
 void BytecodeInterpreter::interpret(Configuration& configuration)
 {
     m_trap = Empty {};
+
+    if (auto compiled_body = configuration.frame().compiled_body(); !compiled_body.is_empty())
+        return interpret_compiled(configuration, compiled_body);
+
+    interpret_instructions(configuration);
+}
+
+void BytecodeInterpreter::interpret_compiled(Configuration& configuration, ReadonlySpan<CompiledInstruction> compiled_body)
+{
+    static void* const dispatch_table[] = {
+#define SET_UP_LABEL(name) &&handle_##name,
+        ENUMERATE_COMPILED_HANDLERS(SET_UP_LABEL)
+#undef SET_UP_LABEL
+    };
+
+    auto& instructions = configuration.frame().expression().instructions();
+    auto& stack = configuration.stack();
+    auto& ip = configuration.ip();
+
+    // NOTE: The locals never change size while the function runs, so they stay put even if the stack (and with it,
+    //       our frame) gets reallocated by a call.
+    auto* locals = configuration.frame().locals().data();
+
+    // NOTE: Counting every instruction would cost us on every dispatch, so this form only counts taken branches.
+    //       Anything that runs forever has to take one over and over (or recurse, which is limited elsewhere).
+    auto const should_limit_instruction_count = configuration.should_limit_instruction_count();
+    u64 taken_branches = 0;
+
+#define CURRENT compiled_body[ip.value()]
+
+#define DISPATCH_NEXT(length)                                  \
+    do {                                                       \
+        ip = ip.value() + (length);                            \
+        goto* dispatch_table[compiled_body[ip.value()].handler]; \
+    } while (0)
+
+#define COUNT_TAKEN_BRANCH()                                                                     \
+    do {                                                                                         \
+        if (should_limit_instruction_count) {                                                    \
+            if (taken_branches++ >= Constants::max_allowed_executed_instructions_per_call) {     \
+                m_trap = Trap { "Exceeded maximum allowed number of instructions" };             \
+                return;                                                                          \
+            }                                                                                    \
+        }                                                                                        \
+    } while (0)
+
+#define BINARY_OPERATION_HANDLER(name, PopType, PushType, Operator)        \
+    handle_##name:                                                         \
+    {                                                                      \
+        binary_numeric_operation<PopType, PushType, Operators::Operator>(configuration); \
+        DISPATCH_NEXT(1);                                                  \
+    }
+
+    goto* dispatch_table[CURRENT.handler];
+
+handle_Generic: {
+    auto old_ip = ip;
+    BytecodeInterpreter::interpret(configuration, ip, instructions[ip.value()]);
+    if (did_trap())
+        return;
+    if (ip == old_ip)
+        DISPATCH_NEXT(1);
+    COUNT_TAKEN_BRANCH();
+    DISPATCH_NEXT(0);
+}
+
+handle_Exit:
+    return;
+
+handle_Nop:
+    DISPATCH_NEXT(1);
+
+handle_LocalGet:
+    stack.push(locals[CURRENT.immediate]);
+    DISPATCH_NEXT(1);
+
+handle_LocalSet: {
+    auto entry = stack.pop();
+    locals[CURRENT.immediate] = move(entry.get<Value>());
+    DISPATCH_NEXT(1);
+}
+
+handle_LocalTee:
+    locals[CURRENT.immediate] = stack.peek().get<Value>();
+    DISPATCH_NEXT(1);
+
+handle_I32Const:
+    stack.push(Value(bit_cast<i32>(CURRENT.immediate)));
+    DISPATCH_NEXT(1);
+
+handle_I64Const:
+    stack.push(Value(bit_cast<i64>(CURRENT.wide_immediate)));
+    DISPATCH_NEXT(1);
+
+handle_Br:
+    branch_to_label(configuration, LabelIndex { CURRENT.immediate });
+    if (did_trap())
+        return;
+    COUNT_TAKEN_BRANCH();
+    DISPATCH_NEXT(0);
+
+handle_BrIf: {
+    auto entry = stack.pop();
+    if (entry.get<Value>().to<i32>().value_or(0) == 0)
+        DISPATCH_NEXT(1);
+    branch_to_label(configuration, LabelIndex { CURRENT.immediate });
+    if (did_trap())
+        return;
+    COUNT_TAKEN_BRANCH();
+    DISPATCH_NEXT(0);
+}
+
+handle_I32Eqz:
+    unary_operation<i32, i32, Operators::EqualsZero>(configuration);
+    DISPATCH_NEXT(1);
+
+    BINARY_OPERATION_HANDLER(I32Eq, i32, i32, Equals)
+    BINARY_OPERATION_HANDLER(I32Ne, i32, i32, NotEquals)
+    BINARY_OPERATION_HANDLER(I32LtS, i32, i32, LessThan)
+    BINARY_OPERATION_HANDLER(I32LtU, u32, i32, LessThan)
+    BINARY_OPERATION_HANDLER(I32GtS, i32, i32, GreaterThan)
+    BINARY_OPERATION_HANDLER(I32GtU, u32, i32, GreaterThan)
+    BINARY_OPERATION_HANDLER(I32LeS, i32, i32, LessThanOrEquals)
+    BINARY_OPERATION_HANDLER(I32LeU, u32, i32, LessThanOrEquals)
+    BINARY_OPERATION_HANDLER(I32GeS, i32, i32, GreaterThanOrEquals)
+    BINARY_OPERATION_HANDLER(I32GeU, u32, i32, GreaterThanOrEquals)
+    BINARY_OPERATION_HANDLER(I32Add, u32, i32, Add)
+    BINARY_OPERATION_HANDLER(I32Sub, u32, i32, Subtract)
+    BINARY_OPERATION_HANDLER(I32Mul, u32, i32, Multiply)
+    BINARY_OPERATION_HANDLER(I32And, i32, i32, BitAnd)
+    BINARY_OPERATION_HANDLER(I32Or, i32, i32, BitOr)
+    BINARY_OPERATION_HANDLER(I32Xor, i32, i32, BitXor)
+    BINARY_OPERATION_HANDLER(I32Shl, u32, i32, BitShiftLeft)
+    BINARY_OPERATION_HANDLER(I32ShrS, i32, i32, BitShiftRight)
+    BINARY_OPERATION_HANDLER(I32ShrU, u32, i32, BitShiftRight)
+    BINARY_OPERATION_HANDLER(I64Add, u64, i64, Add)
+    BINARY_OPERATION_HANDLER(I64Sub, u64, i64, Subtract)
+    BINARY_OPERATION_HANDLER(I64Mul, u64, i64, Multiply)
+
+handle_I32Load:
+    load_and_push<i32, i32>(configuration, instructions[ip.value()]);
+    if (did_trap())
+        return;
+    DISPATCH_NEXT(1);
+
+handle_I32Store:
+    pop_and_store<i32, i32>(configuration, instructions[ip.value()]);
+    if (did_trap())
+        return;
+    DISPATCH_NEXT(1);
+
+handle_LocalGetLocalGet:
+    stack.push(locals[CURRENT.immediate]);
+    stack.push(locals[CURRENT.wide_immediate]);
+    DISPATCH_NEXT(2);
+
+handle_LocalGetI32Add: {
+    auto& value = stack.peek().get<Value>();
+    value = Value(wrapping_add(locals[CURRENT.immediate], *value.to<i32>()));
+    DISPATCH_NEXT(2);
+}
+
+handle_LocalGetLocalGetI32Add:
+    stack.push(Value(wrapping_add(locals[CURRENT.immediate], *locals[CURRENT.wide_immediate].to<i32>())));
+    DISPATCH_NEXT(3);
+
+handle_LocalGetI32ConstI32Add:
+    stack.push(Value(wrapping_add(locals[CURRENT.immediate], static_cast<i32>(CURRENT.wide_immediate))));
+    DISPATCH_NEXT(3);
+
+handle_LocalGetI32ConstI32Sub:
+    stack.push(Value(wrapping_add(locals[CURRENT.immediate], static_cast<i32>(-static_cast<u32>(CURRENT.wide_immediate)))));
+    DISPATCH_NEXT(3);
+
+handle_I32ConstI32Add: {
+    auto& value = stack.peek().get<Value>();
+    value = Value(wrapping_add(value, bit_cast<i32>(CURRENT.immediate)));
+    DISPATCH_NEXT(2);
+}
+
+handle_LocalSetLocalGet: {
+    auto entry = stack.pop();
+    locals[CURRENT.immediate] = move(entry.get<Value>());
+    stack.push(locals[CURRENT.wide_immediate]);
+    DISPATCH_NEXT(2);
+}
+
+handle_LocalTeeLocalGet:
+    locals[CURRENT.immediate] = stack.peek().get<Value>();
+    stack.push(locals[CURRENT.wide_immediate]);
+    DISPATCH_NEXT(2);
+
+#undef BINARY_OPERATION_HANDLER
+#undef COUNT_TAKEN_BRANCH
+#undef DISPATCH_NEXT
+#undef CURRENT
+}
+
+void BytecodeInterpreter::interpret_instructions(Configuration& configuration)
+{
     auto& instructions = configuration.frame().expression().instructions();
     auto max_ip_value = InstructionPointer { instructions.size() };
     auto& current_ip_value = configuration.ip();
@@ -1725,6 +2089,16 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     }
 }
 
+void DebuggerBytecodeInterpreter::interpret(Configuration& configuration)
+{
+    // NOTE: The hooks want to see every single instruction, which the pre-translated form can't offer.
+    if (!pre_interpret_hook && !post_interpret_hook)
+        return BytecodeInterpreter::interpret(configuration);
+
+    m_trap = Empty {};
+    interpret_instructions(configuration);
+}
+
 void DebuggerBytecodeInterpreter::interpret(Configuration& configuration, InstructionPointer& ip, Instruction const& instruction)
 {
     if (pre_interpret_hook) {
@@ -20,6 +20,10 @@ struct BytecodeInterpreter : public Interpreter {
 
     virtual void interpret(Configuration&) override;
     virtual ~BytecodeInterpreter() override = default;
+
+    // Translates a validated function body into the form interpret() prefers to run.
+    static Vector<CompiledInstruction> compile(Expression const&);
+
     virtual bool did_trap() const override { return !m_trap.has<Empty>(); }
     virtual ByteString trap_reason() const override
     {
@@ -44,6 +48,8 @@ struct BytecodeInterpreter : public Interpreter {
     };
 
 protected:
+    void interpret_instructions(Configuration&);
+    void interpret_compiled(Configuration&, ReadonlySpan<CompiledInstruction>);
     virtual void interpret(Configuration&, InstructionPointer&, Instruction const&);
     void branch_to_label(Configuration&, LabelIndex);
     template<typename ReadT, typename PushT>
@@ -100,6 +106,8 @@ struct DebuggerBytecodeInterpreter : public BytecodeInterpreter {
     Function<bool(Configuration&, InstructionPointer&, Instruction const&)> pre_interpret_hook;
     Function<bool(Configuration&, InstructionPointer&, Instruction const&, Interpreter const&)> post_interpret_hook;
 
+    virtual void interpret(Configuration&) override;
+
 private:
     virtual void interpret(Configuration&, InstructionPointer&, Instruction const&) override;
 };
@@ -55,6 +55,7 @@ Result Configuration::call(Interpreter& interpreter, FunctionAddress address, Ve
             move(locals),
             wasm_function->code().func().body(),
             wasm_function->type().results().size(),
+            wasm_function->compiled_body(),
         });
         m_ip = 0;
         return execute(interpreter);
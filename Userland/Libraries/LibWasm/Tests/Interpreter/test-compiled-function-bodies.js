@@ -0,0 +1,77 @@
+// prettier-ignore
+const binary = new Uint8Array([
+        0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x11, 0x03, 0x60, 0x01, 0x7f, 0x01, 0x7f,
+        0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7e, 0x01, 0x7e, 0x03, 0x0e, 0x0d, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x02, 0x00, 0x00, 0x05, 0x03, 0x01, 0x00, 0x10,
+        0x07, 0x9a, 0x01, 0x0d, 0x03, 0x73, 0x75, 0x6d, 0x00, 0x00, 0x03, 0x66, 0x69, 0x62, 0x00, 0x01,
+        0x03, 0x6d, 0x65, 0x6d, 0x00, 0x02, 0x0b, 0x77, 0x72, 0x61, 0x70, 0x70, 0x69, 0x6e, 0x67, 0x41,
+        0x64, 0x64, 0x00, 0x03, 0x0b, 0x77, 0x72, 0x61, 0x70, 0x70, 0x69, 0x6e, 0x67, 0x53, 0x75, 0x62,
+        0x00, 0x04, 0x08, 0x63, 0x6f, 0x6e, 0x73, 0x74, 0x41, 0x64, 0x64, 0x00, 0x05, 0x09, 0x74, 0x65,
+        0x65, 0x41, 0x6e, 0x64, 0x47, 0x65, 0x74, 0x00, 0x06, 0x09, 0x73, 0x65, 0x74, 0x41, 0x6e, 0x64,
+        0x47, 0x65, 0x74, 0x00, 0x07, 0x06, 0x67, 0x65, 0x74, 0x41, 0x64, 0x64, 0x00, 0x08, 0x10, 0x75,
+        0x6e, 0x73, 0x69, 0x67, 0x6e, 0x65, 0x64, 0x4c, 0x65, 0x73, 0x73, 0x54, 0x68, 0x61, 0x6e, 0x00,
+        0x09, 0x0d, 0x69, 0x36, 0x34, 0x41, 0x72, 0x69, 0x74, 0x68, 0x6d, 0x65, 0x74, 0x69, 0x63, 0x00,
+        0x0a, 0x12, 0x62, 0x72, 0x61, 0x6e, 0x63, 0x68, 0x49, 0x6e, 0x74, 0x6f, 0x53, 0x65, 0x71, 0x75,
+        0x65, 0x6e, 0x63, 0x65, 0x00, 0x0b, 0x04, 0x6c, 0x6f, 0x61, 0x64, 0x00, 0x0c, 0x0a, 0x86, 0x02,
+        0x0d, 0x25, 0x02, 0x01, 0x7f, 0x01, 0x7f, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01, 0x20, 0x00, 0x4e,
+        0x0d, 0x01, 0x20, 0x02, 0x20, 0x01, 0x6a, 0x21, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21, 0x01,
+        0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x1c, 0x00, 0x20, 0x00, 0x41, 0x02, 0x48, 0x04, 0x7f,
+        0x20, 0x00, 0x05, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x10, 0x01, 0x20, 0x00, 0x41, 0x02, 0x6b, 0x10,
+        0x01, 0x6a, 0x0b, 0x0b, 0x44, 0x03, 0x01, 0x7f, 0x01, 0x7f, 0x01, 0x7f, 0x02, 0x40, 0x03, 0x40,
+        0x20, 0x01, 0x20, 0x00, 0x4e, 0x0d, 0x01, 0x20, 0x01, 0x41, 0xff, 0xff, 0x00, 0x71, 0x41, 0x02,
+        0x74, 0x22, 0x03, 0x20, 0x03, 0x28, 0x02, 0x00, 0x20, 0x01, 0x73, 0x20, 0x02, 0x6a, 0x36, 0x02,
+        0x00, 0x20, 0x02, 0x20, 0x03, 0x28, 0x02, 0x00, 0x6a, 0x21, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a,
+        0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x0b, 0x00, 0x20, 0x00, 0x41, 0xff, 0xff,
+        0xff, 0xff, 0x07, 0x6a, 0x0b, 0x0b, 0x00, 0x20, 0x00, 0x41, 0x80, 0x80, 0x80, 0x80, 0x78, 0x6b,
+        0x0b, 0x0a, 0x00, 0x20, 0x00, 0x41, 0x05, 0x6c, 0x41, 0x79, 0x6a, 0x0b, 0x0b, 0x01, 0x01, 0x7f,
+        0x20, 0x00, 0x22, 0x01, 0x20, 0x01, 0x6c, 0x0b, 0x10, 0x01, 0x01, 0x7f, 0x20, 0x00, 0x41, 0x03,
+        0x6a, 0x21, 0x01, 0x20, 0x01, 0x20, 0x01, 0x6a, 0x0b, 0x0a, 0x00, 0x20, 0x00, 0x41, 0x01, 0x74,
+        0x20, 0x01, 0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x20, 0x01, 0x49, 0x0b, 0x0a, 0x00, 0x20, 0x00,
+        0x42, 0x03, 0x7e, 0x42, 0x01, 0x7c, 0x0b, 0x16, 0x00, 0x20, 0x00, 0x02, 0x40, 0x20, 0x00, 0x0d,
+        0x00, 0x20, 0x00, 0x41, 0xe4, 0x00, 0x6a, 0x21, 0x00, 0x0b, 0x20, 0x00, 0x6a, 0x0b, 0x07, 0x00,
+        0x20, 0x00, 0x28, 0x02, 0x00, 0x0b,
+]);
+
+const module = parseWebAssemblyModule(binary);
+
+const call = (name, ...args) => module.invoke(module.getExport(name), ...args);
+
+test("loops over locals", () => {
+    expect(call("sum", 0)).toBe(0);
+    expect(call("sum", 100)).toBe(4950);
+    expect(call("sum", 100000)).toBe(704982704);
+});
+
+test("recursive calls", () => {
+    expect(call("fib", 1)).toBe(1);
+    expect(call("fib", 20)).toBe(6765);
+});
+
+test("memory loads and stores", () => {
+    expect(call("mem", 1000)).toBe(-1001);
+    expect(() => call("load", 0x7ffffff0)).toThrow(TypeError, "Execution trapped");
+});
+
+test("fused arithmetic wraps around", () => {
+    expect(call("wrappingAdd", 1)).toBe(-2147483648);
+    expect(call("wrappingSub", 1)).toBe(-2147483647);
+    expect(call("constAdd", 3)).toBe(8);
+    expect(call("getAdd", 3, 4)).toBe(10);
+    expect(call("getAdd", 0x7fffffff, 3)).toBe(1);
+});
+
+test("fused local accesses", () => {
+    expect(call("teeAndGet", -7)).toBe(49);
+    expect(call("setAndGet", 4)).toBe(14);
+});
+
+test("comparisons and 64-bit arithmetic", () => {
+    expect(call("unsignedLessThan", 1, -1)).toBe(1);
+    expect(call("unsignedLessThan", -1, 1)).toBe(0);
+    expect(call("i64Arithmetic", 5n)).toBe(16n);
+});
+
+test("branches landing on fused sequences", () => {
+    expect(call("branchIntoSequence", 0)).toBe(100);
+    expect(call("branchIntoSequence", 5)).toBe(10);
+});
@@ -997,8 +997,21 @@ void KeyframeEffect::update_style_properties()
         }
     }
 
-    if (invalidation.relayout)
-        document.set_needs_layout();
+    if (invalidation.relayout) {
+        JS::GCPtr<Layout::Node> layout_node = target->layout_node();
+        if (pseudo_element_type().has_value())
+            layout_node = target->get_pseudo_element_node(pseudo_element_type().value());
+
+        // NOTE: Inherited properties were applied to the layout nodes of all descendants above.
+        if (layout_node) {
+            layout_node->for_each_in_inclusive_subtree([](Layout::Node& node) {
+                node.set_needs_layout();
+                return TraversalDecision::Continue;
+            });
+        } else {
+            document.set_needs_layout();
+        }
+    }
     if (invalidation.rebuild_layout_tree)
         document.invalidate_layout();
     if (invalidation.repaint)
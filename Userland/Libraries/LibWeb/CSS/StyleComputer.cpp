@@ -7,6 +7,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
 #include <AK/BinarySearch.h>
 #include <AK/Debug.h>
 #include <AK/Error.h>
@@ -2494,6 +2495,12 @@ RefPtr<StyleProperties> StyleComputer::compute_style_impl(DOM::Element& element,
         return style;
     }
 
+    bool can_share_style = mode == ComputeStyleMode::Normal && !pseudo_element.has_value() && this->can_share_style(element);
+    if (can_share_style) {
+        if (auto style = find_shareable_style(element))
+            return style;
+    }
+
     auto style = StyleProperties::create();
     // 1. Perform the cascade. This produces the "specified style"
     bool did_match_any_pseudo_element_rules = false;
@@ -2523,9 +2530,142 @@ RefPtr<StyleProperties> StyleComputer::compute_style_impl(DOM::Element& element,
     // 8. Let the element adjust computed style
     element.adjust_computed_style(style);
 
+    if (can_share_style)
+        add_style_sharing_candidate(element, style);
+
     return style;
 }
 
+static constexpr size_t max_style_sharing_candidates = 16;
+
+void StyleComputer::set_style_sharing_enabled(Badge<DOM::Document>, bool enabled)
+{
+    m_style_sharing_enabled = enabled;
+    m_style_sharing_candidates.clear();
+    m_style_sharing_sources.clear();
+}
+
+void StyleComputer::visit_edges(JS::Cell::Visitor& visitor)
+{
+    // NOTE: A garbage collection can happen in the middle of a style update, while the candidates are still around.
+    for (auto const& candidate : m_style_sharing_candidates)
+        visitor.visit(candidate.element);
+    for (auto const& it : m_style_sharing_sources) {
+        visitor.visit(JS::NonnullGCPtr { *it.key });
+        visitor.visit(JS::NonnullGCPtr { *it.value });
+    }
+}
+
+bool StyleComputer::can_share_style(DOM::Element const& element) const
+{
+    if (!m_style_sharing_enabled)
+        return false;
+
+    // NOTE: Shadow hosts, their children and elements inside of shadow trees may match rules from shadow roots,
+    //       which we don't try to tell apart.
+    auto const* parent = element.parent_element();
+    if (!parent || parent->is_shadow_host() || element.is_shadow_host() || is<DOM::ShadowRoot>(element.root()))
+        return false;
+
+    // NOTE: The inline style and animations of an element contribute to its style without showing up in its
+    //       attributes, and animations are created and updated as a side effect of computing the style.
+    if (element.inline_style() || element.has_associated_animations() || element.cached_animation_name_animation({}))
+        return false;
+
+    return true;
+}
+
+static bool have_same_attributes(DOM::Element const& a, DOM::Element const& b)
+{
+    if (a.attribute_list_size() != b.attribute_list_size())
+        return false;
+
+    bool have_same_attributes = true;
+    a.for_each_attribute([&](DOM::Attr const& attribute) {
+        if (have_same_attributes && b.get_attribute_ns(attribute.namespace_uri(), attribute.local_name()) != attribute.value())
+            have_same_attributes = false;
+    });
+    return have_same_attributes;
+}
+
+RefPtr<StyleProperties> StyleComputer::find_shareable_style(DOM::Element& element) const
+{
+    auto const& parent = *element.parent_element();
+    auto parent_source = m_style_sharing_sources.get(&parent);
+
+    for (auto const& candidate : m_style_sharing_candidates) {
+        auto const& candidate_element = *candidate.element;
+        if (candidate_element.local_name() != element.local_name() || candidate_element.namespace_uri() != element.namespace_uri())
+            continue;
+
+        // The candidate has to be a sibling, or a cousin whose parent shares its style with ours.
+        auto const& candidate_parent = *candidate_element.parent_element();
+        if (&candidate_parent != &parent && (!parent_source.has_value() || m_style_sharing_sources.get(&candidate_parent) != parent_source))
+            continue;
+
+        if (!have_same_attributes(element, candidate_element))
+            continue;
+
+        // Everything else that selectors can depend on (like sibling positions, or pseudo-classes for user
+        // interaction) has to be checked against the rules that could tell the two elements apart.
+        auto has_rule_that_tells_elements_apart = [&](RuleCache const& rule_cache) {
+            return any_of(rule_cache.style_sharing_sensitive_rules, [&](MatchingRule const& rule) {
+                auto const& selector = rule.rule->selectors()[rule.selector_index];
+                return SelectorEngine::matches(selector, *rule.sheet, element, nullptr) != SelectorEngine::matches(selector, *rule.sheet, candidate_element, nullptr);
+            });
+        };
+        if (has_rule_that_tells_elements_apart(*m_user_agent_rule_cache)
+            || has_rule_that_tells_elements_apart(*m_user_rule_cache)
+            || has_rule_that_tells_elements_apart(*m_author_rule_cache))
+            continue;
+
+        element.set_custom_properties({}, candidate_element.custom_properties({}));
+        m_style_sharing_sources.set(&element, m_style_sharing_sources.get(&candidate_element).value());
+        return candidate.style->clone();
+    }
+    return nullptr;
+}
+
+void StyleComputer::add_style_sharing_candidate(DOM::Element& element, StyleProperties const& style) const
+{
+    // NOTE: Styles with animations can't be shared, since the animations are created for one particular element.
+    if (style.animation_name_source())
+        return;
+
+    m_style_sharing_sources.set(&element, &element);
+    if (m_style_sharing_candidates.size() == max_style_sharing_candidates)
+        m_style_sharing_candidates.take_last();
+    m_style_sharing_candidates.prepend({ element, style.clone() });
+}
+
+// Returns whether the selector may match differently for two elements with the same tag name and attributes, and
+// equivalent parents.
+static bool is_style_sharing_sensitive(Selector const& selector)
+{
+    for (auto const& compound_selector : selector.compound_selectors()) {
+        if (compound_selector.combinator == Selector::Combinator::NextSibling || compound_selector.combinator == Selector::Combinator::SubsequentSibling)
+            return true;
+        for (auto const& simple_selector : compound_selector.simple_selectors) {
+            if (simple_selector.type != Selector::SimpleSelector::Type::PseudoClass)
+                continue;
+            auto const& pseudo_class = simple_selector.pseudo_class();
+            switch (pseudo_class.type) {
+            case PseudoClass::Is:
+            case PseudoClass::Where:
+            case PseudoClass::Not:
+                for (auto const& argument_selector : pseudo_class.argument_selector_list) {
+                    if (is_style_sharing_sensitive(*argument_selector))
+                        return true;
+                }
+                break;
+            default:
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 void StyleComputer::build_rule_cache_if_needed() const
 {
     if (m_author_rule_cache && m_user_rule_cache && m_user_agent_rule_cache)
@@ -2581,6 +2721,9 @@ NonnullOwnPtr<StyleComputer::RuleCache> StyleComputer::make_rule_cache_for_casca
                     }
                 }
 
+                if (!shadow_root && !matching_rule.contains_pseudo_element && is_style_sharing_sensitive(selector))
+                    rule_cache->style_sharing_sensitive_rules.append(matching_rule);
+
                 bool added_to_bucket = false;
                 for (auto const& simple_selector : selector.compound_selectors().last().simple_selectors) {
                     if (simple_selector.type == CSS::Selector::SimpleSelector::Type::Id) {
@@ -126,6 +126,13 @@ public:
     void push_ancestor(DOM::Element const&);
     void pop_ancestor(DOM::Element const&);
 
+    // While style sharing is enabled, an element may reuse the computed style of an equivalent sibling or cousin
+    // whose style was computed before it. The candidates aren't invalidated by DOM changes, so this should only be
+    // enabled for the duration of a single style update.
+    void set_style_sharing_enabled(Badge<DOM::Document>, bool);
+
+    void visit_edges(JS::Cell::Visitor&);
+
     NonnullRefPtr<StyleProperties> create_document_style() const;
 
     NonnullRefPtr<StyleProperties> compute_style(DOM::Element&, Optional<CSS::Selector::PseudoElement::Type> = {}) const;
@@ -164,6 +171,10 @@ private:
     [[nodiscard]] bool should_reject_with_ancestor_filter(Selector const&) const;
 
     RefPtr<StyleProperties> compute_style_impl(DOM::Element&, Optional<CSS::Selector::PseudoElement::Type>, ComputeStyleMode) const;
+
+    [[nodiscard]] bool can_share_style(DOM::Element const&) const;
+    [[nodiscard]] RefPtr<StyleProperties> find_shareable_style(DOM::Element&) const;
+    void add_style_sharing_candidate(DOM::Element&, StyleProperties const&) const;
     void compute_cascaded_values(StyleProperties&, DOM::Element&, Optional<CSS::Selector::PseudoElement::Type>, bool& did_match_any_pseudo_element_rules, ComputeStyleMode) const;
     static RefPtr<Gfx::FontCascadeList const> find_matching_font_weight_ascending(Vector<MatchingFontCandidate> const& candidates, int target_weight, float font_size_in_pt, bool inclusive);
     static RefPtr<Gfx::FontCascadeList const> find_matching_font_weight_descending(Vector<MatchingFontCandidate> const& candidates, int target_weight, float font_size_in_pt, bool inclusive);
@@ -216,6 +227,10 @@ private:
         Vector<MatchingRule> root_rules;
         Vector<MatchingRule> other_rules;
 
+        // Rules that may match differently for two elements with the same tag name and attributes, and equivalent
+        // parents. These are matched against both elements before one of them can share the style of the other.
+        Vector<MatchingRule> style_sharing_sensitive_rules;
+
         HashMap<FlyString, NonnullRefPtr<Animations::KeyframeEffect::KeyFrameSet>> rules_by_animation_keyframes;
     };
 
@@ -237,6 +252,20 @@ private:
     CSSPixelRect m_viewport_rect;
 
     CountingBloomFilter<u8, 14> m_ancestor_filter;
+
+    struct StyleSharingCandidate {
+        JS::NonnullGCPtr<DOM::Element> element;
+        NonnullRefPtr<StyleProperties> style;
+    };
+
+    bool m_style_sharing_enabled { false };
+
+    // The most recently computed styles that may be shared, most recent first.
+    mutable Vector<StyleSharingCandidate> m_style_sharing_candidates;
+
+    // For each element that took part in style sharing, the element whose style it has (possibly itself). Children of
+    // elements with the same entry here can share styles with each other, just like siblings.
+    mutable HashMap<DOM::Element const*, DOM::Element const*> m_style_sharing_sources;
 };
 
 class FontLoader : public ResourceClient {
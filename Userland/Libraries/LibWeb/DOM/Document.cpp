@@ -441,6 +441,10 @@ void Document::visit_edges(Cell::Visitor& visitor)
     visitor.visit(m_page);
     visitor.visit(m_window);
     visitor.visit(m_layout_root);
+    visitor.visit(m_dirty_relayout_boundaries);
+    if (m_layout_state)
+        m_layout_state->visit_edges(visitor);
+    m_style_computer->visit_edges(visitor);
     visitor.visit(m_style_sheets);
     visitor.visit(m_hovered_node);
     visitor.visit(m_inspected_node);
@@ -938,6 +942,8 @@ WebIDL::ExceptionOr<void> Document::set_title(String const& title)
 void Document::tear_down_layout_tree()
 {
     m_layout_root = nullptr;
+    m_layout_state = nullptr;
+    m_dirty_relayout_boundaries.clear();
     m_paintable = nullptr;
 }
 
@@ -1039,12 +1045,28 @@ URL::URL Document::parse_url(StringView url) const
 
 void Document::set_needs_layout()
 {
+    m_needs_full_layout = true;
     if (m_needs_layout)
         return;
     m_needs_layout = true;
     schedule_layout_update();
 }
 
+void Document::set_needs_layout(Badge<Layout::Node>, JS::GCPtr<Layout::Box> dirty_relayout_boundary)
+{
+    if (dirty_relayout_boundary)
+        m_dirty_relayout_boundaries.append(*dirty_relayout_boundary);
+    if (m_needs_layout)
+        return;
+    m_needs_layout = true;
+    schedule_layout_update();
+}
+
+bool Document::is_relayout_boundary(Layout::Box const& box) const
+{
+    return m_layout_state && m_layout_state->relayout_boundaries.contains(box);
+}
+
 void Document::invalidate_layout()
 {
     tear_down_layout_tree();
@@ -1125,30 +1147,79 @@ void Document::update_layout()
         }
     }
 
-    Layout::LayoutState layout_state;
+    // NOTE: If everything that changed is inside of relayout boundaries, we only lay out the insides of those again,
+    //       on top of the previous layout. Otherwise, we do a full layout that still reuses the insides of relayout
+    //       boundaries that haven't changed, unless something changed that isn't attributed to particular layout nodes.
+    auto can_relayout_only_inside_dirty_relayout_boundaries = [&] {
+        if (!m_layout_state || m_needs_full_layout || m_layout_root->needs_layout() || m_layout_root->child_needs_layout())
+            return false;
+        auto const& viewport_state = m_layout_state->get(*m_layout_root);
+        return viewport_state.content_width() == viewport_rect.width() && viewport_state.content_height() == viewport_rect.height();
+    };
+
+    if (can_relayout_only_inside_dirty_relayout_boundaries()) {
+        for (auto& relayout_boundary : m_dirty_relayout_boundaries) {
+            if (!relayout_boundary->child_needs_layout())
+                continue;
+            // Relayout boundaries inside of other dirty relayout boundaries are laid out along with those.
+            bool is_inside_dirty_relayout_boundary = false;
+            for (auto* ancestor = relayout_boundary->parent(); ancestor; ancestor = ancestor->parent()) {
+                if (ancestor->child_needs_layout() && ancestor->is_box() && is_relayout_boundary(static_cast<Layout::Box const&>(*ancestor))) {
+                    is_inside_dirty_relayout_boundary = true;
+                    break;
+                }
+            }
+            if (is_inside_dirty_relayout_boundary)
+                continue;
+            m_layout_state->relayout_inside(*relayout_boundary);
+            relayout_boundary->clear_needs_layout_in_subtree();
+        }
+    } else {
+        OwnPtr<Layout::LayoutState> previous_layout_state;
+        if (!m_needs_full_layout)
+            previous_layout_state = move(m_layout_state);
+
+        // The ancestors of dirty relayout boundaries must not reuse their previous insides either.
+        for (auto& relayout_boundary : m_dirty_relayout_boundaries) {
+            for (auto* ancestor = relayout_boundary->parent(); ancestor && !ancestor->child_needs_layout(); ancestor = ancestor->parent())
+                ancestor->set_child_needs_layout(true);
+        }
 
-    {
-        Layout::BlockFormattingContext root_formatting_context(layout_state, *m_layout_root, nullptr);
+        m_layout_state = make<Layout::LayoutState>();
+        auto& layout_state = *m_layout_state;
+        layout_state.set_previous_layout(previous_layout_state.ptr());
 
-        auto& viewport = static_cast<Layout::Viewport&>(*m_layout_root);
-        auto& viewport_state = layout_state.get_mutable(viewport);
-        viewport_state.set_content_width(viewport_rect.width());
-        viewport_state.set_content_height(viewport_rect.height());
+        {
+            Layout::BlockFormattingContext root_formatting_context(layout_state, *m_layout_root, nullptr);
 
-        if (document_element && document_element->layout_node()) {
-            auto& icb_state = layout_state.get_mutable(verify_cast<Layout::NodeWithStyleAndBoxModelMetrics>(*document_element->layout_node()));
-            icb_state.set_content_width(viewport_rect.width());
+            auto& viewport = static_cast<Layout::Viewport&>(*m_layout_root);
+            auto& viewport_state = layout_state.get_mutable(viewport);
+            viewport_state.set_content_width(viewport_rect.width());
+            viewport_state.set_content_height(viewport_rect.height());
+
+            if (document_element && document_element->layout_node()) {
+                auto& icb_state = layout_state.get_mutable(verify_cast<Layout::NodeWithStyleAndBoxModelMetrics>(*document_element->layout_node()));
+                icb_state.set_content_width(viewport_rect.width());
+            }
+
+            root_formatting_context.run(
+                *m_layout_root,
+                Layout::LayoutMode::Normal,
+                Layout::AvailableSpace(
+                    Layout::AvailableSize::make_definite(viewport_rect.width()),
+                    Layout::AvailableSize::make_definite(viewport_rect.height())));
         }
 
-        root_formatting_context.run(
-            *m_layout_root,
-            Layout::LayoutMode::Normal,
-            Layout::AvailableSpace(
-                Layout::AvailableSize::make_definite(viewport_rect.width()),
-                Layout::AvailableSize::make_definite(viewport_rect.height())));
+        layout_state.set_previous_layout(nullptr);
     }
 
-    layout_state.commit(*m_layout_root);
+    m_layout_state->commit(*m_layout_root);
+
+    m_layout_root->clear_needs_layout_in_subtree();
+    for (auto& relayout_boundary : m_dirty_relayout_boundaries)
+        relayout_boundary->clear_needs_layout_in_subtree();
+    m_dirty_relayout_boundaries.clear();
+    m_needs_full_layout = false;
 
     // Broadcast the current viewport rect to any new paintables, so they know whether they're visible or not.
     inform_all_viewport_clients_about_the_current_viewport_rect();
@@ -1248,12 +1319,13 @@ void Document::update_style()
 
     style_computer().reset_ancestor_filter();
 
+    style_computer().set_style_sharing_enabled({}, true);
     auto invalidation = update_style_recursively(*this, style_computer());
+    style_computer().set_style_sharing_enabled({}, false);
+    // NOTE: Elements whose style changed in a way that requires relayout have already marked their layout nodes.
     if (invalidation.rebuild_layout_tree) {
         invalidate_layout();
     } else {
-        if (invalidation.relayout)
-            set_needs_layout();
         if (invalidation.rebuild_stacking_context_tree)
             invalidate_stacking_context_tree();
     }
@@ -238,7 +238,11 @@ public:
     void update_paint_and_hit_testing_properties_if_needed();
     void update_animated_style_if_needed();
 
+    // Invalidates the whole layout, without reusing anything from the previous layout.
     void set_needs_layout();
+    void set_needs_layout(Badge<Layout::Node>, JS::GCPtr<Layout::Box> dirty_relayout_boundary);
+
+    [[nodiscard]] bool is_relayout_boundary(Layout::Box const&) const;
 
     void invalidate_layout();
     void invalidate_stacking_context_tree();
@@ -739,6 +743,10 @@ private:
 
     JS::GCPtr<Layout::Viewport> m_layout_root;
 
+    // The results of the last layout, kept so that the next layout can reuse whatever hasn't changed since.
+    OwnPtr<Layout::LayoutState> m_layout_state;
+    Vector<JS::NonnullGCPtr<Layout::Box>> m_dirty_relayout_boundaries;
+
     Optional<Color> m_normal_link_color;
     Optional<Color> m_active_link_color;
     Optional<Color> m_visited_link_color;
@@ -820,6 +828,7 @@ private:
     Vector<WeakPtr<CSS::MediaQueryList>> m_media_query_lists;
 
     bool m_needs_layout { false };
+    bool m_needs_full_layout { false };
 
     bool m_needs_full_style_update { false };
 
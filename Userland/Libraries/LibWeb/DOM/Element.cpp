@@ -586,6 +586,8 @@ CSS::RequiredInvalidationAfterStyleChange Element::recompute_style()
     if (!invalidation.rebuild_layout_tree && layout_node()) {
         // If we're keeping the layout tree, we can just apply the new style to the existing layout tree.
         layout_node()->apply_style(*m_computed_css_values);
+        if (invalidation.relayout)
+            layout_node()->set_needs_layout();
         if (invalidation.repaint && paintable())
             paintable()->set_needs_display();
 
@@ -602,10 +604,14 @@ CSS::RequiredInvalidationAfterStyleChange Element::recompute_style()
 
             if (auto* node_with_style = dynamic_cast<Layout::NodeWithStyle*>(pseudo_element->layout_node.ptr())) {
                 node_with_style->apply_style(*pseudo_element_style);
+                if (invalidation.relayout)
+                    node_with_style->set_needs_layout();
                 if (invalidation.repaint && node_with_style->paintable())
                     node_with_style->paintable()->set_needs_display();
             }
         }
+    } else if (!invalidation.rebuild_layout_tree && invalidation.relayout) {
+        document().set_needs_layout();
     }
 
     return invalidation;
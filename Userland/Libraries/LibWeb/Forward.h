@@ -597,6 +597,7 @@ class PaintableBox;
 class PaintableWithLines;
 class StackingContext;
 class TextPaintable;
+class TiledRasterizerCPU;
 class VideoPaintable;
 class ViewportPaintable;
 
@@ -18,6 +18,7 @@
 #include <LibWeb/HTML/Window.h>
 #include <LibWeb/Page/Page.h>
 #include <LibWeb/Painting/DisplayListPlayerCPU.h>
+#include <LibWeb/Painting/TiledRasterizerCPU.h>
 #include <LibWeb/Platform/EventLoopPlugin.h>
 
 #ifdef HAS_ACCELERATED_GRAPHICS
@@ -1200,6 +1201,10 @@ void TraversableNavigable::paint(Web::DevicePixelRect const& content_rect, Gfx::
             has_warned_about_configuration = true;
         }
 #endif
+    } else if (display_list_player_type == DisplayListPlayerType::CPU) {
+        if (!m_tiled_rasterizer)
+            m_tiled_rasterizer = make<Painting::TiledRasterizerCPU>();
+        m_tiled_rasterizer->rasterize(display_list, target);
     } else {
         Web::Painting::DisplayListPlayerCPU player(target, display_list_player_type == DisplayListPlayerType::CPUWithExperimentalTransformSupport);
         display_list.execute(player);
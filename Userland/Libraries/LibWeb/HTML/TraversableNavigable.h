@@ -123,6 +123,9 @@ private:
     JS::NonnullGCPtr<SessionHistoryTraversalQueue> m_session_history_traversal_queue;
 
     String m_window_handle;
+
+    // Kept between frames, so that tiles whose contents did not change don't have to be painted again.
+    OwnPtr<Painting::TiledRasterizerCPU> m_tiled_rasterizer;
 };
 
 struct BrowsingContextAndDocument {
@@ -175,6 +175,11 @@ struct DummyFormattingContext : public FormattingContext {
 };
 
 OwnPtr<FormattingContext> FormattingContext::create_independent_formatting_context_if_needed(LayoutState& state, Box const& child_box)
+{
+    return create_independent_formatting_context_if_needed(state, child_box, this);
+}
+
+OwnPtr<FormattingContext> FormattingContext::create_independent_formatting_context_if_needed(LayoutState& state, Box const& child_box, FormattingContext* parent)
 {
     auto type = formatting_context_type_created_by_box(child_box);
     if (!type.has_value())
@@ -182,15 +187,15 @@ OwnPtr<FormattingContext> FormattingContext::create_independent_formatting_conte
 
     switch (type.value()) {
     case Type::Block:
-        return make<BlockFormattingContext>(state, verify_cast<BlockContainer>(child_box), this);
+        return make<BlockFormattingContext>(state, verify_cast<BlockContainer>(child_box), parent);
     case Type::SVG:
-        return make<SVGFormattingContext>(state, child_box, this);
+        return make<SVGFormattingContext>(state, child_box, parent);
     case Type::Flex:
-        return make<FlexFormattingContext>(state, child_box, this);
+        return make<FlexFormattingContext>(state, child_box, parent);
     case Type::Grid:
-        return make<GridFormattingContext>(state, child_box, this);
+        return make<GridFormattingContext>(state, child_box, parent);
     case Type::Table:
-        return make<TableFormattingContext>(state, child_box, this);
+        return make<TableFormattingContext>(state, child_box, parent);
     case Type::InternalReplaced:
         return make<ReplacedFormattingContext>(state, child_box);
     case Type::InternalDummy:
@@ -225,13 +230,55 @@ OwnPtr<FormattingContext> FormattingContext::layout_inside(Box const& child_box,
 
     auto independent_formatting_context = create_independent_formatting_context_if_needed(m_state, child_box);
     if (independent_formatting_context)
-        independent_formatting_context->run(child_box, layout_mode, available_space);
+        run_independent_formatting_context(*independent_formatting_context, child_box, layout_mode, available_space);
     else
         run(child_box, layout_mode, available_space);
 
     return independent_formatting_context;
 }
 
+// A box can be a relayout boundary if its size is determined without looking at its contents. To keep this simple,
+// we only consider block-level boxes with a fixed size in flow layout, since flex, grid and table layout may size
+// their items based on contents regardless, and the baseline of inline-level boxes depends on their contents.
+static bool can_be_relayout_boundary(Box const& box)
+{
+    if (!box.parent() || !box.display().is_block_outside())
+        return false;
+
+    auto parent_display = box.parent()->display();
+    if (!parent_display.is_flow_inside() && !parent_display.is_flow_root_inside())
+        return false;
+
+    auto type = FormattingContext::formatting_context_type_created_by_box(box);
+    if (type != FormattingContext::Type::Block && type != FormattingContext::Type::Flex && type != FormattingContext::Type::Grid)
+        return false;
+
+    auto is_fixed = [](CSS::Size const& size) { return size.is_length() || size.is_percentage(); };
+    auto is_intrinsic = [](CSS::Size const& size) { return size.is_min_content() || size.is_max_content() || size.is_fit_content(); };
+    auto const& computed_values = box.computed_values();
+    return is_fixed(computed_values.width())
+        && is_fixed(computed_values.height())
+        && !is_intrinsic(computed_values.min_width())
+        && !is_intrinsic(computed_values.min_height())
+        && !is_intrinsic(computed_values.max_width())
+        && !is_intrinsic(computed_values.max_height());
+}
+
+void FormattingContext::run_independent_formatting_context(FormattingContext& context, Box const& box, LayoutMode layout_mode, AvailableSpace const& available_space)
+{
+    // NOTE: Only the layout that gets committed is kept around, so throwaway layouts for intrinsic sizing don't count.
+    if (layout_mode == LayoutMode::Normal && !m_state.m_parent && can_be_relayout_boundary(box)) {
+        auto const& box_state = m_state.get(box);
+        if (box_state.has_definite_width() && box_state.has_definite_height()) {
+            LayoutState::RelayoutBoundaryInputs inputs { available_space, box_state.content_width(), box_state.content_height() };
+            m_state.relayout_boundaries.set(box, inputs);
+            if (m_state.reuse_previous_layout_inside(box, inputs))
+                return;
+        }
+    }
+    context.run(box, layout_mode, available_space);
+}
+
 CSSPixels FormattingContext::greatest_child_width(Box const& box) const
 {
     CSSPixels max_width = 0;
@@ -65,6 +65,7 @@ public:
     CSSPixels compute_height_for_replaced_element(Box const&, AvailableSpace const&) const;
 
     OwnPtr<FormattingContext> create_independent_formatting_context_if_needed(LayoutState&, Box const& child_box);
+    static OwnPtr<FormattingContext> create_independent_formatting_context_if_needed(LayoutState&, Box const& child_box, FormattingContext* parent);
 
     virtual void parent_context_did_dimension_child_root_box() { }
 
@@ -123,6 +124,9 @@ protected:
 
     OwnPtr<FormattingContext> layout_inside(Box const&, LayoutMode, AvailableSpace const&);
 
+    // Runs `context` for `box`, reusing the previous layout of its insides instead if `box` is an unchanged relayout boundary.
+    void run_independent_formatting_context(FormattingContext& context, Box const& box, LayoutMode, AvailableSpace const&);
+
     struct SpaceUsedByFloats {
         CSSPixels left { 0 };
         CSSPixels right { 0 };
@@ -6,9 +6,11 @@
  */
 
 #include <AK/Debug.h>
+#include <AK/TemporaryChange.h>
 #include <LibWeb/DOM/ShadowRoot.h>
 #include <LibWeb/Layout/AvailableSpace.h>
 #include <LibWeb/Layout/BlockContainer.h>
+#include <LibWeb/Layout/FormattingContext.h>
 #include <LibWeb/Layout/InlineNode.h>
 #include <LibWeb/Layout/LayoutState.h>
 #include <LibWeb/Layout/Viewport.h>
@@ -29,6 +31,18 @@ LayoutState::~LayoutState()
 {
 }
 
+void LayoutState::visit_edges(JS::Cell::Visitor& visitor) const
+{
+    for (auto const& it : used_values_per_layout_node) {
+        visitor.visit(it.key);
+        it.value->visit_edges(visitor);
+    }
+    for (auto const& it : intrinsic_sizes)
+        visitor.visit(it.key);
+    for (auto const& it : relayout_boundaries)
+        visitor.visit(it.key);
+}
+
 LayoutState::UsedValues& LayoutState::get_mutable(NodeWithStyle const& node)
 {
     if (auto* used_values = used_values_per_layout_node.get(node).value_or(nullptr))
@@ -71,6 +85,90 @@ LayoutState::UsedValues const& LayoutState::get(NodeWithStyle const& node) const
     return *new_used_values_ptr;
 }
 
+bool LayoutState::reuse_previous_layout_inside(Box const& box, RelayoutBoundaryInputs const& inputs)
+{
+    if (!m_previous_layout || box.needs_layout() || box.child_needs_layout())
+        return false;
+
+    auto previous_inputs = m_previous_layout->relayout_boundaries.get(box);
+    if (!previous_inputs.has_value() || previous_inputs.value() != inputs)
+        return false;
+
+    // NOTE: Absolutely positioned descendants with a containing block outside of the box are positioned relative
+    //       to something that may have moved since the previous layout, so we can't reuse anything.
+    auto has_descendant_positioned_outside = false;
+    box.for_each_in_subtree_of_type<Box>([&](Box const& descendant) {
+        if (descendant.is_absolutely_positioned() && !box.is_inclusive_ancestor_of(*descendant.containing_block())) {
+            has_descendant_positioned_outside = true;
+            return TraversalDecision::Break;
+        }
+        return TraversalDecision::Continue;
+    });
+    if (has_descendant_positioned_outside)
+        return false;
+
+    // NOTE: This is a pre-order traversal, so the used values of containing blocks are always copied before those
+    //       of the boxes they contain.
+    box.for_each_in_subtree_of_type<NodeWithStyle>([&](NodeWithStyle const& node) {
+        auto const* previous_used_values = m_previous_layout->used_values_per_layout_node.get(node).value_or(nullptr);
+        if (!previous_used_values)
+            return TraversalDecision::Continue;
+
+        auto used_values = adopt_own(*new UsedValues(*previous_used_values));
+        used_values->set_containing_block_used_values(&get(*node.containing_block()));
+        used_values_per_layout_node.set(node, move(used_values));
+
+        if (node.is_box()) {
+            if (auto nested_inputs = m_previous_layout->relayout_boundaries.get(static_cast<Box const&>(node)); nested_inputs.has_value())
+                relayout_boundaries.set(static_cast<Box const&>(node), nested_inputs.value());
+        }
+        return TraversalDecision::Continue;
+    });
+
+    // The line boxes and floats of the box itself are also produced by laying out its insides.
+    auto const& previous_box_state = m_previous_layout->get(box);
+    auto& box_state = get_mutable(box);
+    box_state.line_boxes = previous_box_state.line_boxes;
+    for (auto const& floating_box : previous_box_state.floating_descendants())
+        box_state.add_floating_descendant(*floating_box);
+    return true;
+}
+
+void LayoutState::relayout_inside(Box const& box)
+{
+    // Only the top-level LayoutState is kept around between layouts.
+    VERIFY(!m_parent);
+
+    auto maybe_inputs = relayout_boundaries.get(box);
+    VERIFY(maybe_inputs.has_value());
+    auto inputs = maybe_inputs.value();
+
+    // NOTE: The previous used values of everything inside the box are moved out of the way, so that the insides of
+    //       relayout boundaries nested in it can still be reused if nothing changed in them.
+    LayoutState previous_layout;
+    box.for_each_in_subtree_of_type<NodeWithStyle>([&](NodeWithStyle const& node) {
+        if (auto used_values = used_values_per_layout_node.take(node); used_values.has_value())
+            previous_layout.used_values_per_layout_node.set(node, used_values.release_value());
+        if (node.is_box()) {
+            if (auto nested_inputs = relayout_boundaries.take(static_cast<Box const&>(node)); nested_inputs.has_value())
+                previous_layout.relayout_boundaries.set(static_cast<Box const&>(node), nested_inputs.release_value());
+        }
+        intrinsic_sizes.remove(node);
+        return TraversalDecision::Continue;
+    });
+    intrinsic_sizes.remove(box);
+
+    auto& box_state = get_mutable(box);
+    box_state.line_boxes.clear();
+    box_state.clear_floating_descendants();
+
+    TemporaryChange previous_layout_change { m_previous_layout, static_cast<LayoutState const*>(&previous_layout) };
+    auto context = FormattingContext::create_independent_formatting_context_if_needed(*this, box, nullptr);
+    VERIFY(context);
+    context->run(box, LayoutMode::Normal, inputs.available_space);
+    context->parent_context_did_dimension_child_root_box();
+}
+
 // https://www.w3.org/TR/css-overflow-3/#scrollable-overflow
 static CSSPixelRect measure_scrollable_overflow(Box const& box)
 {
@@ -276,7 +374,7 @@ void LayoutState::commit(Box& root)
 
             if (used_values.computed_svg_path().has_value() && is<Painting::SVGPathPaintable>(paintable_box)) {
                 auto& svg_geometry_paintable = static_cast<Painting::SVGPathPaintable&>(paintable_box);
-                svg_geometry_paintable.set_computed_path(move(*used_values.computed_svg_path()));
+                svg_geometry_paintable.set_computed_path(*used_values.computed_svg_path());
             }
         }
     }
@@ -526,6 +624,16 @@ void LayoutState::UsedValues::set_node(NodeWithStyle& node, UsedValues const* co
     }
 }
 
+void LayoutState::UsedValues::visit_edges(JS::Cell::Visitor& visitor) const
+{
+    visitor.visit(m_node);
+    visitor.visit(m_floating_descendants);
+    for (auto const& line_box : line_boxes) {
+        for (auto const& fragment : line_box.fragments())
+            visitor.visit(JS::NonnullGCPtr { fragment.layout_node() });
+    }
+}
+
 void LayoutState::UsedValues::set_content_width(CSSPixels width)
 {
     VERIFY(!width.might_be_saturated());
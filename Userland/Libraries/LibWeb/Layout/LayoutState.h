@@ -8,6 +8,7 @@
 
 #include <AK/HashMap.h>
 #include <LibGfx/Point.h>
+#include <LibWeb/Layout/AvailableSpace.h>
 #include <LibWeb/Layout/Box.h>
 #include <LibWeb/Layout/LineBox.h>
 #include <LibWeb/Painting/PaintableBox.h>
@@ -21,9 +22,6 @@ enum class SizeConstraint {
     MaxContent,
 };
 
-class AvailableSize;
-class AvailableSpace;
-
 struct LayoutState {
     LayoutState()
         : m_root(*this)
@@ -46,6 +44,7 @@ struct LayoutState {
         void set_node(NodeWithStyle&, UsedValues const* containing_block_used_values);
 
         UsedValues const* containing_block_used_values() const { return m_containing_block_used_values; }
+        void set_containing_block_used_values(UsedValues const* used_values) { m_containing_block_used_values = used_values; }
 
         CSSPixels content_width() const { return m_content_width; }
         CSSPixels content_height() const { return m_content_height; }
@@ -125,6 +124,7 @@ struct LayoutState {
 
         void add_floating_descendant(Box const& box) { m_floating_descendants.set(&box); }
         auto const& floating_descendants() const { return m_floating_descendants; }
+        void clear_floating_descendants() { m_floating_descendants.clear(); }
 
         void set_override_borders_data(Painting::PaintableBox::BordersDataWithElementKind const& override_borders_data) { m_override_borders_data = override_borders_data; }
         auto const& override_borders_data() const { return m_override_borders_data; }
@@ -133,9 +133,11 @@ struct LayoutState {
         auto const& table_cell_coordinates() const { return m_table_cell_coordinates; }
 
         void set_computed_svg_path(Gfx::Path const& svg_path) { m_computed_svg_path = svg_path; }
-        auto& computed_svg_path() { return m_computed_svg_path; }
+        auto const& computed_svg_path() const { return m_computed_svg_path; }
 
         void set_computed_svg_transforms(Painting::SVGGraphicsPaintable::ComputedTransforms const& computed_transforms) { m_computed_svg_transforms = computed_transforms; }
+
+        void visit_edges(JS::Cell::Visitor&) const;
         auto const& computed_svg_transforms() const { return m_computed_svg_transforms; }
 
     private:
@@ -190,11 +192,39 @@ struct LayoutState {
 
     HashMap<JS::GCPtr<NodeWithStyle const>, NonnullOwnPtr<IntrinsicSizes>> mutable intrinsic_sizes;
 
+    // A relayout boundary is a box whose size doesn't depend on anything inside of it, so changes inside of it
+    // can't affect the layout of anything outside of it. For each one, we remember what its insides were laid out
+    // with, so that a later layout can tell whether they can be reused as is.
+    struct RelayoutBoundaryInputs {
+        AvailableSpace available_space;
+        CSSPixels content_width;
+        CSSPixels content_height;
+
+        bool operator==(RelayoutBoundaryInputs const&) const = default;
+    };
+    HashMap<JS::NonnullGCPtr<Box const>, RelayoutBoundaryInputs> relayout_boundaries;
+
+    // The layout that this one is replacing, if any.
+    void set_previous_layout(LayoutState const* previous_layout) { m_previous_layout = previous_layout; }
+
+    // Copies the used values of everything inside `box` from the previous layout, if nothing in there has changed
+    // and the box is laid out with the same inputs as before. Returns false if the insides need to be laid out.
+    [[nodiscard]] bool reuse_previous_layout_inside(Box const&, RelayoutBoundaryInputs const&);
+
+    // Lays out the insides of a relayout boundary again, keeping the used values of everything outside of it.
+    void relayout_inside(Box const&);
+
+    // NOTE: The document keeps its last layout state around between layouts, so it has to be able to keep the layout
+    //       nodes in it alive.
+    void visit_edges(JS::Cell::Visitor&) const;
+
     LayoutState const* m_parent { nullptr };
     LayoutState const& m_root;
 
 private:
     void resolve_relative_positions();
+
+    LayoutState const* m_previous_layout { nullptr };
 };
 
 }
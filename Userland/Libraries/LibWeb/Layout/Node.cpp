@@ -1019,6 +1019,40 @@ JS::GCPtr<Painting::Paintable> Node::create_paintable() const
     return nullptr;
 }
 
+void Node::set_needs_layout()
+{
+    if (m_needs_layout)
+        return;
+    m_needs_layout = true;
+
+    // NOTE: Nothing outside of a relayout boundary is affected by changes inside of it, so we stop marking ancestors
+    //       at the nearest one. If this node is a relayout boundary itself, its own size may change, so it doesn't count.
+    Box* relayout_boundary = nullptr;
+    for (auto* ancestor = parent(); ancestor; ancestor = ancestor->parent()) {
+        // If the ancestor is already marked, so is everything above it up to the nearest relayout boundary.
+        if (ancestor->child_needs_layout())
+            break;
+        ancestor->set_child_needs_layout(true);
+        if (ancestor->is_box() && document().is_relayout_boundary(static_cast<Box const&>(*ancestor))) {
+            relayout_boundary = static_cast<Box*>(ancestor);
+            break;
+        }
+    }
+    document().set_needs_layout({}, relayout_boundary);
+}
+
+void Node::clear_needs_layout_in_subtree()
+{
+    m_needs_layout = false;
+    if (!m_child_needs_layout)
+        return;
+    m_child_needs_layout = false;
+    for_each_child([](Node& child) {
+        child.clear_needs_layout_in_subtree();
+        return IterationDecision::Continue;
+    });
+}
+
 bool Node::is_anonymous() const
 {
     return m_anonymous;
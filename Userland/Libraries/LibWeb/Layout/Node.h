@@ -172,6 +172,16 @@ public:
     // https://www.w3.org/TR/CSS22/visuren.html#positioning-scheme
     bool is_in_flow() const { return !is_out_of_flow(); }
 
+    // A node that needs layout has changed in a way that may affect its layout. Its ancestors, up to the nearest
+    // relayout boundary, are marked as having a child that needs layout. See LayoutState::relayout_boundaries.
+    bool needs_layout() const { return m_needs_layout; }
+    void set_needs_layout();
+
+    bool child_needs_layout() const { return m_child_needs_layout; }
+    void set_child_needs_layout(bool b) { m_child_needs_layout = b; }
+
+    void clear_needs_layout_in_subtree();
+
 protected:
     Node(DOM::Document&, DOM::Node*);
 
@@ -194,6 +204,9 @@ private:
     bool m_is_flex_item { false };
     bool m_is_grid_item { false };
 
+    bool m_needs_layout { false };
+    bool m_child_needs_layout { false };
+
     GeneratedFor m_generated_for { GeneratedFor::NotGenerated };
 
     u32 m_initial_quote_nesting_level { 0 };
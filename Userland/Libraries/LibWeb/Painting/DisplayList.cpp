@@ -111,17 +111,28 @@ void DisplayList::execute(DisplayListPlayer& executor)
         executor.update_immutable_bitmap_texture_cache(immutable_bitmaps);
     }
 
+    execute_commands(executor, m_commands.size(), [](size_t index) { return index; });
+}
+
+void DisplayList::execute(DisplayListPlayer& executor, ReadonlySpan<u32> command_indices)
+{
+    executor.prepare_to_execute(m_corner_clip_max_depth);
+    execute_commands(executor, command_indices.size(), [&](size_t index) { return command_indices[index]; });
+}
+
+template<typename GetCommandIndex>
+void DisplayList::execute_commands(DisplayListPlayer& executor, size_t command_count, GetCommandIndex command_index_at)
+{
     HashTable<u32> skipped_sample_corner_commands;
     size_t next_command_index = 0;
     Vector<DisplayListPlayer&, 16> executor_stack;
     DisplayListPlayer* current_executor = &executor;
-    while (next_command_index < m_commands.size()) {
-        if (m_commands[next_command_index].skip) {
-            next_command_index++;
+    while (next_command_index < command_count) {
+        CommandListItem& command_list_item = m_commands[command_index_at(next_command_index++)];
+        if (command_list_item.skip)
             continue;
-        }
 
-        auto& command = m_commands[next_command_index++].command;
+        auto& command = command_list_item.command;
         auto bounding_rect = command_bounding_rectangle(command);
         if (bounding_rect.has_value() && (bounding_rect->is_empty() || current_executor->would_be_fully_clipped_by_painter(*bounding_rect))) {
             if (command.has<SampleUnderCorners>()) {
@@ -187,10 +198,11 @@ void DisplayList::execute(DisplayListPlayer& executor)
             current_executor = &executor_stack.take_last();
         } else if (result == CommandResult::SkipStackingContext) {
             auto stacking_context_nesting_level = 1;
-            while (next_command_index < m_commands.size()) {
-                if (m_commands[next_command_index].command.has<PushStackingContext>()) {
+            while (next_command_index < command_count) {
+                Command const& skipped_command = m_commands[command_index_at(next_command_index)].command;
+                if (skipped_command.has<PushStackingContext>()) {
                     stacking_context_nesting_level++;
-                } else if (m_commands[next_command_index].command.has<PopStackingContext>()) {
+                } else if (skipped_command.has<PopStackingContext>()) {
                     stacking_context_nesting_level--;
                 }
 
@@ -92,10 +92,27 @@ public:
     void mark_unnecessary_commands();
     void execute(DisplayListPlayer&);
 
+    // Replays only the commands with the given indices, e.g. the ones binned to a single tile.
+    // The indices have to be in ascending order and include every stacking context command, so that pushes and pops
+    // stay balanced.
+    void execute(DisplayListPlayer&, ReadonlySpan<u32> command_indices);
+
+    template<typename Callback>
+    void for_each_command(Callback callback) const
+    {
+        for (u32 command_index = 0; command_index < m_commands.size(); ++command_index) {
+            if (!m_commands[command_index].skip)
+                callback(command_index, m_commands[command_index].command);
+        }
+    }
+
     size_t corner_clip_max_depth() const { return m_corner_clip_max_depth; }
     void set_corner_clip_max_depth(size_t depth) { m_corner_clip_max_depth = depth; }
 
 private:
+    template<typename GetCommandIndex>
+    void execute_commands(DisplayListPlayer&, size_t command_count, GetCommandIndex);
+
     struct CommandListItem {
         Optional<i32> scroll_frame_id;
         Command command;
@@ -25,6 +25,13 @@ DisplayListPlayerCPU::DisplayListPlayerCPU(Gfx::Bitmap& bitmap, bool enable_affi
         .scaling_mode = {} });
 }
 
+DisplayListPlayerCPU::DisplayListPlayerCPU(Gfx::Bitmap& bitmap, Gfx::IntPoint origin)
+    : DisplayListPlayerCPU(bitmap)
+{
+    m_origin = origin;
+    painter().translate(-origin);
+}
+
 DisplayListPlayerCPU::~DisplayListPlayerCPU() = default;
 
 CommandResult DisplayListPlayerCPU::draw_glyph_run(DrawGlyphRun const& command)
@@ -134,8 +141,11 @@ CommandResult DisplayListPlayerCPU::push_stacking_context(PushStackingContext co
     }
 
     painter().save();
-    if (command.is_fixed_position)
+    if (command.is_fixed_position) {
         painter().translate(-painter().translation());
+        if (stacking_contexts.first().painter.ptr() == &painter())
+            painter().translate(-m_origin);
+    }
 
     if (command.mask.has_value()) {
         // TODO: Support masks and other stacking context features at the same time.
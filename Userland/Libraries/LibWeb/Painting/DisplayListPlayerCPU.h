@@ -54,6 +54,10 @@ public:
     void update_immutable_bitmap_texture_cache(HashMap<u32, Gfx::ImmutableBitmap const*>&) override {};
 
     DisplayListPlayerCPU(Gfx::Bitmap& bitmap, bool enable_affine_command_executor = false);
+
+    // Paints the part of the display list that lands on the given bitmap when its top left corner is placed at origin,
+    // e.g. a single tile of the viewport.
+    DisplayListPlayerCPU(Gfx::Bitmap& bitmap, Gfx::IntPoint origin);
     ~DisplayListPlayerCPU();
 
     DisplayListPlayer& nested_player() override
@@ -64,6 +68,7 @@ public:
 private:
     Gfx::Bitmap& m_target_bitmap;
     bool m_enable_affine_command_executor { false };
+    Gfx::IntPoint m_origin;
 
     Vector<RefPtr<BorderRadiusCornerClipper>> m_corner_clippers_stack;
 
@@ -0,0 +1,615 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BitCast.h>
+#include <AK/HashMap.h>
+#include <LibCore/System.h>
+#include <LibGfx/Painter.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+#include <LibThreading/ThreadPool.h>
+#include <LibWeb/Painting/DisplayListPlayerCPU.h>
+#include <LibWeb/Painting/TiledRasterizerCPU.h>
+
+namespace Web::Painting {
+
+// A hash of everything that affects the pixels produced by a sequence of commands.
+class Fingerprint {
+public:
+    static u64 combine(u64 seed, u64 value)
+    {
+        return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+    }
+
+    u64 value() const { return m_value; }
+
+    void add(u64 value) { m_value = combine(m_value, value); }
+
+    template<Integral T>
+    void add(T value) { add(static_cast<u64>(value)); }
+
+    template<Enum T>
+    void add(T value) { add(to_underlying(value)); }
+
+    void add(float value) { add(bit_cast<u32>(value)); }
+    void add(double value) { add(bit_cast<u64>(value)); }
+    void add(Color color) { add(color.value()); }
+
+    template<typename T>
+    void add(Gfx::Point<T> point)
+    {
+        add(point.x());
+        add(point.y());
+    }
+
+    template<typename T>
+    void add(Gfx::Size<T> size)
+    {
+        add(size.width());
+        add(size.height());
+    }
+
+    template<typename T>
+    void add(Gfx::Rect<T> rect)
+    {
+        add(rect.location());
+        add(rect.size());
+    }
+
+    template<typename T>
+    void add(Optional<T> const& value)
+    {
+        add(value.has_value());
+        if (value.has_value())
+            add(*value);
+    }
+
+    template<typename T, size_t inline_capacity>
+    void add(Vector<T, inline_capacity> const& values)
+    {
+        add(values.size());
+        for (auto const& value : values)
+            add(value);
+    }
+
+    void add(Gfx::CornerRadius radius)
+    {
+        add(radius.horizontal_radius);
+        add(radius.vertical_radius);
+    }
+
+    void add(CornerRadii const& radii)
+    {
+        add(radii.top_left);
+        add(radii.top_right);
+        add(radii.bottom_right);
+        add(radii.bottom_left);
+    }
+
+    void add(Gfx::ColorStop const& color_stop)
+    {
+        add(color_stop.color);
+        add(color_stop.position);
+        add(color_stop.transition_hint);
+    }
+
+    void add(ColorStopData const& color_stops)
+    {
+        add(color_stops.list);
+        add(color_stops.repeat_length);
+    }
+
+    void add(Gfx::Path const& path)
+    {
+        for (auto segment : path) {
+            add(segment.command());
+            for (auto point : segment.points())
+                add(point);
+        }
+    }
+
+    void add(Gfx::GlyphRun const& glyph_run)
+    {
+        // NOTE: Fonts are immutable and kept alive by the glyph runs that use them, so their address identifies them.
+        add(reinterpret_cast<FlatPtr>(&glyph_run.font()));
+        add(glyph_run.glyphs().size());
+        for (auto const& glyph_or_emoji : glyph_run.glyphs()) {
+            glyph_or_emoji.visit(
+                [&](Gfx::DrawGlyph const& glyph) {
+                    add(glyph.position);
+                    add(glyph.code_point);
+                },
+                [&](Gfx::DrawEmoji const& emoji) {
+                    add(emoji.position);
+                    add(reinterpret_cast<FlatPtr>(emoji.emoji));
+                });
+        }
+    }
+
+    void add(PaintBoxShadowParams const& params)
+    {
+        add(params.color);
+        add(params.placement);
+        add(params.corner_radii);
+        add(params.offset_x);
+        add(params.offset_y);
+        add(params.blur_radius);
+        add(params.spread_distance);
+        add(params.device_content_rect);
+    }
+
+    void add(StackingContextTransform const& transform)
+    {
+        add(transform.origin);
+        for (size_t i = 0; i < 4; ++i) {
+            for (size_t j = 0; j < 4; ++j)
+                add(transform.matrix.elements()[i][j]);
+        }
+    }
+
+private:
+    u64 m_value { 0 };
+};
+
+// Returns nothing if the pixels produced by the command depend on something that may change without the command
+// changing, like the contents of a mutable bitmap.
+static Optional<u64> command_fingerprint(Command const& command)
+{
+    Fingerprint fingerprint;
+    fingerprint.add(command.index());
+    auto is_cacheable = command.visit(
+        [&](DrawGlyphRun const& command) {
+            fingerprint.add(*command.glyph_run);
+            fingerprint.add(command.color);
+            fingerprint.add(command.rect);
+            fingerprint.add(command.translation);
+            fingerprint.add(command.scale);
+            return true;
+        },
+        [&](FillRect const& command) {
+            fingerprint.add(command.rect);
+            fingerprint.add(command.color);
+            fingerprint.add(command.clip_paths);
+            return true;
+        },
+        [&](DrawScaledBitmap const&) {
+            return false;
+        },
+        [&](DrawScaledImmutableBitmap const& command) {
+            fingerprint.add(command.dst_rect);
+            fingerprint.add(command.bitmap->id());
+            fingerprint.add(command.src_rect);
+            fingerprint.add(command.scaling_mode);
+            fingerprint.add(command.clip_paths);
+            return true;
+        },
+        [&](SetClipRect const& command) {
+            fingerprint.add(command.rect);
+            return true;
+        },
+        [&](ClearClipRect const&) {
+            return true;
+        },
+        [&](PushStackingContext const& command) {
+            if (command.mask.has_value())
+                return false;
+            fingerprint.add(command.opacity);
+            fingerprint.add(command.is_fixed_position);
+            fingerprint.add(command.source_paintable_rect);
+            fingerprint.add(command.post_transform_translation);
+            fingerprint.add(command.image_rendering);
+            fingerprint.add(command.transform);
+            return true;
+        },
+        [&](PopStackingContext const&) {
+            return true;
+        },
+        [&](PaintLinearGradient const& command) {
+            fingerprint.add(command.gradient_rect);
+            fingerprint.add(command.linear_gradient_data.gradient_angle);
+            fingerprint.add(command.linear_gradient_data.color_stops);
+            fingerprint.add(command.clip_paths);
+            return true;
+        },
+        [&](PaintRadialGradient const& command) {
+            fingerprint.add(command.rect);
+            fingerprint.add(command.radial_gradient_data.color_stops);
+            fingerprint.add(command.center);
+            fingerprint.add(command.size);
+            fingerprint.add(command.clip_paths);
+            return true;
+        },
+        [&](PaintConicGradient const& command) {
+            fingerprint.add(command.rect);
+            fingerprint.add(command.conic_gradient_data.start_angle);
+            fingerprint.add(command.conic_gradient_data.color_stops);
+            fingerprint.add(command.position);
+            fingerprint.add(command.clip_paths);
+            return true;
+        },
+        [&](PaintOuterBoxShadow const& command) {
+            fingerprint.add(command.box_shadow_params);
+            return true;
+        },
+        [&](PaintInnerBoxShadow const& command) {
+            fingerprint.add(command.box_shadow_params);
+            return true;
+        },
+        [&](PaintTextShadow const& command) {
+            fingerprint.add(command.blur_radius);
+            fingerprint.add(command.shadow_bounding_rect);
+            fingerprint.add(command.text_rect);
+            fingerprint.add(*command.glyph_run);
+            fingerprint.add(command.glyph_run_scale);
+            fingerprint.add(command.color);
+            fingerprint.add(command.draw_location);
+            return true;
+        },
+        [&](FillRectWithRoundedCorners const& command) {
+            fingerprint.add(command.rect);
+            fingerprint.add(command.color);
+            fingerprint.add(command.top_left_radius);
+            fingerprint.add(command.top_right_radius);
+            fingerprint.add(command.bottom_left_radius);
+            fingerprint.add(command.bottom_right_radius);
+            fingerprint.add(command.clip_paths);
+            return true;
+        },
+        [&](FillPathUsingColor const& command) {
+            fingerprint.add(command.path_bounding_rect);
+            fingerprint.add(command.path);
+            fingerprint.add(command.color);
+            fingerprint.add(command.winding_rule);
+            fingerprint.add(command.aa_translation);
+            return true;
+        },
+        [&](FillPathUsingPaintStyle const&) {
+            return false;
+        },
+        [&](StrokePathUsingColor const& command) {
+            fingerprint.add(command.cap_style);
+            fingerprint.add(command.path_bounding_rect);
+            fingerprint.add(command.path);
+            fingerprint.add(command.color);
+            fingerprint.add(command.thickness);
+            fingerprint.add(command.aa_translation);
+            return true;
+        },
+        [&](StrokePathUsingPaintStyle const&) {
+            return false;
+        },
+        [&](DrawEllipse const& command) {
+            fingerprint.add(command.rect);
+            fingerprint.add(command.color);
+            fingerprint.add(command.thickness);
+            return true;
+        },
+        [&](FillEllipse const& command) {
+            fingerprint.add(command.rect);
+            fingerprint.add(command.color);
+            return true;
+        },
+        [&](DrawLine const& command) {
+            fingerprint.add(command.color);
+            fingerprint.add(command.from);
+            fingerprint.add(command.to);
+            fingerprint.add(command.thickness);
+            fingerprint.add(command.style);
+            fingerprint.add(command.alternate_color);
+            return true;
+        },
+        [&](ApplyBackdropFilter const&) {
+            return false;
+        },
+        [&](DrawRect const& command) {
+            fingerprint.add(command.rect);
+            fingerprint.add(command.color);
+            fingerprint.add(command.rough);
+            return true;
+        },
+        [&](DrawTriangleWave const& command) {
+            fingerprint.add(command.p1);
+            fingerprint.add(command.p2);
+            fingerprint.add(command.color);
+            fingerprint.add(command.amplitude);
+            fingerprint.add(command.thickness);
+            return true;
+        },
+        [&](SampleUnderCorners const& command) {
+            fingerprint.add(command.corner_radii);
+            fingerprint.add(command.border_rect);
+            fingerprint.add(command.corner_clip);
+            return true;
+        },
+        [&](BlitCornerClipping const& command) {
+            fingerprint.add(command.border_rect);
+            return true;
+        });
+    if (!is_cacheable)
+        return {};
+    return fingerprint.value();
+}
+
+// Returns whether several players can execute the command at the same time. Commands that are thread-safe only read
+// from the command itself and the bitmaps it draws, and only write to the player's own bitmaps. Everything else, like
+// the glyph caches of fonts, or reference counts of objects shared between commands, must not be touched by them.
+// NOTE: Keep this in sync with DisplayListPlayerCPU when adding commands, or changing how they are executed.
+static bool is_thread_safe(Command const& command)
+{
+    return command.visit(
+        [](DrawGlyphRun const&) {
+            // NOTE: Looking up scaled fonts and rasterizing glyphs fills caches that are shared by all players.
+            return false;
+        },
+        [](PaintTextShadow const&) {
+            return false;
+        },
+        [](FillPathUsingPaintStyle const&) {
+            // NOTE: Paint styles are reference counted, and may be used by several commands.
+            return false;
+        },
+        [](StrokePathUsingPaintStyle const&) {
+            return false;
+        },
+        [](PushStackingContext const& command) {
+            // NOTE: The player keeps a reference to the mask bitmap until the stacking context is popped.
+            return !command.mask.has_value();
+        },
+        [](auto const&) {
+            return true;
+        });
+}
+
+// NOTE: Paths compute their line segments lazily, which must not happen on several threads at once.
+static void segmentize_paths(Command const& command)
+{
+    command.visit([](auto const& command) {
+        if constexpr (requires { command.path; })
+            (void)command.path.split_lines();
+        if constexpr (requires { command.clip_paths; }) {
+            for (auto const& clip_path : command.clip_paths)
+                (void)clip_path.split_lines();
+        }
+    });
+}
+
+static Threading::ThreadPool<Function<void()>>& rasterization_thread_pool()
+{
+    static Threading::ThreadPool<Function<void()>> thread_pool { [](Function<void()> work) { work(); } };
+    return thread_pool;
+}
+
+void TiledRasterizerCPU::create_tiles(Gfx::IntSize viewport_size, Gfx::BitmapFormat bitmap_format)
+{
+    m_viewport_size = viewport_size;
+    m_bitmap_format = bitmap_format;
+    m_column_count = ceil_div(viewport_size.width(), tile_size);
+    m_row_count = ceil_div(viewport_size.height(), tile_size);
+
+    m_tiles.clear();
+    m_tiles.ensure_capacity(m_column_count * m_row_count);
+    for (int row = 0; row < m_row_count; ++row) {
+        for (int column = 0; column < m_column_count; ++column) {
+            Gfx::IntRect rect { column * tile_size, row * tile_size, tile_size, tile_size };
+            m_tiles.unchecked_append({ .rect = rect.intersected(Gfx::IntRect { {}, viewport_size }) });
+        }
+    }
+}
+
+bool TiledRasterizerCPU::bin_commands(DisplayList const& display_list)
+{
+    for (auto& tile : m_tiles) {
+        tile.command_indices.clear_with_capacity();
+        tile.fingerprint = 0;
+        tile.is_cacheable = true;
+        tile.is_thread_safe = true;
+    }
+
+    // The state of the player's painter at the command being binned, which decides where the command's bounding rect
+    // ends up on the viewport. Commands inside stacking contexts that paint into a bitmap of their own are binned to
+    // every tile, since their final position is only known once the stacking context has been painted.
+    struct PainterState {
+        Optional<Gfx::IntPoint> translation;
+        bool is_root_painter { true };
+    };
+    PainterState state { .translation = Gfx::IntPoint {} };
+    Vector<PainterState> state_stack;
+
+    HashMap<u32, Optional<Gfx::IntRect>> sample_under_corners_rects;
+    bool can_rasterize_in_tiles = true;
+    bool command_is_thread_safe = true;
+
+    auto bin_command = [&](u32 command_index, Optional<u64> fingerprint, Optional<Gfx::IntRect> rect) {
+        int first_column = 0;
+        int last_column = m_column_count - 1;
+        int first_row = 0;
+        int last_row = m_row_count - 1;
+        if (rect.has_value()) {
+            // NOTE: Allow for the rounding of fractional stacking context translations.
+            auto viewport_rect = rect->inflated(2, 2).intersected(Gfx::IntRect { {}, m_viewport_size });
+            if (viewport_rect.is_empty())
+                return;
+            first_column = viewport_rect.left() / tile_size;
+            last_column = (viewport_rect.right() - 1) / tile_size;
+            first_row = viewport_rect.top() / tile_size;
+            last_row = (viewport_rect.bottom() - 1) / tile_size;
+        }
+        for (int row = first_row; row <= last_row; ++row) {
+            for (int column = first_column; column <= last_column; ++column) {
+                auto& tile = m_tiles[row * m_column_count + column];
+                tile.command_indices.append(command_index);
+                if (fingerprint.has_value())
+                    tile.fingerprint = Fingerprint::combine(tile.fingerprint, *fingerprint);
+                else
+                    tile.is_cacheable = false;
+                if (!command_is_thread_safe)
+                    tile.is_thread_safe = false;
+            }
+        }
+    };
+
+    display_list.for_each_command([&](u32 command_index, Command const& command) {
+        if (!can_rasterize_in_tiles)
+            return;
+
+        segmentize_paths(command);
+
+        auto fingerprint = command_fingerprint(command);
+        command_is_thread_safe = is_thread_safe(command);
+        auto viewport_rect = [&](Gfx::IntRect rect) -> Optional<Gfx::IntRect> {
+            if (!state.translation.has_value())
+                return {};
+            return rect.translated(*state.translation);
+        };
+
+        command.visit(
+            [&](PushStackingContext const& command) {
+                bin_command(command_index, fingerprint, {});
+                auto affine_transform = Gfx::extract_2d_affine_transform(command.transform.matrix);
+                if (!affine_transform.is_identity_or_translation()) {
+                    // NOTE: Scaled stacking contexts are painted by resampling the area below them, which gives
+                    //       different results at the edges of a tile.
+                    can_rasterize_in_tiles = false;
+                    return;
+                }
+                state_stack.append(state);
+                if (command.is_fixed_position) {
+                    if (state.is_root_painter)
+                        state.translation = Gfx::IntPoint {};
+                    else
+                        state.translation = {};
+                }
+                if (command.mask.has_value()) {
+                    state = { .translation = {}, .is_root_painter = false };
+                    return;
+                }
+                if (state.translation.has_value())
+                    state.translation = *state.translation + affine_transform.translation().to_rounded<int>() + command.post_transform_translation;
+                if (command.opacity != 1.0f)
+                    state.is_root_painter = false;
+            },
+            [&](PopStackingContext const&) {
+                bin_command(command_index, fingerprint, {});
+                state = state_stack.take_last();
+            },
+            [&](ApplyBackdropFilter const&) {
+                // NOTE: Backdrop filters sample the pixels around them, which may belong to another tile.
+                can_rasterize_in_tiles = false;
+            },
+            [&](SampleUnderCorners const& command) {
+                if (command.border_rect.is_empty())
+                    return;
+                auto rect = viewport_rect(command.border_rect);
+                sample_under_corners_rects.set(command.id, rect);
+                bin_command(command_index, fingerprint, rect);
+            },
+            [&](BlitCornerClipping const& command) {
+                // NOTE: Each blit has to end up in the same tiles as its sample, or the players' corner clipper
+                //       stacks would get out of balance.
+                auto rect = sample_under_corners_rects.take(command.id);
+                if (!rect.has_value())
+                    return;
+                bin_command(command_index, fingerprint, *rect);
+            },
+            [&](auto const& command) {
+                if constexpr (requires { command.bounding_rect(); }) {
+                    if (command.bounding_rect().is_empty())
+                        return;
+                    bin_command(command_index, fingerprint, viewport_rect(command.bounding_rect()));
+                } else {
+                    bin_command(command_index, fingerprint, {});
+                }
+            });
+    });
+
+    return can_rasterize_in_tiles;
+}
+
+ErrorOr<void> TiledRasterizerCPU::paint_tile(DisplayList& display_list, Tile& tile)
+{
+    tile.cached_fingerprint = {};
+    if (!tile.bitmap)
+        tile.bitmap = TRY(Gfx::Bitmap::create(m_bitmap_format, tile.rect.size()));
+
+    DisplayListPlayerCPU player(*tile.bitmap, tile.rect.location());
+    display_list.execute(player, tile.command_indices.span());
+
+    if (tile.is_cacheable)
+        tile.cached_fingerprint = tile.fingerprint;
+    return {};
+}
+
+void TiledRasterizerCPU::paint_dirty_tiles(DisplayList& display_list)
+{
+    Vector<Tile&> dirty_tiles;
+    Vector<Tile&> dirty_thread_safe_tiles;
+    for (auto& tile : m_tiles) {
+        if (!tile.needs_repaint())
+            continue;
+        if (tile.is_thread_safe)
+            dirty_thread_safe_tiles.append(tile);
+        else
+            dirty_tiles.append(tile);
+    }
+
+    auto report_error = [](ErrorOr<void> result) {
+        if (result.is_error())
+            dbgln("Unable to rasterize tile: {}", result.error());
+    };
+
+    if (dirty_thread_safe_tiles.is_empty() || dirty_tiles.size() + dirty_thread_safe_tiles.size() <= 1 || Core::System::hardware_concurrency() <= 1) {
+        for (auto& tile : dirty_tiles)
+            report_error(paint_tile(display_list, tile));
+        for (auto& tile : dirty_thread_safe_tiles)
+            report_error(paint_tile(display_list, tile));
+        return;
+    }
+
+    Threading::Mutex mutex;
+    Threading::ConditionVariable all_tiles_painted { mutex };
+    size_t remaining_tile_count = dirty_thread_safe_tiles.size();
+
+    for (auto& tile : dirty_thread_safe_tiles) {
+        rasterization_thread_pool().submit([&, tile = &tile] {
+            report_error(paint_tile(display_list, *tile));
+
+            Threading::MutexLocker locker(mutex);
+            if (--remaining_tile_count == 0)
+                all_tiles_painted.signal();
+        });
+    }
+
+    // NOTE: The tiles that aren't thread-safe are painted one after another, at the same time as the others.
+    for (auto& tile : dirty_tiles)
+        report_error(paint_tile(display_list, tile));
+
+    Threading::MutexLocker locker(mutex);
+    all_tiles_painted.wait_while([&] { return remaining_tile_count > 0; });
+}
+
+void TiledRasterizerCPU::rasterize(DisplayList& display_list, Gfx::Bitmap& target)
+{
+    if (target.size() != m_viewport_size || target.format() != m_bitmap_format)
+        create_tiles(target.size(), target.format());
+
+    if (!bin_commands(display_list)) {
+        for (auto& tile : m_tiles)
+            tile.cached_fingerprint = {};
+        DisplayListPlayerCPU player(target);
+        display_list.execute(player);
+        return;
+    }
+
+    paint_dirty_tiles(display_list);
+
+    Gfx::Painter painter(target);
+    for (auto const& tile : m_tiles) {
+        if (tile.bitmap)
+            painter.blit(tile.rect.location(), *tile.bitmap, tile.bitmap->rect(), 1.0f, false);
+    }
+}
+
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/RefPtr.h>
+#include <AK/Vector.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Rect.h>
+#include <LibWeb/Painting/DisplayList.h>
+
+namespace Web::Painting {
+
+// Paints a display list on the CPU by splitting the viewport into tiles that are rasterized in parallel.
+// Every command is binned to the tiles its bounding rectangle intersects, and a tile is only painted again if the
+// commands binned to it changed since the previous frame.
+// Each tile has a player of its own, and the players share no state. Tiles with commands that aren't thread-safe are
+// painted on the calling thread, while the thread pool paints the others.
+class TiledRasterizerCPU {
+public:
+    static constexpr int tile_size = 256;
+
+    void rasterize(DisplayList&, Gfx::Bitmap& target);
+
+private:
+    struct Tile {
+        Gfx::IntRect rect;
+        RefPtr<Gfx::Bitmap> bitmap {};
+        Vector<u32> command_indices {};
+        u64 fingerprint { 0 };
+        bool is_cacheable { true };
+        bool is_thread_safe { true };
+
+        // The fingerprint of the commands that produced the current contents of the tile's bitmap, if any.
+        Optional<u64> cached_fingerprint {};
+
+        bool needs_repaint() const { return !is_cacheable || cached_fingerprint != fingerprint; }
+    };
+
+    void create_tiles(Gfx::IntSize viewport_size, Gfx::BitmapFormat);
+    bool bin_commands(DisplayList const&);
+    void paint_dirty_tiles(DisplayList&);
+    ErrorOr<void> paint_tile(DisplayList&, Tile&);
+
+    Gfx::IntSize m_viewport_size;
+    Gfx::BitmapFormat m_bitmap_format { Gfx::BitmapFormat::Invalid };
+    int m_column_count { 0 };
+    int m_row_count { 0 };
+    Vector<Tile> m_tiles;
+};
+
+}
@@ -160,7 +160,10 @@ void SVGImageElement::fetch_the_document(URL::URL const& url)
                 m_animation_timer->start();
             }
             set_needs_style_update(true);
-            document().set_needs_layout();
+            if (auto layout_node = this->layout_node())
+                layout_node->set_needs_layout();
+            else
+                document().set_needs_layout();
         },
         [this] {
             m_load_event_delayer.clear();
@@ -177,6 +177,23 @@ ErrorOr<bool> Client::handle_request(HTTP::HttpRequest const& request)
 }
 
 ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+{
+    TRY(send_response_headers(request, content_info));
+    TRY(send_response_body(response));
+    finish_response(request);
+    return {};
+}
+
+ErrorOr<void> Client::send_response(Core::File& file, HTTP::HttpRequest const& request, ContentInfo content_info)
+{
+    TRY(send_response_headers(request, content_info));
+    if (!TRY(send_file_contents(file, content_info.length)))
+        TRY(send_response_body(file));
+    finish_response(request);
+    return {};
+}
+
+ErrorOr<void> Client::send_response_headers(HTTP::HttpRequest const& request, ContentInfo const& content_info)
 {
     StringBuilder builder;
     TRY(builder.try_append("HTTP/1.0 200 OK\r\n"sv));
@@ -194,7 +211,11 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
     auto builder_contents = TRY(builder.to_byte_buffer());
     TRY(m_socket->write_until_depleted(builder_contents));
     log_response(200, request);
+    return {};
+}
 
+ErrorOr<void> Client::send_response_body(Stream& response)
+{
     char buffer[PAGE_SIZE];
     do {
         auto size = TRY(response.read_some({ buffer, sizeof(buffer) })).size();
@@ -212,7 +233,33 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
             write_buffer = write_buffer.slice(nwritten);
         }
     } while (true);
+    return {};
+}
 
+// Lets the kernel move the file contents straight to the socket, instead of
+// bouncing every page through our buffer with a read() and a write().
+// Returns false if the socket can't do that, in which case nothing was sent.
+ErrorOr<bool> Client::send_file_contents(Core::File& file, u64 length)
+{
+    off_t offset = 0;
+    while (static_cast<u64>(offset) < length) {
+        auto nsent_or_error = m_socket->send_file(file.fd(), offset, length - offset);
+        if (nsent_or_error.is_error()) {
+            auto code = nsent_or_error.error().code();
+            if (offset == 0 && (code == ENOTSUP || code == ENOSYS || code == EINVAL))
+                return false;
+            return nsent_or_error.release_error();
+        }
+
+        // The file got shorter since we looked at its size.
+        if (nsent_or_error.value() == 0)
+            break;
+    }
+    return true;
+}
+
+void Client::finish_response(HTTP::HttpRequest const& request)
+{
     auto keep_alive = false;
     if (auto it = request.headers().headers().find_if([](auto& header) { return header.name.equals_ignoring_ascii_case("Connection"sv); }); !it.is_end()) {
         if (it->value.trim_whitespace().equals_ignoring_ascii_case("keep-alive"sv))
@@ -220,8 +267,6 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
     }
     if (!keep_alive)
         m_socket->close();
-
-    return {};
 }
 
 ErrorOr<void> Client::send_redirect(StringView redirect_path, HTTP::HttpRequest const& request)
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/LexicalPath.h>
+#include <AK/NumberFormat.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/File.h>
+#include <LibCompress/Deflate.h>
+#include <LibMain/Main.h>
+
+static auto g_time_slice = Duration::from_seconds(3);
+
+struct Timings {
+    u64 total_us { 0 };
+    size_t count { 0 };
+};
+
+static Timings run_for_time_slice(Function<void()> const& function)
+{
+    Timings timings;
+    auto total_timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+    while (total_timer.elapsed_time() < g_time_slice || timings.count == 0) {
+        auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+        function();
+        timings.total_us += timer.elapsed_time().to_microseconds();
+        timings.count++;
+    }
+    return timings;
+}
+
+static ByteString throughput(size_t bytes, Timings const& timings)
+{
+    return ByteString::formatted("{}/s", human_readable_quantity(bytes * timings.count * 1'000'000 / max(timings.total_us, 1u)));
+}
+
+static StringView level_name(Compress::DeflateCompressor::CompressionLevel level)
+{
+    switch (level) {
+    case Compress::DeflateCompressor::CompressionLevel::STORE:
+        return "store"sv;
+    case Compress::DeflateCompressor::CompressionLevel::FAST:
+        return "fast"sv;
+    case Compress::DeflateCompressor::CompressionLevel::GOOD:
+        return "good"sv;
+    case Compress::DeflateCompressor::CompressionLevel::GREAT:
+        return "great"sv;
+    case Compress::DeflateCompressor::CompressionLevel::BEST:
+        return "best"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+static ErrorOr<void> benchmark_file(StringView path, ReadonlySpan<Compress::DeflateCompressor::CompressionLevel> levels)
+{
+    auto file = TRY(Core::File::open(path, Core::File::OpenMode::Read));
+    auto input = TRY(file->read_until_eof());
+
+    for (auto level : levels) {
+        ByteBuffer compressed;
+        auto compression = run_for_time_slice([&] {
+            compressed = MUST(Compress::DeflateCompressor::compress_all(input, level));
+        });
+
+        ByteBuffer decompressed;
+        auto decompression = run_for_time_slice([&] {
+            decompressed = MUST(Compress::DeflateDecompressor::decompress_all(compressed));
+        });
+        VERIFY(decompressed == input);
+
+        outln("{:<24} {:<6} {:>10} {:>10} {:>8.3} {:>14} {:>14}",
+            LexicalPath::basename(path),
+            level_name(level),
+            human_readable_size(input.size()),
+            human_readable_size(compressed.size()),
+            static_cast<double>(compressed.size()) / static_cast<double>(max(input.size(), 1uz)),
+            throughput(input.size(), compression),
+            throughput(input.size(), decompression));
+    }
+
+    return {};
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    Vector<StringView> paths;
+    Optional<u32> time_slice_ms;
+    Optional<u8> level;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Benchmark LibCompress's Deflate implementation on a corpus of files, at every compression level by default");
+    args_parser.add_positional_argument(paths, "Files to use as the corpus", "files");
+    args_parser.add_option(time_slice_ms, "Time slice for each benchmark in milliseconds", "time-slice", 't', "time-slice");
+    args_parser.add_option(level, "Only benchmark this compression level (0-4)", "level", 'l', "level");
+    args_parser.parse(arguments);
+
+    if (time_slice_ms.has_value())
+        g_time_slice = Duration::from_milliseconds(*time_slice_ms);
+
+    Vector<Compress::DeflateCompressor::CompressionLevel> levels;
+    if (level.has_value()) {
+        if (*level > static_cast<u8>(Compress::DeflateCompressor::CompressionLevel::BEST))
+            return Error::from_string_literal("Invalid compression level");
+        levels.append(static_cast<Compress::DeflateCompressor::CompressionLevel>(*level));
+    } else {
+        for (u8 i = 0; i <= static_cast<u8>(Compress::DeflateCompressor::CompressionLevel::BEST); ++i)
+            levels.append(static_cast<Compress::DeflateCompressor::CompressionLevel>(i));
+    }
+
+    outln("{:<24} {:<6} {:>10} {:>10} {:>8} {:>14} {:>14}", "File", "Level", "Size", "Deflated", "Ratio", "Deflate", "Inflate");
+    for (auto path : paths)
+        TRY(benchmark_file(path, levels));
+
+    return 0;
+}
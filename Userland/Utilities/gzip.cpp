@@ -20,11 +20,13 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool keep_input_files { false };
     bool write_to_stdout { false };
     bool decompress { false };
+    Optional<size_t> thread_count;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(keep_input_files, "Keep (don't delete) input files", "keep", 'k');
     args_parser.add_option(write_to_stdout, "Write to stdout, keep original files unchanged", "stdout", 'c');
     args_parser.add_option(decompress, "Decompress", "decompress", 'd');
+    args_parser.add_option(thread_count, "Compress on this many threads (0 for one per CPU)", "parallel", 'p', "threads");
     args_parser.add_positional_argument(filenames, "Files", "FILES", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
@@ -46,6 +48,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     if (write_to_stdout)
         keep_input_files = true;
 
+    if (thread_count == 0u)
+        thread_count = Core::System::hardware_concurrency();
+
     for (auto const& input_filename : filenames) {
         OwnPtr<Stream> output_stream;
 
@@ -74,10 +79,12 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         if (decompress) {
             input_stream = TRY(try_make<Compress::GzipDecompressor>(move(input_stream)));
         } else {
-            output_stream = TRY(try_make<Compress::GzipCompressor>(output_stream.release_nonnull()));
+            output_stream = TRY(try_make<Compress::GzipCompressor>(output_stream.release_nonnull(), thread_count.value_or(1)));
         }
 
-        auto buffer = TRY(ByteBuffer::create_uninitialized(1 * MiB));
+        // Every write to the compressor produces a separate gzip member, so give every thread a few chunks of each one.
+        auto buffer_size = max(1 * MiB, thread_count.value_or(1) * 4 * Compress::DeflateCompressor::parallel_chunk_size);
+        auto buffer = TRY(ByteBuffer::create_uninitialized(buffer_size));
 
         while (!input_stream->is_eof()) {
             auto span = TRY(input_stream->read_some(buffer));
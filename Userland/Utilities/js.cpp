@@ -534,6 +534,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     TRY(Core::System::pledge("stdio rpath wpath cpath tty sigaction map_fixed"));
 
     bool gc_on_every_allocation = false;
+    bool print_gc_reports = false;
+    bool incremental_gc = false;
     bool disable_syntax_highlight = false;
     bool disable_debug_printing = false;
     bool use_test262_global = false;
@@ -544,11 +546,15 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.set_general_help("This is a JavaScript interpreter.");
     args_parser.add_option(s_dump_ast, "Dump the AST", "dump-ast", 'A');
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
+    args_parser.add_option(JS::Bytecode::g_dump_property_lookup_cache_statistics, "Print property lookup cache statistics", "dump-property-cache-stats", {});
+    args_parser.add_option(JS::Bytecode::g_jit_enabled, "Compile hot bytecode to machine code", "jit", {});
     args_parser.add_option(s_as_module, "Treat as module", "as-module", 'm');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(s_strip_ansi, "Disable ANSI colors", "disable-ansi-colors", 'i');
     args_parser.add_option(s_disable_source_location_hints, "Disable source location hints", "disable-source-location-hints", 'h');
     args_parser.add_option(gc_on_every_allocation, "GC on every allocation", "gc-on-every-allocation", 'g');
+    args_parser.add_option(print_gc_reports, "Print a report after every garbage collection", "print-gc-reports", {});
+    args_parser.add_option(incremental_gc, "Mark and sweep the whole heap incrementally", "incremental-gc", {});
     args_parser.add_option(disable_syntax_highlight, "Disable live syntax highlighting", "no-syntax-highlight", 's');
     args_parser.add_option(disable_debug_printing, "Disable debug output", "disable-debug-output", {});
     args_parser.add_option(evaluate_script, "Evaluate argument as a script", "evaluate", 'c', "script");
@@ -563,6 +569,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     g_vm = TRY(JS::VM::create());
     g_vm->set_dynamic_imports_allowed(true);
+    g_vm->heap().set_should_print_collection_reports(print_gc_reports);
+    g_vm->heap().set_should_collect_incrementally(incremental_gc);
 
     if (!disable_debug_printing) {
         // NOTE: These will print out both warnings when using something like Promise.reject().catch(...) -
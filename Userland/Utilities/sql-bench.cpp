@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Random.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/System.h>
+#include <LibMain/Main.h>
+#include <LibSQL/BTree.h>
+#include <LibSQL/Heap.h>
+#include <LibSQL/Key.h>
+#include <LibSQL/Serializer.h>
+#include <LibSQL/TupleDescriptor.h>
+
+static ErrorOr<NonnullRefPtr<SQL::BTree>> open_index(SQL::Serializer& serializer)
+{
+    auto tuple_descriptor = adopt_ref(*new SQL::TupleDescriptor);
+    tuple_descriptor->append({ "bench", "index", "key", SQL::SQLType::Integer, SQL::Order::Ascending });
+
+    auto root = serializer.heap().user_value(0);
+    if (root == 0) {
+        root = serializer.heap().request_new_block_index();
+        serializer.heap().set_user_value(0, root);
+    }
+    auto btree = TRY(SQL::BTree::create(serializer, tuple_descriptor, true, root));
+    btree->on_new_root = [&serializer, btree = btree.ptr()] {
+        serializer.heap().set_user_value(0, btree->root());
+    };
+    return btree;
+}
+
+static SQL::Key make_key(SQL::BTree& btree, i32 value)
+{
+    SQL::Key key(btree.descriptor());
+    key[0] = value;
+    key.set_block_index(value + 1);
+    return key;
+}
+
+static u8 record_byte(size_t record, size_t offset)
+{
+    return static_cast<u8>(record * 31 + offset);
+}
+
+static void print_result(StringView name, size_t operations, Duration elapsed)
+{
+    auto elapsed_us = max(elapsed.to_microseconds(), 1);
+    outln("{:<8} {:>10} {:>10}ms {:>12.1}/s", name, operations, elapsed.to_milliseconds(), static_cast<double>(operations) * 1'000'000 / static_cast<double>(elapsed_us));
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    StringView database_path = "/tmp/sql-bench.db"sv;
+    size_t key_count = 10'000;
+    size_t lookup_count = 100'000;
+    size_t keys_per_commit = 1;
+    size_t record_count = 4'000;
+    size_t record_size = 2'000;
+    size_t read_count = 100'000;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Benchmark inserting keys into, and looking keys up in an index of a LibSQL heap, as well as writing and reading records");
+    args_parser.add_option(key_count, "Number of keys to insert", "keys", 'n', "count");
+    args_parser.add_option(lookup_count, "Number of random keys to look up", "lookups", 'l', "count");
+    args_parser.add_option(keys_per_commit, "Number of keys to insert per commit (1 commits every insert, like SQLServer does)", "keys-per-commit", 'c', "count");
+    args_parser.add_option(record_count, "Number of records to store outside of the index", "records", 'r', "count");
+    args_parser.add_option(record_size, "Size of every record in bytes", "record-size", 's', "bytes");
+    args_parser.add_option(read_count, "Number of random records to read back", "reads", 'R', "count");
+    args_parser.add_positional_argument(database_path, "Path of the database file to create", "database", Core::ArgsParser::Required::No);
+    args_parser.parse(arguments);
+
+    if (key_count == 0 || keys_per_commit == 0 || record_size == 0)
+        return Error::from_string_literal("Key count, keys per commit and record size must be positive");
+    if (!Core::System::access(database_path, F_OK).is_error())
+        return Error::from_string_literal("Refusing to overwrite an existing database");
+
+    // Insert the keys in random order, so the inserts are spread across the whole index
+    Vector<i32> keys;
+    TRY(keys.try_ensure_capacity(key_count));
+    for (size_t i = 0; i < key_count; ++i)
+        keys.unchecked_append(static_cast<i32>(i));
+    shuffle(keys);
+
+    outln("{:<8} {:>10} {:>12} {:>14}", "Phase", "Count", "Time", "Throughput");
+
+    {
+        auto heap = TRY(SQL::Heap::create(database_path));
+        TRY(heap->open());
+        SQL::Serializer serializer(heap);
+        auto btree = TRY(open_index(serializer));
+
+        auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+        for (size_t i = 0; i < key_count; ++i) {
+            VERIFY(btree->insert(make_key(*btree, keys[i])));
+            if ((i + 1) % keys_per_commit == 0 || i + 1 == key_count)
+                TRY(heap->flush());
+        }
+        print_result("insert"sv, key_count, timer.elapsed_time());
+    }
+
+    {
+        // Start looking up keys with an index that is read back from disk, not one that is still in memory
+        auto heap = TRY(SQL::Heap::create(database_path));
+        TRY(heap->open());
+        SQL::Serializer serializer(heap);
+        auto btree = TRY(open_index(serializer));
+
+        auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+        for (size_t i = 0; i < lookup_count; ++i) {
+            auto key = static_cast<i32>(get_random_uniform(key_count));
+            auto lookup_key = make_key(*btree, key);
+            auto pointer = btree->get(lookup_key);
+            VERIFY(pointer.has_value() && pointer.value() == static_cast<u32>(key) + 1);
+        }
+        print_result("lookup"sv, lookup_count, timer.elapsed_time());
+    }
+
+    // The lookups above mostly hit nodes the index keeps in memory. These records take up several times as many blocks
+    // as the buffer pool holds, and every read goes through the heap.
+    Vector<SQL::Block::Index> record_indices;
+    TRY(record_indices.try_ensure_capacity(record_count));
+    {
+        auto heap = TRY(SQL::Heap::create(database_path));
+        TRY(heap->open());
+        auto record = TRY(ByteBuffer::create_uninitialized(record_size));
+
+        auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+        for (size_t i = 0; i < record_count; ++i) {
+            for (size_t offset = 0; offset < record_size; ++offset)
+                record[offset] = record_byte(i, offset);
+            auto index = heap->request_new_block_index();
+            TRY(heap->write_storage(index, record));
+            record_indices.unchecked_append(index);
+            if ((i + 1) % keys_per_commit == 0 || i + 1 == record_count)
+                TRY(heap->flush());
+        }
+        print_result("write"sv, record_count, timer.elapsed_time());
+    }
+
+    if (record_count > 0) {
+        auto heap = TRY(SQL::Heap::create(database_path));
+        TRY(heap->open());
+
+        auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+        for (size_t i = 0; i < read_count; ++i) {
+            auto record = get_random_uniform(record_count);
+            auto data = TRY(heap->read_storage(record_indices[record]));
+            VERIFY(data.size() == record_size);
+            VERIFY(data[0] == record_byte(record, 0) && data[record_size - 1] == record_byte(record, record_size - 1));
+        }
+        print_result("read"sv, read_count, timer.elapsed_time());
+    }
+
+    TRY(Core::System::unlink(database_path));
+    return 0;
+}
@@ -19,15 +19,17 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     Vector<StringView> source_paths;
     bool recurse = false;
     bool force = false;
+    Optional<size_t> thread_count;
 
     Core::ArgsParser args_parser;
     args_parser.add_positional_argument(zip_path, "Zip file path", "zipfile", Core::ArgsParser::Required::Yes);
     args_parser.add_positional_argument(source_paths, "Input files to be archived", "files", Core::ArgsParser::Required::Yes);
     args_parser.add_option(recurse, "Travel the directory structure recursively", "recurse-paths", 'r');
     args_parser.add_option(force, "Overwrite existing zip file", "force", 'f');
+    args_parser.add_option(thread_count, "Compress on this many threads (0 for one per CPU)", "parallel", 'p', "threads");
     args_parser.parse(arguments);
 
-    TRY(Core::System::pledge("stdio rpath wpath cpath"));
+    TRY(Core::System::pledge("stdio rpath wpath cpath thread"));
 
     auto cwd = TRY(Core::System::getcwd());
     TRY(Core::System::unveil(LexicalPath::absolute_path(cwd, zip_path), "wc"sv));
@@ -47,7 +49,9 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     outln("Archive: {}", zip_path);
     auto file_stream = TRY(Core::File::open(zip_path, Core::File::OpenMode::Write));
-    Archive::ZipOutputStream zip_stream(move(file_stream));
+    if (thread_count == 0u)
+        thread_count = Core::System::hardware_concurrency();
+    Archive::ZipOutputStream zip_stream(move(file_stream), thread_count.value_or(1));
 
     auto add_file = [&](StringView path) -> ErrorOr<void> {
         auto canonicalized_path = TRY(String::from_byte_string(LexicalPath::canonicalized_path(path)));